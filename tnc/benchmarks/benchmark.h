@@ -0,0 +1,62 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Minimal benchmark harness, benchmarks register themselves with
+ * TONIC_BENCHMARK and are run by the runBenchmarks executable
+ */
+
+#ifndef TONIC_BENCHMARK_H
+#define TONIC_BENCHMARK_H
+
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace tonic::bench {
+
+    struct Benchmark {
+        std::string name;
+        std::function<void()> run;
+    };
+
+    std::vector<Benchmark> &Registry();
+
+    bool Register(const std::string &name, std::function<void()> run);
+
+    // prints a result line, items and unit are optional (e.g. 1e6 "nodes" or bytes "B")
+    void Report(const std::string &label, double seconds, double items = 0, const std::string &unit = "");
+
+    template<typename T>
+    inline void DoNotOptimize(const T &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // runs fn repeatedly and reports the fastest run
+    template<typename F>
+    double Measure(const std::string &label, size_t repetitions, F &&fn, double items = 0,
+                   const std::string &unit = "") {
+        double best = std::numeric_limits<double>::max();
+
+        for (size_t i = 0; i < repetitions; i++) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+
+        Report(label, best, items, unit);
+        return best;
+    }
+
+}
+
+#define TONIC_BENCHMARK(name)                                                              \
+    static void name();                                                                    \
+    [[maybe_unused]] static bool name##_registered = tonic::bench::Register(#name, name); \
+    static void name()
+
+#endif //TONIC_BENCHMARK_H
@@ -0,0 +1,76 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Global-scope lookups from many reader threads, snapshot table
+ * against an unordered_map behind a shared_mutex
+ */
+
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "core/concurrent_symbol_table.h"
+
+using namespace tonic;
+
+namespace {
+
+    constexpr size_t NAMES = 2000;
+    constexpr size_t LOOKUPS_PER_THREAD = 200000;
+
+    template<typename F>
+    void RunReaders(size_t threads, F &&lookup) {
+        std::vector<std::thread> readers;
+        for (size_t t = 0; t < threads; t++) {
+            readers.emplace_back([&lookup, t] {
+                size_t found = 0;
+                uint64_t state = t + 1;
+                for (size_t i = 0; i < LOOKUPS_PER_THREAD; i++) {
+                    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                    found += lookup(static_cast<size_t>(state >> 33) % NAMES);
+                }
+                bench::DoNotOptimize(found);
+            });
+        }
+        for (auto &reader: readers)
+            reader.join();
+    }
+
+}
+
+TONIC_BENCHMARK(ConcurrentSymbolLookups) {
+    std::vector<Atom> names;
+    for (size_t i = 0; i < NAMES; i++)
+        names.emplace_back("global" + std::to_string(i));
+
+    ConcurrentSymbolTable table;
+    std::unordered_map<Atom, SymbolInfo> locked_table;
+    std::shared_mutex mutex;
+    for (Atom name: names) {
+        table.Insert(name, "long long");
+        locked_table.emplace(name, SymbolInfo(name, "long long"));
+    }
+    table.Publish();
+
+    for (size_t threads = 1; threads <= 64; threads *= 2) {
+        double lookups = double(threads * LOOKUPS_PER_THREAD);
+
+        bench::Measure("shared_mutex map, " + std::to_string(threads) + " readers", 3, [&] {
+            RunReaders(threads, [&](size_t i) {
+                std::shared_lock lock(mutex);
+                return locked_table.count(names[i]);
+            });
+        }, lookups, "lookups");
+
+        bench::Measure("snapshot table, " + std::to_string(threads) + " readers", 3, [&] {
+            RunReaders(threads, [&](size_t i) {
+                return size_t(table.Find(names[i]) != nullptr);
+            });
+        }, lookups, "lookups");
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Traversal of the pointer-based AST against the flat AST
+ */
+
+#include "benchmark.h"
+#include "programs.h"
+
+#include "core/children.h"
+#include "core/flat_ast.h"
+#include "traversal/walker.h"
+
+using namespace tonic;
+
+namespace {
+
+    size_t CountStatements(const Node &node) {
+        size_t count = dynamic_cast<const GeneralStatement *>(&node) ? 1 : 0;
+        ForEachChildSlot(node, [&](const auto &slot) {
+            if (slot)
+                count += CountStatements(*slot);
+        });
+        return count;
+    }
+
+}
+
+TONIC_BENCHMARK(FlatAstTraversal) {
+    auto program = bench::MakeLoopProgram(1000000 / 12);
+    FlatAst flat(program);
+    auto nodes = static_cast<double>(flat.Size());
+
+    bench::Measure("flatten", 3, [&] {
+        FlatAst copy(program);
+        bench::DoNotOptimize(copy.Size());
+    }, nodes, "nodes");
+
+    bench::Measure("Walker over tree", 5, [&] {
+        size_t count = 0;
+        Walker walker;
+        walker.Register<GeneralStatement>([&](std::shared_ptr<GeneralStatement>) { ++count; });
+        walker.Walk(program);
+        bench::DoNotOptimize(count);
+    }, nodes, "nodes");
+
+    bench::Measure("Walker over flat AST", 5, [&] {
+        size_t count = 0;
+        Walker walker;
+        walker.Register<GeneralStatement>([&](std::shared_ptr<GeneralStatement>) { ++count; });
+        walker.Walk(flat);
+        bench::DoNotOptimize(count);
+    }, nodes, "nodes");
+
+    bench::Measure("recursive child slots", 5, [&] {
+        bench::DoNotOptimize(CountStatements(*program));
+    }, nodes, "nodes");
+
+    bench::Measure("linear scan of flat AST", 5, [&] {
+        size_t count = 0;
+        for (const FlatNode &node: flat.Nodes())
+            count += node.kind == NodeKind::GENERAL_STATEMENT;
+        bench::DoNotOptimize(count);
+    }, nodes, "nodes");
+
+    bench::Measure("flat scan skipping loop bodies", 5, [&] {
+        size_t count = 0;
+        for (uint32_t i = 0; i < flat.Size();) {
+            if (flat[i].kind == NodeKind::FOR_LOOP) {
+                ++count;
+                i = flat.SkipSubtree(i);
+            } else {
+                ++i;
+            }
+        }
+        bench::DoNotOptimize(count);
+    }, nodes, "nodes");
+}
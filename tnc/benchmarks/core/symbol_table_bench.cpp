@@ -0,0 +1,122 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Scoped symbol table against a stack of string-keyed maps on deeply
+ * nested blocks that keep shadowing the same short names
+ */
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "core/symbol_table.h"
+
+using namespace tonic;
+
+namespace {
+
+    constexpr size_t ROUNDS = 2000;
+    constexpr size_t DEPTH = 16;
+    constexpr size_t DECLARATIONS_PER_SCOPE = 6;
+    constexpr size_t LOOKUPS_PER_SCOPE = 40;
+
+    struct Workload {
+        std::vector<std::string> names;
+        std::vector<size_t> declared; // DECLARATIONS_PER_SCOPE entries per scope
+        std::vector<size_t> looked_up; // LOOKUPS_PER_SCOPE entries per scope
+    };
+
+    Workload MakeWorkload() {
+        Workload workload;
+        for (const char *name: {"i", "j", "k", "n", "m", "x", "y", "a", "b", "dp", "ans", "res", "cnt", "sum", "l", "r"})
+            workload.names.emplace_back(name);
+        for (size_t i = 0; i < 48; i++)
+            workload.names.push_back("temp" + std::to_string(i));
+
+        uint64_t state = 12345;
+        auto next = [&]() {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<size_t>(state >> 33);
+        };
+
+        for (size_t scope = 0; scope < DEPTH; scope++) {
+            for (size_t i = 0; i < DECLARATIONS_PER_SCOPE; i++)
+                workload.declared.push_back(next() % 16); // mostly the short names, heavy shadowing
+            for (size_t i = 0; i < LOOKUPS_PER_SCOPE; i++)
+                workload.looked_up.push_back(next() % workload.names.size());
+        }
+        return workload;
+    }
+
+    struct NaiveInfo {
+        std::string name;
+        std::string type;
+    };
+
+    size_t RunNaive(const Workload &workload) {
+        size_t found = 0;
+        std::vector<std::unordered_map<std::string, NaiveInfo>> scopes(1);
+
+        for (size_t round = 0; round < ROUNDS; round++) {
+            for (size_t depth = 0; depth < DEPTH; depth++) {
+                scopes.emplace_back();
+                for (size_t i = 0; i < DECLARATIONS_PER_SCOPE; i++) {
+                    const std::string &name = workload.names[workload.declared[depth * DECLARATIONS_PER_SCOPE + i]];
+                    scopes.back().insert_or_assign(name, NaiveInfo{name, "long long"});
+                }
+
+                for (size_t i = 0; i < LOOKUPS_PER_SCOPE; i++) {
+                    const std::string &name = workload.names[workload.looked_up[depth * LOOKUPS_PER_SCOPE + i]];
+                    for (size_t scope = scopes.size(); scope-- > 0;) {
+                        if (scopes[scope].count(name)) {
+                            ++found;
+                            break;
+                        }
+                    }
+                }
+            }
+            scopes.resize(1);
+        }
+        return found;
+    }
+
+    size_t RunScoped(const Workload &workload, const std::vector<Atom> &atoms, SymbolTable &table, Atom type) {
+        size_t found = 0;
+
+        for (size_t round = 0; round < ROUNDS; round++) {
+            for (size_t depth = 0; depth < DEPTH; depth++) {
+                table.PushScope();
+                for (size_t i = 0; i < DECLARATIONS_PER_SCOPE; i++)
+                    table.Insert(atoms[workload.declared[depth * DECLARATIONS_PER_SCOPE + i]], type);
+
+                for (size_t i = 0; i < LOOKUPS_PER_SCOPE; i++)
+                    found += table.Find(atoms[workload.looked_up[depth * LOOKUPS_PER_SCOPE + i]]) != nullptr;
+            }
+            for (size_t depth = 0; depth < DEPTH; depth++)
+                table.PopScope();
+        }
+        return found;
+    }
+
+}
+
+TONIC_BENCHMARK(ScopedSymbolTable) {
+    Workload workload = MakeWorkload();
+    double operations = ROUNDS * DEPTH * (DECLARATIONS_PER_SCOPE + LOOKUPS_PER_SCOPE);
+
+    bench::Measure("stack of unordered_map<string> scopes", 5, [&] {
+        bench::DoNotOptimize(RunNaive(workload));
+    }, operations, "operations");
+
+    std::vector<Atom> atoms(workload.names.begin(), workload.names.end());
+    Atom type = "long long";
+    SymbolTable table;
+
+    bench::Measure("SymbolTable, interned names", 5, [&] {
+        bench::DoNotOptimize(RunScoped(workload, atoms, table, type));
+    }, operations, "operations");
+}
@@ -0,0 +1,71 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief C++ generation throughput into the chunked output sink
+ */
+
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+
+#include "benchmark.h"
+#include "programs.h"
+
+#include "core/thread_pool.h"
+#include "generators/cppgen.h"
+
+using namespace tonic;
+
+TONIC_BENCHMARK(CppgenThroughput) {
+    auto program = bench::MakeLoopProgram(1000000 / 12);
+
+    OutputSink sized;
+    CppGenerator(sized).Generate(*program);
+    double bytes = static_cast<double>(sized.Size());
+
+    bench::Measure("whole program into an in-memory sink", 5, [&] {
+        OutputSink out;
+        CppGenerator(out).Generate(*program);
+        bench::DoNotOptimize(out.Pages());
+    }, bytes, "B");
+
+    int null = open("/dev/null", O_WRONLY);
+    bench::Measure("whole program streamed to a descriptor", 5, [&] {
+        OutputSink out(null);
+        CppGenerator(out).Generate(*program);
+        out.Flush();
+    }, bytes, "B");
+    close(null);
+
+    bench::Measure("in-memory sink copied out with ToString", 5, [&] {
+        OutputSink out;
+        CppGenerator(out).Generate(*program);
+        bench::DoNotOptimize(out.ToString());
+    }, bytes, "B");
+}
+
+TONIC_BENCHMARK(CppgenParallelScaling) {
+    auto program = bench::MakeLoopProgram(1000000 / 12);
+
+    OutputSink sized;
+    CppGenerator(sized).Generate(*program);
+    double bytes = static_cast<double>(sized.Size());
+
+    bench::Measure("sequential", 5, [&] {
+        OutputSink out;
+        CppGenerator(out).Generate(*program);
+        bench::DoNotOptimize(out.Pages());
+    }, bytes, "B");
+
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= std::max<size_t>(8, hardware); threads *= 2) {
+        ThreadPool pool(threads);
+        bench::Measure(std::to_string(threads) + " threads", 5, [&] {
+            OutputSink out;
+            CppGenerator(out).Generate(*program, &pool);
+            bench::DoNotOptimize(out.Pages());
+        }, bytes, "B");
+    }
+}
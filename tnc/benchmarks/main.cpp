@@ -0,0 +1,47 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Benchmark runner. Pass a substring to run only matching benchmarks
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "benchmark.h"
+
+namespace tonic::bench {
+
+    std::vector<Benchmark> &Registry() {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    bool Register(const std::string &name, std::function<void()> run) {
+        Registry().push_back({name, std::move(run)});
+        return true;
+    }
+
+    void Report(const std::string &label, double seconds, double items, const std::string &unit) {
+        std::printf("  %-48s %12.3f ms", label.c_str(), seconds * 1e3);
+        if (items > 0)
+            std::printf("  %12.3e %s/s", items / seconds, unit.c_str());
+        std::printf("\n");
+    }
+
+}
+
+int main(int argc, char **argv) {
+    std::string filter = argc > 1 ? argv[1] : "";
+
+    for (const auto &benchmark: tonic::bench::Registry()) {
+        if (benchmark.name.find(filter) == std::string::npos)
+            continue;
+
+        std::printf("%s\n", benchmark.name.c_str());
+        benchmark.run();
+    }
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Synthetic programs shared by the benchmarks
+ */
+
+#ifndef TONIC_BENCHMARK_PROGRAMS_H
+#define TONIC_BENCHMARK_PROGRAMS_H
+
+#include <memory>
+#include <string>
+
+#include "core/ast.h"
+
+namespace tonic::bench {
+
+    inline std::shared_ptr<GeneralStatement> Statement(const std::string &text) {
+        auto statement = std::make_shared<GeneralStatement>();
+        statement->statement = text;
+        return statement;
+    }
+
+    // functions made of loops over small statement blocks, 12 nodes per loop
+    inline std::shared_ptr<Program> MakeLoopProgram(size_t loops, size_t loops_per_function = 50) {
+        auto program = std::make_shared<Program>();
+        std::shared_ptr<FunctionDeclaration> function;
+
+        for (size_t i = 0; i < loops; i++) {
+            if (i % loops_per_function == 0) {
+                function = std::make_shared<FunctionDeclaration>();
+                function->type = Statement("void");
+                function->name = Statement("solve" + std::to_string(i / loops_per_function));
+                function->block = std::make_shared<Block>();
+                program->body.push_back(function);
+            }
+
+            auto loop = std::make_shared<ForLoop>();
+            loop->identifier = Statement("i");
+            loop->start = Statement("0");
+            loop->end = Statement("n");
+            loop->block = std::make_shared<Block>();
+            loop->block->body.push_back(Statement("a [ i ] += b [ i ] * " + std::to_string(i % 7)));
+            loop->block->body.push_back(Statement("sum += a [ i ]"));
+
+            auto variable = std::make_shared<VariableDeclaration>();
+            variable->identifier = Statement("x");
+            variable->initializer = Statement("a [ i ] % 1000000007");
+            loop->block->body.push_back(variable);
+
+            auto output = std::make_shared<InputOutput>();
+            output->type = InOut::OUT;
+            output->operands.push_back(Statement("x"));
+            loop->block->body.push_back(output);
+
+            function->block->body.push_back(loop);
+        }
+
+        return program;
+    }
+
+}
+
+#endif //TONIC_BENCHMARK_PROGRAMS_H
@@ -0,0 +1,85 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Input reader runtime against iostreams on 10^7 integers
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <unistd.h>
+
+#include "benchmark.h"
+
+#include "runtime/fast_input.h"
+
+using namespace tonic;
+
+TONIC_BENCHMARK(FastInputIntegers) {
+    const size_t count = 10000000;
+    char path[] = "/tmp/tnc_fast_input_XXXXXX";
+    int fd = mkstemp(path);
+
+    {
+        std::mt19937_64 random(1);
+        std::ofstream file(path);
+        for (size_t i = 0; i < count; i++)
+            file << static_cast<long long>(random() % 2000000001) - 1000000000 << (i % 20 == 19 ? '\n' : ' ');
+    }
+
+    // with sync_with_stdio(false) cin reads through the same filebuf as an ifstream
+    bench::Measure("ifstream >>, as cin without stdio sync", 3, [&] {
+        std::ifstream file(path);
+        long long value, sum = 0;
+        for (size_t i = 0; i < count; i++) {
+            file >> value;
+            sum += value;
+        }
+        bench::DoNotOptimize(sum);
+    }, count, "ints");
+
+    bench::Measure("Reader, stdin mapped", 3, [&] {
+        lseek(fd, 0, SEEK_SET);
+        _tnc_runtime::Reader reader(fd);
+        long long value, sum = 0;
+        for (size_t i = 0; i < count; i++) {
+            reader.Read(value);
+            sum += value;
+        }
+        bench::DoNotOptimize(sum);
+    }, count, "ints");
+
+    bench::Measure("Reader, 64 KiB reads as from a pipe", 3, [&] {
+        lseek(fd, 0, SEEK_SET);
+        _tnc_runtime::Reader reader(fd, false);
+        long long value, sum = 0;
+        for (size_t i = 0; i < count; i++) {
+            reader.Read(value);
+            sum += value;
+        }
+        bench::DoNotOptimize(sum);
+    }, count, "ints");
+
+    const char *kernels[] = {"scalar", "SSE4.1", "AVX2"};
+    for (int level = 0; level < 3; level++) {
+#if TNC_RUNTIME_X86
+        if ((level == 1 && !__builtin_cpu_supports("sse4.1")) || (level == 2 && !__builtin_cpu_supports("avx2")))
+            continue;
+#else
+        if (level > 0)
+            continue;
+#endif
+        bench::Measure(std::string("Reader, into a vector, ") + kernels[level] + " digits", 3, [&] {
+            lseek(fd, 0, SEEK_SET);
+            _tnc_runtime::Reader reader(fd, true, level);
+            std::vector<long long> values(count);
+            reader.Read(values);
+            bench::DoNotOptimize(values.back());
+        }, count, "ints");
+    }
+
+    close(fd);
+    unlink(path);
+}
@@ -0,0 +1,60 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Output writer runtime against iostreams and printf on 10^7 integers
+ */
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <random>
+#include <unistd.h>
+
+#include "benchmark.h"
+
+#include "runtime/fast_output.h"
+
+using namespace tonic;
+
+TONIC_BENCHMARK(FastOutputIntegers) {
+    const size_t count = 10000000;
+    std::mt19937_64 random(1);
+    std::vector<long long> values(count);
+    for (auto &value: values)
+        value = static_cast<long long>(random() % 2000000001) - 1000000000;
+
+    // with sync_with_stdio(false) cout writes through the same filebuf as an ofstream
+    bench::Measure("ofstream <<, as cout without stdio sync", 3, [&] {
+        std::ofstream file("/dev/null");
+        for (long long value: values)
+            file << value << '\n';
+    }, count, "ints");
+
+    bench::Measure("printf", 3, [&] {
+        FILE *file = std::fopen("/dev/null", "w");
+        for (long long value: values)
+            std::fprintf(file, "%lld\n", value);
+        std::fclose(file);
+    }, count, "ints");
+
+    int null = open("/dev/null", O_WRONLY);
+    bench::Measure("Writer, a line per number", 3, [&] {
+        _tnc_runtime::Writer writer(false, null);
+        for (long long value: values)
+            writer.Line(value);
+    }, count, "ints");
+
+    bench::Measure("Writer, the vector joined on one line", 3, [&] {
+        _tnc_runtime::Writer writer(false, null);
+        writer.Line(values);
+    }, count, "ints");
+
+    bench::Measure("Writer, interactive, flushed per line", 1, [&] {
+        _tnc_runtime::Writer writer(true, null);
+        for (size_t i = 0; i < count / 10; i++)
+            writer.Line(values[i]);
+    }, count / 10, "ints");
+    close(null);
+}
@@ -0,0 +1,122 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Memo table runtime against std::map and std::unordered_map on a
+ * grid path count and a knapsack recursion, top-down and filled bottom-up
+ */
+
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+#include "benchmark.h"
+
+#include "runtime/memo.h"
+
+using namespace tonic;
+
+namespace {
+
+    const long long MOD = 1000000007;
+
+    // paths to (i, j) moving right or down, f is the memoized function the body calls
+    template<typename F>
+    long long Paths(int i, int j, F &f) {
+        if (i == 0 || j == 0)
+            return 1;
+        return (f(i - 1, j) + f(i, j - 1)) % MOD;
+    }
+
+    // best value of the first i items within capacity c, weights are spread so few capacities are reached
+    template<typename F>
+    long long Knapsack(int i, int c, F &f) {
+        if (i == 0)
+            return 0;
+        int weight = 100 + i * 7919 % 5000, value = i * 104729 % 1000;
+        long long best = f(i - 1, c);
+        if (weight <= c)
+            best = std::max(best, f(i - 1, c - weight) + value);
+        return best;
+    }
+
+    // the wrapper generated code has around a body, with find and store on the table
+    template<typename Body, typename Find, typename Store>
+    long long TopDown(int a, int b, Body body, Find find, Store store) {
+        std::function<long long(int, int)> f = [&](int i, int j) {
+            if (const long long *cached = find(i, j))
+                return *cached;
+            return store(body(i, j, f), i, j);
+        };
+        return f(a, b);
+    }
+
+    template<typename Body>
+    void Compare(const std::string &problem, int a, int b, size_t states, Body body) {
+        bench::Measure(problem + ", DenseMemo", 3, [&] {
+            _tnc_runtime::DenseMemo<long long, 2> memo({0, 0}, {a + 1, b + 1});
+            bench::DoNotOptimize(TopDown(a, b, body, [&](int i, int j) { return memo.Find(i, j); },
+                                         [&](long long value, int i, int j) { return memo.Store(value, i, j); }));
+        }, states, "states");
+
+        // the lowering of decreasing recursion, the wrapper fills the table up to its arguments
+        bench::Measure(problem + ", DenseMemo filled bottom-up", 3, [&] {
+            _tnc_runtime::DenseMemo<long long, 2> memo({0, 0}, {a + 1, b + 1});
+            std::function<long long(int, int)> f;
+            auto compute = [&](int i, int j) { return body(i, j, f); };
+            f = [&](int i, int j) {
+                if (const long long *cached = memo.Fill(compute, i, j))
+                    return *cached;
+                return compute(i, j);
+            };
+            bench::DoNotOptimize(f(a, b));
+        }, static_cast<double>(a + 1) * (b + 1), "states");
+
+        bench::Measure(problem + ", HashMemo", 3, [&] {
+            _tnc_runtime::HashMemo<long long, int, int> memo;
+            bench::DoNotOptimize(TopDown(a, b, body, [&](int i, int j) { return memo.Find(i, j); },
+                                         [&](long long value, int i, int j) { return memo.Store(value, i, j); }));
+        }, states, "states");
+
+        bench::Measure(problem + ", unordered_map<long long>", 3, [&] {
+            std::unordered_map<long long, long long> memo;
+            auto find = [&](int i, int j) -> const long long * {
+                auto it = memo.find(static_cast<long long>(i) << 32 | j);
+                return it == memo.end() ? nullptr : &it->second;
+            };
+            auto store = [&](long long value, int i, int j) {
+                return memo[static_cast<long long>(i) << 32 | j] = value;
+            };
+            bench::DoNotOptimize(TopDown(a, b, body, find, store));
+        }, states, "states");
+
+        bench::Measure(problem + ", map<pair>", 1, [&] {
+            std::map<std::pair<int, int>, long long> memo;
+            auto find = [&](int i, int j) -> const long long * {
+                auto it = memo.find({i, j});
+                return it == memo.end() ? nullptr : &it->second;
+            };
+            auto store = [&](long long value, int i, int j) { return memo[{i, j}] = value; };
+            bench::DoNotOptimize(TopDown(a, b, body, find, store));
+        }, states, "states");
+    }
+
+}
+
+TONIC_BENCHMARK(MemoTables) {
+    const int n = 2000;
+    Compare("grid paths 2000x2000", n, n, static_cast<size_t>(n + 1) * n, [](int i, int j, auto &f) {
+        return Paths(i, j, f);
+    });
+
+    // a sparse table, most capacities are never reached top-down
+    const int items = 200, capacity = 20000;
+    _tnc_runtime::HashMemo<long long, int, int> reached;
+    TopDown(items, capacity, [](int i, int c, auto &f) { return Knapsack(i, c, f); },
+            [&](int i, int c) { return reached.Find(i, c); },
+            [&](long long value, int i, int c) { return reached.Store(value, i, c); });
+    Compare("knapsack 200 items", items, capacity, reached.Size(), [](int i, int c, auto &f) {
+        return Knapsack(i, c, f);
+    });
+}
@@ -0,0 +1,52 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Scaling of a per-function analysis with the parallel walker
+ */
+
+#include <thread>
+
+#include "benchmark.h"
+#include "programs.h"
+
+#include "traversal/parallel_walker.h"
+
+using namespace tonic;
+
+namespace {
+
+    // stands in for a per-statement check, hashes the statement text
+    struct Checksum {
+        uint64_t value = 0;
+
+        void Merge(Checksum &&other) {
+            value = value * 31 + other.value;
+        }
+    };
+
+}
+
+TONIC_BENCHMARK(ParallelWalkerScaling) {
+    auto program = bench::MakeLoopProgram(1000000 / 12);
+    double nodes = 1000000;
+
+    ParallelWalker<Checksum> walker;
+    walker.Register<GeneralStatement>([](GeneralStatement &statement, Checksum &state) {
+        for (char c: statement.statement)
+            state.value = (state.value ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }, HandlerSafety::SUBTREE_LOCAL);
+
+    bench::Measure("serial", 5, [&] {
+        bench::DoNotOptimize(walker.Walk(program).value);
+    }, nodes, "nodes");
+
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= std::max<size_t>(8, hardware); threads *= 2) {
+        ThreadPool pool(threads);
+        bench::Measure(std::to_string(threads) + " threads", 5, [&] {
+            bench::DoNotOptimize(walker.Walk(program, &pool).value);
+        }, nodes, "nodes");
+    }
+}
@@ -0,0 +1,44 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Runtime Walker against the compile-time AstVisitor
+ */
+
+#include "benchmark.h"
+#include "programs.h"
+
+#include "traversal/visitor.h"
+#include "traversal/walker.h"
+
+using namespace tonic;
+
+namespace {
+
+    struct StatementCounter : AstVisitor<StatementCounter> {
+        size_t count = 0;
+
+        void Visit(GeneralStatement &) { ++count; }
+    };
+
+}
+
+TONIC_BENCHMARK(WalkerAgainstVisitor) {
+    auto program = bench::MakeLoopProgram(1000000 / 12);
+    double nodes = 1000000;
+
+    bench::Measure("Walker with std::function handler", 5, [&] {
+        size_t count = 0;
+        Walker walker;
+        walker.Register<GeneralStatement>([&](std::shared_ptr<GeneralStatement>) { ++count; });
+        walker.Walk(program);
+        bench::DoNotOptimize(count);
+    }, nodes, "nodes");
+
+    bench::Measure("AstVisitor with inlined Visit", 5, [&] {
+        StatementCounter counter;
+        counter.Traverse(program);
+        bench::DoNotOptimize(counter.count);
+    }, nodes, "nodes");
+}
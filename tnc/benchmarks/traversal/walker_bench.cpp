@@ -0,0 +1,44 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Walker steady-state traversal with a reused walk stack
+ */
+
+#include "benchmark.h"
+#include "programs.h"
+
+#include "traversal/walker.h"
+
+using namespace tonic;
+
+TONIC_BENCHMARK(WalkerReuse) {
+    auto program = bench::MakeLoopProgram(1000000 / 12);
+    double nodes = 1000000;
+
+    size_t loops = 0;
+    size_t max_depth = 0;
+    Walker walker;
+    walker.Register<ForLoop>([&](std::shared_ptr<ForLoop>) {
+        ++loops;
+        max_depth = std::max(max_depth, walker.Ancestors().size());
+    });
+    walker.Walk(program); // warm-up sizes the reusable stacks
+
+    bench::Measure("reused Walker, handler on loops only", 5, [&] {
+        walker.Walk(program);
+        bench::DoNotOptimize(loops);
+    }, nodes, "nodes");
+
+    bench::Measure("fresh Walker per walk", 5, [&] {
+        Walker fresh;
+        fresh.Register<ForLoop>([&](std::shared_ptr<ForLoop>) { ++loops; });
+        fresh.Walk(program);
+        bench::DoNotOptimize(loops);
+    }, nodes, "nodes");
+
+    bench::Measure("Any<InputOutput>, stops at the first match", 5, [&] {
+        bench::DoNotOptimize(Any<InputOutput>(program));
+    });
+}
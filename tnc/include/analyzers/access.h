@@ -0,0 +1,87 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Subscript patterns of nested loops, with loop interchange where an
+ * array is walked column by column
+ */
+
+#ifndef TONIC_ACCESS_H
+#define TONIC_ACCESS_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/ast.h"
+#include "core/persistent.h"
+#include "errors/diagnostics.h"
+
+namespace tonic {
+
+    // an indexed read or write such as a [ j ] [ i ]
+    struct ArrayAccess {
+        Atom array;
+        std::vector<std::string> subscripts;
+        bool write;
+    };
+
+    // the indexed accesses of a statement, subscripts nested in subscripts included
+    std::vector<ArrayAccess> FindAccesses(const std::string &statement);
+
+    // true when the index moves a subscript other than the last one, so consecutive iterations are a row apart
+    bool IsStrided(const ArrayAccess &access, Atom index);
+
+    /**
+     * Copy of a perfect two loop nest with the loops swapped, built from shallow copies, so the
+     * original nest, which may be shared, is left untouched. The body block is shared.
+     */
+    std::shared_ptr<ForLoop> Interchange(const ForLoop &outer);
+
+    struct NestReport {
+        const ForLoop *outer;      // the nest as it was before any interchange
+        const ForLoop *inner;
+        size_t strided;            // strided accesses in the current order
+        size_t strided_swapped;    // strided accesses with the loops swapped
+        std::vector<Atom> arrays;  // arrays the swap would turn to unit stride
+        bool interchanged;
+        std::string reason;        // why a beneficial swap is not legal, empty otherwise
+    };
+
+    /**
+     * Looks at every perfect nest of two for loops whose inner body has no loops. The swap pays off
+     * when it leaves fewer strided accesses, and it is legal when the bounds are rectangular and
+     * invariant, the body makes no calls with side effects, no input, output or jumps, every written
+     * array is indexed by both loop indices plus constants and always accessed with the same subscripts,
+     * or only updated by reductions such as c[0] += e, and scalars outside the body are only updated by
+     * statements that are a reduction such as s += e or s |= e, any other write refuses the swap. Legal
+     * swaps replace the nest through copies of the path down to it, so trees that share nodes with the
+     * program keep the original nest; the others are reported.
+     */
+    class AccessAnalysis {
+    public:
+        explicit AccessAnalysis(Diagnostics &diagnostics);
+
+        // also runs the loop bounds analysis, which folds constant loop bounds in place
+        void Run(Program &program);
+
+        const std::vector<NestReport> &Nests() const;
+
+    private:
+        // collects the interchanged nests and their paths from the program
+        void Walk(Node &node, AstPath &path);
+
+        // replacement for the slot of the outer loop, nullptr to keep it
+        std::shared_ptr<ForLoop> Examine(const std::shared_ptr<ForLoop> &outer);
+
+        Diagnostics &diagnostics;
+        std::vector<NestReport> nests;
+        std::vector<std::shared_ptr<ForLoop>> originals; // keeps reported nests alive after a replacement
+        std::vector<std::pair<AstPath, std::shared_ptr<Node>>> interchanges;
+    };
+
+}
+
+#endif //TONIC_ACCESS_H
@@ -0,0 +1,167 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Static time complexity estimate of functions and loop nests, with
+ * warnings where the operation count under the problem constraints exceeds
+ * the time budget
+ */
+
+#ifndef TONIC_COMPLEXITY_H
+#define TONIC_COMPLEXITY_H
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "analyzers/constraints.h"
+#include "analyzers/loop_bounds.h"
+#include "core/ast.h"
+#include "errors/diagnostics.h"
+
+namespace tonic {
+
+    // about 1e8 simple operations per second and a few seconds of time limit
+    constexpr double DEFAULT_OPERATION_BUDGET = 3e8;
+
+    /**
+     * Sum of terms coefficient * base^symbol * product of symbol^power * log(symbol)^exponent,
+     * for example 2 * n * m + n * log n. Symbols are variable names, the unknown symbol "?" stands
+     * for a count the analysis could not bound.
+     */
+    class Cost {
+    public:
+        // orders symbols by name so printed costs do not depend on interning order
+        struct ByText {
+            bool operator()(Atom first, Atom second) const {
+                return first.Text() < second.Text();
+            }
+        };
+
+        struct Term {
+            double coefficient = 1;
+            std::map<Atom, double, ByText> powers; // symbol to power, fractional for sqrt
+            std::map<Atom, int, ByText> logs;      // symbol to the power of its logarithm
+            double base = 1;               // base^exponential, 1 when the term is not exponential
+            Atom exponential;
+        };
+
+        static Cost Constant(double value);
+
+        static Cost Symbol(Atom name);
+
+        static Cost Log(Atom name);
+
+        static Cost Exponential(double base, Atom name);
+
+        Cost operator+(const Cost &other) const;
+
+        Cost operator*(const Cost &other) const;
+
+        Cost Scaled(double factor) const;
+
+        // the symbol raised to a power, terms are raised one by one, which bounds a sum from above
+        Cost Power(double power) const;
+
+        const std::vector<Term> &Terms() const;
+
+        // highest power of the symbol over all terms
+        double PowerOf(Atom name) const;
+
+        // the terms no other term dominates, for example "O(n·m + n·log n)", coefficients are dropped
+        std::string ToString() const;
+
+        // operation count with every symbol at its upper bound, nullopt if a symbol is unbounded
+        std::optional<double> Estimate(const Constraints &constraints) const;
+
+        // symbols that have no upper bound in the constraints, sorted by name
+        std::vector<Atom> Unbounded(const Constraints &constraints) const;
+
+    private:
+        void Add(const Term &term);
+
+        std::vector<Term> terms;
+    };
+
+    inline const Atom UNKNOWN_SYMBOL = "?"; // a count the analysis could not bound
+
+    // cost of a name in a size expression, for example the trip count of an enclosing loop index
+    using NameCost = std::function<Cost(Atom)>;
+
+    // symbolic value of a bound or size expression such as "n * m", "sqrt ( n )" or "v . size ( )"
+    Cost ExpressionCost(const std::string &expression, const NameCost &resolve);
+
+    struct ComplexityReport {
+        std::string name; // function name, "main" for top-level statements, "loop" for loop nests
+        const Node *node;
+        Cost cost;
+        std::optional<double> operations; // nullopt when a symbol has no upper bound
+    };
+
+    /**
+     * A statement costs one operation plus the cost of the functions it calls. A for loop multiplies
+     * its body by the trip count, taken from the loop bounds analysis or symbolically from its end,
+     * a ranged loop by the size of its object and a while loop by the variables of its condition,
+     * logarithmically when the loop halves or doubles them. Recursive functions are solved from the
+     * number of self calls and how they shrink their argument, n - 1 or n / 2, or multiply their
+     * body by the number of states when memoized.
+     */
+    class ComplexityAnalysis {
+    public:
+        ComplexityAnalysis(Diagnostics &diagnostics, Constraints constraints,
+                           double budget = DEFAULT_OPERATION_BUDGET);
+
+        // also runs the loop bounds analysis, which folds constant loop bounds in place
+        void Run(Program &program);
+
+        const std::vector<ComplexityReport> &Functions() const;
+
+        const std::vector<ComplexityReport> &LoopNests() const;
+
+    private:
+        struct Context {
+            std::vector<std::pair<Atom, Cost>> indices; // enclosing loop indices and their trip counts
+            size_t depth = 0;                            // loops opened in the current function
+            bool warned = false;                         // a loop nest of the function exceeded the budget
+        };
+
+        Cost NodeCost(const Node &node, Context &context);
+
+        Cost StatementCost(const std::string &statement);
+
+        Cost LoopCost(const Node &loop, const Cost &trips, const Node *body, Context &context);
+
+        Cost FunctionCost(const FunctionDeclaration &function);
+
+        Cost RecursionCost(const FunctionDeclaration &function, const Cost &body);
+
+        // ExpressionCost with enclosing loop indices and constants resolved
+        Cost ExpressionCost(const std::string &expression, const Context &context);
+
+        Cost WhileTrips(const WhileLoop &loop, const Context &context);
+
+        void Report(std::vector<ComplexityReport> &reports, std::string name, const Node &node, const Cost &cost,
+                    bool warn);
+
+        Diagnostics &diagnostics;
+        Constraints constraints;
+        double budget;
+
+        LoopBoundsAnalysis bounds;
+        std::unordered_map<Atom, const FunctionDeclaration *> functions;
+        std::unordered_map<const FunctionDeclaration *, Cost> function_costs;
+        std::unordered_set<const FunctionDeclaration *> in_progress;
+        const FunctionDeclaration *current = nullptr; // function whose body is being costed
+
+        std::vector<ComplexityReport> function_reports;
+        std::vector<ComplexityReport> loop_reports;
+    };
+
+}
+
+#endif //TONIC_COMPLEXITY_H
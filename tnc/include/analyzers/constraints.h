@@ -0,0 +1,41 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Problem constraints such as 1 <= n <= 2e5, read from
+ * "// constraints:" comments or command line flags and used by the analyzers
+ * to bound input sizes
+ */
+
+#ifndef TONIC_CONSTRAINTS_H
+#define TONIC_CONSTRAINTS_H
+
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "analyzers/interval.h"
+#include "core/tokens.h"
+
+namespace tonic {
+
+    // bounds by variable name, a bound given twice is intersected
+    using Constraints = std::unordered_map<Atom, Interval>;
+
+    /**
+     * Parses comma or semicolon separated chains such as "n<=2e5", "1 <= n, m <= 10^5" or
+     * "|s| <= 1e5", where the names before a chain share its bounds. Anything that is not
+     * a chain is skipped, so free text around the constraints does no harm.
+     */
+    void ParseConstraints(std::string_view text, Constraints &constraints);
+
+    // reads every comment whose text starts with "constraints:"
+    Constraints ConstraintsFromComments(const std::vector<Token> &tokens);
+
+    // upper bound of a name, nullopt when it is not constrained from above
+    std::optional<double> UpperBound(const Constraints &constraints, Atom name);
+
+}
+
+#endif //TONIC_CONSTRAINTS_H
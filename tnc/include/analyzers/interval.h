@@ -0,0 +1,131 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Interval arithmetic over the text of general statements, used by
+ * the range analysis to bound the values an integer expression can take
+ */
+
+#ifndef TONIC_INTERVAL_H
+#define TONIC_INTERVAL_H
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/interner.h"
+
+namespace tonic {
+
+    // closed interval, infinite bounds mean the value is not bounded on that side
+    struct Interval {
+        double low;
+        double high;
+
+        static Interval Empty();
+
+        static Interval Unbounded();
+
+        static Interval Point(double value);
+
+        static Interval Of(double low, double high);
+
+        bool IsEmpty() const;
+
+        bool IsBounded() const;
+
+        bool FitsInt32() const; // an empty interval fits
+
+        Interval Hull(const Interval &other) const;
+
+        bool operator==(const Interval &other) const;
+    };
+
+    Interval Int32Range();
+
+    Interval Int64Range();
+
+    // values a variable of the type can hold, nullopt for non-integer types such as string or auto
+    std::optional<Interval> TypeRange(Atom type);
+
+    enum class ValueKind {
+        INTEGER,
+        BOOLEAN, // comparisons, logical operators and true/false
+        OTHER,   // floating point, strings, calls, indexing, members, unknown variables
+    };
+
+    struct Evaluation {
+        Interval value = Interval::Unbounded();
+        ValueKind kind = ValueKind::OTHER;
+
+        // variables of an integer operation whose operands are all bounded but whose result
+        // leaves 32 bits, they overflow if they are declared int
+        std::vector<Atom> overflowing;
+
+        // every literal, variable and intermediate result was below 2^53 in magnitude, where a double
+        // holds each integer exactly, so a point value is the exact result of the expression
+        bool exact = false;
+    };
+
+    // range of an integer variable, nullopt when the name is not a known integer variable
+    using IntervalLookup = std::function<std::optional<Interval>(Atom name)>;
+
+    /**
+     * Supports integer and scientific literals such as 2e5, identifiers, parentheses, unary and
+     * binary arithmetic, shifts, bitwise, comparison and logical operators and the conditional
+     * operator. Calls, indexing and member accesses are OTHER, but their arguments are still
+     * checked for overflow. Text that does not parse evaluates to an unbounded OTHER.
+     */
+    Evaluation EvaluateInterval(std::string_view expression, const IntervalLookup &lookup);
+
+    // operator, literal and identifier tokens, two character operators split by a space are joined
+    std::vector<std::string> TokenizeExpression(std::string_view expression);
+
+    // identifiers the expression reads, member names after . and -> are left out
+    std::vector<Atom> ExpressionNames(std::string_view expression);
+
+    // whether the text is a single identifier or keyword
+    bool IsName(std::string_view text);
+
+    // whether tokens[i] names a member, after . or ->
+    bool IsMember(const std::vector<std::string> &tokens, size_t i);
+
+    // "=", the compound assignments and the increment and decrement operators
+    bool IsAssignmentOperator(std::string_view token);
+
+    // index just past the bracket group that opens at tokens[open]
+    size_t SkipGroup(const std::vector<std::string> &tokens, size_t open);
+
+    /**
+     * Library functions, casts and keywords before a parenthesis that read only their arguments and
+     * keep no state. Any other call may write a global or an argument it takes by reference, as a
+     * function declared in the program or rand may.
+     */
+    bool IsPureCall(std::string_view name);
+
+    /**
+     * Whether the statement may write the variable named at tokens[i]: it, or an element of it, is
+     * assigned, updated by a compound operator, incremented or decremented, or it is a whole argument
+     * of a call that is not pure, by itself or by its address, as in swap ( x , y ) and scanf ( "%d" , & x ).
+     */
+    bool IsWritten(const std::vector<std::string> &tokens, size_t i);
+
+    struct Assignment {
+        Atom target;
+        char operation;    // '=' for a plain assignment, else the first character of the compound operator
+        std::string value; // right hand side, "1" for increments and decrements
+    };
+
+    // the binary operator of a compound assignment, "<<" for the operation '<'
+    std::string BinaryOperator(const Assignment &assignment);
+
+    // splits "x = e", "x += e", "x <<= e" and "x ++" style statements, tolerating the spaces the parser
+    // puts between tokens
+    std::optional<Assignment> SplitAssignment(std::string_view statement);
+
+}
+
+#endif //TONIC_INTERVAL_H
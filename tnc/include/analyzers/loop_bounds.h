@@ -0,0 +1,73 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Constant folding and invariance of for loop bounds, so the C++
+ * generator can emit canonical loops with hoisted bounds and a known direction
+ */
+
+#ifndef TONIC_LOOP_BOUNDS_H
+#define TONIC_LOOP_BOUNDS_H
+
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/ast.h"
+
+namespace tonic {
+
+    /**
+     * Start, end and step that evaluate to an integer constant are replaced by the literal, where
+     * a constant is a literal expression or a variable assigned once with one. Every write counts
+     * as an assignment, compound ones and passing the variable to a call that is not pure included.
+     * Only values below 2^53 in magnitude are folded, where the evaluation is exact. Loops are
+     * half-open, ascending loops run while i < end and descending ones while i > end.
+     *
+     * End and step are invariant when no variable they read is assigned, incremented or read
+     * through in inside the body. When they call, index or access members, their variables may
+     * not appear in the body at all, since any use could change them. A body that calls a
+     * function not known to be pure, or runs raw C++, may change anything, so its bounds are
+     * never invariant; a member call counts as an assignment of its object.
+     *
+     * Folding rehashes the tree when it was hashed.
+     */
+    class LoopBoundsAnalysis {
+    public:
+        // fills trip_count, step_sign and bounds_invariant of every ForLoop under root
+        void Run(Node &root);
+
+        // value of a variable assigned exactly once with a constant, valid after Run
+        std::optional<int64_t> ConstantOf(Atom name);
+
+    private:
+        class Collector;
+
+        struct Definitions {
+            size_t count = 0;
+            std::string value; // initializer of the only definition, empty if it has none
+        };
+
+        struct LoopNames {
+            ForLoop *loop;
+            std::unordered_set<Atom> assigned;  // in the body
+            std::unordered_set<Atom> mentioned; // anywhere in the body
+            bool calls;                         // the body calls something that may write globals
+        };
+
+        // true when a bound was replaced by a literal
+        bool Fold(ForLoop &loop);
+
+        bool Invariant(const LoopNames &names, const std::shared_ptr<GeneralStatement> &bound) const;
+
+        std::unordered_map<Atom, Definitions> definitions;
+        std::unordered_map<Atom, std::optional<int64_t>> constants; // memoized ConstantOf
+        std::unordered_set<Atom> resolving;                         // guards against cyclic definitions
+        std::vector<LoopNames> loops;
+    };
+
+}
+
+#endif //TONIC_LOOP_BOUNDS_H
@@ -0,0 +1,109 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Finds pure recursive functions that recompute overlapping
+ * subproblems, and suggests or applies @memoize for them
+ */
+
+#ifndef TONIC_MEMOIZE_H
+#define TONIC_MEMOIZE_H
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "analyzers/constraints.h"
+#include "core/ast.h"
+#include "errors/diagnostics.h"
+
+namespace tonic {
+
+    // cells of the largest dense memo table, larger argument ranges are hashed
+    constexpr size_t MAX_DENSE_MEMO_CELLS = size_t(1) << 25;
+
+    enum class MemoizeMode {
+        SUGGEST, // warn and leave the function as written
+        APPLY,   // set is_memoize on functions that qualify
+    };
+
+    struct RecursionReport {
+        const FunctionDeclaration *function;
+        bool pure;
+        bool overlapping;
+        bool decreasing; // every recursive call lowers the arguments by constants, none of them raised
+        std::string reason;                // why the function is not pure, empty when it is
+        std::vector<std::string> calls;    // the recursive calls, for example "fib ( n - 1 )"
+    };
+
+    /**
+     * A function is pure when it returns a value, takes its arguments by value as scalars, strings,
+     * pairs or tuples, does no input or output, writes no global, reads no global that is written
+     * after its initialization and calls only pure functions, of the library only known ones.
+     * Subproblems overlap when two recursive calls repeat the same arguments, when they step the
+     * arguments by different constants as in f(n - 1) + f(n - 2) or ways(n - 1, k) + ways(n, k - 1),
+     * or when a recursive call inside a loop depends on the loop index.
+     */
+    class MemoizeAnalysis {
+    public:
+        explicit MemoizeAnalysis(Diagnostics &diagnostics, MemoizeMode mode = MemoizeMode::SUGGEST);
+
+        void Run(Program &program);
+
+        // every directly recursive function, in declaration order
+        const std::vector<RecursionReport> &Reports() const;
+
+    private:
+        class Collector;
+
+        struct Call {
+            std::vector<std::string> arguments;
+            std::vector<Atom> loop_indices; // indices of the loops around the call, inside the function
+        };
+
+        struct FunctionInfo {
+            FunctionDeclaration *function;
+            std::unordered_set<Atom> locals;     // parameters, typed declarations and loop indices
+            std::vector<std::pair<Atom, size_t>> writes; // names written and the line of the write
+            std::vector<Atom> callees;
+            std::vector<Call> self_calls;
+            std::vector<std::string> call_texts;
+            std::vector<Atom> reads;             // names read, including the ones also written
+            bool io = false;
+        };
+
+        // input, output or global writes of the function or its callees, empty when there are none
+        std::string SideEffect(const FunctionInfo &info, std::unordered_map<Atom, std::string> &verdicts);
+
+        // why the function cannot be memoized, empty when it is pure
+        std::string Impurity(const FunctionInfo &info, std::unordered_map<Atom, std::string> &verdicts);
+
+        static bool Overlapping(const FunctionInfo &info);
+
+        // a table filled in ascending order of the arguments holds every recursive call before it is made
+        static bool Decreasing(const FunctionInfo &info);
+
+        Diagnostics &diagnostics;
+        MemoizeMode mode;
+
+        std::unordered_set<Atom> globals;
+        std::unordered_set<Atom> rewritten; // globals written by functions, after the first call or in loops of main
+        std::vector<FunctionInfo> infos;
+        std::unordered_map<Atom, size_t> by_name;
+        std::vector<RecursionReport> reports;
+    };
+
+    /**
+     * Low bound and extent of each argument of the dense memo table of a @memoize function, nullopt
+     * when its table is hashed. A declared range narrows the range of the argument type, the return
+     * type has to be an integer or floating point type the table can copy as bytes.
+     */
+    std::optional<std::vector<std::pair<long long, long long>>> DenseMemoRanges(const FunctionDeclaration &function,
+                                                                               const Constraints *constraints);
+
+}
+
+#endif //TONIC_MEMOIZE_H
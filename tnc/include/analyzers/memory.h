@@ -0,0 +1,116 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Static estimate of the memory held by containers and memo tables,
+ * per scope and for the whole program, against the memory limit
+ */
+
+#ifndef TONIC_MEMORY_H
+#define TONIC_MEMORY_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "analyzers/complexity.h"
+
+namespace tonic {
+
+    constexpr double DEFAULT_MEMORY_LIMIT = 256.0 * 1024 * 1024; // bytes
+
+    // consumers listed in the report, largest first
+    constexpr size_t TOP_CONSUMERS = 5;
+
+    // a parsed type such as vector<pair<int, long long>>, the N of array<int, N> is an argument named "N"
+    struct TypeShape {
+        std::string name; // without std:: and const, for example "long long"
+        std::vector<TypeShape> arguments;
+    };
+
+    TypeShape ParseType(std::string_view type);
+
+    // bytes of the object itself, a vector is its 24 byte header
+    double InlineSize(const TypeShape &type);
+
+    // bytes a container allocates per element, including node and bucket overhead, 0 for non-containers
+    double ElementSize(const TypeShape &type);
+
+    struct Allocation {
+        Atom name;           // the variable, or the function of a memo table
+        const Node *node;
+        std::string scope;   // function name, "global" for top-level code
+        Cost bytes;
+        std::optional<double> estimate; // nullopt when a size has no upper bound
+    };
+
+    struct ScopeFootprint {
+        std::string name;
+        Cost bytes;
+        std::optional<double> estimate;
+    };
+
+    /**
+     * Sizes come from constructor arguments such as vector<int>(n + 1), list literals and list
+     * comprehension ranges, and grow by the trip count of the loops around push_back, insert or
+     * map [] statements. Memo tables are sized like the generated ones, a cell per argument tuple
+     * when the argument ranges make a dense table, else hash slots per state of the arguments. The
+     * locals of a function stay alive while the functions it calls run, so the peak is the global
+     * scope and the memo tables plus the deepest chain of locals along the calls. A function that
+     * calls itself holds its locals once per level, n levels when the self call passes n - 1 and
+     * log n when it passes n / 2, and mutual recursion has no known depth. When a size or a depth
+     * has no upper bound the peak is unknown, and the sizes that have one are still checked against
+     * the limit.
+     */
+    class MemoryAnalysis {
+    public:
+        MemoryAnalysis(Diagnostics &diagnostics, Constraints constraints, double limit = DEFAULT_MEMORY_LIMIT);
+
+        // also runs the loop bounds analysis, which folds constant loop bounds in place
+        void Run(Program &program);
+
+        // in declaration order
+        const std::vector<Allocation> &Allocations() const;
+
+        const std::vector<ScopeFootprint> &Scopes() const;
+
+        // nullopt when a size has no upper bound
+        std::optional<double> Peak() const;
+
+        // the peak counting only the allocations that have an upper bound, equal to Peak when all have one
+        double BoundedPeak() const;
+
+    private:
+        class Collector;
+
+        // locals alive while a function runs, with those of the functions it calls
+        struct Chain {
+            double bounded = 0; // bytes of the allocations with an upper bound
+            bool known = true;  // every size and recursion depth on the chain has an upper bound
+        };
+
+        // the deepest chain below the function, open holds the functions on the current path
+        Chain ChainOf(const std::string &function, std::unordered_set<std::string> &open);
+
+        Diagnostics &diagnostics;
+        Constraints constraints;
+        double limit;
+
+        LoopBoundsAnalysis bounds;
+        std::vector<Allocation> allocations;
+        std::vector<ScopeFootprint> scopes;
+        std::unordered_map<std::string, std::vector<std::string>> callees; // of every declared function
+        std::unordered_map<std::string, Cost> depths; // levels of the functions that call themselves
+        std::unordered_map<std::string, Chain> locals; // of each function, for one level of recursion
+        std::unordered_map<std::string, Chain> chains; // memoized ChainOf
+        std::optional<double> peak;
+        double bounded_peak = 0;
+    };
+
+}
+
+#endif //TONIC_MEMORY_H
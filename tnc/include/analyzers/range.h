@@ -0,0 +1,136 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Value range analysis choosing between int and long long for auto
+ * integer declarations and loop indices, 32-bit types halve the memory and
+ * double the vector width, so they are used wherever no overflow is possible
+ */
+
+#ifndef TONIC_RANGE_H
+#define TONIC_RANGE_H
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "analyzers/interval.h"
+#include "core/ast.h"
+#include "errors/diagnostics.h"
+
+namespace tonic {
+
+    struct RangeDecision {
+        Node *node; // VariableDeclaration or ForLoop whose auto type was replaced
+        Atom name;
+        Atom type;  // int or long long
+        Interval range;
+    };
+
+    /**
+     * Flow-insensitive: every variable gets one range covering all of its assignments, increments
+     * and reads through in, computed to a fixed point and widened when it keeps growing. Variables
+     * are tracked by name over the whole tree and loop indices per loop, merging same-named
+     * variables only widens their ranges. For ranges are half-open, so 0..n runs while i < n.
+     *
+     * Increments under a while loop, a ranged loop over an object of unknown size or a recursive
+     * function can run any number of times, so they leave the variable unbounded.
+     *
+     * A variable becomes int when its range fits in 32 bits and no arithmetic it takes part in
+     * can leave 32 bits while all of its operands are bounded, otherwise it stays long long. Only
+     * auto declarations initialized by integer expressions are changed, explicit types are kept.
+     */
+    class RangeAnalysis {
+    public:
+        explicit RangeAnalysis(Diagnostics &diagnostics);
+
+        // bounds of a variable known from the problem constraints, such as 1 <= n <= 2e5
+        void Assume(Atom name, Interval range);
+
+        // replaces the chosen types in the tree and reports one note per choice
+        void Run(Node &root);
+
+        const std::vector<RangeDecision> &Decisions() const;
+
+        // range of a variable that is not a loop index after Run, unbounded when it is unknown
+        Interval RangeOf(Atom name) const;
+
+    private:
+        class Collector;
+
+        enum class DefinitionKind {
+            ASSIGN,
+            INCREMENT, // += and -=, applied once per iteration of the enclosing loops
+            INPUT,
+            LOOP,
+            UNKNOWN, // a write the analysis cannot follow, such as a call that may take the variable by reference
+        };
+
+        struct Definition {
+            DefinitionKind kind;
+            size_t variable;
+            char operation;                   // '+' or '-' for increments
+            std::string value;                // right hand side of assignments and increments
+            const ForLoop *loop;              // the loop of a LOOP definition
+            std::vector<const ForLoop *> loops; // enclosing loops, outermost first
+            size_t line;
+            double repeats = 1; // runs of the enclosing while loops, ranged loops and recursive functions
+        };
+
+        struct Variable {
+            Atom name;
+            const ForLoop *loop = nullptr;    // set for loop indices
+            Interval range = Interval::Empty();
+            double trips = 0;                 // loop indices only, most iterations of the loop
+            std::optional<Interval> assumed;
+            std::optional<Interval> declared; // hull of the explicit integer types it was declared with
+            bool auto_declared = false;
+            bool other = false;               // non-integer or of unknown type somewhere
+            bool boolean = false;             // assigned a comparison or true/false, auto already picks bool
+            Node *declaration = nullptr;      // first auto declaration or auto loop, the one a decision changes
+            std::string overflow;             // first expression that needs 64 bits, empty if none
+            size_t overflow_line = 0;
+        };
+
+        // a statement that only needs its arithmetic checked for overflow
+        struct Use {
+            std::string text;
+            std::vector<const ForLoop *> loops;
+            size_t line;
+        };
+
+        size_t VariableFor(Atom name);
+
+        size_t VariableFor(const ForLoop &loop);
+
+        // the innermost loop index of that name, else the variable of the name
+        std::optional<size_t> Resolve(Atom name, const std::vector<const ForLoop *> &loops) const;
+
+        Evaluation Evaluate(const std::string &text, const std::vector<const ForLoop *> &loops) const;
+
+        void Solve();
+
+        // the range was replaced by an assumption or an explicit type instead of solved
+        static bool Pinned(const Variable &variable);
+
+        void CheckOverflow(const std::string &text, const std::vector<const ForLoop *> &loops, size_t line);
+
+        void Decide();
+
+        Diagnostics &diagnostics;
+
+        std::vector<Variable> variables;
+        std::unordered_map<Atom, size_t> by_name;
+        std::unordered_map<const ForLoop *, size_t> by_loop;
+        std::unordered_map<Atom, Interval> assumptions;
+
+        std::vector<Definition> definitions;
+        std::vector<Use> uses;
+        std::vector<RangeDecision> decisions;
+    };
+
+}
+
+#endif //TONIC_RANGE_H
@@ -13,6 +13,7 @@
 // operators
 // type table can have data type, and inference here would determine data type
 // long long by default instead of int for inference (auto can be handled manually eventually)
+// auto integers that provably fit are narrowed to int by the range analysis (analyzers/range.h)
 // vector initialization using [] that have different types = bad, for example [2, "test"]
 // different types for implicit unordered_map initialization using curly braces
 
@@ -9,13 +9,18 @@
 #ifndef TONIC_AST_H
 #define TONIC_AST_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
+#include <optional>
+
+#include "core/interner.h"
 
 namespace tonic {
 
     const std::string AUTO = "auto";
+    inline const Atom AUTO_ATOM = "auto"; // interned once instead of per node
 
     enum class DeclarationType {
         DECLARATION,
@@ -27,17 +32,56 @@ namespace tonic {
         OUT,
     };
 
+    enum class NodeKind {
+        PROGRAM,
+        GENERAL_STATEMENT,
+        CPP_NODE,
+        BLOCK,
+        VARIABLE_DECLARATION,
+        FUNCTION_DECLARATION,
+        FOR_LOOP,
+        RANGED_LOOP,
+        WHILE_LOOP,
+        INPUT_OUTPUT,
+        CLASS_DECLARATION,
+        STRUCT_DECLARATION,
+        NAMESPACE_DECLARATION,
+        TEMPLATE_DECLARATION,
+        LAMBDA_EXPRESSION,
+        ELSE_IF_STATEMENT,
+        IF_STATEMENT,
+        TRY_CATCH_STATEMENT,
+        SWITCH_CASE_STATEMENT,
+        PAIR_DESTRUCTURING,
+    };
+
+    const size_t NODE_KIND_COUNT = static_cast<size_t>(NodeKind::PAIR_DESTRUCTURING) + 1;
+
     struct Node {
+        const NodeKind kind; // dispatch tag, always the kind of the most derived node type
+        uint64_t hash = 0; // merkle content hash of the subtree, 0 until hashed (see core/hash.h)
+        size_t line = 0;   // source line the node starts on, 0 when unknown, not part of the hash
+
+        explicit Node(NodeKind kind) : kind(kind) {}
+
         virtual ~Node() = default;
     };
 
     struct Program : Node {
+        static constexpr NodeKind KIND = NodeKind::PROGRAM;
+
         std::vector<std::shared_ptr<Node>> body;
+
+        Program() : Node(KIND) {}
     };
 
     struct GeneralStatement : Node {
+        static constexpr NodeKind KIND = NodeKind::GENERAL_STATEMENT;
+
         std::string statement;
 
+        GeneralStatement() : Node(KIND) {}
+
         void RemoveLast() {
             if (!statement.empty()) {
                 statement.pop_back();
@@ -46,37 +90,49 @@ namespace tonic {
     };
 
     struct CppNode : Node {
+        static constexpr NodeKind KIND = NodeKind::CPP_NODE;
+
         std::shared_ptr<GeneralStatement> cpp_code;
 
-        CppNode() : cpp_code(nullptr) {}
+        CppNode() : Node(KIND), cpp_code(nullptr) {}
     };
 
     struct Block : Node {
+        static constexpr NodeKind KIND = NodeKind::BLOCK;
+
         std::vector<std::shared_ptr<Node>> body;
+
+        Block() : Node(KIND) {}
     };
 
     struct VariableDeclaration : Node {
-        std::string data_type;
+        static constexpr NodeKind KIND = NodeKind::VARIABLE_DECLARATION;
+
+        Atom data_type;
         DeclarationType declaration_type;
         std::shared_ptr<GeneralStatement> identifier;
         std::shared_ptr<Node> initializer;
 
-        VariableDeclaration() : data_type(AUTO), declaration_type(DeclarationType::DECLARATION), identifier(nullptr),
-                                initializer(nullptr) {}
+        VariableDeclaration() : Node(KIND), data_type(AUTO_ATOM), declaration_type(DeclarationType::DECLARATION),
+                                identifier(nullptr), initializer(nullptr) {}
     };
 
     struct FunctionDeclaration : Node {
+        static constexpr NodeKind KIND = NodeKind::FUNCTION_DECLARATION;
+
         bool is_memoize;
         std::shared_ptr<GeneralStatement> type;
         std::shared_ptr<GeneralStatement> name;
-        std::vector<std::pair<std::string, std::string>> arguments; // identifier, type
+        std::vector<std::pair<Atom, Atom>> arguments; // identifier, type
         std::shared_ptr<Block> block;
 
-        FunctionDeclaration() : is_memoize(false), type(nullptr), name(nullptr), block(nullptr) {}
+        FunctionDeclaration() : Node(KIND), is_memoize(false), type(nullptr), name(nullptr), block(nullptr) {}
     };
 
     struct ForLoop : Node {
-        std::string id_type;
+        static constexpr NodeKind KIND = NodeKind::FOR_LOOP;
+
+        Atom id_type;
         std::shared_ptr<GeneralStatement> identifier;
         std::shared_ptr<GeneralStatement> start;
         std::shared_ptr<GeneralStatement> end;
@@ -84,108 +140,141 @@ namespace tonic {
         std::shared_ptr<GeneralStatement> operation; // for list comprehension
         std::shared_ptr<Block> block;
 
-        ForLoop() : id_type(AUTO), identifier(nullptr), start(nullptr), end(nullptr), step(nullptr), operation(nullptr) {}
+        // filled by the loop bounds analysis (see analyzers/loop_bounds.h), not part of the hash
+        std::optional<uint64_t> trip_count; // known when start, end and step are constant
+        int step_sign;                      // 1 ascending, -1 descending, 0 unknown
+        bool bounds_invariant;              // end and step can be evaluated once before the loop
+
+        ForLoop() : Node(KIND), id_type(AUTO_ATOM), identifier(nullptr), start(nullptr), end(nullptr), step(nullptr),
+                    operation(nullptr), step_sign(0), bounds_invariant(false) {}
     };
 
     struct RangedLoop : Node {
-        std::string id_type;
+        static constexpr NodeKind KIND = NodeKind::RANGED_LOOP;
+
+        Atom id_type;
         std::shared_ptr<GeneralStatement> identifier;
         std::shared_ptr<GeneralStatement> object;
         std::shared_ptr<GeneralStatement> operation; // for list comprehension
         std::shared_ptr<Block> block;
 
-        RangedLoop() : id_type(AUTO), identifier(nullptr), object(nullptr), operation(nullptr), block(nullptr) {}
+        RangedLoop() : Node(KIND), id_type(AUTO_ATOM), identifier(nullptr), object(nullptr), operation(nullptr),
+                       block(nullptr) {}
     };
 
     struct WhileLoop : Node {
+        static constexpr NodeKind KIND = NodeKind::WHILE_LOOP;
+
         std::shared_ptr<GeneralStatement> condition;
         std::shared_ptr<Block> block;
 
-        WhileLoop() : condition(nullptr), block(nullptr) {}
+        WhileLoop() : Node(KIND), condition(nullptr), block(nullptr) {}
     };
 
     struct InputOutput : Node { // array-like input is in the form of a statement
+        static constexpr NodeKind KIND = NodeKind::INPUT_OUTPUT;
+
         InOut type;
         std::vector<std::shared_ptr<GeneralStatement>> operands;
 
-        InputOutput() : type(InOut::IN) {}
+        InputOutput() : Node(KIND), type(InOut::IN) {}
     };
 
     struct ClassDeclaration : Node {
+        static constexpr NodeKind KIND = NodeKind::CLASS_DECLARATION;
+
         std::shared_ptr<GeneralStatement> declaration;
         std::shared_ptr<Block> block;
 
-        ClassDeclaration() : declaration(nullptr), block(nullptr) {}
+        ClassDeclaration() : Node(KIND), declaration(nullptr), block(nullptr) {}
     };
 
     struct StructDeclaration : Node {
+        static constexpr NodeKind KIND = NodeKind::STRUCT_DECLARATION;
+
         std::shared_ptr<GeneralStatement> declaration;
         std::shared_ptr<Block> block;
 
-        StructDeclaration() : declaration(nullptr), block(nullptr) {}
+        StructDeclaration() : Node(KIND), declaration(nullptr), block(nullptr) {}
     };
 
     struct NamespaceDeclaration : Node {
+        static constexpr NodeKind KIND = NodeKind::NAMESPACE_DECLARATION;
+
         std::shared_ptr<GeneralStatement> namespace_name;
         std::shared_ptr<Block> block;
 
-        NamespaceDeclaration() : namespace_name(nullptr), block(nullptr) {}
+        NamespaceDeclaration() : Node(KIND), namespace_name(nullptr), block(nullptr) {}
     };
 
     struct TemplateDeclaration : Node {
+        static constexpr NodeKind KIND = NodeKind::TEMPLATE_DECLARATION;
+
         std::shared_ptr<GeneralStatement> template_statement;
-        std::vector<std::pair<std::string, std::string>> arguments;
+        std::vector<std::pair<Atom, Atom>> arguments;
         std::shared_ptr<Node> content; // could be a function, class, or struct
 
-        TemplateDeclaration() : template_statement(nullptr), content(nullptr) {}
+        TemplateDeclaration() : Node(KIND), template_statement(nullptr), content(nullptr) {}
     };
 
     struct LambdaExpression : Node {
-        std::vector<std::pair<std::string, std::string>> arguments;
+        static constexpr NodeKind KIND = NodeKind::LAMBDA_EXPRESSION;
+
+        std::vector<std::pair<Atom, Atom>> arguments;
         std::shared_ptr<GeneralStatement> capture_clause;
         std::shared_ptr<Node> body; // could be an expression or a block
 
-        LambdaExpression() : capture_clause(nullptr), body(nullptr) {}
+        LambdaExpression() : Node(KIND), capture_clause(nullptr), body(nullptr) {}
     };
 
     struct ElseIfStatement : Node {
+        static constexpr NodeKind KIND = NodeKind::ELSE_IF_STATEMENT;
+
         std::shared_ptr<GeneralStatement> condition;
         std::shared_ptr<Block> block;
 
-        ElseIfStatement() : condition(nullptr), block(nullptr) {}
+        ElseIfStatement() : Node(KIND), condition(nullptr), block(nullptr) {}
     };
 
     struct IfStatement : Node {
+        static constexpr NodeKind KIND = NodeKind::IF_STATEMENT;
+
         std::shared_ptr<GeneralStatement> condition;
         std::shared_ptr<Block> true_block;
         std::vector<std::shared_ptr<ElseIfStatement>> else_if_statements; // nullptr if there is no else if
         std::shared_ptr<Block> else_block; // nullptr if there is no else
 
-        IfStatement() : condition(nullptr), true_block(nullptr), else_block(nullptr) {}
+        IfStatement() : Node(KIND), condition(nullptr), true_block(nullptr), else_block(nullptr) {}
     };
 
     struct TryCatchStatement : Node {
+        static constexpr NodeKind KIND = NodeKind::TRY_CATCH_STATEMENT;
+
         std::shared_ptr<Block> try_block;
-        std::vector<std::pair<std::string, std::string>> catch_arguments;
+        std::vector<std::pair<Atom, Atom>> catch_arguments;
         std::shared_ptr<Block> catch_block;
 
-        TryCatchStatement() : try_block(nullptr), catch_block(nullptr) {}
+        TryCatchStatement() : Node(KIND), try_block(nullptr), catch_block(nullptr) {}
     };
 
     struct SwitchCaseStatement : Node {
+        static constexpr NodeKind KIND = NodeKind::SWITCH_CASE_STATEMENT;
+
         std::shared_ptr<GeneralStatement> condition;
         std::vector<std::pair<std::shared_ptr<GeneralStatement>, std::shared_ptr<Block>>> cases;
         std::shared_ptr<Block> default_case; // nullptr if there is no default case
 
-        SwitchCaseStatement() : condition(nullptr), default_case(nullptr) {}
+        SwitchCaseStatement() : Node(KIND), condition(nullptr), default_case(nullptr) {}
     };
 
     struct PairDestructuring : Node {
-        std::string first_var;
-        std::string second_var;
+        static constexpr NodeKind KIND = NodeKind::PAIR_DESTRUCTURING;
+
+        Atom first_var;
+        Atom second_var;
         std::shared_ptr<GeneralStatement> initializer;
 
-        PairDestructuring() : initializer(nullptr) {}
+        PairDestructuring() : Node(KIND), initializer(nullptr) {}
     };
 
 }
@@ -0,0 +1,166 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Uniform, index-based access to the child slots of AST nodes
+ */
+
+#ifndef TONIC_CHILDREN_H
+#define TONIC_CHILDREN_H
+
+#include <memory>
+#include <type_traits>
+
+#include "core/ast.h"
+
+namespace tonic {
+
+    template<typename T, typename NodeT>
+    using MatchConst = std::conditional_t<std::is_const_v<NodeT>, const T, T>;
+
+    // casts to the concrete node type selected by the kind tag
+    template<typename T, typename NodeT>
+    MatchConst<T, NodeT> &NodeAs(NodeT &node) {
+        return static_cast<MatchConst<T, NodeT> &>(node);
+    }
+
+    // calls visit(slot) for every child slot of a node of statically known
+    // type in walking order, slots are typed shared pointers and may be nullptr
+    template<typename T, typename F>
+    void ForEachTypedChildSlot(T &node, F &&visit) {
+        using Type = std::remove_const_t<T>;
+
+        if constexpr (std::is_same_v<Type, Program> || std::is_same_v<Type, Block>) {
+            for (auto &child: node.body)
+                visit(child);
+        } else if constexpr (std::is_same_v<Type, CppNode>) {
+            visit(node.cpp_code);
+        } else if constexpr (std::is_same_v<Type, VariableDeclaration>) {
+            visit(node.identifier);
+            visit(node.initializer);
+        } else if constexpr (std::is_same_v<Type, FunctionDeclaration>) {
+            visit(node.type);
+            visit(node.name);
+            visit(node.block);
+        } else if constexpr (std::is_same_v<Type, ForLoop>) {
+            visit(node.identifier);
+            visit(node.start);
+            visit(node.end);
+            visit(node.step);
+            visit(node.operation);
+            visit(node.block);
+        } else if constexpr (std::is_same_v<Type, RangedLoop>) {
+            visit(node.identifier);
+            visit(node.object);
+            visit(node.operation);
+            visit(node.block);
+        } else if constexpr (std::is_same_v<Type, WhileLoop> || std::is_same_v<Type, ElseIfStatement>) {
+            visit(node.condition);
+            visit(node.block);
+        } else if constexpr (std::is_same_v<Type, InputOutput>) {
+            for (auto &operand: node.operands)
+                visit(operand);
+        } else if constexpr (std::is_same_v<Type, ClassDeclaration> || std::is_same_v<Type, StructDeclaration>) {
+            visit(node.declaration);
+            visit(node.block);
+        } else if constexpr (std::is_same_v<Type, NamespaceDeclaration>) {
+            visit(node.namespace_name);
+            visit(node.block);
+        } else if constexpr (std::is_same_v<Type, TemplateDeclaration>) {
+            visit(node.template_statement);
+            visit(node.content);
+        } else if constexpr (std::is_same_v<Type, LambdaExpression>) {
+            visit(node.capture_clause);
+            visit(node.body);
+        } else if constexpr (std::is_same_v<Type, IfStatement>) {
+            visit(node.condition);
+            visit(node.true_block);
+            for (auto &else_if_statement: node.else_if_statements)
+                visit(else_if_statement);
+            visit(node.else_block);
+        } else if constexpr (std::is_same_v<Type, TryCatchStatement>) {
+            visit(node.try_block);
+            visit(node.catch_block);
+        } else if constexpr (std::is_same_v<Type, SwitchCaseStatement>) {
+            visit(node.condition);
+            for (auto &case_pair: node.cases) {
+                visit(case_pair.first);
+                visit(case_pair.second);
+            }
+            visit(node.default_case);
+        } else if constexpr (std::is_same_v<Type, PairDestructuring>) {
+            visit(node.initializer);
+        }
+    }
+
+    // calls f(concrete_node) with the node cast to the type selected by its kind tag
+    template<typename NodeT, typename F>
+    decltype(auto) DispatchNode(NodeT &node, F &&f) {
+        switch (node.kind) {
+            case NodeKind::PROGRAM:
+                return f(NodeAs<Program>(node));
+            case NodeKind::GENERAL_STATEMENT:
+                return f(NodeAs<GeneralStatement>(node));
+            case NodeKind::CPP_NODE:
+                return f(NodeAs<CppNode>(node));
+            case NodeKind::BLOCK:
+                return f(NodeAs<Block>(node));
+            case NodeKind::VARIABLE_DECLARATION:
+                return f(NodeAs<VariableDeclaration>(node));
+            case NodeKind::FUNCTION_DECLARATION:
+                return f(NodeAs<FunctionDeclaration>(node));
+            case NodeKind::FOR_LOOP:
+                return f(NodeAs<ForLoop>(node));
+            case NodeKind::RANGED_LOOP:
+                return f(NodeAs<RangedLoop>(node));
+            case NodeKind::WHILE_LOOP:
+                return f(NodeAs<WhileLoop>(node));
+            case NodeKind::INPUT_OUTPUT:
+                return f(NodeAs<InputOutput>(node));
+            case NodeKind::CLASS_DECLARATION:
+                return f(NodeAs<ClassDeclaration>(node));
+            case NodeKind::STRUCT_DECLARATION:
+                return f(NodeAs<StructDeclaration>(node));
+            case NodeKind::NAMESPACE_DECLARATION:
+                return f(NodeAs<NamespaceDeclaration>(node));
+            case NodeKind::TEMPLATE_DECLARATION:
+                return f(NodeAs<TemplateDeclaration>(node));
+            case NodeKind::LAMBDA_EXPRESSION:
+                return f(NodeAs<LambdaExpression>(node));
+            case NodeKind::ELSE_IF_STATEMENT:
+                return f(NodeAs<ElseIfStatement>(node));
+            case NodeKind::IF_STATEMENT:
+                return f(NodeAs<IfStatement>(node));
+            case NodeKind::TRY_CATCH_STATEMENT:
+                return f(NodeAs<TryCatchStatement>(node));
+            case NodeKind::SWITCH_CASE_STATEMENT:
+                return f(NodeAs<SwitchCaseStatement>(node));
+            case NodeKind::PAIR_DESTRUCTURING:
+            default:
+                return f(NodeAs<PairDestructuring>(node));
+        }
+    }
+
+    // same as ForEachTypedChildSlot, with the node type selected at runtime
+    template<typename NodeT, typename F>
+    void ForEachChildSlot(NodeT &node, F &&visit) {
+        DispatchNode(node, [&](auto &concrete) {
+            ForEachTypedChildSlot(concrete, visit);
+        });
+    }
+
+    // number of child slots, including empty (nullptr) ones
+    size_t ChildCount(const Node &node);
+
+    std::shared_ptr<Node> GetChild(const Node &node, size_t index);
+
+    // throws an InternalError if the child does not fit the slot type
+    void SetChild(Node &node, size_t index, const std::shared_ptr<Node> &child);
+
+    // copies the node itself, children are shared with the original
+    std::shared_ptr<Node> ShallowCopy(const Node &node);
+
+}
+
+#endif //TONIC_CHILDREN_H
@@ -0,0 +1,89 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Read-mostly symbol table for global names shared by parallel
+ * analyses, lookups read immutable per-shard snapshots without locking and
+ * inserts are batched into new snapshots at phase boundaries
+ */
+
+#ifndef TONIC_CONCURRENT_SYMBOL_TABLE_H
+#define TONIC_CONCURRENT_SYMBOL_TABLE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "core/symbol_table.h"
+
+namespace tonic {
+
+    /**
+     * Insert may be called from any thread, Publish and Reclaim from one thread
+     * between phases. Find is lock-free and may run concurrently with Insert
+     * and Publish; a returned pointer stays valid until the next Reclaim.
+     */
+    class ConcurrentSymbolTable {
+    public:
+        ConcurrentSymbolTable();
+
+        ~ConcurrentSymbolTable();
+
+        ConcurrentSymbolTable(const ConcurrentSymbolTable &) = delete;
+
+        ConcurrentSymbolTable &operator=(const ConcurrentSymbolTable &) = delete;
+
+        // staged until the next Publish, a later insert of the same name wins
+        void Insert(Atom name, Atom type);
+
+        // makes every staged insert visible to readers
+        void Publish();
+
+        // frees the snapshots replaced by Publish, no reader may be running
+        void Reclaim();
+
+        const SymbolInfo *Find(Atom name) const;
+
+        const SymbolInfo &LookupSymbol(Atom name) const;
+
+        bool SymbolExists(Atom name) const;
+
+        // published symbols ordered by name text, independent of interning order and thread count
+        std::vector<SymbolInfo> Entries() const;
+
+        size_t Size() const;
+
+    private:
+        static constexpr size_t SHARD_BITS = 4;
+
+        // immutable once published
+        struct Snapshot {
+            std::vector<uint32_t> keys; // atom ids, NO_ATOM marks an empty slot
+            std::vector<SymbolInfo> symbols;
+            uint32_t shift;             // for Fibonacci hashing over keys.size()
+            size_t size;
+
+            const SymbolInfo *Find(uint32_t name) const;
+        };
+
+        // on its own cache line so readers of different shards do not share one
+        struct alignas(64) Shard {
+            std::atomic<const Snapshot *> current;
+        };
+
+        static const Snapshot *Build(const Snapshot *previous, const std::vector<SymbolInfo> &staged);
+
+        std::array<Shard, size_t(1) << SHARD_BITS> shards;
+
+        std::mutex staging_mutex;
+        std::vector<SymbolInfo> staged;
+
+        std::vector<const Snapshot *> retired;
+    };
+
+}
+
+#endif //TONIC_CONCURRENT_SYMBOL_TABLE_H
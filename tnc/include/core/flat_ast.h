@@ -0,0 +1,66 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Compact, index-based AST representation. Nodes are stored in one
+ * contiguous array in pre-order, so a full traversal is a linear scan and
+ * skipping a subtree is a single addition
+ */
+
+#ifndef TONIC_FLAT_AST_H
+#define TONIC_FLAT_AST_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/ast.h"
+
+namespace tonic {
+
+    const uint32_t FLAT_NONE = UINT32_MAX;
+
+    struct FlatNode {
+        NodeKind kind;
+        uint32_t parent;
+        uint32_t first_child;   // FLAT_NONE for leaves, otherwise always index + 1
+        uint32_t next_sibling;  // FLAT_NONE for the last child
+        uint32_t subtree_size;  // including the node itself
+    };
+
+    class FlatAst {
+    public:
+        // empty child slots are not stored
+        explicit FlatAst(const std::shared_ptr<Node> &root);
+
+        size_t Size() const {
+            return nodes.size();
+        }
+
+        const FlatNode &operator[](uint32_t index) const {
+            return nodes[index];
+        }
+
+        const std::vector<FlatNode> &Nodes() const {
+            return nodes;
+        }
+
+        // the tree node the flat node was built from, for access to node fields
+        const std::shared_ptr<Node> &Source(uint32_t index) const {
+            return sources[index];
+        }
+
+        // index of the next node in pre-order that is not inside the subtree
+        uint32_t SkipSubtree(uint32_t index) const {
+            return index + nodes[index].subtree_size;
+        }
+
+    private:
+        std::vector<FlatNode> nodes;
+        std::vector<std::shared_ptr<Node>> sources;
+    };
+
+}
+
+#endif //TONIC_FLAT_AST_H
@@ -0,0 +1,35 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Merkle content hashes for AST subtrees
+ */
+
+#ifndef TONIC_HASH_H
+#define TONIC_HASH_H
+
+#include <cstdint>
+#include <string_view>
+
+#include "core/ast.h"
+
+namespace tonic {
+
+    uint64_t HashBytes(std::string_view bytes);
+
+    uint64_t HashCombine(uint64_t seed, uint64_t value);
+
+    // hashes the node from its kind, its own fields and the stored hashes of
+    // its children, the result is stored in node.hash and returned
+    uint64_t RehashNode(Node &node);
+
+    // hashes the whole subtree bottom-up
+    uint64_t HashTree(Node &node);
+
+    // both nodes must be hashed, equal hashes are treated as equal subtrees
+    bool StructurallyEqual(const Node &first, const Node &second);
+
+}
+
+#endif //TONIC_HASH_H
@@ -0,0 +1,140 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Thread-safe string interner and the Atom handle for identifiers,
+ * type names and keywords, so equal names compare and hash as integers
+ */
+
+#ifndef TONIC_INTERNER_H
+#define TONIC_INTERNER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace tonic {
+
+    constexpr uint32_t NO_ATOM = UINT32_MAX;
+
+    // 2^32 divided by the golden ratio, spreads consecutive atoms over the table
+    constexpr uint32_t FIBONACCI_MULTIPLIER = 2654435769u;
+
+    // home slot of an atom id in an open addressing table of 2^(32 - shift) slots
+    constexpr size_t AtomSlot(uint32_t id, uint32_t shift) {
+        return static_cast<uint32_t>(id * FIBONACCI_MULTIPLIER) >> shift;
+    }
+
+    /**
+     * Ids are handed out densely from 0, which is always the empty string.
+     * Interning takes a lock, reading the text or hash of an id does not.
+     */
+    class Interner {
+    public:
+        Interner();
+
+        ~Interner();
+
+        Interner(const Interner &) = delete;
+
+        Interner &operator=(const Interner &) = delete;
+
+        // the interner behind every Atom
+        static Interner &Global();
+
+        uint32_t Intern(std::string_view text);
+
+        // NO_ATOM when the string was never interned
+        uint32_t Find(std::string_view text) const;
+
+        const std::string &Text(uint32_t id) const;
+
+        // HashBytes of the text, computed once when the string is interned
+        uint64_t Hash(uint32_t id) const;
+
+        size_t Size() const;
+
+    private:
+        struct Entry {
+            std::string text;
+            uint64_t hash;
+        };
+
+        // chunk k holds 2^(FIRST_CHUNK_BITS + k) entries and never moves once allocated
+        static constexpr uint32_t FIRST_CHUNK_BITS = 10;
+        static constexpr uint32_t CHUNK_COUNT = 23;
+
+        const Entry &At(uint32_t id) const;
+
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string_view, uint32_t> ids; // views into the entries
+        std::array<std::atomic<Entry *>, CHUNK_COUNT> chunks;
+        std::atomic<uint32_t> size;
+    };
+
+    // handle to a string in the global interner, the default atom is the empty string
+    class Atom {
+    public:
+        constexpr Atom() : id(0) {}
+
+        Atom(std::string_view text) : id(Interner::Global().Intern(text)) {}
+
+        Atom(const std::string &text) : Atom(std::string_view(text)) {}
+
+        Atom(const char *text) : Atom(std::string_view(text)) {}
+
+        uint32_t Id() const {
+            return id;
+        }
+
+        const std::string &Text() const {
+            return Interner::Global().Text(id);
+        }
+
+        uint64_t Hash() const {
+            return Interner::Global().Hash(id);
+        }
+
+        bool Empty() const {
+            return id == 0;
+        }
+
+        bool operator==(const Atom &other) const = default;
+
+        bool operator==(std::string_view text) const {
+            return Text() == text;
+        }
+
+        bool operator==(const std::string &text) const {
+            return Text() == text;
+        }
+
+        bool operator==(const char *text) const {
+            return Text() == text;
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, const Atom &atom) {
+            return os << atom.Text();
+        }
+
+    private:
+        uint32_t id;
+    };
+
+}
+
+template<>
+struct std::hash<tonic::Atom> {
+    size_t operator()(const tonic::Atom &atom) const noexcept {
+        return atom.Id();
+    }
+};
+
+#endif //TONIC_INTERNER_H
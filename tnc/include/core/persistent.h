@@ -0,0 +1,62 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Immutable AST mode. Updates copy only the spine from the root
+ * to the changed node, every other subtree is shared between versions
+ */
+
+#ifndef TONIC_PERSISTENT_H
+#define TONIC_PERSISTENT_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "core/ast.h"
+
+namespace tonic {
+
+    // child slot indices from the root down to a node, see core/children.h
+    using AstPath = std::vector<size_t>;
+
+    // both return a new root, the input tree is never modified so these
+    // are safe to call concurrently on a shared version
+    std::shared_ptr<Node> PathCopy(const std::shared_ptr<Node> &root, const AstPath &path,
+                                   const std::shared_ptr<Node> &replacement);
+
+    std::shared_ptr<Node> PathModify(const std::shared_ptr<Node> &root, const AstPath &path,
+                                     const std::function<void(Node &)> &edit);
+
+    // false if the target is not reachable from the root
+    bool FindPath(const std::shared_ptr<Node> &root, const Node *target, AstPath &path);
+
+    class PersistentAst {
+    public:
+        explicit PersistentAst(std::shared_ptr<Program> root);
+
+        // nodes reachable from a version are frozen, edit through Replace and Modify
+        std::shared_ptr<const Program> Root() const;
+
+        std::shared_ptr<const Program> Root(size_t version) const;
+
+        size_t Version() const;
+
+        size_t Replace(const AstPath &path, const std::shared_ptr<Node> &replacement);
+
+        // the edit receives a private copy of the node at the path
+        size_t Modify(const AstPath &path, const std::function<void(Node &)> &edit);
+
+        // drops every version after the given one
+        void Rollback(size_t version);
+
+    private:
+        size_t Commit(const std::shared_ptr<Node> &root);
+
+        std::vector<std::shared_ptr<Program>> versions;
+    };
+
+}
+
+#endif //TONIC_PERSISTENT_H
@@ -3,35 +3,93 @@
  * Please find the license in the repository .LICENSE file here:
  * https://github.com/tonic-lang/tonic/blob/main/LICENSE
  *
- * @brief Symbol table for analyzers
+ * @brief Scoped symbol table for analyzers, an open-addressing hash keyed by
+ * interned names points at the innermost binding of each name, and an undo
+ * log restores shadowed bindings when a scope is popped
  */
 
 #ifndef TONIC_TABLE_H
 #define TONIC_TABLE_H
 
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <vector>
+
+#include "core/interner.h"
 
 namespace tonic {
     struct SymbolInfo {
-        std::string name;
-        std::string type;
+        Atom name;
+        Atom type;
+        uint32_t depth; // scope depth of the declaration, 0 is the global scope
 
-        SymbolInfo(std::string name, std::string type) : name(name), type(type) {}
+        SymbolInfo(Atom name, Atom type, uint32_t depth = 0) : name(name), type(type), depth(depth) {}
     };
 
     class SymbolTable {
     public:
-        void Insert(const std::string &name, const SymbolInfo &info);
+        SymbolTable();
+
+        void PushScope();
+
+        // O(number of declarations and removals made in the scope)
+        void PopScope();
+
+        size_t Depth() const;
 
-        SymbolInfo &LookupSymbol(const std::string &name);
+        // declares the name in the current scope, shadowing outer declarations. Strings convert
+        // to atoms implicitly. References to SymbolInfo are invalidated by Insert and PopScope
+        SymbolInfo &Insert(Atom name, Atom type);
 
-        bool SymbolExists(const std::string &name) const;
+        // innermost visible declaration, nullptr if there is none
+        SymbolInfo *Find(Atom name);
 
-        void RemoveSymbol(const std::string &name);
+        const SymbolInfo *Find(Atom name) const;
+
+        SymbolInfo &LookupSymbol(Atom name);
+
+        bool SymbolExists(Atom name) const;
+
+        // unshadows the outer declaration, a removal made inside a scope is undone when it is popped
+        void RemoveSymbol(Atom name);
 
     private:
-        std::unordered_map<std::string, SymbolInfo> table;
+        static constexpr uint32_t NO_BINDING = UINT32_MAX;
+
+        struct Slot {
+            uint32_t name;    // atom id
+            uint32_t binding; // innermost binding, NO_BINDING once all of them went out of scope
+        };
+
+        struct Binding {
+            SymbolInfo info;
+            uint32_t shadowed; // binding of the same name this one hides
+        };
+
+        struct UndoEntry {
+            uint32_t name;
+            uint32_t binding; // value of the slot before the change
+        };
+
+        struct ScopeMark {
+            size_t undo_size;
+            size_t binding_count;
+        };
+
+        // index of the slot holding the name, or of the empty slot where it would go
+        size_t Probe(uint32_t name) const;
+
+        Slot &SlotFor(uint32_t name);
+
+        void Grow();
+
+        std::vector<Slot> slots; // power of two sized, names are never removed
+        size_t used_slots;
+        uint32_t shift;          // 32 - log2(slots.size()), for Fibonacci hashing
+
+        std::vector<Binding> bindings;
+        std::vector<UndoEntry> undo_log;
+        std::vector<ScopeMark> scopes;
     };
 }
 
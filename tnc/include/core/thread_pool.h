@@ -0,0 +1,80 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Work-stealing thread pool, every worker owns a task deque and
+ * takes from its back while idle workers steal from the front of others
+ */
+
+#ifndef TONIC_THREAD_POOL_H
+#define TONIC_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tonic {
+
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+
+        // 0 picks the hardware concurrency
+        explicit ThreadPool(size_t threads = 0);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // tasks submitted from a worker go to that worker's own deque
+        void Submit(Task task);
+
+        // blocks until every submitted task, including ones submitted by tasks, has
+        // finished; the calling thread runs tasks while it waits. The first exception
+        // thrown by a task is rethrown here
+        void Wait();
+
+        size_t Size() const;
+
+        // number of tasks taken from another worker's deque since construction
+        size_t Steals() const;
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        bool TryRun(size_t self);
+
+        void WorkerLoop(size_t index);
+
+        // one deque per worker plus a last one for threads outside the pool
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> workers;
+
+        std::atomic<size_t> queued;  // tasks sitting in a deque
+        std::atomic<size_t> pending; // tasks submitted and not yet finished
+        std::atomic<size_t> steals;
+
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        bool stopping;
+
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+}
+
+#endif //TONIC_THREAD_POOL_H
@@ -10,6 +10,9 @@
 #define TONIC_TOKENS_H
 
 #include <string>
+#include <string_view>
+
+#include "core/interner.h"
 
 namespace tonic {
     const std::string CPP_TAG = "#cpp";
@@ -117,17 +120,34 @@ namespace tonic {
         EOF_TOKEN,
     };
 
+    // identifiers, keywords and types, the tokens that carry an interned atom
+    inline bool IsNamedToken(TokenType type) {
+        return type == TokenType::IDENTIFIER || type == TokenType::TYPE ||
+               (type >= TokenType::IF && type <= TokenType::STEP);
+    }
+
+    /**
+     * Named tokens keep only their interned atom. The text of the other tokens is a view into the
+     * source of the Lexer that produced them, or into one of the constant strings above, so a token
+     * must not outlive its lexer.
+     */
     class Token {
     public:
         TokenType type;
-        std::string lexeme;
         int line;
+        Atom atom;             // the interned lexeme of named tokens, empty otherwise
+        std::string_view text; // the lexeme of the other tokens
+
+        Token(TokenType type, std::string_view lexeme, int line)
+                : type(type), line(line), atom(IsNamedToken(type) ? Atom(lexeme) : Atom()),
+                  text(IsNamedToken(type) ? std::string_view() : lexeme) {}
 
-        Token(TokenType type, std::string lexeme, int line)
-                : type(type), lexeme(std::move(lexeme)), line(line) {}
+        std::string_view Lexeme() const {
+            return IsNamedToken(type) ? std::string_view(atom.Text()) : text;
+        }
 
         friend std::ostream &operator<<(std::ostream &os, const Token &token) {
-            os << token.lexeme;
+            os << token.Lexeme();
             return os;
         }
 
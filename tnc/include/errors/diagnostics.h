@@ -0,0 +1,73 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Non-fatal diagnostics reported by analyzers, unlike the errors in
+ * errors.h they do not stop compilation
+ */
+
+#ifndef TONIC_DIAGNOSTICS_H
+#define TONIC_DIAGNOSTICS_H
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tonic {
+
+    enum class Severity {
+        NOTE,
+        WARNING,
+    };
+
+    struct Diagnostic {
+        Severity severity;
+        std::string pass; // analyzer that reported it, for example "range"
+        std::string message;
+        size_t line;      // 0 when the node has no source line
+    };
+
+    class Diagnostics {
+    public:
+        void Note(const std::string &pass, std::string message, size_t line) {
+            diagnostics.push_back({Severity::NOTE, pass, std::move(message), line});
+        }
+
+        void Warning(const std::string &pass, std::string message, size_t line) {
+            diagnostics.push_back({Severity::WARNING, pass, std::move(message), line});
+        }
+
+        const std::vector<Diagnostic> &All() const {
+            return diagnostics;
+        }
+
+        size_t Count(Severity severity) const {
+            return std::count_if(diagnostics.begin(), diagnostics.end(), [severity](const Diagnostic &diagnostic) {
+                return diagnostic.severity == severity;
+            });
+        }
+
+        bool Empty() const {
+            return diagnostics.empty();
+        }
+
+        // one line per diagnostic, for example "line 3: note [range]: ..."
+        void Print(std::ostream &out) const {
+            for (const auto &diagnostic: diagnostics) {
+                if (diagnostic.line)
+                    out << "line " << diagnostic.line << ": ";
+                out << (diagnostic.severity == Severity::NOTE ? "note" : "warning");
+                out << " [" << diagnostic.pass << "]: " << diagnostic.message << "\n";
+            }
+        }
+
+    private:
+        std::vector<Diagnostic> diagnostics;
+    };
+
+}
+
+#endif //TONIC_DIAGNOSTICS_H
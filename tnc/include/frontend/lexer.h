@@ -14,6 +14,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -33,7 +34,10 @@ namespace tonic {
         std::vector<Token> Tokenize();
 
     private:
-        void AddToken(TokenType type, const std::string &text);
+        void AddToken(TokenType type, std::string_view text);
+
+        // the source from first_pass_start up to first_pass_current
+        std::string_view CurrentLexeme() const;
 
         void SkipWhitespace();
 
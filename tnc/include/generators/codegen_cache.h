@@ -0,0 +1,71 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Per-declaration cache of generated code keyed by subtree hashes,
+ * so recompilation only regenerates declarations that changed
+ */
+
+#ifndef TONIC_CODEGEN_CACHE_H
+#define TONIC_CODEGEN_CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace tonic {
+
+    // what CppGenerator writes for one top-level declaration
+    struct CachedDeclaration {
+        std::string code;
+        std::string prototype; // forward declaration of a function, empty otherwise
+        std::set<std::string, std::less<>> includes;
+        bool reads_input = false;
+        bool writes_output = false;
+        bool uses_memo = false;
+    };
+
+    /**
+     * Kept between runs of CppGenerator::Generate, as in watch mode or when a judge resubmits. The
+     * key is computed by the generator from the subtree hash and everything else the code depends on,
+     * the options and the analysis results. Lookups and stores may come from the generator's workers.
+     */
+    class CodegenCache {
+    public:
+        // the entry stays valid until the next Prune
+        const CachedDeclaration *Find(uint64_t key);
+
+        void Store(uint64_t key, CachedDeclaration declaration);
+
+        // starts a new build, Generate calls it
+        void BeginBuild();
+
+        // drops entries that were not used since the last BeginBuild
+        void Prune();
+
+        size_t Hits() const;
+
+        size_t Misses() const;
+
+        size_t Size() const;
+
+    private:
+        struct Entry {
+            CachedDeclaration declaration;
+            size_t last_build;
+        };
+
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, Entry> entries;
+        size_t build = 0;
+        size_t hits = 0;
+        size_t misses = 0;
+    };
+
+}
+
+#endif //TONIC_CODEGEN_CACHE_H
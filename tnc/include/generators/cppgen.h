@@ -9,14 +9,138 @@
 #ifndef TONIC_GENERATOR_H
 #define TONIC_GENERATOR_H
 
-#include <sstream>
+#include <functional>
+#include <set>
+#include <string>
+#include <string_view>
 
+#include "analyzers/constraints.h"
+#include "analyzers/memoize.h"
 #include "core/ast.h"
+#include "core/thread_pool.h"
+#include "generators/codegen_cache.h"
+#include "generators/output_sink.h"
 
 namespace tonic {
     namespace cppgen {
         std::string Generate(const VariableDeclaration &var);
+
+        // prefix of the names generated code introduces, kept out of the way of user identifiers
+        const std::string GENERATED_PREFIX = "_tnc_";
+
+        // "for (...)" of a manual for loop, invariant bounds are evaluated once in the init statement
+        std::string GenerateLoopHeader(const ForLoop &loop);
     }
+
+    // instruction sets the judge machine is known to have, the generated code may use them
+    enum class JudgeProfile {
+        PORTABLE,
+        SSE41,
+        AVX2,
+    };
+
+    struct GeneratorOptions {
+        // in statements read through the embedded runtime/fast_input.h reader instead of cin, unless the
+        // program also reads stdin itself, as with cin, getline ( cin , s ) or scanf
+        bool fast_input = true;
+        // picks the digit kernel of bulk integer input, PORTABLE keeps the scalar parser
+        JudgeProfile judge = JudgeProfile::PORTABLE;
+        // out statements write into the runtime/fast_output.h buffer instead of cout, unless the
+        // program also prints itself, as with cout, printf or puts
+        bool fast_output = true;
+        // interactive problems, the output is flushed after every out statement
+        bool interactive = false;
+        // declared ranges of @memoize arguments, which make dense memo tables possible
+        const Constraints *constraints = nullptr;
+        // reports of MemoizeAnalysis, dense memo tables of decreasing recursion are filled bottom-up
+        const std::vector<RecursionReport> *recursion = nullptr;
+        // source file named in the errors about top-level code that cannot be placed
+        std::string file_name;
+        // code of the hashed top-level declarations of earlier runs, reused while the declaration, these
+        // options and the loop bounds and recursion reports of its subtree stay the same
+        CodegenCache *cache = nullptr;
+    };
+
+    /**
+     * Writes a program as the #include lines its code needs, the top-level declarations in source
+     * order with forward declarations of the functions before the first one, after the types they
+     * may name, and a main function running the other top-level statements. Globals with a typed,
+     * non-constant initializer are declared at file scope and initialized in main where they appear,
+     * so they can read input read before them. When the program defines main itself, every top-level
+     * variable is declared with its initializer at file scope in source order, and a SyntaxError
+     * reports top-level statements and list comprehensions, which only a function can run.
+     *
+     * Every run of declarations has its own sink, prototypes and include set, merged in source order.
+     * With a cache, each declaration is looked up before it is generated and stored after.
+     */
+    class CppGenerator {
+    public:
+        explicit CppGenerator(OutputSink &out, GeneratorOptions options = {});
+
+        // a pool generates runs of top-level declarations in parallel, the text is the same without one
+        void Generate(const Program &program, ThreadPool *pool = nullptr);
+
+        // a node and its children at the current indentation, without the prelude
+        void Emit(const Node &node);
+
+        void EmitLoopHeader(const ForLoop &loop);
+
+        // headers needed by the code emitted so far
+        const std::set<std::string, std::less<>> &Includes() const;
+
+    private:
+        // a top-level declaration with its prototype, or the file-scope part of a global initialized in main
+        void Declaration(const Node &node, bool deferred, OutputSink &prototypes);
+
+        // statement text with the operators the lexer splits joined back, "cnt + = 1" becomes "cnt += 1"
+        void Code(std::string_view text);
+
+        void Type(Atom type, std::string_view fallback);
+
+        // parenthesized unless it is a single token, so it can be an operand of a comparison
+        void Operand(std::string_view expression);
+
+        void Statement(std::string_view text);
+
+        void Body(const Block *block);
+
+        void Arguments(const std::vector<std::pair<Atom, Atom>> &arguments);
+
+        // "TYPE NAME(ARGUMENTS)", with a generated prefix before the name when one is given
+        void Signature(const FunctionDeclaration &function, std::string_view prefix);
+
+        void Prototype(const FunctionDeclaration &function);
+
+        bool IsMemoized(const FunctionDeclaration &function) const;
+
+        // the recursion is proven to only lower its arguments, so the table can be filled in ascending order
+        bool BottomUp(const FunctionDeclaration &function) const;
+
+        /**
+         * The memo table, an inline wrapper named like the function that looks the arguments up and
+         * the body under a generated name. Recursive calls reach the wrapper, so the lookup is inlined
+         * at every call site. Under BottomUp the wrapper fills the dense table up to the arguments, so
+         * the body never recurses more than one call deep.
+         */
+        void Memoized(const FunctionDeclaration &function);
+
+        void Initializer(const Node &initializer);
+
+        void Lambda(const LambdaExpression &lambda);
+
+        // a list comprehension filling a vector declared just before
+        void Comprehension(std::string_view name, const Node &loop);
+
+        void NeedsFor(std::string_view name);
+
+        OutputSink *out;
+        GeneratorOptions options;
+        std::set<std::string, std::less<>> includes;
+        bool reads_input;   // the reader runtime is needed
+        bool writes_output; // the writer runtime is needed
+        bool uses_memo;     // the memo table runtime is needed
+        bool in_type;       // inside a class, struct or template, where no memo table can be declared
+    };
 }
 
 #endif //TONIC_GENERATOR_H
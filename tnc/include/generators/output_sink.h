@@ -0,0 +1,100 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Chunked output buffer the code generator writes into, kept in memory
+ * as a rope of pages or streamed to a file descriptor page by page
+ */
+
+#ifndef TONIC_OUTPUT_SINK_H
+#define TONIC_OUTPUT_SINK_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tonic {
+
+    /**
+     * Text is copied into fixed size pages, so a whole program costs one allocation per page
+     * in memory and a single page when streaming to a file descriptor. Indentation is written
+     * lazily before the first character of each line, so callers only write newlines.
+     */
+    class OutputSink {
+    public:
+        static constexpr size_t PAGE_SIZE = 64 * 1024;
+        static constexpr size_t INDENT_WIDTH = 4;
+
+        // in memory, read back with ToString or Splice
+        OutputSink();
+
+        // streams full pages to the descriptor, which stays open and owned by the caller
+        explicit OutputSink(int fd);
+
+        OutputSink(const OutputSink &) = delete;
+
+        OutputSink &operator=(const OutputSink &) = delete;
+
+        OutputSink(OutputSink &&other) noexcept;
+
+        OutputSink &operator=(OutputSink &&other) noexcept;
+
+        // flushes a descriptor sink
+        ~OutputSink();
+
+        void Write(std::string_view text);
+
+        void Put(char c);
+
+        OutputSink &operator<<(std::string_view text);
+
+        OutputSink &operator<<(char c);
+
+        OutputSink &operator<<(long long value);
+
+        void Indent();
+
+        void Dedent();
+
+        // throws an InternalError if the descriptor cannot be written
+        void Flush();
+
+        // appends the text of an in-memory sink, moving its pages instead of copying them
+        void Splice(OutputSink &&other);
+
+        // bytes written so far, including flushed ones
+        size_t Size() const;
+
+        // pages allocated so far
+        size_t Pages() const;
+
+        // the text of an in-memory sink
+        std::string ToString() const;
+
+    private:
+        struct Page {
+            std::unique_ptr<char[]> data;
+            size_t size;
+        };
+
+        void Append(const char *data, size_t size);
+
+        // a page with free space at the back of the rope
+        Page &Writable();
+
+        void WritePage(const Page &page);
+
+        std::vector<Page> pages;
+        size_t allocated;
+        size_t flushed;  // bytes already written to the descriptor
+        int fd;          // -1 for an in-memory sink
+        size_t indent;
+        bool line_start;
+    };
+
+}
+
+#endif //TONIC_OUTPUT_SINK_H
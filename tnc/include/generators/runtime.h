@@ -0,0 +1,28 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Sources of the runtime headers in tnc/runtime, embedded at configure
+ * time and pasted into the generated programs that need them
+ */
+
+#ifndef TONIC_RUNTIME_H
+#define TONIC_RUNTIME_H
+
+#include <string_view>
+
+namespace tonic::runtime {
+
+    // runtime/fast_input.h, the reader behind in statements
+    std::string_view FastInput();
+
+    // runtime/fast_output.h, the writer behind out statements
+    std::string_view FastOutput();
+
+    // runtime/memo.h, the tables behind @memoize functions
+    std::string_view Memo();
+
+}
+
+#endif //TONIC_RUNTIME_H
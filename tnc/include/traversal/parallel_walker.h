@@ -0,0 +1,200 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Parallel walker for analyses that are independent across function,
+ * class and namespace subtrees, every such subtree becomes a task on a
+ * work-stealing pool and per-task states are merged in a fixed order
+ */
+
+#ifndef TONIC_PARALLEL_WALKER_H
+#define TONIC_PARALLEL_WALKER_H
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/ast.h"
+#include "core/children.h"
+#include "core/thread_pool.h"
+
+namespace tonic {
+
+    enum class HandlerSafety {
+        SERIAL,        // touches data shared between subtrees, forces a serial walk
+        SUBTREE_LOCAL, // reads only the subtree of its node and writes only the task state
+        THREAD_SAFE,   // may touch shared data and synchronizes that itself
+    };
+
+    inline bool IsTaskRoot(NodeKind kind) {
+        return kind == NodeKind::FUNCTION_DECLARATION ||
+               kind == NodeKind::CLASS_DECLARATION ||
+               kind == NodeKind::NAMESPACE_DECLARATION;
+    }
+
+    /**
+     * State is default constructible and provides Merge(State &&). Each task
+     * walks its subtree with a fresh State, stopping at nested task roots,
+     * which become tasks of their own. The result is the state of the
+     * outermost task merged with the states of the other tasks in pre-order of
+     * their roots, so it does not depend on scheduling or on the thread count.
+     *
+     * Handlers of one task run in walking order; a post handler of a task root
+     * may run before the nested tasks of that root have finished.
+     */
+    template<typename State>
+    class ParallelWalker {
+    public:
+        template<typename T>
+        using Handler = std::function<void(T &, State &)>;
+
+        // called before the children of the node are walked
+        template<typename T>
+        void Register(Handler<T> action, HandlerSafety safety) {
+            handlers[static_cast<size_t>(T::KIND)] = Wrap(std::move(action));
+            safeties[static_cast<size_t>(T::KIND)] = safety;
+        }
+
+        // called after the children of the node are walked
+        template<typename T>
+        void RegisterPost(Handler<T> action, HandlerSafety safety) {
+            post_handlers[static_cast<size_t>(T::KIND)] = Wrap(std::move(action));
+            post_safeties[static_cast<size_t>(T::KIND)] = safety;
+        }
+
+        // walks on the calling thread when no pool is given or a handler is SERIAL,
+        // the tasks and the merge order are the same either way
+        State Walk(const std::shared_ptr<Node> &root, ThreadPool *pool = nullptr) {
+            if (!root)
+                return State();
+
+            Task outermost{root.get(), State{}, {}};
+            tasks = 1;
+            parallel = pool && CanRunInParallel();
+
+            if (parallel) {
+                std::function<void(Task &)> spawn = [&](Task &task) {
+                    pool->Submit([this, target = &task, &spawn] { RunTask(*target, spawn); });
+                };
+                spawn(outermost);
+                pool->Wait();
+            } else {
+                std::vector<Task *> worklist;
+                std::function<void(Task &)> spawn = [&](Task &task) {
+                    worklist.push_back(&task);
+                };
+                spawn(outermost);
+                while (!worklist.empty()) {
+                    Task *task = worklist.back();
+                    worklist.pop_back();
+                    RunTask(*task, spawn);
+                }
+            }
+
+            std::vector<Task *> order;
+            CollectPreOrder(outermost, order);
+            tasks = order.size();
+
+            State result = std::move(outermost.state);
+            for (size_t i = 1; i < order.size(); i++)
+                result.Merge(std::move(order[i]->state));
+
+            return result;
+        }
+
+        // whether the last walk ran its tasks on the pool
+        bool Parallel() const {
+            return parallel;
+        }
+
+        // number of tasks the last walk was split into
+        size_t Tasks() const {
+            return tasks;
+        }
+
+    private:
+        using Action = std::function<void(Node &, State &)>;
+
+        struct Task {
+            Node *root;
+            State state;
+            std::vector<std::unique_ptr<Task>> nested; // in pre-order, owned by the task thread while it runs
+        };
+
+        struct Frame {
+            Node *node;
+            bool entered;
+        };
+
+        template<typename T>
+        static Action Wrap(Handler<T> action) {
+            return [action = std::move(action)](Node &node, State &state) {
+                action(NodeAs<T>(node), state);
+            };
+        }
+
+        bool CanRunInParallel() const {
+            for (size_t i = 0; i < NODE_KIND_COUNT; i++) {
+                if ((handlers[i] && safeties[i] == HandlerSafety::SERIAL) ||
+                    (post_handlers[i] && post_safeties[i] == HandlerSafety::SERIAL))
+                    return false;
+            }
+            return true;
+        }
+
+        void RunTask(Task &task, const std::function<void(Task &)> &spawn) const {
+            std::vector<Frame> stack = {{task.root, false}};
+
+            while (!stack.empty()) {
+                Frame frame = stack.back();
+
+                if (frame.entered) {
+                    stack.pop_back();
+                    if (const Action &handler = post_handlers[static_cast<size_t>(frame.node->kind)])
+                        handler(*frame.node, task.state);
+                    continue;
+                }
+
+                // nested task roots are split off when reached, which keeps them in pre-order
+                if (frame.node != task.root && IsTaskRoot(frame.node->kind)) {
+                    stack.pop_back();
+                    task.nested.push_back(std::make_unique<Task>(Task{frame.node, State{}, {}}));
+                    spawn(*task.nested.back());
+                    continue;
+                }
+
+                stack.back().entered = true;
+                if (const Action &handler = handlers[static_cast<size_t>(frame.node->kind)])
+                    handler(*frame.node, task.state);
+
+                size_t first_child = stack.size();
+                ForEachChildSlot(*frame.node, [&](const auto &slot) {
+                    if (slot)
+                        stack.push_back({slot.get(), false});
+                });
+                std::reverse(stack.begin() + static_cast<std::ptrdiff_t>(first_child), stack.end());
+            }
+        }
+
+        static void CollectPreOrder(Task &task, std::vector<Task *> &order) {
+            order.push_back(&task);
+            for (auto &nested: task.nested)
+                CollectPreOrder(*nested, order);
+        }
+
+        std::array<Action, NODE_KIND_COUNT> handlers;
+        std::array<Action, NODE_KIND_COUNT> post_handlers;
+        std::array<HandlerSafety, NODE_KIND_COUNT> safeties{};
+        std::array<HandlerSafety, NODE_KIND_COUNT> post_safeties{};
+
+        bool parallel = false;
+        size_t tasks = 0;
+    };
+
+}
+
+#endif //TONIC_PARALLEL_WALKER_H
@@ -0,0 +1,85 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Pass manager that fuses independent analysis passes into shared
+ * traversals, the tree is walked once per dependency level instead of
+ * once per pass
+ */
+
+#ifndef TONIC_PASS_MANAGER_H
+#define TONIC_PASS_MANAGER_H
+
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "core/ast.h"
+
+namespace tonic {
+
+    class Pass {
+    public:
+        virtual ~Pass() = default;
+
+        virtual std::string Name() const = 0;
+
+        // node kinds the pass receives Enter and Leave calls for
+        virtual std::vector<NodeKind> Kinds() const = 0;
+
+        // names of passes that must have finished before this one starts
+        virtual std::vector<std::string> Dependencies() const {
+            return {};
+        }
+
+        virtual void Begin(Program &) {}
+
+        virtual void Enter(Node &) {}
+
+        virtual void Leave(Node &) {}
+
+        virtual void End(Program &) {}
+    };
+
+    struct PassTiming {
+        std::string name;
+        size_t level;
+        size_t calls;
+        std::chrono::nanoseconds time; // Begin and End, and every Enter and Leave call when nodes are timed
+    };
+
+    class PassManager {
+    public:
+        // timing every Enter and Leave call reads the clock twice per pass and node, which can cost more than
+        // the calls themselves, so by default only levels and the Begin and End calls are timed
+        explicit PassManager(bool time_nodes = false);
+
+        void Add(std::unique_ptr<Pass> pass);
+
+        // passes grouped by dependency level, each level is one fused traversal
+        std::vector<std::vector<std::string>> Schedule() const;
+
+        void Run(const std::shared_ptr<Program> &program);
+
+        const std::vector<PassTiming> &Timings() const;
+
+        // number of tree traversals done by the last run
+        size_t Traversals() const;
+
+        void Report(std::ostream &os) const;
+
+    private:
+        std::vector<std::vector<size_t>> Levels() const;
+
+        bool time_nodes;
+        std::vector<std::unique_ptr<Pass>> passes;
+        std::vector<PassTiming> timings;
+        std::vector<std::chrono::nanoseconds> level_times;
+    };
+
+}
+
+#endif //TONIC_PASS_MANAGER_H
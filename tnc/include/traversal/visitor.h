@@ -0,0 +1,71 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Compile-time typed visitor for built-in passes. Unlike the Walker,
+ * handlers are plain member functions that receive typed node references
+ * and can be inlined, the Walker stays the dynamic API for plugins and tests
+ */
+
+#ifndef TONIC_VISITOR_H
+#define TONIC_VISITOR_H
+
+#include <memory>
+#include <type_traits>
+
+#include "core/ast.h"
+#include "core/children.h"
+
+namespace tonic {
+
+    /**
+     * Derived classes declare only the overloads they need, for example
+     *
+     *     struct LoopCounter : AstVisitor<LoopCounter> {
+     *         void Visit(ForLoop &loop) { ... }  // before the children
+     *         void Leave(ForLoop &loop) { ... }  // after the children
+     *     };
+     *
+     * Node types without a matching Visit or Leave are traversed without a call.
+     */
+    template<typename Derived>
+    class AstVisitor {
+    public:
+        void Traverse(Node &node) {
+            DispatchNode(node, [this](auto &concrete) {
+                TraverseNode(concrete);
+            });
+        }
+
+        template<typename T>
+        void Traverse(const std::shared_ptr<T> &node) {
+            if (!node)
+                return;
+
+            if constexpr (std::is_same_v<T, Node>)
+                Traverse(*node);
+            else
+                TraverseNode(*node); // slot type is the concrete type, no dispatch needed
+        }
+
+    protected:
+        template<typename T>
+        void TraverseNode(T &node) {
+            Derived &self = static_cast<Derived &>(*this);
+
+            if constexpr (requires { self.Visit(node); })
+                self.Visit(node);
+
+            ForEachTypedChildSlot(node, [this](const auto &slot) {
+                Traverse(slot);
+            });
+
+            if constexpr (requires { self.Leave(node); })
+                self.Leave(node);
+        }
+    };
+
+}
+
+#endif //TONIC_VISITOR_H
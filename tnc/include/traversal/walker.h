@@ -9,44 +9,142 @@
 #ifndef TONIC_WALKER_H
 #define TONIC_WALKER_H
 
-#include <stack>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <functional>
-#include <unordered_map>
+#include <type_traits>
+#include <vector>
 
 #include "core/ast.h"
+#include "core/flat_ast.h"
 
 namespace tonic {
 
+    enum class WalkControl {
+        CONTINUE,
+        SKIP_CHILDREN,
+        STOP,
+    };
+
     class Walker {
     public:
         using NodePtr = std::shared_ptr<Node>;
-        using Action = std::function<void(NodePtr)>;
+        using Action = std::function<WalkControl(NodePtr)>;
 
         Walker();
 
-        template<typename T>
-        void Register(std::function<void(std::shared_ptr<T>)> action) {
-            std::string type_name = typeid(T).name();
-            handlers[type_name] = [action](NodePtr node) {
-                action(std::dynamic_pointer_cast<T>(node));
-            };
+        // called before the children of the node are walked. Handlers return
+        // nothing or a WalkControl, SKIP_CHILDREN still runs the post handler
+        template<typename T, typename F>
+        void Register(F action) {
+            handlers[static_cast<size_t>(T::KIND)] = Wrap<T>(std::move(action));
+        }
+
+        // called after the children of the node are walked
+        template<typename T, typename F>
+        void RegisterPost(F action) {
+            post_handlers[static_cast<size_t>(T::KIND)] = Wrap<T>(std::move(action));
+        }
+
+        // untyped registration by kind, for dispatchers that route many node kinds
+        template<typename F>
+        void Register(NodeKind kind, F action) {
+            handlers[static_cast<size_t>(kind)] = Wrap<Node>(std::move(action));
+        }
+
+        template<typename F>
+        void RegisterPost(NodeKind kind, F action) {
+            post_handlers[static_cast<size_t>(kind)] = Wrap<Node>(std::move(action));
         }
 
-        void Walk(const NodePtr& node);
+        // returns false when a handler stopped the walk
+        bool Walk(const NodePtr& node);
+
+        // same visiting order as walking the tree the flat AST was built from
+        bool Walk(const FlatAst &ast);
+
+        // enclosing nodes of the node being handled, outermost first, excluding the node itself
+        const std::vector<Node *> &Ancestors() const {
+            return ancestors;
+        }
+
+        Node *Parent() const {
+            return ancestors.empty() ? nullptr : ancestors.back();
+        }
 
     private:
+        // a node on the explicit walk stack, the owning pointer is only
+        // materialized when a handler needs it so walking causes no refcount traffic
+        struct Frame {
+            Node *node;
+            const void *slot;
+            NodePtr (*own)(const void *slot);
+            bool entered;
+        };
+
         template<typename T>
-        void WalkVector(const std::vector<T>& list) {
-            for (const auto &sub_node: list) {
-                Walk(sub_node);
-            }
+        static NodePtr Own(const void *slot) {
+            return *static_cast<const std::shared_ptr<T> *>(slot);
         }
 
-        std::unordered_map<std::string, std::function<void(NodePtr)>> handlers;
-        std::stack<NodePtr> visited_nodes;
+        template<typename T, typename F>
+        static Action Wrap(F action) {
+            return [action = std::move(action)](NodePtr node) -> WalkControl {
+                auto typed = std::static_pointer_cast<T>(std::move(node));
+                if constexpr (std::is_same_v<std::invoke_result_t<F &, std::shared_ptr<T>>, WalkControl>) {
+                    return action(std::move(typed));
+                } else {
+                    action(std::move(typed));
+                    return WalkControl::CONTINUE;
+                }
+            };
+        }
+
+        WalkControl Enter(const Frame &frame);
+
+        WalkControl Leave(const Frame &frame);
+
+        std::array<Action, NODE_KIND_COUNT> handlers; // indexed by NodeKind
+        std::array<Action, NODE_KIND_COUNT> post_handlers;
+
+        // reused between walks, so walking allocates nothing after warm-up
+        std::vector<Frame> stack;
+        std::vector<Node *> ancestors;
+        std::vector<uint32_t> open_flat_nodes;
     };
 
+    // first node of type T in walking order satisfying the predicate, the walk stops there
+    template<typename T, typename Predicate>
+    std::shared_ptr<T> FindFirst(const std::shared_ptr<Node> &root, Predicate predicate) {
+        std::shared_ptr<T> found;
+        Walker walker;
+        walker.Register<T>([&](std::shared_ptr<T> node) {
+            if (!predicate(static_cast<const T &>(*node)))
+                return WalkControl::CONTINUE;
+
+            found = std::move(node);
+            return WalkControl::STOP;
+        });
+        walker.Walk(root);
+        return found;
+    }
+
+    template<typename T>
+    std::shared_ptr<T> FindFirst(const std::shared_ptr<Node> &root) {
+        return FindFirst<T>(root, [](const T &) { return true; });
+    }
+
+    template<typename T, typename Predicate>
+    bool Any(const std::shared_ptr<Node> &root, Predicate predicate) {
+        return FindFirst<T>(root, std::move(predicate)) != nullptr;
+    }
+
+    template<typename T>
+    bool Any(const std::shared_ptr<Node> &root) {
+        return FindFirst<T>(root) != nullptr;
+    }
+
 }
 
 #endif //TONIC_WALKER_H
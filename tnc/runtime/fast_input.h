@@ -0,0 +1,342 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Input reader pasted into generated programs that read input, maps
+ * stdin when it is a regular file and reads it in large blocks otherwise
+ */
+
+#ifndef TONIC_RUNTIME_FAST_INPUT_H
+#define TONIC_RUNTIME_FAST_INPUT_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TNC_RUNTIME_POSIX 1
+#else
+#include <cstdio>
+#define TNC_RUNTIME_POSIX 0
+#endif
+
+// 1 for SSE4.1 and 2 for AVX2 digit kernels in bulk integer reads, set by the generator from the judge profile
+#ifndef TNC_RUNTIME_SIMD
+#define TNC_RUNTIME_SIMD 0
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TNC_RUNTIME_X86 1
+#else
+#define TNC_RUNTIME_X86 0
+#endif
+
+namespace _tnc_runtime {
+
+#if TNC_RUNTIME_X86
+    /**
+     * Digit kernels after simdjson: the digits are classified a vector at a time and the ones of a
+     * number, shifted to the end of a 16 byte lane, are combined by multiply-adds of 2, 4 and 8
+     * digits. The functions carry their own target, so the rest of the program is built as usual.
+     */
+    namespace simd {
+
+        // the first length bytes of digits, already minus '0', as a number, length at most 16
+        __attribute__((target("sse4.1"))) inline std::uint64_t Combine(__m128i digits, int length) {
+            __m128i shift = _mm_add_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                         _mm_set1_epi8(static_cast<char>(length - 16)));
+            __m128i value = _mm_shuffle_epi8(digits, shift); // negative lanes are zeroed
+            value = _mm_maddubs_epi16(value, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+            value = _mm_madd_epi16(value, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+            value = _mm_packus_epi32(value, value);
+            value = _mm_madd_epi16(value, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_cvtsi128_si32(value))) * 100000000 +
+                   static_cast<std::uint32_t>(_mm_extract_epi32(value, 1));
+        }
+
+        // reads the digits at p, 16 bytes must be readable; nullptr when there are more than 15
+        __attribute__((target("sse4.1"))) inline const char *ParseSse41(const char *p, std::uint64_t &result) {
+            __m128i digits = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_set1_epi8('0'));
+            __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+            unsigned other = ~static_cast<unsigned>(_mm_movemask_epi8(is_digit)) & 0xFFFF;
+            if (other == 0)
+                return nullptr;
+
+            int length = __builtin_ctz(other);
+            result = Combine(digits, length);
+            return p + length;
+        }
+
+        // reads the digits at p, 32 bytes must be readable; nullptr when there are more than 31
+        __attribute__((target("avx2"))) inline const char *ParseAvx2(const char *p, std::uint64_t &result) {
+            __m256i digits = _mm256_sub_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)),
+                                             _mm256_set1_epi8('0'));
+            __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits);
+            unsigned other = ~static_cast<unsigned>(_mm256_movemask_epi8(is_digit));
+            if (other == 0)
+                return nullptr;
+
+            int length = __builtin_ctz(other);
+            if (length <= 16) {
+                result = Combine(_mm256_castsi256_si128(digits), length);
+                return p + length;
+            }
+
+            // leading digits beyond the last 16, wrapping like the scalar loop
+            std::uint64_t head = 0;
+            for (const char *digit = p; digit < p + length - 16; digit++)
+                head = head * 10 + static_cast<std::uint64_t>(*digit - '0');
+            __m128i tail = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + length - 16)),
+                                        _mm_set1_epi8('0'));
+            result = head * 10000000000000000ULL + Combine(tail, 16);
+            return p + length;
+        }
+
+    }
+#endif
+
+    template<typename T>
+    struct IsNumber : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                                   !std::is_same<T, char>::value> {
+    };
+
+    // parses without locales; a value that is not in the input is left untouched and Read returns false
+    class Reader {
+    public:
+        static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+        // simd picks the digit kernel of bulk integer reads, it needs the matching instruction set
+        explicit Reader(int fd = 0, bool map = true, int simd = TNC_RUNTIME_SIMD) : fd(fd), simd(simd) {
+#if TNC_RUNTIME_POSIX
+            struct stat info;
+            off_t offset = lseek(fd, 0, SEEK_CUR);
+            if (map && offset >= 0 && fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > offset) {
+                void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    madvise(data, info.st_size, MADV_SEQUENTIAL);
+                    mapped = static_cast<char *>(data);
+                    mapped_size = info.st_size;
+                    pos = mapped + offset;
+                    end = mapped + mapped_size;
+                    done = true;
+                    return;
+                }
+            }
+#endif
+            buffer = new char[BUFFER_SIZE];
+            pos = end = buffer;
+        }
+
+        Reader(const Reader &) = delete;
+
+        Reader &operator=(const Reader &) = delete;
+
+        ~Reader() {
+#if TNC_RUNTIME_POSIX
+            if (mapped)
+                munmap(mapped, mapped_size);
+#endif
+            delete[] buffer;
+        }
+
+        template<typename T>
+        typename std::enable_if<IsNumber<T>::value, bool>::type Read(T &value) {
+            if (!SkipSpace())
+                return false;
+
+            bool negative = Sign();
+            typedef typename std::make_unsigned<T>::type Unsigned;
+            Unsigned result = 0;
+            Digits(result);
+            value = static_cast<T>(negative ? Unsigned(0) - result : result);
+            return true;
+        }
+
+        bool Read(bool &value) {
+            int number = 0;
+            if (!Read(number))
+                return false;
+            value = number != 0;
+            return true;
+        }
+
+        // the next character that is not white space
+        bool Read(char &value) {
+            if (!SkipSpace())
+                return false;
+            value = *pos++;
+            return true;
+        }
+
+        bool Read(std::string &value) {
+            if (!SkipSpace())
+                return false;
+
+            value.clear();
+            for (;;) {
+                const char *start = pos;
+                while (pos < end && static_cast<unsigned char>(*pos) > ' ')
+                    ++pos;
+                value.append(start, pos - start);
+                if (pos < end || !Refill())
+                    return true;
+            }
+        }
+
+        template<typename T>
+        typename std::enable_if<std::is_floating_point<T>::value, bool>::type Read(T &value) {
+            std::string token;
+            if (!Read(token))
+                return false;
+            value = static_cast<T>(std::strtold(token.c_str(), nullptr));
+            return true;
+        }
+
+        // as many elements as the vector already holds, so the size is read first
+        template<typename T>
+        bool Read(std::vector<T> &values) {
+            return ReadAll(values.data(), values.data() + values.size());
+        }
+
+        bool Read(std::vector<bool> &values) {
+            for (std::size_t i = 0; i < values.size(); i++) {
+                bool value;
+                if (!Read(value))
+                    return false;
+                values[i] = value;
+            }
+            return true;
+        }
+
+        template<typename T, std::size_t N>
+        bool Read(T (&values)[N]) {
+            return ReadAll(values, values + N);
+        }
+
+        template<typename A, typename B>
+        bool Read(std::pair<A, B> &value) {
+            return Read(value.first) && Read(value.second);
+        }
+
+        template<typename T, typename U, typename... Rest>
+        bool Read(T &first, U &second, Rest &... rest) {
+            return Read(first) && Read(second, rest...);
+        }
+
+    private:
+        template<typename T>
+        bool ReadAll(T *first, T *last) {
+            for (; first != last; ++first)
+                if (!ReadElement(*first))
+                    return false;
+            return true;
+        }
+
+        // integers of a bulk read go through the digit kernel while a whole window is buffered
+        template<typename T>
+        bool ReadElement(T &value) {
+#if TNC_RUNTIME_X86
+            if constexpr (IsNumber<T>::value && sizeof(T) <= 8) {
+                if (simd > 0 && end - pos >= WINDOW) {
+                    while (pos < end - WINDOW && static_cast<unsigned char>(*pos) <= ' ')
+                        ++pos;
+
+                    const char *start = pos + (*pos == '-' || *pos == '+');
+                    std::uint64_t result;
+                    const char *next = static_cast<unsigned char>(*start - '0') >= 10 ? nullptr :
+                                       simd > 1 ? simd::ParseAvx2(start, result) : simd::ParseSse41(start, result);
+                    if (next) {
+                        value = static_cast<T>(*pos == '-' ? 0 - result : result);
+                        pos += next - pos;
+                        return true;
+                    }
+                }
+            }
+#endif
+            return Read(value);
+        }
+
+        // consumes a sign, true when it is a minus
+        bool Sign() {
+            if (*pos != '-' && *pos != '+')
+                return false;
+            return *pos++ == '-';
+        }
+
+        // wraps around on overflow
+        template<typename Unsigned>
+        void Digits(Unsigned &result) {
+            for (;;) {
+                while (pos < end && static_cast<unsigned char>(*pos - '0') < 10)
+                    result = result * 10 + static_cast<Unsigned>(*pos++ - '0');
+                if (pos < end || !Refill())
+                    return;
+            }
+        }
+
+        // false at the end of the input
+        bool SkipSpace() {
+            for (;;) {
+                while (pos < end && static_cast<unsigned char>(*pos) <= ' ')
+                    ++pos;
+                if (pos < end)
+                    return true;
+                if (!Refill())
+                    return false;
+            }
+        }
+
+        // a single read, so interactive input is not waited for beyond what is available
+        bool Refill() {
+            if (done)
+                return false;
+
+            std::size_t left = end - pos;
+            std::memmove(buffer, pos, left);
+            pos = buffer;
+            end = buffer + left;
+
+            for (;;) {
+#if TNC_RUNTIME_POSIX
+                long result = ::read(fd, end, BUFFER_SIZE - left);
+                if (result < 0 && errno == EINTR)
+                    continue;
+#else
+                long result = static_cast<long>(std::fread(end, 1, BUFFER_SIZE - left, stdin));
+#endif
+                if (result <= 0) {
+                    done = true;
+                    return false;
+                }
+                end += result;
+                return true;
+            }
+        }
+
+        // bytes a kernel may read past the start of a number, with room for a sign
+        static constexpr long WINDOW = 40;
+
+        int fd;
+        int simd;
+        char *buffer = nullptr;
+        char *mapped = nullptr;
+        std::size_t mapped_size = 0;
+        char *pos = nullptr;
+        char *end = nullptr;
+        bool done = false;
+    };
+
+}
+
+#endif //TONIC_RUNTIME_FAST_INPUT_H
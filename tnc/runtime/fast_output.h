@@ -0,0 +1,231 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Output writer pasted into generated programs that write output, one
+ * large buffer written out when it fills up, on Flush and at exit
+ */
+
+#ifndef TONIC_RUNTIME_FAST_OUTPUT_H
+#define TONIC_RUNTIME_FAST_OUTPUT_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define TNC_RUNTIME_POSIX 1
+#else
+#define TNC_RUNTIME_POSIX 0
+#endif
+
+namespace _tnc_runtime {
+
+    // "00" to "99", two digits are written per division
+    static const char DIGIT_PAIRS[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+    template<typename T>
+    struct IsCharacter : std::integral_constant<bool, std::is_same<T, char>::value ||
+                                                      std::is_same<T, signed char>::value ||
+                                                      std::is_same<T, unsigned char>::value> {
+    };
+
+    /**
+     * Values are formatted like cout formats them by default. Containers are joined by spaces,
+     * containers of containers put each inner container on a line of its own. In interactive mode
+     * every Line is flushed, so the judge sees the whole line before the program reads again.
+     */
+    class Writer {
+    public:
+        static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+        explicit Writer(bool interactive = false, int fd = 1) : fd(fd), interactive(interactive) {
+            buffer = new char[BUFFER_SIZE];
+        }
+
+        Writer(const Writer &) = delete;
+
+        Writer &operator=(const Writer &) = delete;
+
+        ~Writer() {
+            Flush();
+            delete[] buffer;
+        }
+
+        template<typename T>
+        typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                !IsCharacter<T>::value>::type Write(T value) {
+            typedef typename std::make_unsigned<T>::type Unsigned;
+            Reserve(24);
+            Unsigned magnitude = static_cast<Unsigned>(value);
+            if (value < 0) {
+                buffer[size++] = '-';
+                magnitude = Unsigned(0) - magnitude;
+            }
+            WriteUnsigned(static_cast<std::uint64_t>(magnitude));
+        }
+
+        void Write(bool value) {
+            Write(value ? '1' : '0');
+        }
+
+        template<typename T>
+        typename std::enable_if<IsCharacter<T>::value>::type Write(T value) {
+            Reserve(1);
+            buffer[size++] = static_cast<char>(value);
+        }
+
+        void Write(const char *text) {
+            Write(text, std::strlen(text));
+        }
+
+        void Write(const std::string &text) {
+            Write(text.data(), text.size());
+        }
+
+        void Write(const char *text, std::size_t length) {
+            if (length > BUFFER_SIZE) {
+                Flush();
+                Send(text, length);
+                return;
+            }
+            Reserve(length);
+            std::memcpy(buffer + size, text, length);
+            size += length;
+        }
+
+        // six significant digits, as cout without manipulators
+        template<typename T>
+        typename std::enable_if<std::is_floating_point<T>::value>::type Write(T value) {
+            Reserve(64);
+            size += std::snprintf(buffer + size, 64, "%Lg", static_cast<long double>(value));
+        }
+
+        template<typename T>
+        void Write(const std::vector<T> &values) {
+            for (std::size_t i = 0; i < values.size(); i++) {
+                if (i)
+                    Write(IsContainer<T>::value ? '\n' : ' ');
+                Write(values[i]);
+            }
+        }
+
+        template<typename T, std::size_t N>
+        typename std::enable_if<!IsCharacter<T>::value>::type Write(const T (&values)[N]) {
+            for (std::size_t i = 0; i < N; i++) {
+                if (i)
+                    Write(IsContainer<T>::value ? '\n' : ' ');
+                Write(values[i]);
+            }
+        }
+
+        template<typename A, typename B>
+        void Write(const std::pair<A, B> &value) {
+            Write(value.first);
+            Write(' ');
+            Write(value.second);
+        }
+
+        // anything else cout can print, through a string stream
+        template<typename T>
+        typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_pointer<T>::value>::type
+        Write(const T &value) {
+            std::ostringstream text;
+            text << value;
+            Write(text.str());
+        }
+
+        // the values separated by spaces and a newline
+        void Line() {
+            Write('\n');
+            if (interactive)
+                Flush();
+        }
+
+        template<typename T, typename... Rest>
+        void Line(const T &first, const Rest &... rest) {
+            Write(first);
+            ((Write(' '), Write(rest)), ...);
+            Write('\n');
+            if (interactive)
+                Flush();
+        }
+
+        void Flush() {
+            Send(buffer, size);
+            size = 0;
+        }
+
+    private:
+        template<typename T>
+        struct IsContainer : std::false_type {
+        };
+
+        template<typename T>
+        struct IsContainer<std::vector<T>> : std::true_type {
+        };
+
+        void Reserve(std::size_t length) {
+            if (size + length > BUFFER_SIZE)
+                Flush();
+        }
+
+        void WriteUnsigned(std::uint64_t value) {
+            char digits[20];
+            char *first = digits + sizeof(digits);
+            while (value >= 100) {
+                const char *pair = DIGIT_PAIRS + (value % 100) * 2;
+                value /= 100;
+                *--first = pair[1];
+                *--first = pair[0];
+            }
+            if (value >= 10) {
+                *--first = DIGIT_PAIRS[value * 2 + 1];
+                *--first = DIGIT_PAIRS[value * 2];
+            } else {
+                *--first = static_cast<char>('0' + value);
+            }
+
+            std::size_t length = digits + sizeof(digits) - first;
+            std::memcpy(buffer + size, first, length);
+            size += length;
+        }
+
+        void Send(const char *data, std::size_t length) {
+            while (length > 0) {
+#if TNC_RUNTIME_POSIX
+                long written = ::write(fd, data, length);
+                if (written < 0 && errno == EINTR)
+                    continue;
+#else
+                long written = static_cast<long>(std::fwrite(data, 1, length, stdout));
+                std::fflush(stdout);
+#endif
+                if (written <= 0)
+                    return; // the reader went away, the rest of the output is dropped
+                data += written;
+                length -= written;
+            }
+        }
+
+        int fd;
+        bool interactive;
+        char *buffer;
+        std::size_t size = 0;
+    };
+
+}
+
+#endif //TONIC_RUNTIME_FAST_OUTPUT_H
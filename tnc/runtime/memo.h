@@ -0,0 +1,339 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Memo tables pasted into generated programs with @memoize functions,
+ * dense arrays over declared argument ranges and an open addressing hash
+ */
+
+#ifndef TONIC_RUNTIME_MEMO_H
+#define TONIC_RUNTIME_MEMO_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace _tnc_runtime {
+
+    // the splitmix64 finalizer, every input bit reaches every output bit
+    inline std::uint64_t Mix(std::uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // declared before any is defined, so the overloads find each other for nested keys such as vector<pair<int, int>>
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, std::uint64_t>::type
+    HashOf(const T &value);
+
+    template<typename T>
+    typename std::enable_if<!std::is_integral<T>::value && !std::is_enum<T>::value, std::uint64_t>::type
+    HashOf(const T &value);
+
+    inline std::uint64_t HashOf(const std::string &value);
+
+    template<typename A, typename B>
+    std::uint64_t HashOf(const std::pair<A, B> &value);
+
+    template<typename... T>
+    std::uint64_t HashOf(const std::tuple<T...> &value);
+
+    template<typename T, std::size_t N>
+    std::uint64_t HashOf(const std::array<T, N> &value);
+
+    template<typename T>
+    std::uint64_t HashOf(const std::vector<T> &value);
+
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, std::uint64_t>::type
+    HashOf(const T &value) {
+        return static_cast<std::uint64_t>(value);
+    }
+
+    // floating point keys and the rest std::hash knows
+    template<typename T>
+    typename std::enable_if<!std::is_integral<T>::value && !std::is_enum<T>::value, std::uint64_t>::type
+    HashOf(const T &value) {
+        return std::hash<T>()(value);
+    }
+
+    inline std::uint64_t HashOf(const std::string &value) {
+        return std::hash<std::string_view>()(value);
+    }
+
+    template<typename A, typename B>
+    std::uint64_t HashOf(const std::pair<A, B> &value) {
+        return Mix(HashOf(value.first)) ^ HashOf(value.second);
+    }
+
+    template<typename... T>
+    std::uint64_t HashOf(const std::tuple<T...> &value) {
+        return std::apply([](const auto &... fields) {
+            std::uint64_t hash = 0;
+            ((hash = Mix(hash ^ HashOf(fields))), ...);
+            return hash;
+        }, value);
+    }
+
+    template<typename T, std::size_t N>
+    std::uint64_t HashOf(const std::array<T, N> &value) {
+        std::uint64_t hash = 0;
+        for (const T &element: value)
+            hash = Mix(hash ^ HashOf(element));
+        return hash;
+    }
+
+    template<typename T>
+    std::uint64_t HashOf(const std::vector<T> &value) {
+        std::uint64_t hash = value.size();
+        for (const T &element: value)
+            hash = Mix(hash ^ HashOf(element));
+        return hash;
+    }
+
+    /**
+     * One cell per argument tuple in the declared ranges, allocated zeroed so the pages of cells
+     * that are never reached are never touched. A cell is set when its epoch is the table's, so
+     * Reset forgets every value at once. Arguments outside the ranges are computed, not cached.
+     */
+    template<typename Value, std::size_t Dims>
+    class DenseMemo {
+        static_assert(std::is_trivially_copyable<Value>::value, "dense memo values are copied as bytes");
+
+    public:
+        DenseMemo(const std::array<long long, Dims> &low, const std::array<long long, Dims> &extent)
+                : low(low), extent(extent) {
+            std::size_t size = 1;
+            for (long long length: extent)
+                size *= static_cast<std::size_t>(length);
+            cells = static_cast<Cell *>(std::calloc(size, sizeof(Cell)));
+            if (!cells)
+                throw std::bad_alloc();
+        }
+
+        DenseMemo(const DenseMemo &) = delete;
+
+        DenseMemo &operator=(const DenseMemo &) = delete;
+
+        ~DenseMemo() {
+            std::free(cells);
+        }
+
+        template<typename... Index>
+        const Value *Find(Index... index) const {
+            std::size_t cell;
+            if (!Locate(cell, index...) || cells[cell].epoch != epoch)
+                return nullptr;
+            return &cells[cell].value;
+        }
+
+        template<typename... Index>
+        Value Store(Value value, Index... index) {
+            std::size_t cell;
+            if (Locate(cell, index...)) {
+                cells[cell].value = value;
+                cells[cell].epoch = epoch;
+            }
+            return value;
+        }
+
+        /**
+         * The value at index, after filling every cell from the low corner up to it in ascending
+         * order, nullptr outside the ranges. When each call of compute only reads cells with no
+         * argument higher and one lower, every read finds its cell filled, so nothing recurses.
+         * The box filled last is remembered and its rows are skipped by the next fill.
+         */
+        template<typename Compute, typename... Index>
+        const Value *Fill(Compute compute, Index... index) {
+            std::size_t target;
+            if (!Locate(target, index...))
+                return nullptr;
+            if (cells[target].epoch == epoch)
+                return &cells[target].value;
+
+            const std::array<long long, Dims> corner = {static_cast<long long>(index)...};
+            std::array<long long, Dims> current = low;
+            for (;;) {
+                // the rest of a row inside the filled box is known to be set
+                bool inside = filled;
+                for (std::size_t d = 0; inside && d + 1 < Dims; d++)
+                    inside = current[d] <= filled_corner[d];
+                if (inside && current[Dims - 1] <= filled_corner[Dims - 1])
+                    current[Dims - 1] = filled_corner[Dims - 1] + 1;
+
+                if (current[Dims - 1] <= corner[Dims - 1]) {
+                    std::size_t cell = CellOf(current);
+                    if (cells[cell].epoch != epoch) {
+                        Value value = Call(compute, current, std::make_index_sequence<Dims>());
+                        cells[cell].value = value;
+                        cells[cell].epoch = epoch;
+                    }
+                    current[Dims - 1]++;
+                    continue;
+                }
+
+                // the next row, the last dimension varies fastest
+                std::size_t d = Dims - 1;
+                while (d > 0 && current[d - 1] == corner[d - 1])
+                    d--;
+                if (d == 0)
+                    break;
+                current[d - 1]++;
+                for (; d < Dims; d++)
+                    current[d] = low[d];
+            }
+
+            bool covers = true;
+            for (std::size_t d = 0; d < Dims; d++)
+                covers &= !filled || corner[d] >= filled_corner[d];
+            if (covers) {
+                filled_corner = corner;
+                filled = true;
+            }
+            return &cells[target].value;
+        }
+
+        void Reset() {
+            filled = false;
+            if (++epoch != 0)
+                return;
+
+            std::size_t size = 1;
+            for (long long length: extent)
+                size *= static_cast<std::size_t>(length);
+            std::memset(static_cast<void *>(cells), 0, size * sizeof(Cell));
+            epoch = 1;
+        }
+
+    private:
+        struct Cell {
+            Value value;
+            std::uint32_t epoch;
+        };
+
+        template<typename... Index>
+        bool Locate(std::size_t &cell, Index... index) const {
+            static_assert(sizeof...(Index) == Dims, "one index per declared range");
+            const long long values[Dims + 1] = {static_cast<long long>(index)...};
+            cell = 0;
+            for (std::size_t d = 0; d < Dims; d++) {
+                unsigned long long offset = static_cast<unsigned long long>(values[d] - low[d]);
+                if (offset >= static_cast<unsigned long long>(extent[d]))
+                    return false;
+                cell = cell * static_cast<std::size_t>(extent[d]) + static_cast<std::size_t>(offset);
+            }
+            return true;
+        }
+
+        std::size_t CellOf(const std::array<long long, Dims> &current) const {
+            std::size_t cell = 0;
+            for (std::size_t d = 0; d < Dims; d++)
+                cell = cell * static_cast<std::size_t>(extent[d]) + static_cast<std::size_t>(current[d] - low[d]);
+            return cell;
+        }
+
+        template<typename Compute, std::size_t... D>
+        static Value Call(Compute &compute, const std::array<long long, Dims> &current, std::index_sequence<D...>) {
+            return compute(current[D]...);
+        }
+
+        std::array<long long, Dims> low;
+        std::array<long long, Dims> extent;
+        Cell *cells;
+        std::uint32_t epoch = 1;
+        bool filled = false; // filled_corner bounds a box whose cells are all set
+        std::array<long long, Dims> filled_corner{};
+    };
+
+    /**
+     * Linear probing over a power of two table kept at most half full. The argument hashes are
+     * combined through Mix with a seed taken at startup, so inputs crafted against a fixed hash
+     * do not line up in one probe chain.
+     */
+    template<typename Value, typename... Args>
+    class HashMemo {
+    public:
+        HashMemo() : slots(1024), seed(Mix(static_cast<std::uint64_t>(
+                std::chrono::steady_clock::now().time_since_epoch().count()) ^ reinterpret_cast<std::uintptr_t>(this))) {}
+
+        const Value *Find(const typename std::decay<Args>::type &... args) const {
+            std::size_t mask = slots.size() - 1;
+            for (std::size_t i = Hash(args...) & mask; slots[i].used; i = (i + 1) & mask)
+                if (slots[i].key == std::tie(args...))
+                    return &slots[i].value;
+            return nullptr;
+        }
+
+        Value Store(Value value, const typename std::decay<Args>::type &... args) {
+            if ((count + 1) * 2 > slots.size())
+                Grow();
+            Insert(Key(args...), value);
+            return value;
+        }
+
+        std::size_t Size() const {
+            return count;
+        }
+
+    private:
+        typedef std::tuple<typename std::decay<Args>::type...> Key;
+
+        struct Slot {
+            Key key;
+            Value value;
+            bool used = false;
+        };
+
+        template<typename... Values>
+        std::uint64_t Hash(const Values &... values) const {
+            std::uint64_t hash = seed;
+            ((hash = Mix(hash ^ HashOf(values))), ...);
+            return hash;
+        }
+
+        void Insert(Key key, const Value &value) {
+            std::size_t mask = slots.size() - 1;
+            std::size_t i = std::apply([this](const auto &... args) { return Hash(args...); }, key) & mask;
+            for (; slots[i].used; i = (i + 1) & mask) {
+                if (slots[i].key == key) {
+                    slots[i].value = value;
+                    return;
+                }
+            }
+            slots[i].key = std::move(key);
+            slots[i].value = value;
+            slots[i].used = true;
+            count++;
+        }
+
+        void Grow() {
+            std::vector<Slot> old(slots.size() * 2);
+            old.swap(slots);
+            count = 0;
+            for (auto &slot: old)
+                if (slot.used)
+                    Insert(std::move(slot.key), slot.value);
+        }
+
+        std::vector<Slot> slots;
+        std::size_t count = 0;
+        std::uint64_t seed;
+    };
+
+}
+
+#endif //TONIC_RUNTIME_MEMO_H
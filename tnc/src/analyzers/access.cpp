@@ -0,0 +1,371 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the access pattern analysis and loop interchange
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_set>
+#include <utility>
+
+#include "analyzers/access.h"
+#include "analyzers/interval.h"
+#include "analyzers/loop_bounds.h"
+#include "core/children.h"
+#include "core/hash.h"
+
+namespace tonic {
+
+    namespace {
+
+        const std::unordered_set<std::string> JUMPS = {"break", "continue", "return", "goto"};
+
+        // updates of an array element that commute with each other, as the scalar reductions do
+        const std::unordered_set<std::string> REDUCTIONS = {"+=", "-=", "*="};
+
+        // operations of the compound assignments that accumulate a scalar in any order
+        constexpr std::string_view SCALAR_REDUCTIONS = "+-*&|^";
+
+        // member functions that only read the container they are called on
+        const std::unordered_set<std::string> READ_MEMBERS = {"size", "length", "empty", "count", "find", "at"};
+
+        bool Mentions(const std::string &expression, Atom name) {
+            std::vector<Atom> names = ExpressionNames(expression);
+            return std::find(names.begin(), names.end(), name) != names.end();
+        }
+
+        struct BodyFacts {
+            std::vector<std::string> statements;
+            std::unordered_set<Atom> declared; // locals of the body, private to an iteration
+            bool loops = false;
+            bool io = false;
+        };
+
+        void Collect(const Node &node, BodyFacts &facts) {
+            DispatchNode(node, [&](const auto &concrete) {
+                using Type = std::decay_t<decltype(concrete)>;
+
+                if constexpr (std::is_same_v<Type, ForLoop> || std::is_same_v<Type, RangedLoop> ||
+                              std::is_same_v<Type, WhileLoop>) {
+                    facts.loops = true;
+                } else if constexpr (std::is_same_v<Type, InputOutput>) {
+                    facts.io = true;
+                } else if constexpr (std::is_same_v<Type, GeneralStatement>) {
+                    facts.statements.push_back(concrete.statement);
+                } else if constexpr (std::is_same_v<Type, VariableDeclaration>) {
+                    if (concrete.identifier)
+                        facts.declared.insert(Atom(concrete.identifier->statement));
+                    if (concrete.initializer)
+                        Collect(*concrete.initializer, facts);
+                } else {
+                    ForEachTypedChildSlot(concrete, [&](const auto &child) {
+                        if (child)
+                            Collect(*child, facts);
+                    });
+                }
+            });
+        }
+
+        // the operator of "a [ k ] + = e" when e does not read a, 0 for any other statement
+        char Reduction(const std::vector<std::string> &tokens) {
+            if (tokens.size() < 2 || !IsName(tokens[0]) || tokens[1] != "[")
+                return 0;
+
+            size_t position = 1;
+            for (int depth = 0; position < tokens.size(); position++) {
+                if (tokens[position] == "[" || tokens[position] == "(")
+                    depth++;
+                else if (tokens[position] == "]" || tokens[position] == ")")
+                    depth--;
+                else if (depth == 0)
+                    break;
+            }
+
+            if (position + 1 >= tokens.size() || !REDUCTIONS.contains(tokens[position]))
+                return 0;
+            for (size_t i = position + 1; i < tokens.size(); i++)
+                if (tokens[i] == tokens[0])
+                    return 0;
+            return tokens[position][0];
+        }
+
+        // a subscript such as "i", "i + 1" or "n - i", which takes a different value for every value of the index
+        bool Offsets(const std::string &subscript, Atom index) {
+            size_t mentions = 0;
+            for (const auto &token: TokenizeExpression(subscript)) {
+                if (token == index.Text())
+                    mentions++;
+                else if (token != "+" && token != "-" && !std::all_of(token.begin(), token.end(), [](char c) {
+                    return std::isdigit(static_cast<unsigned char>(c));
+                }))
+                    return false;
+            }
+            return mentions == 1;
+        }
+
+        // the access names a different element in every iteration of the two loops
+        bool OneToOne(const ArrayAccess &access, Atom outer_index, Atom inner_index) {
+            auto offsets = [&](Atom index) {
+                return std::any_of(access.subscripts.begin(), access.subscripts.end(), [&](const std::string &subscript) {
+                    return Offsets(subscript, index);
+                });
+            };
+            return offsets(outer_index) && offsets(inner_index);
+        }
+
+        std::string Describe(const ArrayAccess &access) {
+            std::string text = access.array.Text();
+            for (const auto &subscript: access.subscripts)
+                text += " [ " + subscript + " ]";
+            return text;
+        }
+
+        // why swapping the loops could change the result, empty when it cannot
+        std::string Illegal(const ForLoop &outer, const ForLoop &inner, const BodyFacts &facts) {
+            Atom outer_index(outer.identifier->statement), inner_index(inner.identifier->statement);
+
+            for (const auto &bound: {inner.start, inner.end, inner.step})
+                if (bound && Mentions(bound->statement, outer_index))
+                    return "the bounds of `" + inner_index.Text() + "` depend on `" + outer_index.Text() + "`";
+            if (facts.io)
+                return "the body does input or output";
+
+            std::vector<ArrayAccess> accesses;
+            std::vector<char> reductions; // per access, the operator when it is the target of a reduction
+            for (const auto &statement: facts.statements) {
+                std::vector<std::string> tokens = TokenizeExpression(statement);
+                for (size_t i = 0; i < tokens.size(); i++) {
+                    if (JUMPS.contains(tokens[i]))
+                        return "the body leaves the loops early";
+                    bool pure = IsMember(tokens, i) ? READ_MEMBERS.contains(tokens[i]) : IsPureCall(tokens[i]);
+                    if (IsName(tokens[i]) && i + 1 < tokens.size() && tokens[i + 1] == "(" && !pure)
+                        return "the body calls `" + tokens[i] + "`";
+                }
+
+                char reduction = Reduction(tokens);
+                for (auto &access: FindAccesses(statement)) {
+                    reductions.push_back(access.write ? std::exchange(reduction, 0) : 0);
+                    accesses.push_back(std::move(access));
+                }
+            }
+            // checked after the calls, which are the more specific reason a bound is not invariant
+            if (!outer.bounds_invariant || !inner.bounds_invariant)
+                return "the loop bounds change inside the loops";
+
+            // a written array must be a different element in every iteration and the same element in every
+            // access, so each iteration keeps to itself, unless the array is only updated by one reduction
+            for (size_t i = 0; i < accesses.size(); i++) {
+                const ArrayAccess &write = accesses[i];
+                if (!write.write)
+                    continue;
+
+                if (reductions[i]) {
+                    for (size_t j = 0; j < accesses.size(); j++)
+                        if (accesses[j].array == write.array && reductions[j] != reductions[i])
+                            return "`" + write.array.Text() + "` is updated at " + Describe(write) +
+                                   " and accessed at " + Describe(accesses[j]);
+                    continue;
+                }
+
+                if (!OneToOne(write, outer_index, inner_index))
+                    return "`" + write.array.Text() + "` is written at " + Describe(write) +
+                           ", the same element in different iterations";
+                for (const auto &access: accesses)
+                    if (access.array == write.array && access.subscripts != write.subscripts)
+                        return "`" + write.array.Text() + "` is written at " + Describe(write) + " and accessed at " +
+                               Describe(access);
+            }
+
+            // scalars outside the body may only accumulate, as in s += a [ j ] [ i ], array elements are
+            // the accesses above
+            for (size_t i = 0; i < facts.statements.size(); i++) {
+                std::vector<std::string> tokens = TokenizeExpression(facts.statements[i]);
+                std::optional<Assignment> assignment = SplitAssignment(facts.statements[i]);
+
+                for (size_t k = 0; k < tokens.size(); k++) {
+                    bool element = k + 1 < tokens.size() && tokens[k + 1] == "[";
+                    if (!IsWritten(tokens, k) || element || facts.declared.contains(Atom(tokens[k])))
+                        continue;
+
+                    Atom target(tokens[k]);
+                    if (target == outer_index || target == inner_index)
+                        return "the body changes the loop index `" + target.Text() + "`";
+
+                    // a write inside a larger expression, as in if ( ( s < < = 1 ) > m ), is not followed
+                    if (!assignment || assignment->target != target)
+                        return "`" + target.Text() + "` is written in `" + facts.statements[i] + "`";
+                    if (SCALAR_REDUCTIONS.find(assignment->operation) == std::string_view::npos)
+                        return "`" + target.Text() + "` is assigned in the body";
+                    if (Mentions(assignment->value, target))
+                        return "`" + target.Text() + "` is read and updated in the body";
+
+                    for (size_t j = 0; j < facts.statements.size(); j++) {
+                        if (i == j)
+                            continue;
+                        std::optional<Assignment> other = SplitAssignment(facts.statements[j]);
+                        bool same_reduction = other && other->target == target &&
+                                              other->operation == assignment->operation;
+                        if (!same_reduction && Mentions(facts.statements[j], target))
+                            return "`" + target.Text() + "` is read and updated in the body";
+                    }
+                }
+            }
+
+            return "";
+        }
+
+    }
+
+    std::vector<ArrayAccess> FindAccesses(const std::string &statement) {
+        std::vector<std::string> tokens = TokenizeExpression(statement);
+        std::vector<ArrayAccess> accesses;
+
+        for (size_t i = 0; i + 1 < tokens.size(); i++) {
+            if (!IsName(tokens[i]) || tokens[i + 1] != "[" || IsMember(tokens, i))
+                continue;
+
+            ArrayAccess access{Atom(tokens[i]), {}, false};
+            size_t position = i + 1;
+            while (position < tokens.size() && tokens[position] == "[") {
+                std::string subscript;
+                int depth = 0;
+                for (; position < tokens.size(); position++) {
+                    if (tokens[position] == "[" || tokens[position] == "(")
+                        depth++;
+                    else if ((tokens[position] == "]" || tokens[position] == ")") && --depth == 0)
+                        break;
+                    if (depth > 1 || (depth == 1 && tokens[position] != "["))
+                        subscript += (subscript.empty() ? "" : " ") + tokens[position];
+                }
+                access.subscripts.push_back(std::move(subscript));
+                ++position;
+            }
+
+            access.write = (position < tokens.size() && IsAssignmentOperator(tokens[position])) ||
+                           (i > 0 && (tokens[i - 1] == "++" || tokens[i - 1] == "--"));
+            accesses.push_back(std::move(access));
+        }
+
+        return accesses;
+    }
+
+    bool IsStrided(const ArrayAccess &access, Atom index) {
+        for (size_t i = 0; i + 1 < access.subscripts.size(); i++)
+            if (Mentions(access.subscripts[i], index))
+                return true;
+        return false;
+    }
+
+    std::shared_ptr<ForLoop> Interchange(const ForLoop &outer) {
+        const auto &inner = static_cast<const ForLoop &>(*outer.block->body[0]);
+
+        auto new_inner = std::static_pointer_cast<ForLoop>(ShallowCopy(outer));
+        new_inner->block = inner.block;
+
+        auto block = std::static_pointer_cast<Block>(ShallowCopy(*outer.block));
+        block->body = {new_inner};
+
+        auto new_outer = std::static_pointer_cast<ForLoop>(ShallowCopy(inner));
+        new_outer->block = block;
+        return new_outer;
+    }
+
+    AccessAnalysis::AccessAnalysis(Diagnostics &diagnostics) : diagnostics(diagnostics) {}
+
+    void AccessAnalysis::Run(Program &program) {
+        LoopBoundsAnalysis().Run(program);
+
+        AstPath path;
+        interchanges.clear();
+        Walk(program, path);
+
+        // the nests may be shared with other versions of the tree, so only the path down to them is copied
+        for (const auto &[nest_path, replacement]: interchanges) {
+            AstPath below(nest_path.begin() + 1, nest_path.end());
+            SetChild(program, nest_path[0], PathCopy(GetChild(program, nest_path[0]), below, replacement));
+        }
+        if (!interchanges.empty() && program.hash != 0)
+            RehashNode(program);
+    }
+
+    const std::vector<NestReport> &AccessAnalysis::Nests() const {
+        return nests;
+    }
+
+    void AccessAnalysis::Walk(Node &node, AstPath &path) {
+        for (size_t i = 0; i < ChildCount(node); i++) {
+            std::shared_ptr<Node> child = GetChild(node, i);
+            if (!child)
+                continue;
+
+            path.push_back(i);
+            if (child->kind == NodeKind::FOR_LOOP) {
+                if (auto replacement = Examine(std::static_pointer_cast<ForLoop>(child))) {
+                    interchanges.emplace_back(path, replacement);
+                    child = replacement;
+                }
+            }
+            Walk(*child, path);
+            path.pop_back();
+        }
+    }
+
+    std::shared_ptr<ForLoop> AccessAnalysis::Examine(const std::shared_ptr<ForLoop> &outer) {
+        if (!outer->identifier || !outer->block || outer->block->body.size() != 1 || !outer->block->body[0] ||
+            outer->block->body[0]->kind != NodeKind::FOR_LOOP)
+            return nullptr;
+
+        const auto &inner = static_cast<const ForLoop &>(*outer->block->body[0]);
+        if (!inner.identifier || !inner.block)
+            return nullptr;
+
+        BodyFacts facts;
+        Collect(*inner.block, facts);
+        if (facts.loops)
+            return nullptr; // only the innermost pair decides the stride
+
+        Atom outer_index(outer->identifier->statement), inner_index(inner.identifier->statement);
+        NestReport report{outer.get(), &inner, 0, 0, {}, false, ""};
+
+        for (const auto &statement: facts.statements) {
+            for (const auto &access: FindAccesses(statement)) {
+                bool strided = IsStrided(access, inner_index), strided_swapped = IsStrided(access, outer_index);
+                report.strided += strided;
+                report.strided_swapped += strided_swapped;
+                if (strided && !strided_swapped &&
+                    std::find(report.arrays.begin(), report.arrays.end(), access.array) == report.arrays.end())
+                    report.arrays.push_back(access.array);
+            }
+        }
+
+        if (report.strided_swapped >= report.strided) {
+            nests.push_back(std::move(report));
+            return nullptr;
+        }
+
+        std::string arrays;
+        for (size_t i = 0; i < report.arrays.size(); i++)
+            arrays += (i ? ", `" : "`") + report.arrays[i].Text() + "`";
+
+        report.reason = Illegal(*outer, inner, facts);
+        report.interchanged = report.reason.empty();
+        originals.push_back(outer);
+
+        if (report.interchanged) {
+            diagnostics.Note("access", "loops over `" + outer_index.Text() + "` and `" + inner_index.Text() +
+                                       "` are interchanged so " + arrays + " is walked along its rows", outer->line);
+        } else {
+            diagnostics.Warning("access", arrays + " is walked column by column, making `" + inner_index.Text() +
+                                          "` the outer loop would walk it along its rows, but " + report.reason,
+                                outer->line);
+        }
+
+        bool interchanged = report.interchanged;
+        nests.push_back(std::move(report));
+        return interchanged ? Interchange(*outer) : nullptr;
+    }
+
+}
@@ -0,0 +1,851 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the time complexity estimate
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <set>
+#include <sstream>
+
+#include "analyzers/complexity.h"
+#include "core/children.h"
+
+namespace tonic {
+
+    namespace {
+
+        // terms kept before dominated ones are pruned, keeps products of long sums small
+        constexpr size_t MAX_TERMS = 32;
+
+        // a loop that halves or doubles a 64-bit value runs at most this many times
+        constexpr double HALVING_LIMIT = 64;
+
+        constexpr double EPSILON = 1e-9;
+
+        bool SameMonomial(const Cost::Term &first, const Cost::Term &second) {
+            return first.powers == second.powers && first.logs == second.logs && first.base == second.base &&
+                   first.exponential == second.exponential;
+        }
+
+        bool HasSymbols(const Cost::Term &term) {
+            return !term.powers.empty() || !term.logs.empty() || term.base > 1;
+        }
+
+        bool Mentions(const Cost::Term &term, Atom name) {
+            return term.powers.contains(name) || term.logs.contains(name) || (term.base > 1 && term.exponential == name);
+        }
+
+        // true when first grows at least as fast as second in every symbol
+        bool Dominates(const Cost::Term &first, const Cost::Term &second) {
+            if (second.base > 1 && (first.base < second.base || first.exponential != second.exponential))
+                return false;
+
+            for (const auto &[name, power]: second.powers) {
+                if (first.base > 1 && first.exponential == name)
+                    continue;
+                auto found = first.powers.find(name);
+                if (found == first.powers.end() || found->second < power - EPSILON)
+                    return false;
+            }
+
+            for (const auto &[name, exponent]: second.logs) {
+                if (first.base > 1 && first.exponential == name)
+                    continue;
+                double first_power = first.powers.contains(name) ? first.powers.at(name) : 0;
+                double second_power = second.powers.contains(name) ? second.powers.at(name) : 0;
+                if (first_power > second_power + EPSILON)
+                    continue;
+                auto found = first.logs.find(name);
+                if (found == first.logs.end() || found->second < exponent)
+                    return false;
+            }
+
+            // an exponential only dominates terms over its own symbols
+            if (first.base > 1 && second.base <= 1) {
+                for (const auto &[name, power]: second.powers)
+                    if (!Mentions(first, name))
+                        return false;
+            }
+
+            return true;
+        }
+
+        std::string FormatNumber(double value) {
+            std::ostringstream stream;
+            stream << value;
+            return stream.str();
+        }
+
+        std::string FormatTerm(const Cost::Term &term) {
+            std::vector<std::string> factors;
+
+            if (term.base > 1)
+                factors.push_back(FormatNumber(term.base) + "^" + term.exponential.Text());
+            for (const auto &[name, power]: term.powers) {
+                if (std::abs(power - 1) < EPSILON)
+                    factors.push_back(name.Text());
+                else if (std::abs(power - 0.5) < EPSILON)
+                    factors.push_back("sqrt " + name.Text());
+                else
+                    factors.push_back(name.Text() + "^" + FormatNumber(power));
+            }
+            for (const auto &[name, exponent]: term.logs)
+                factors.push_back(exponent == 1 ? "log " + name.Text() : "log^" + std::to_string(exponent) + " " + name.Text());
+
+            if (factors.empty())
+                return "1";
+
+            std::string text = factors[0];
+            for (size_t i = 1; i < factors.size(); i++)
+                text += "·" + factors[i];
+            return text;
+        }
+
+        // 12345 for small counts, 2.0e10 for large ones
+        std::string FormatCount(double count) {
+            if (count < 1e4)
+                return std::to_string(static_cast<long long>(std::ceil(count)));
+
+            char buffer[32];
+            int exponent = static_cast<int>(std::floor(std::log10(count)));
+            std::snprintf(buffer, sizeof(buffer), "%.1fe%d", count / std::pow(10.0, exponent), exponent);
+            return buffer;
+        }
+
+        std::optional<double> ConstantValue(const std::string &token) {
+            if (token.empty() || !std::isdigit(static_cast<unsigned char>(token[0])))
+                return std::nullopt;
+
+            Evaluation evaluation = EvaluateInterval(token, [](Atom) { return std::nullopt; });
+            if (evaluation.kind != ValueKind::INTEGER || evaluation.value.low != evaluation.value.high)
+                return std::nullopt;
+            return evaluation.value.low;
+        }
+
+        // calls of the form "name ( ... )" in a statement, with their top-level arguments
+        struct Call {
+            Atom name;
+            std::vector<std::string> arguments;
+        };
+
+        std::vector<Call> FindCalls(const std::string &statement) {
+            std::vector<std::string> tokens = TokenizeExpression(statement);
+            std::vector<Call> calls;
+
+            for (size_t i = 0; i + 1 < tokens.size(); i++) {
+                if (!IsName(tokens[i]) || tokens[i + 1] != "(")
+                    continue;
+                if (IsMember(tokens, i))
+                    continue;
+
+                Call call{Atom(tokens[i]), {}};
+                std::string argument;
+                int depth = 0;
+                for (size_t j = i + 2; j < tokens.size(); j++) {
+                    const std::string &token = tokens[j];
+                    if (depth == 0 && (token == ")" || token == ",")) {
+                        if (!argument.empty())
+                            call.arguments.push_back(argument);
+                        argument.clear();
+                        if (token == ")")
+                            break;
+                        continue;
+                    }
+                    if (token == "(" || token == "[" || token == "{")
+                        depth++;
+                    else if (token == ")" || token == "]" || token == "}")
+                        depth--;
+                    argument += argument.empty() ? token : " " + token;
+                }
+                calls.push_back(std::move(call));
+            }
+
+            return calls;
+        }
+
+        // texts of every general statement under a node, in walking order
+        void CollectStatements(const Node &node, std::vector<std::string> &statements) {
+            DispatchNode(node, [&](const auto &concrete) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(concrete)>, GeneralStatement>)
+                    statements.push_back(concrete.statement);
+                ForEachTypedChildSlot(concrete, [&](const auto &child) {
+                    if (child)
+                        CollectStatements(*child, statements);
+                });
+            });
+        }
+
+        // "x /= 2", "x = x >> 1", "mid = ( lo + hi ) / 2" and the doubling counterparts
+        bool HalvesOrDoubles(const std::string &statement) {
+            std::optional<Assignment> assignment = SplitAssignment(statement);
+            if (!assignment)
+                return false;
+
+            std::vector<std::string> tokens = TokenizeExpression(assignment->value);
+            if (assignment->operation == '*' || assignment->operation == '/') {
+                std::optional<double> factor = tokens.size() == 1 ? ConstantValue(tokens[0]) : std::nullopt;
+                return factor && *factor >= 2;
+            }
+
+            for (size_t i = 0; i + 1 < tokens.size(); i++) {
+                const std::string &token = tokens[i];
+                std::optional<double> factor = ConstantValue(tokens[i + 1]);
+                if ((token == ">>" || token == "<<") && factor && *factor >= 1)
+                    return true;
+                if ((token == "/" || token == "*") && factor && *factor >= 2)
+                    return true;
+            }
+            return false;
+        }
+
+    }
+
+    Cost Cost::Constant(double value) {
+        Cost cost;
+        if (value != 0)
+            cost.terms.push_back({value, {}, {}, 1, {}});
+        return cost;
+    }
+
+    Cost Cost::Symbol(Atom name) {
+        Cost cost;
+        cost.terms.push_back({1, {{name, 1.0}}, {}, 1, {}});
+        return cost;
+    }
+
+    Cost Cost::Log(Atom name) {
+        Cost cost;
+        cost.terms.push_back({1, {}, {{name, 1}}, 1, {}});
+        return cost;
+    }
+
+    Cost Cost::Exponential(double base, Atom name) {
+        if (base <= 1)
+            return Constant(1);
+
+        Cost cost;
+        cost.terms.push_back({1, {}, {}, base, name});
+        return cost;
+    }
+
+    Cost Cost::operator+(const Cost &other) const {
+        Cost sum = *this;
+        for (const auto &term: other.terms)
+            sum.Add(term);
+        return sum;
+    }
+
+    Cost Cost::operator*(const Cost &other) const {
+        Cost product;
+
+        for (const auto &first: terms) {
+            for (const auto &second: other.terms) {
+                Term term = first;
+                term.coefficient *= second.coefficient;
+                for (const auto &[name, power]: second.powers)
+                    term.powers[name] += power;
+                for (const auto &[name, exponent]: second.logs)
+                    term.logs[name] += exponent;
+
+                // 2^n * 3^n is 6^n, exponentials of different symbols keep the larger one
+                if (second.base > 1) {
+                    if (term.base <= 1) {
+                        term.base = second.base;
+                        term.exponential = second.exponential;
+                    } else if (term.exponential == second.exponential) {
+                        term.base *= second.base;
+                    } else if (second.base > term.base) {
+                        term.base = second.base;
+                        term.exponential = second.exponential;
+                    }
+                }
+                product.Add(term);
+            }
+        }
+
+        return product;
+    }
+
+    Cost Cost::Scaled(double factor) const {
+        Cost scaled;
+        for (Term term: terms) {
+            term.coefficient *= factor;
+            scaled.Add(term);
+        }
+        return scaled;
+    }
+
+    Cost Cost::Power(double power) const {
+        Cost raised;
+        for (Term term: terms) {
+            term.coefficient = std::pow(term.coefficient, power);
+            for (auto &[name, exponent]: term.powers)
+                exponent *= power;
+            for (auto &[name, exponent]: term.logs)
+                exponent = std::max(1, static_cast<int>(std::lround(exponent * power)));
+            if (term.base > 1)
+                term.base = std::pow(term.base, power);
+            raised.Add(term);
+        }
+        return raised;
+    }
+
+    const std::vector<Cost::Term> &Cost::Terms() const {
+        return terms;
+    }
+
+    double Cost::PowerOf(Atom name) const {
+        double power = 0;
+        for (const auto &term: terms) {
+            auto found = term.powers.find(name);
+            if (found != term.powers.end())
+                power = std::max(power, found->second);
+        }
+        return power;
+    }
+
+    std::string Cost::ToString() const {
+        std::set<std::string> shown;
+
+        for (size_t i = 0; i < terms.size(); i++) {
+            bool dominated = false;
+            for (size_t j = 0; j < terms.size() && !dominated; j++)
+                dominated = i != j && HasSymbols(terms[j]) && Dominates(terms[j], terms[i]);
+            if (!dominated)
+                shown.insert(FormatTerm(terms[i]));
+        }
+
+        if (shown.empty())
+            return "O(1)";
+
+        std::string text;
+        for (const auto &term: shown)
+            text += (text.empty() ? "" : " + ") + term;
+        return "O(" + text + ")";
+    }
+
+    std::optional<double> Cost::Estimate(const Constraints &constraints) const {
+        double total = 0;
+
+        for (const auto &term: terms) {
+            double value = term.coefficient;
+            for (const auto &[name, power]: term.powers) {
+                std::optional<double> bound = UpperBound(constraints, name);
+                if (!bound)
+                    return std::nullopt;
+                value *= std::pow(std::max(*bound, 1.0), power);
+            }
+            for (const auto &[name, exponent]: term.logs) {
+                std::optional<double> bound = UpperBound(constraints, name);
+                if (!bound)
+                    return std::nullopt;
+                value *= std::pow(std::log2(std::max(*bound, 2.0)), exponent);
+            }
+            if (term.base > 1) {
+                std::optional<double> bound = UpperBound(constraints, term.exponential);
+                if (!bound)
+                    return std::nullopt;
+                value *= std::pow(term.base, *bound);
+            }
+            total += value;
+        }
+
+        return total;
+    }
+
+    std::vector<Atom> Cost::Unbounded(const Constraints &constraints) const {
+        std::set<Atom, ByText> unbounded;
+
+        auto check = [&](Atom name) {
+            if (!UpperBound(constraints, name))
+                unbounded.insert(name);
+        };
+
+        for (const auto &term: terms) {
+            for (const auto &[name, power]: term.powers)
+                check(name);
+            for (const auto &[name, exponent]: term.logs)
+                check(name);
+            if (term.base > 1)
+                check(term.exponential);
+        }
+
+        return {unbounded.begin(), unbounded.end()};
+    }
+
+    void Cost::Add(const Term &term) {
+        if (term.coefficient == 0)
+            return;
+
+        for (auto &existing: terms) {
+            if (SameMonomial(existing, term)) {
+                existing.coefficient += term.coefficient;
+                return;
+            }
+        }
+        terms.push_back(term);
+
+        if (terms.size() <= MAX_TERMS)
+            return;
+
+        std::vector<Term> kept;
+        for (size_t i = 0; i < terms.size(); i++) {
+            bool dominated = false;
+            for (size_t j = 0; j < terms.size() && !dominated; j++)
+                dominated = i != j && HasSymbols(terms[j]) && Dominates(terms[j], terms[i]);
+            if (!dominated)
+                kept.push_back(terms[i]);
+        }
+        terms = std::move(kept);
+    }
+
+    Cost ExpressionCost(const std::string &expression, const NameCost &resolve) {
+        std::vector<std::string> tokens = TokenizeExpression(expression);
+        size_t position = 0;
+
+        auto peek = [&]() -> const std::string & {
+            static const std::string END;
+            return position < tokens.size() ? tokens[position] : END;
+        };
+
+        std::function<Cost()> sum;
+
+        auto arguments = [&]() {
+            std::vector<Cost> values;
+            ++position; // (
+            while (position < tokens.size() && peek() != ")") {
+                values.push_back(sum());
+                if (peek() == ",")
+                    ++position;
+                else if (peek() != ")")
+                    break;
+            }
+            ++position; // )
+            return values;
+        };
+
+        auto factor = [&]() -> Cost {
+            std::string token = peek();
+            ++position;
+
+            if (token == "(") {
+                Cost inner = sum();
+                ++position;
+                return inner;
+            }
+            if (token == "-" || token == "+")
+                return Cost::Symbol(UNKNOWN_SYMBOL);
+            if (std::optional<double> value = ConstantValue(token))
+                return Cost::Constant(*value);
+            if (!IsName(token))
+                return Cost::Symbol(UNKNOWN_SYMBOL);
+
+            if (peek() == "(") {
+                std::vector<Cost> values = arguments();
+                if (values.empty())
+                    return Cost::Symbol(UNKNOWN_SYMBOL);
+                if (token == "sqrt" || token == "sqrtl")
+                    return values[0].Power(0.5);
+                if (token == "log" || token == "log2" || token == "__lg" || token == "lg") {
+                    const auto &terms = values[0].Terms();
+                    if (!terms.empty() && !terms[0].powers.empty())
+                        return Cost::Log(terms[0].powers.begin()->first);
+                    return Cost::Constant(1);
+                }
+                if (token == "max") {
+                    Cost total = Cost::Constant(0);
+                    for (const auto &value: values)
+                        total = total + value;
+                    return total;
+                }
+                if (token == "min" || token == "abs")
+                    return values[0];
+                return Cost::Symbol(UNKNOWN_SYMBOL);
+            }
+
+            // v . size ( ), s . length ( ) and adj [ u ] are all as large as the container
+            Cost value = resolve(Atom(token));
+            while (peek() == "." || peek() == "->" || peek() == "[") {
+                if (peek() == "[") {
+                    int depth = 0;
+                    do {
+                        if (peek() == "[")
+                            depth++;
+                        else if (peek() == "]")
+                            depth--;
+                        ++position;
+                    } while (position < tokens.size() && depth > 0);
+                } else {
+                    position += 2;
+                    if (peek() == "(")
+                        arguments();
+                }
+            }
+            return value;
+        };
+
+        auto product = [&]() {
+            Cost value = factor();
+            while (peek() == "*" || peek() == "/" || peek() == "%" || peek() == "<<" || peek() == ">>") {
+                std::string operation = peek();
+                ++position;
+                Cost right = factor();
+
+                const auto &terms = right.Terms();
+                std::optional<double> constant;
+                if (terms.empty())
+                    constant = 0;
+                else if (terms.size() == 1 && !HasSymbols(terms[0]))
+                    constant = terms[0].coefficient;
+
+                if (operation == "*") {
+                    value = value * right;
+                } else if (operation == "/") {
+                    if (constant && *constant > 0)
+                        value = value.Scaled(1 / *constant);
+                } else if (operation == "%") {
+                    value = right; // x % m stays below m
+                } else if (operation == "<<") {
+                    if (constant)
+                        value = value.Scaled(std::pow(2, *constant));
+                    else if (terms.size() == 1 && terms[0].powers.size() == 1)
+                        value = value * Cost::Exponential(2, terms[0].powers.begin()->first);
+                    else
+                        value = Cost::Symbol(UNKNOWN_SYMBOL);
+                } else if (constant) {
+                    value = value.Scaled(std::pow(2, -*constant));
+                }
+            }
+            return value;
+        };
+
+        sum = [&]() {
+            Cost value = product();
+            while (peek() == "+" || peek() == "-") {
+                bool add = peek() == "+";
+                ++position;
+                Cost right = product();
+                if (add)
+                    value = value + right; // subtracting only lowers the count, the bound stays
+            }
+            return value;
+        };
+
+        if (tokens.empty())
+            return Cost::Symbol(UNKNOWN_SYMBOL);
+        return sum();
+    }
+
+    ComplexityAnalysis::ComplexityAnalysis(Diagnostics &diagnostics, Constraints constraints, double budget)
+            : diagnostics(diagnostics), constraints(std::move(constraints)), budget(budget) {}
+
+    void ComplexityAnalysis::Run(Program &program) {
+        bounds.Run(program);
+
+        std::vector<const FunctionDeclaration *> declarations;
+        std::function<void(const Node &)> collect = [&](const Node &node) {
+            DispatchNode(node, [&](const auto &concrete) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(concrete)>, FunctionDeclaration>) {
+                    if (concrete.name) {
+                        functions[Atom(concrete.name->statement)] = &concrete;
+                        declarations.push_back(&concrete);
+                    }
+                }
+                ForEachTypedChildSlot(concrete, [&](const auto &child) {
+                    if (child)
+                        collect(*child);
+                });
+            });
+        };
+        collect(program);
+
+        for (const auto *function: declarations)
+            FunctionCost(*function);
+
+        Context context;
+        Cost main = Cost::Constant(0);
+        bool has_statements = false;
+        for (const auto &statement: program.body) {
+            if (!statement || statement->kind == NodeKind::FUNCTION_DECLARATION)
+                continue;
+            main = main + NodeCost(*statement, context);
+            has_statements = true;
+        }
+
+        if (has_statements)
+            Report(function_reports, "main", program, main, !context.warned);
+    }
+
+    const std::vector<ComplexityReport> &ComplexityAnalysis::Functions() const {
+        return function_reports;
+    }
+
+    const std::vector<ComplexityReport> &ComplexityAnalysis::LoopNests() const {
+        return loop_reports;
+    }
+
+    Cost ComplexityAnalysis::NodeCost(const Node &node, Context &context) {
+        return DispatchNode(node, [&](const auto &concrete) -> Cost {
+            using Type = std::decay_t<decltype(concrete)>;
+
+            if constexpr (std::is_same_v<Type, GeneralStatement>) {
+                return StatementCost(concrete.statement);
+            } else if constexpr (std::is_same_v<Type, FunctionDeclaration> || std::is_same_v<Type, LambdaExpression>) {
+                return Cost::Constant(0); // costed where it is called
+            } else if constexpr (std::is_same_v<Type, ForLoop>) {
+                Cost trips = Cost::Symbol(UNKNOWN_SYMBOL);
+                if (concrete.trip_count) {
+                    trips = Cost::Constant(static_cast<double>(*concrete.trip_count));
+                } else {
+                    const auto &bound = concrete.step_sign < 0 ? concrete.start : concrete.end;
+                    if (bound)
+                        trips = ExpressionCost(bound->statement, context);
+
+                    std::optional<double> step;
+                    if (concrete.step)
+                        step = ConstantValue(concrete.step->statement.starts_with('-') ? concrete.step->statement.substr(1)
+                                                                                   : concrete.step->statement);
+                    if (step && *step > 1)
+                        trips = trips.Scaled(1 / *step);
+                }
+
+                if (concrete.identifier)
+                    context.indices.emplace_back(Atom(concrete.identifier->statement), trips);
+                Cost cost = LoopCost(concrete, trips, concrete.block.get(), context);
+                if (concrete.operation)
+                    cost = cost + trips * StatementCost(concrete.operation->statement);
+                if (concrete.identifier)
+                    context.indices.pop_back();
+                return cost;
+            } else if constexpr (std::is_same_v<Type, RangedLoop>) {
+                Cost trips = concrete.object ? ExpressionCost(concrete.object->statement, context)
+                                             : Cost::Symbol(UNKNOWN_SYMBOL);
+                Cost cost = LoopCost(concrete, trips, concrete.block.get(), context);
+                if (concrete.operation)
+                    cost = cost + trips * StatementCost(concrete.operation->statement);
+                return cost;
+            } else if constexpr (std::is_same_v<Type, WhileLoop>) {
+                return LoopCost(concrete, WhileTrips(concrete, context), concrete.block.get(), context);
+            } else {
+                Cost cost = Cost::Constant(0);
+                ForEachTypedChildSlot(concrete, [&](const auto &child) {
+                    if (child)
+                        cost = cost + NodeCost(*child, context);
+                });
+                return cost;
+            }
+        });
+    }
+
+    Cost ComplexityAnalysis::StatementCost(const std::string &statement) {
+        Cost cost = Cost::Constant(1);
+
+        for (const auto &call: FindCalls(statement)) {
+            auto found = functions.find(call.name);
+            if (found == functions.end() || found->second == current)
+                continue; // library calls count as one operation, self calls are solved as recursion
+
+            cost = cost + FunctionCost(*found->second);
+        }
+
+        return cost;
+    }
+
+    Cost ComplexityAnalysis::LoopCost(const Node &loop, const Cost &trips, const Node *body, Context &context) {
+        context.depth++;
+        Cost body_cost = Cost::Constant(1); // the condition and the increment
+        if (body)
+            body_cost = body_cost + NodeCost(*body, context);
+        context.depth--;
+
+        Cost cost = trips * body_cost;
+        if (context.depth == 0) {
+            std::optional<double> operations = cost.Estimate(constraints);
+            Report(loop_reports, "loop", loop, cost, true);
+            context.warned |= operations && *operations > budget;
+        }
+        return cost;
+    }
+
+    Cost ComplexityAnalysis::FunctionCost(const FunctionDeclaration &function) {
+        if (auto found = function_costs.find(&function); found != function_costs.end())
+            return found->second;
+        if (in_progress.contains(&function))
+            return Cost::Symbol(UNKNOWN_SYMBOL); // mutual recursion is not solved
+
+        in_progress.insert(&function);
+        const FunctionDeclaration *caller = current;
+        current = &function;
+
+        Context context;
+        Cost body = Cost::Constant(1);
+        if (function.block)
+            body = body + NodeCost(*function.block, context);
+        Cost cost = RecursionCost(function, body);
+
+        current = caller;
+        in_progress.erase(&function);
+        function_costs.emplace(&function, cost);
+
+        Report(function_reports, function.name ? function.name->statement : "", function, cost, !context.warned);
+        return cost;
+    }
+
+    Cost ComplexityAnalysis::RecursionCost(const FunctionDeclaration &function, const Cost &body) {
+        if (!function.block || !function.name)
+            return body;
+
+        std::vector<std::string> statements;
+        CollectStatements(*function.block, statements);
+
+        Atom name(function.name->statement);
+        size_t calls = 0;
+        bool subtracts = false, divides = false;
+        double divisor = 0;
+        std::optional<Atom> shrinking;
+        std::set<Atom, Cost::ByText> changed; // parameters that differ between calls, the memoized state
+
+        for (const auto &statement: statements) {
+            for (const auto &call: FindCalls(statement)) {
+                if (call.name != name)
+                    continue;
+                calls++;
+
+                for (const auto &argument: call.arguments) {
+                    std::vector<std::string> tokens = TokenizeExpression(argument);
+                    for (const auto &[parameter, type]: function.arguments) {
+                        if (std::find(tokens.begin(), tokens.end(), parameter.Text()) == tokens.end())
+                            continue;
+                        if (tokens.size() > 1)
+                            changed.insert(parameter);
+
+                        for (size_t i = 0; i + 1 < tokens.size(); i++) {
+                            std::optional<double> amount = ConstantValue(tokens[i + 1]);
+                            if (tokens[i] == "/" && amount && *amount >= 2) {
+                                divides = true;
+                                divisor = divisor == 0 ? *amount : std::min(divisor, *amount);
+                            } else if (tokens[i] == ">>" && amount && *amount >= 1) {
+                                divides = true;
+                                divisor = divisor == 0 ? std::pow(2, *amount) : std::min(divisor, std::pow(2, *amount));
+                            } else if ((tokens[i] == "-" || tokens[i] == "+") && amount) {
+                                subtracts = true;
+                            } else {
+                                continue;
+                            }
+                            if (!shrinking)
+                                shrinking = parameter;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (calls == 0)
+            return body;
+
+        if (function.is_memoize) {
+            Cost states = Cost::Constant(1);
+            for (Atom parameter: changed)
+                states = states * Cost::Symbol(parameter);
+            return states * body;
+        }
+
+        Atom symbol = shrinking ? *shrinking : UNKNOWN_SYMBOL;
+        if (divides && !subtracts) {
+            // master theorem for T(n) = calls * T(n / divisor) + body
+            double critical = std::log(static_cast<double>(calls)) / std::log(divisor);
+            double power = body.PowerOf(symbol);
+            if (critical > power + EPSILON)
+                return Cost::Symbol(symbol).Power(critical);
+            if (critical > power - EPSILON)
+                return body * Cost::Log(symbol);
+            return body;
+        }
+
+        if (calls == 1)
+            return Cost::Symbol(symbol) * body;
+        return Cost::Exponential(static_cast<double>(calls), symbol) * body;
+    }
+
+    Cost ComplexityAnalysis::ExpressionCost(const std::string &expression, const Context &context) {
+        return tonic::ExpressionCost(expression, [&](Atom name) {
+            for (auto index = context.indices.rbegin(); index != context.indices.rend(); ++index)
+                if (index->first == name)
+                    return index->second;
+            if (std::optional<int64_t> constant = bounds.ConstantOf(name))
+                return Cost::Constant(static_cast<double>(*constant));
+            return Cost::Symbol(name);
+        });
+    }
+
+    Cost ComplexityAnalysis::WhileTrips(const WhileLoop &loop, const Context &context) {
+        if (!loop.condition)
+            return Cost::Symbol(UNKNOWN_SYMBOL);
+
+        bool logarithmic = false;
+        if (loop.block) {
+            std::vector<std::string> statements;
+            CollectStatements(*loop.block, statements);
+            for (const auto &statement: statements)
+                logarithmic |= HalvesOrDoubles(statement);
+        }
+
+        // only names with a known size say how long the loop runs, locals are counters
+        Cost trips = Cost::Constant(0);
+        bool bounded = false;
+        for (Atom name: ExpressionNames(loop.condition->statement)) {
+            bool parameter = current && std::any_of(current->arguments.begin(), current->arguments.end(),
+                                                    [&](const auto &argument) { return argument.first == name; });
+            bool index = std::any_of(context.indices.begin(), context.indices.end(),
+                                     [&](const auto &entry) { return entry.first == name; });
+            if (!constraints.contains(name) && !parameter && !index)
+                continue;
+
+            trips = trips + (logarithmic ? Cost::Log(name) : Cost::Symbol(name));
+            bounded = true;
+        }
+
+        if (bounded)
+            return trips;
+        return logarithmic ? Cost::Constant(HALVING_LIMIT) : Cost::Symbol(UNKNOWN_SYMBOL);
+    }
+
+    void ComplexityAnalysis::Report(std::vector<ComplexityReport> &reports, std::string name, const Node &node,
+                                    const Cost &cost, bool warn) {
+        std::optional<double> operations = cost.Estimate(constraints);
+        std::string subject = name == "loop" ? "loop nest" : "function `" + name + "`";
+        if (name == "main")
+            subject = "top-level code";
+
+        std::string message = subject + " is " + cost.ToString();
+        if (operations) {
+            message += ", about " + FormatCount(*operations) + " operations";
+        } else {
+            std::vector<Atom> unbounded = cost.Unbounded(constraints);
+            unbounded.erase(std::remove(unbounded.begin(), unbounded.end(), UNKNOWN_SYMBOL), unbounded.end());
+
+            if (unbounded.empty()) {
+                message += ", its operation count could not be bounded";
+            } else {
+                message += ", constrain ";
+                for (size_t i = 0; i < unbounded.size(); i++)
+                    message += (i ? ", `" : "`") + unbounded[i].Text() + "`";
+                message += " to estimate its operation count";
+            }
+        }
+        diagnostics.Note("complexity", message, node.line);
+
+        if (warn && operations && *operations > budget)
+            diagnostics.Warning("complexity", subject + " needs about " + FormatCount(*operations) +
+                                              " operations, over the budget of " + FormatCount(budget), node.line);
+
+        reports.push_back({std::move(name), &node, cost, operations});
+    }
+
+}
@@ -0,0 +1,253 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the constraint parser
+ */
+
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "analyzers/constraints.h"
+
+namespace tonic {
+
+    namespace {
+
+        const std::string_view PREFIX = "constraints:";
+
+        enum class PieceKind {
+            NUMBER,
+            NAME,
+            RELATION,
+        };
+
+        struct Piece {
+            PieceKind kind;
+            double number = 0;
+            Atom name;
+            std::string relation;
+        };
+
+        // a number such as 200000, 2e5, 2*10^5 or 1'000'000 starting at position, advances past it
+        double ScanNumber(std::string_view text, size_t &position) {
+            auto factor = [&]() {
+                std::string digits;
+                while (position < text.size()) {
+                    char c = text[position];
+                    bool sign = (c == '+' || c == '-') && !digits.empty() && (digits.back() == 'e' || digits.back() == 'E');
+                    if (!std::isdigit(static_cast<unsigned char>(c)) && c != '.' && c != 'e' && c != 'E' && c != '\'' &&
+                        !sign)
+                        break;
+                    if (c != '\'')
+                        digits += c;
+                    ++position;
+                }
+
+                double value = std::strtod(digits.c_str(), nullptr);
+                if (position + 1 < text.size() && text[position] == '^' &&
+                    std::isdigit(static_cast<unsigned char>(text[position + 1]))) {
+                    ++position;
+                    size_t start = position;
+                    while (position < text.size() && std::isdigit(static_cast<unsigned char>(text[position])))
+                        ++position;
+                    value = std::pow(value, std::stod(std::string(text.substr(start, position - start))));
+                }
+                return value;
+            };
+
+            double value = factor();
+            while (position + 1 < text.size() && text[position] == '*' &&
+                   std::isdigit(static_cast<unsigned char>(text[position + 1]))) {
+                ++position;
+                value *= factor();
+            }
+            return value;
+        }
+
+        std::vector<Piece> Scan(std::string_view text) {
+            std::vector<Piece> pieces;
+            size_t position = 0;
+
+            while (position < text.size()) {
+                char c = text[position];
+                if (std::isdigit(static_cast<unsigned char>(c))) {
+                    pieces.push_back({PieceKind::NUMBER, ScanNumber(text, position), {}, {}});
+                } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                    size_t start = position;
+                    while (position < text.size() &&
+                           (std::isalnum(static_cast<unsigned char>(text[position])) || text[position] == '_'))
+                        ++position;
+                    pieces.push_back({PieceKind::NAME, 0, Atom(text.substr(start, position - start)), {}});
+                } else if (c == '<' || c == '>' || c == '=') {
+                    std::string relation(1, c);
+                    if (++position < text.size() && text[position] == '=') {
+                        relation += '=';
+                        ++position;
+                    }
+                    pieces.push_back({PieceKind::RELATION, 0, {}, relation == "==" ? "=" : relation});
+                } else {
+                    ++position; // spaces, |s| bars and free text
+                }
+            }
+
+            return pieces;
+        }
+
+        void Bound(Constraints &constraints, Atom name, double low, double high) {
+            auto [bound, inserted] = constraints.emplace(name, Interval::Unbounded());
+            bound->second = Interval::Of(std::max(bound->second.low, low), std::min(bound->second.high, high));
+        }
+
+        // applies "left relation right" where exactly one side is a number
+        void Apply(Constraints &constraints, const std::vector<Atom> &names, const std::string &relation, double number,
+                   bool names_first) {
+            constexpr double INF = std::numeric_limits<double>::infinity();
+
+            // with the number first, "1 <= n" bounds n like "n >= 1"
+            std::string flipped = relation;
+            if (!names_first && relation != "=")
+                flipped[0] = relation[0] == '<' ? '>' : '<';
+
+            bool strict = flipped.size() == 1 && flipped != "=";
+            for (Atom name: names) {
+                if (flipped[0] == '<')
+                    Bound(constraints, name, -INF, number - strict);
+                else if (flipped[0] == '>')
+                    Bound(constraints, name, number + strict, INF);
+                else
+                    Bound(constraints, name, number, number);
+            }
+        }
+
+        void ParseItem(std::string_view item, Constraints &constraints, std::vector<Atom> &pending) {
+            std::vector<Piece> pieces = Scan(item);
+
+            bool has_relation = false;
+            for (const auto &piece: pieces)
+                has_relation |= piece.kind == PieceKind::RELATION;
+
+            if (!has_relation) {
+                if (pieces.size() == 1 && pieces[0].kind == PieceKind::NAME)
+                    pending.push_back(pieces[0].name);
+                else
+                    pending.clear();
+                return;
+            }
+
+            // operands are numbers or runs of names, a chain ends where two operands meet without a relation
+            struct Operand {
+                bool number;
+                double value;
+                std::vector<Atom> names;
+            };
+
+            std::vector<Operand> operands;
+            std::vector<std::string> relations; // relations[i] sits between operands[i] and operands[i + 1]
+            bool expect_operand = true;
+
+            auto flush = [&]() {
+                for (size_t i = 0; i < relations.size() && i + 1 < operands.size(); i++) {
+                    const Operand &left = operands[i];
+                    const Operand &right = operands[i + 1];
+                    if (!left.number && right.number)
+                        Apply(constraints, left.names, relations[i], right.value, true);
+                    else if (left.number && !right.number)
+                        Apply(constraints, right.names, relations[i], left.value, false);
+                }
+                operands.clear();
+                relations.clear();
+            };
+
+            for (const auto &piece: pieces) {
+                if (piece.kind == PieceKind::RELATION) {
+                    relations.push_back(piece.relation);
+                    expect_operand = true;
+                    continue;
+                }
+
+                if (!expect_operand && !(piece.kind == PieceKind::NAME && !operands.back().number)) {
+                    flush();
+                } else if (!expect_operand) {
+                    operands.back().names.push_back(piece.name);
+                    continue;
+                }
+
+                if (piece.kind == PieceKind::NUMBER) {
+                    operands.push_back({true, piece.number, {}});
+                } else {
+                    std::vector<Atom> names;
+                    if (!pending.empty()) {
+                        names = std::move(pending);
+                        pending.clear();
+                    }
+                    names.push_back(piece.name);
+                    operands.push_back({false, 0, std::move(names)});
+                }
+                expect_operand = false;
+            }
+
+            // "1 <= n, m <= 1e5" bounds n from above as well, so a chain ending in names passes them on
+            std::vector<Atom> trailing;
+            if (!operands.empty() && !operands.back().number)
+                trailing = operands.back().names;
+
+            flush();
+            pending = std::move(trailing);
+        }
+
+    }
+
+    void ParseConstraints(std::string_view text, Constraints &constraints) {
+        std::vector<Atom> pending; // names waiting for the chain that follows them, as in "n, m <= 10"
+        size_t start = 0;
+
+        for (size_t i = 0; i <= text.size(); i++) {
+            if (i == text.size() || text[i] == ',' || text[i] == ';' || text[i] == '\n') {
+                ParseItem(text.substr(start, i - start), constraints, pending);
+                start = i + 1;
+            }
+        }
+    }
+
+    Constraints ConstraintsFromComments(const std::vector<Token> &tokens) {
+        Constraints constraints;
+
+        for (const auto &token: tokens) {
+            if (token.type != TokenType::COMMENT)
+                continue;
+
+            std::string_view text = token.Lexeme();
+            if (text.starts_with("//") || text.starts_with("/*"))
+                text.remove_prefix(2);
+            if (text.ends_with("*/"))
+                text.remove_suffix(2);
+            while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())))
+                text.remove_prefix(1);
+
+            if (text.size() < PREFIX.size())
+                continue;
+
+            bool matches = true;
+            for (size_t i = 0; i < PREFIX.size(); i++)
+                matches &= std::tolower(static_cast<unsigned char>(text[i])) == PREFIX[i];
+
+            if (matches)
+                ParseConstraints(text.substr(PREFIX.size()), constraints);
+        }
+
+        return constraints;
+    }
+
+    std::optional<double> UpperBound(const Constraints &constraints, Atom name) {
+        auto found = constraints.find(name);
+        if (found == constraints.end() || !std::isfinite(found->second.high))
+            return std::nullopt;
+
+        return found->second.high;
+    }
+
+}
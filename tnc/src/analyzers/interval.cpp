@@ -0,0 +1,722 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the interval evaluator
+ */
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <unordered_set>
+
+#include "analyzers/interval.h"
+
+namespace tonic {
+
+    namespace {
+
+        constexpr double INF = std::numeric_limits<double>::infinity();
+        constexpr double EXACT_LIMIT = 9007199254740992.0; // 2^53
+
+        // two character operators that may be split by the spaces the parser puts between tokens
+        constexpr std::array<std::string_view, 17> JOINABLE = {
+                "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "==", "!=", "<=", ">=", "&&", "||", "::", "<<", ">>",
+        };
+
+        constexpr std::array<std::string_view, 20> TWO_CHARACTER = {
+                "<<", ">>", "<=", ">=", "==", "!=", "&&", "||", "++", "--",
+                "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "::", "->",
+        };
+
+        constexpr std::array<std::string_view, 13> ASSIGNMENT_OPERATORS = {
+                "=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>=", "++", "--",
+        };
+
+        const std::unordered_set<std::string_view> PURE_CALLS = {
+                "min", "max", "abs", "llabs", "fabs", "sqrt", "sqrtl", "cbrt", "pow", "powl", "exp", "log", "log2",
+                "log10", "floor", "ceil", "round", "gcd", "lcm", "__gcd", "__lg", "__builtin_popcount",
+                "__builtin_popcountll", "__builtin_clz", "__builtin_clzll", "__builtin_ctz", "__builtin_ctzll",
+                "make_pair", "make_tuple", "to_string", "stoi", "stoll", "string", "sizeof", "int", "long",
+                "unsigned", "double", "float", "char", "bool", "size_t", "int64_t", "return", "if", "while", "for",
+                "switch"};
+
+        bool IsIdentifierStart(char c) {
+            return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        bool IsIdentifierPart(char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        size_t SkipSpaces(std::string_view text, size_t i) {
+            while (i < text.size() && text[i] == ' ')
+                ++i;
+            return i;
+        }
+
+        // "<<=" and ">>=", joined or split as "< < =", extend the shift that ends before text[i]
+        size_t JoinShiftAssignment(std::string_view text, size_t i, std::string &token) {
+            size_t next = SkipSpaces(text, i);
+            if ((token != "<<" && token != ">>") || next >= text.size() || text[next] != '=' ||
+                (next + 1 < text.size() && text[next + 1] == '='))
+                return i;
+
+            token += '=';
+            return next + 1;
+        }
+
+        std::vector<std::string> Tokenize(std::string_view text) {
+            std::vector<std::string> tokens;
+            size_t i = 0;
+
+            while (i < text.size()) {
+                char c = text[i];
+                if (std::isspace(static_cast<unsigned char>(c))) {
+                    ++i;
+                    continue;
+                }
+
+                size_t start = i;
+                if (std::isdigit(static_cast<unsigned char>(c)) ||
+                    (c == '.' && i + 1 < text.size() && std::isdigit(static_cast<unsigned char>(text[i + 1])))) {
+                    bool hex = c == '0' && i + 1 < text.size() && (text[i + 1] == 'x' || text[i + 1] == 'X');
+                    while (i < text.size()) {
+                        char d = text[i];
+                        bool exponent_sign = (d == '+' || d == '-') && !hex && (text[i - 1] == 'e' || text[i - 1] == 'E');
+                        if (!IsIdentifierPart(d) && d != '.' && d != '\'' && !exponent_sign)
+                            break;
+                        ++i;
+                    }
+                } else if (IsIdentifierStart(c)) {
+                    while (i < text.size() && IsIdentifierPart(text[i]))
+                        ++i;
+                } else if (c == '"' || c == '\'') {
+                    for (++i; i < text.size() && text[i] != c; ++i) {
+                        if (text[i] == '\\')
+                            ++i;
+                    }
+                    i = std::min(i + 1, text.size());
+                } else {
+                    std::string_view pair = text.substr(i, 2);
+                    if (std::find(TWO_CHARACTER.begin(), TWO_CHARACTER.end(), pair) != TWO_CHARACTER.end()) {
+                        tokens.emplace_back(pair);
+                        i += 2;
+                        i = JoinShiftAssignment(text, i, tokens.back());
+                        continue;
+                    }
+
+                    ++i;
+                    size_t next = SkipSpaces(text, i);
+
+                    std::string joined{c};
+                    if (next < text.size())
+                        joined += text[next];
+                    if (next > i && std::find(JOINABLE.begin(), JOINABLE.end(), joined) != JOINABLE.end()) {
+                        tokens.push_back(joined);
+                        i = JoinShiftAssignment(text, next + 1, tokens.back());
+                        continue;
+                    }
+                }
+
+                tokens.emplace_back(text.substr(start, i - start));
+            }
+
+            return tokens;
+        }
+
+        std::optional<double> ParseInteger(std::string literal) {
+            literal.erase(std::remove(literal.begin(), literal.end(), '\''), literal.end());
+
+            bool hex = literal.size() > 2 && literal[0] == '0' && (literal[1] == 'x' || literal[1] == 'X');
+            if (!hex) {
+                while (!literal.empty() && std::string_view("uUlL").find(literal.back()) != std::string_view::npos)
+                    literal.pop_back();
+            }
+
+            char *end = nullptr;
+            double value = hex ? static_cast<double>(std::strtoull(literal.c_str(), &end, 16))
+                               : std::strtod(literal.c_str(), &end);
+            if (literal.empty() || *end != '\0' || value != std::floor(value))
+                return std::nullopt;
+
+            return value;
+        }
+
+        // 0 times an infinite bound is 0, the other operand is exactly zero
+        double Multiply(double first, double second) {
+            return first == 0 || second == 0 ? 0 : first * second;
+        }
+
+        Interval Corners(double a, double b, double c, double d) {
+            return Interval::Of(std::min({a, b, c, d}), std::max({a, b, c, d}));
+        }
+
+        double Magnitude(const Interval &interval) {
+            return std::max(std::abs(interval.low), std::abs(interval.high));
+        }
+
+        struct Operand {
+            Interval value;
+            ValueKind kind;
+            std::vector<Atom> names; // variables the value depends on
+        };
+
+        class Evaluator {
+        public:
+            Evaluator(std::vector<std::string> tokens, const IntervalLookup &lookup)
+                    : tokens(std::move(tokens)), lookup(lookup) {}
+
+            Evaluation Run() {
+                Evaluation evaluation;
+                Operand result = Conditional();
+
+                if (!failed && position == tokens.size()) {
+                    evaluation.value = result.value;
+                    evaluation.kind = result.kind;
+                    evaluation.exact = !inexact;
+                }
+
+                evaluation.overflowing = std::move(overflowing);
+                return evaluation;
+            }
+
+        private:
+            static Operand Other() {
+                return {Interval::Unbounded(), ValueKind::OTHER, {}};
+            }
+
+            bool Match(std::string_view token) const {
+                return position < tokens.size() && tokens[position] == token;
+            }
+
+            bool Accept(std::string_view token) {
+                if (!Match(token))
+                    return false;
+
+                ++position;
+                return true;
+            }
+
+            void Expect(std::string_view token) {
+                if (!Accept(token))
+                    failed = true;
+            }
+
+            Operand Conditional() {
+                Operand condition = LogicalOr();
+                if (!Accept("?"))
+                    return condition;
+
+                Operand first = Conditional();
+                Expect(":");
+                Operand second = Conditional();
+
+                if (first.kind != second.kind)
+                    return Other();
+
+                first.value = first.value.Hull(second.value);
+                first.names.insert(first.names.end(), second.names.begin(), second.names.end());
+                return first;
+            }
+
+            template<typename Next>
+            Operand Boolean(std::initializer_list<std::string_view> operators, Next next) {
+                Operand first = (this->*next)();
+                while (std::any_of(operators.begin(), operators.end(), [this](auto op) { return Match(op); })) {
+                    ++position;
+                    (this->*next)();
+                    first = {Interval::Of(0, 1), ValueKind::BOOLEAN, {}};
+                }
+                return first;
+            }
+
+            Operand LogicalOr() {
+                return Boolean({"||"}, &Evaluator::LogicalAnd);
+            }
+
+            Operand LogicalAnd() {
+                return Boolean({"&&"}, &Evaluator::BitwiseOr);
+            }
+
+            Operand BitwiseOr() {
+                Operand first = BitwiseXor();
+                while (Accept("|"))
+                    first = Bitwise(first, BitwiseXor(), '|');
+                return first;
+            }
+
+            Operand BitwiseXor() {
+                Operand first = BitwiseAnd();
+                while (Accept("^"))
+                    first = Bitwise(first, BitwiseAnd(), '^');
+                return first;
+            }
+
+            Operand BitwiseAnd() {
+                Operand first = Equality();
+                while (Accept("&"))
+                    first = Bitwise(first, Equality(), '&');
+                return first;
+            }
+
+            Operand Equality() {
+                return Boolean({"==", "!="}, &Evaluator::Relational);
+            }
+
+            Operand Relational() {
+                return Boolean({"<", "<=", ">", ">="}, &Evaluator::Shift);
+            }
+
+            Operand Shift() {
+                Operand first = Additive();
+                while (Match("<<") || Match(">>")) {
+                    char op = tokens[position++][0];
+                    first = Arithmetic(first, Additive(), op);
+                }
+                return first;
+            }
+
+            Operand Additive() {
+                Operand first = Multiplicative();
+                while (Match("+") || Match("-")) {
+                    char op = tokens[position++][0];
+                    first = Arithmetic(first, Multiplicative(), op);
+                }
+                return first;
+            }
+
+            Operand Multiplicative() {
+                Operand first = Unary();
+                while (Match("*") || Match("/") || Match("%")) {
+                    char op = tokens[position++][0];
+                    first = Arithmetic(first, Unary(), op);
+                }
+                return first;
+            }
+
+            Operand Unary() {
+                if (Accept("-")) {
+                    Operand operand = Unary();
+                    if (operand.kind == ValueKind::OTHER)
+                        return Other();
+
+                    Interval value = Interval::Of(-operand.value.high, -operand.value.low);
+                    return Checked(std::move(operand), {Interval::Point(0), ValueKind::INTEGER, {}}, value);
+                }
+
+                if (Accept("+"))
+                    return Unary();
+
+                if (Accept("!")) {
+                    Unary();
+                    return {Interval::Of(0, 1), ValueKind::BOOLEAN, {}};
+                }
+
+                if (Accept("~")) {
+                    Operand operand = Unary();
+                    if (operand.kind == ValueKind::OTHER)
+                        return Other();
+
+                    Interval value = Interval::Of(-operand.value.high - 1, -operand.value.low - 1);
+                    Track(value);
+                    return {value, ValueKind::INTEGER, std::move(operand.names)};
+                }
+
+                return Primary();
+            }
+
+            Operand Primary() {
+                if (position >= tokens.size()) {
+                    failed = true;
+                    return Other();
+                }
+
+                const std::string &token = tokens[position++];
+
+                if (token == "(") {
+                    Operand inner = Conditional();
+                    Expect(")");
+                    return inner;
+                }
+
+                if (token == "true" || token == "false") {
+                    return {Interval::Point(token == "true" ? 1 : 0), ValueKind::BOOLEAN, {}};
+                }
+
+                if (std::isdigit(static_cast<unsigned char>(token[0])) || token[0] == '.') {
+                    std::optional<double> value = ParseInteger(token);
+                    if (!value)
+                        return Other();
+
+                    Track(Interval::Point(*value));
+                    return {Interval::Point(*value), ValueKind::INTEGER, {}};
+                }
+
+                if (token[0] == '"' || token[0] == '\'')
+                    return Other();
+
+                if (!IsIdentifierStart(token[0])) {
+                    failed = true;
+                    return Other();
+                }
+
+                if (Postfix())
+                    return Other();
+
+                Atom name(token);
+                std::optional<Interval> range = lookup(name);
+                if (!range)
+                    return Other();
+
+                Track(*range);
+                return {*range, ValueKind::INTEGER, {name}};
+            }
+
+            // consumes calls, indexing and member accesses after an identifier, true if there were any
+            bool Postfix() {
+                bool any = false;
+
+                while (!failed) {
+                    if (Accept("(")) {
+                        while (!failed && !Accept(")")) {
+                            Conditional();
+                            if (!Match(")"))
+                                Expect(",");
+                        }
+                    } else if (Accept("[")) {
+                        Conditional();
+                        Expect("]");
+                    } else if (Accept(".") || Accept("::") || Accept("->")) {
+                        if (position < tokens.size() && IsIdentifierStart(tokens[position][0]))
+                            ++position;
+                        else
+                            failed = true;
+                    } else {
+                        return any;
+                    }
+                    any = true;
+                }
+
+                return any;
+            }
+
+            Operand Arithmetic(Operand first, Operand second, char op) {
+                if (first.kind == ValueKind::OTHER || second.kind == ValueKind::OTHER)
+                    return Other();
+
+                const Interval &a = first.value;
+                const Interval &b = second.value;
+                Interval result = Interval::Unbounded();
+
+                if (a.IsEmpty() || b.IsEmpty()) {
+                    result = Interval::Empty();
+                } else if (op == '+') {
+                    result = Interval::Of(a.low + b.low, a.high + b.high);
+                } else if (op == '-') {
+                    result = Interval::Of(a.low - b.high, a.high - b.low);
+                } else if (op == '*') {
+                    result = Corners(Multiply(a.low, b.low), Multiply(a.low, b.high),
+                                     Multiply(a.high, b.low), Multiply(a.high, b.high));
+                } else if (op == '/') {
+                    result = Divide(a, b);
+                } else if (op == '%') {
+                    double limit = Magnitude(b) - 1;
+                    result = Interval::Of(a.low >= 0 ? 0 : std::max(a.low, -limit),
+                                          a.high <= 0 ? 0 : std::min(a.high, limit));
+                } else if (op == '<' && b.low >= 0 && b.high < 64) {
+                    double low = std::ldexp(1.0, static_cast<int>(b.low));
+                    double high = std::ldexp(1.0, static_cast<int>(b.high));
+                    result = Corners(Multiply(a.low, low), Multiply(a.low, high),
+                                     Multiply(a.high, low), Multiply(a.high, high));
+                } else if (op == '>' && b.low >= 0) {
+                    result = a.low >= 0 && b.high < 64
+                             ? Interval::Of(std::floor(std::ldexp(a.low, -static_cast<int>(b.high))),
+                                            std::floor(std::ldexp(a.high, -static_cast<int>(b.low))))
+                             : a.Hull(Interval::Point(0));
+                }
+
+                return Checked(std::move(first), std::move(second), result);
+            }
+
+            static Interval Divide(const Interval &a, const Interval &b) {
+                Interval divisor = b;
+                if (divisor.low == 0)
+                    divisor.low = 1;
+                if (divisor.high == 0)
+                    divisor.high = -1;
+
+                if (divisor.low > 0 || divisor.high < 0) {
+                    if (!a.IsBounded() || !divisor.IsBounded())
+                        return Interval::Of(-Magnitude(a), Magnitude(a));
+
+                    return Corners(std::trunc(a.low / divisor.low), std::trunc(a.low / divisor.high),
+                                   std::trunc(a.high / divisor.low), std::trunc(a.high / divisor.high));
+                }
+
+                // a nonzero integer divisor never grows the magnitude
+                return Interval::Of(-Magnitude(a), Magnitude(a));
+            }
+
+            Operand Bitwise(Operand first, Operand second, char op) {
+                if (first.kind == ValueKind::OTHER || second.kind == ValueKind::OTHER)
+                    return Other();
+
+                const Interval &a = first.value;
+                const Interval &b = second.value;
+                Interval result = Interval::Unbounded();
+
+                // a variable with no value yet, as in the first round of the range analysis
+                if (a.IsEmpty() || b.IsEmpty()) {
+                    result = Interval::Empty();
+                } else if (op == '&' && (a.low >= 0 || b.low >= 0)) {
+                    double high = a.low >= 0 && b.low >= 0 ? std::min(a.high, b.high)
+                                                           : (a.low >= 0 ? a.high : b.high);
+                    result = Interval::Of(0, high);
+                } else if (op != '&' && a.low >= 0 && b.low >= 0 && a.IsBounded() && b.IsBounded()) {
+                    double high = std::max(a.high, b.high);
+                    result = Interval::Of(0, std::exp2(std::ceil(std::log2(high + 1))) - 1);
+                }
+
+                Track(result);
+                first.names.insert(first.names.end(), second.names.begin(), second.names.end());
+                return {result, ValueKind::INTEGER, std::move(first.names)};
+            }
+
+            void Track(const Interval &value) {
+                inexact |= !value.IsEmpty() && Magnitude(value) >= EXACT_LIMIT;
+            }
+
+            // records the variables of an operation that leaves 32 bits although its operands are bounded
+            Operand Checked(Operand first, Operand second, Interval result) {
+                Track(result);
+                first.names.insert(first.names.end(), second.names.begin(), second.names.end());
+
+                if (first.value.IsBounded() && second.value.IsBounded() && !result.FitsInt32())
+                    overflowing.insert(overflowing.end(), first.names.begin(), first.names.end());
+
+                return {result, ValueKind::INTEGER, std::move(first.names)};
+            }
+
+            std::vector<std::string> tokens;
+            const IntervalLookup &lookup;
+            size_t position = 0;
+            bool failed = false;
+            bool inexact = false; // a value reached 2^53, where doubles start to round
+            std::vector<Atom> overflowing;
+        };
+
+    }
+
+    Interval Interval::Empty() {
+        return {INF, -INF};
+    }
+
+    Interval Interval::Unbounded() {
+        return {-INF, INF};
+    }
+
+    Interval Interval::Point(double value) {
+        return {value, value};
+    }
+
+    Interval Interval::Of(double low, double high) {
+        return {low, high};
+    }
+
+    bool Interval::IsEmpty() const {
+        return low > high;
+    }
+
+    bool Interval::IsBounded() const {
+        return std::isfinite(low) && std::isfinite(high);
+    }
+
+    bool Interval::FitsInt32() const {
+        return IsEmpty() || (low >= std::numeric_limits<int32_t>::min() && high <= std::numeric_limits<int32_t>::max());
+    }
+
+    Interval Interval::Hull(const Interval &other) const {
+        return {std::min(low, other.low), std::max(high, other.high)};
+    }
+
+    bool Interval::operator==(const Interval &other) const {
+        return (IsEmpty() && other.IsEmpty()) || (low == other.low && high == other.high);
+    }
+
+    Interval Int32Range() {
+        return {static_cast<double>(std::numeric_limits<int32_t>::min()),
+                static_cast<double>(std::numeric_limits<int32_t>::max())};
+    }
+
+    Interval Int64Range() {
+        return {static_cast<double>(std::numeric_limits<int64_t>::min()),
+                static_cast<double>(std::numeric_limits<int64_t>::max())};
+    }
+
+    std::optional<Interval> TypeRange(Atom type) {
+        std::string_view name = type.Text();
+        for (std::string_view qualifier: {"constexpr ", "const "}) {
+            if (name.starts_with(qualifier))
+                name.remove_prefix(qualifier.size());
+        }
+
+        if (name == "int" || name == "signed" || name == "int32_t")
+            return Int32Range();
+        if (name == "long long" || name == "long" || name == "int64_t")
+            return Int64Range();
+        if (name == "unsigned" || name == "unsigned int" || name == "uint32_t")
+            return Interval::Of(0, 4294967295.0);
+        if (name == "unsigned long long" || name == "uint64_t" || name == "size_t")
+            return Interval::Of(0, 18446744073709551615.0);
+        if (name == "short" || name == "int16_t")
+            return Interval::Of(-32768, 32767);
+        if (name == "char" || name == "int8_t")
+            return Interval::Of(-128, 127);
+        if (name == "bool")
+            return Interval::Of(0, 1);
+
+        return std::nullopt;
+    }
+
+    Evaluation EvaluateInterval(std::string_view expression, const IntervalLookup &lookup) {
+        return Evaluator(Tokenize(expression), lookup).Run();
+    }
+
+    std::vector<std::string> TokenizeExpression(std::string_view expression) {
+        return Tokenize(expression);
+    }
+
+    std::vector<Atom> ExpressionNames(std::string_view expression) {
+        std::vector<std::string> tokens = Tokenize(expression);
+        std::vector<Atom> names;
+
+        for (size_t i = 0; i < tokens.size(); i++) {
+            if (IsIdentifierStart(tokens[i][0]) && !IsMember(tokens, i) && tokens[i] != "true" && tokens[i] != "false")
+                names.emplace_back(tokens[i]);
+        }
+
+        return names;
+    }
+
+    bool IsName(std::string_view text) {
+        return !text.empty() && IsIdentifierStart(text[0]) && std::all_of(text.begin(), text.end(), IsIdentifierPart);
+    }
+
+    bool IsMember(const std::vector<std::string> &tokens, size_t i) {
+        return i > 0 && (tokens[i - 1] == "." || tokens[i - 1] == "->");
+    }
+
+    bool IsAssignmentOperator(std::string_view token) {
+        return std::find(ASSIGNMENT_OPERATORS.begin(), ASSIGNMENT_OPERATORS.end(), token) != ASSIGNMENT_OPERATORS.end();
+    }
+
+    bool IsPureCall(std::string_view name) {
+        return PURE_CALLS.contains(name);
+    }
+
+    size_t SkipGroup(const std::vector<std::string> &tokens, size_t open) {
+        int depth = 0;
+        for (size_t i = open; i < tokens.size(); i++) {
+            if (tokens[i] == "(" || tokens[i] == "[" || tokens[i] == "{")
+                depth++;
+            else if ((tokens[i] == ")" || tokens[i] == "]" || tokens[i] == "}") && --depth == 0)
+                return i + 1;
+        }
+        return tokens.size();
+    }
+
+    bool IsWritten(const std::vector<std::string> &tokens, size_t i) {
+        if (!IsName(tokens[i]) || IsMember(tokens, i))
+            return false;
+
+        size_t next = i + 1;
+        while (next < tokens.size() && tokens[next] == "[")
+            next = SkipGroup(tokens, next);
+
+        if (next < tokens.size() && IsAssignmentOperator(tokens[next]))
+            return true;
+        if (i > 0 && (tokens[i - 1] == "++" || tokens[i - 1] == "--"))
+            return true;
+
+        // a whole argument, or its address, which the callee may write through
+        size_t first = i > 1 && tokens[i - 1] == "&" ? i - 1 : i;
+        bool whole = first > 0 && (tokens[first - 1] == "(" || tokens[first - 1] == ",") &&
+                     next < tokens.size() && (tokens[next] == ")" || tokens[next] == ",");
+        if (!whole)
+            return false;
+
+        int depth = 0;
+        for (size_t open = first; open-- > 0;) {
+            if (tokens[open] == ")" || tokens[open] == "]" || tokens[open] == "}") {
+                depth++;
+            } else if (tokens[open] == "(" || tokens[open] == "[" || tokens[open] == "{") {
+                if (depth-- > 0)
+                    continue;
+                return tokens[open] == "(" && open > 0 && IsName(tokens[open - 1]) && !IsMember(tokens, open - 1) &&
+                       !IsPureCall(tokens[open - 1]);
+            }
+        }
+        return false;
+    }
+
+    std::string BinaryOperator(const Assignment &assignment) {
+        if (assignment.operation == '<' || assignment.operation == '>')
+            return std::string(2, assignment.operation);
+        return std::string(1, assignment.operation);
+    }
+
+    std::optional<Assignment> SplitAssignment(std::string_view statement) {
+        std::vector<std::string> tokens = Tokenize(statement);
+        auto is_name = [](const std::string &token) {
+            return IsIdentifierStart(token[0]);
+        };
+
+        auto is_step = [](const std::string &token) {
+            return token == "++" || token == "--";
+        };
+        auto is_sign = [](const std::string &token) {
+            return token == "+" || token == "-";
+        };
+
+        // "x ++" and "++ x", or with the two signs kept as separate tokens by the parser
+        if (tokens.size() == 2) {
+            if (is_name(tokens[0]) && is_step(tokens[1]))
+                return Assignment{Atom(tokens[0]), tokens[1][0], "1"};
+            if (is_step(tokens[0]) && is_name(tokens[1]))
+                return Assignment{Atom(tokens[1]), tokens[0][0], "1"};
+        } else if (tokens.size() == 3) {
+            if (is_name(tokens[0]) && is_sign(tokens[1]) && tokens[1] == tokens[2])
+                return Assignment{Atom(tokens[0]), tokens[1][0], "1"};
+            if (is_sign(tokens[0]) && tokens[0] == tokens[1] && is_name(tokens[2]))
+                return Assignment{Atom(tokens[2]), tokens[0][0], "1"};
+        }
+
+        if (tokens.size() < 3 || !is_name(tokens[0]))
+            return std::nullopt;
+
+        char operation;
+        if (tokens[1] == "=") {
+            operation = '=';
+        } else if (tokens[1].size() >= 2 && tokens[1].back() == '=' && IsAssignmentOperator(tokens[1])) {
+            operation = tokens[1][0];
+        } else {
+            return std::nullopt;
+        }
+
+        // the value is re-tokenized by the evaluator, so the original spacing does not matter
+        std::string value;
+        for (size_t i = 2; i < tokens.size(); i++) {
+            value += tokens[i];
+            value += ' ';
+        }
+        value.pop_back();
+
+        return Assignment{Atom(tokens[0]), operation, value};
+    }
+
+}
@@ -0,0 +1,258 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the loop bounds analysis
+ */
+
+#include <string_view>
+
+#include "analyzers/interval.h"
+#include "analyzers/loop_bounds.h"
+#include "core/hash.h"
+#include "traversal/visitor.h"
+
+namespace tonic {
+
+    namespace {
+
+        // only exact values are folded, 0 .. 1000000000000000001 must not become 0 .. 1000000000000000000
+        std::optional<int64_t> AsConstant(const Evaluation &evaluation) {
+            const Interval &value = evaluation.value;
+            if (evaluation.kind != ValueKind::INTEGER || !evaluation.exact || value.low != value.high)
+                return std::nullopt;
+
+            return static_cast<int64_t>(value.low);
+        }
+
+    }
+
+    class LoopBoundsAnalysis::Collector : public AstVisitor<Collector> {
+    public:
+        explicit Collector(LoopBoundsAnalysis &analysis) : analysis(analysis) {}
+
+        void Visit(VariableDeclaration &declaration) {
+            if (!declaration.identifier)
+                return;
+
+            Definitions &definitions = Define(Atom(declaration.identifier->statement));
+
+            if (declaration.initializer && declaration.initializer->kind == NodeKind::GENERAL_STATEMENT) {
+                auto &initializer = NodeAs<GeneralStatement>(*declaration.initializer);
+                if (definitions.count == 1)
+                    definitions.value = initializer.statement;
+            }
+        }
+
+        void Visit(ForLoop &loop) {
+            if (loop.identifier)
+                Define(Atom(loop.identifier->statement));
+
+            // the bounds belong to the loop itself, not to its body
+            for (const auto &slot: {loop.start, loop.end, loop.step})
+                owners[slot.get()] = analysis.loops.size();
+
+            analysis.loops.push_back({&loop, {}, {}, false});
+            open.push_back(analysis.loops.size() - 1);
+        }
+
+        void Leave(ForLoop &loop) {
+            if (!open.empty() && analysis.loops[open.back()].loop == &loop)
+                open.pop_back();
+        }
+
+        void Visit(InputOutput &io) {
+            if (io.type != InOut::IN)
+                return;
+
+            for (const auto &operand: io.operands) {
+                if (operand) {
+                    for (Atom name: ExpressionNames(operand->statement))
+                        Define(name);
+                }
+            }
+        }
+
+        void Visit(GeneralStatement &statement) {
+            auto owner = owners.find(&statement);
+            size_t skipped = owner == owners.end() ? SIZE_MAX : owner->second;
+
+            for (Atom name: ExpressionNames(statement.statement)) {
+                for (size_t index: open) {
+                    if (index != skipped)
+                        analysis.loops[index].mentioned.insert(name);
+                }
+            }
+
+            Calls(statement.statement);
+
+            // any write defines the name again, x <<= 1 and swap ( x , y ) as much as x = 1
+            std::vector<std::string> tokens = TokenizeExpression(statement.statement);
+            for (size_t i = 0; i < tokens.size(); i++) {
+                if (IsWritten(tokens, i))
+                    Define(Atom(tokens[i]));
+            }
+        }
+
+        void Visit(FunctionDeclaration &function) {
+            for (const auto &argument: function.arguments)
+                Define(argument.first);
+        }
+
+        void Visit(LambdaExpression &lambda) {
+            for (const auto &argument: lambda.arguments)
+                Define(argument.first);
+        }
+
+        void Visit(TryCatchStatement &statement) {
+            for (const auto &argument: statement.catch_arguments)
+                Define(argument.first);
+        }
+
+        void Visit(RangedLoop &loop) {
+            if (loop.identifier)
+                Define(Atom(loop.identifier->statement));
+        }
+
+        void Visit(PairDestructuring &pair) {
+            Define(pair.first_var);
+            Define(pair.second_var);
+        }
+
+        // raw C++ can do anything
+        void Visit(CppNode &) {
+            for (size_t index: open)
+                analysis.loops[index].calls = true;
+        }
+
+    private:
+        // a member call may change its object, any other call not known to be pure may change globals
+        void Calls(const std::string &statement) {
+            std::vector<std::string> tokens = TokenizeExpression(statement);
+            for (size_t i = 0; i + 1 < tokens.size(); i++) {
+                if (tokens[i + 1] != "(" || !IsName(tokens[i]))
+                    continue;
+
+                if (i >= 2 && IsMember(tokens, i)) {
+                    for (size_t index: open)
+                        analysis.loops[index].assigned.insert(Atom(tokens[i - 2]));
+                } else if (!IsPureCall(tokens[i])) {
+                    for (size_t index: open)
+                        analysis.loops[index].calls = true;
+                }
+            }
+        }
+
+        Definitions &Define(Atom name) {
+            for (size_t index: open)
+                analysis.loops[index].assigned.insert(name);
+
+            Definitions &definitions = analysis.definitions[name];
+            ++definitions.count;
+            return definitions;
+        }
+
+        LoopBoundsAnalysis &analysis;
+        std::vector<size_t> open; // loops being traversed, outermost first
+        std::unordered_map<const Node *, size_t> owners; // bound statements to their loop
+    };
+
+    void LoopBoundsAnalysis::Run(Node &root) {
+        Collector(*this).Traverse(root);
+
+        bool folded = false;
+        for (const auto &names: loops) {
+            folded |= Fold(*names.loop);
+
+            ForLoop &loop = *names.loop;
+            loop.bounds_invariant = Invariant(names, loop.end) && (!loop.step || Invariant(names, loop.step));
+        }
+
+        // a folded bound changes the hashes of the loop and everything above it
+        if (folded && root.hash != 0)
+            HashTree(root);
+    }
+
+    std::optional<int64_t> LoopBoundsAnalysis::ConstantOf(Atom name) {
+        auto memoized = constants.find(name);
+        if (memoized != constants.end())
+            return memoized->second;
+
+        auto found = definitions.find(name);
+        if (found == definitions.end() || found->second.count != 1 || found->second.value.empty() ||
+            !resolving.insert(name).second)
+            return std::nullopt;
+
+        Evaluation evaluation = EvaluateInterval(found->second.value, [this](Atom other) -> std::optional<Interval> {
+            std::optional<int64_t> constant = ConstantOf(other);
+            return constant ? std::optional(Interval::Point(static_cast<double>(*constant))) : std::nullopt;
+        });
+
+        resolving.erase(name);
+        return constants[name] = AsConstant(evaluation);
+    }
+
+    bool LoopBoundsAnalysis::Fold(ForLoop &loop) {
+        IntervalLookup lookup = [this](Atom name) -> std::optional<Interval> {
+            std::optional<int64_t> constant = ConstantOf(name);
+            return constant ? std::optional(Interval::Point(static_cast<double>(*constant))) : std::nullopt;
+        };
+
+        bool folded = false;
+        std::optional<int64_t> values[3];
+        const std::shared_ptr<GeneralStatement> *slots[3] = {&loop.start, &loop.end, &loop.step};
+
+        for (size_t i = 0; i < 3; i++) {
+            const auto &slot = *slots[i];
+            if (!slot)
+                continue;
+
+            values[i] = AsConstant(EvaluateInterval(slot->statement, lookup));
+            if (values[i]) {
+                std::string literal = std::to_string(*values[i]);
+                folded |= literal != slot->statement;
+                slot->statement = std::move(literal);
+            }
+        }
+
+        auto [start, end, step] = values;
+        if (!loop.step)
+            step = 1;
+
+        loop.step_sign = step ? (*step > 0) - (*step < 0) : 0;
+        loop.trip_count.reset();
+
+        if (start && end && step && *step != 0) {
+            // 128 bits, the distance between two 64-bit bounds does not fit in 64
+            __int128 distance = *step > 0 ? __int128(*end) - *start : __int128(*start) - *end;
+            __int128 stride = *step > 0 ? __int128(*step) : -__int128(*step);
+            loop.trip_count = distance > 0 ? static_cast<uint64_t>((distance + stride - 1) / stride) : 0;
+        }
+        return folded;
+    }
+
+    bool LoopBoundsAnalysis::Invariant(const LoopNames &names, const std::shared_ptr<GeneralStatement> &bound) const {
+        if (!bound)
+            return false;
+
+        // calls, indexing and member accesses may depend on any use of their variables
+        bool pure = EvaluateInterval(bound->statement, [](Atom) {
+            return std::optional(Interval::Unbounded());
+        }).kind != ValueKind::OTHER;
+
+        if (names.calls)
+            return false;
+
+        const auto &changed = pure ? names.assigned : names.mentioned;
+        Atom index = names.loop->identifier ? Atom(names.loop->identifier->statement) : Atom();
+
+        for (Atom name: ExpressionNames(bound->statement)) {
+            if (name == index || changed.contains(name))
+                return false;
+        }
+
+        return true;
+    }
+
+}
@@ -0,0 +1,480 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the memoization analysis
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <map>
+
+#include "analyzers/interval.h"
+#include "analyzers/memoize.h"
+#include "analyzers/memory.h"
+#include "traversal/visitor.h"
+
+namespace tonic {
+
+    namespace {
+
+        // member functions that change the object they are called on
+        const std::unordered_set<std::string> MUTATORS = {"push_back", "emplace_back", "pop_back", "push_front",
+                                                          "emplace_front", "pop_front", "push", "emplace", "pop",
+                                                          "insert", "erase", "clear", "assign", "resize", "swap",
+                                                          "append", "reserve"};
+
+        // floating point values a dense memo table can copy as bytes, integer types are known to TypeRange
+        const std::unordered_set<std::string_view> FLOATING_TYPES = {"double", "float", "long double"};
+
+        const std::unordered_set<std::string> IO_NAMES = {"cin", "cout", "cerr", "printf", "scanf", "puts",
+                                                          "getchar", "putchar", "fread", "fwrite", "getline"};
+
+        // top-level arguments of the call whose parenthesis opens at tokens[open]
+        std::vector<std::string> Arguments(const std::vector<std::string> &tokens, size_t open) {
+            std::vector<std::string> arguments;
+            std::string argument;
+            size_t close = SkipGroup(tokens, open) - 1;
+
+            for (size_t i = open + 1; i < close; i++) {
+                if (tokens[i] == "(" || tokens[i] == "[" || tokens[i] == "{") {
+                    size_t end = std::min(SkipGroup(tokens, i), close);
+                    for (; i < end; i++)
+                        argument += (argument.empty() ? "" : " ") + tokens[i];
+                    --i;
+                } else if (tokens[i] == ",") {
+                    arguments.push_back(std::move(argument));
+                    argument.clear();
+                } else {
+                    argument += (argument.empty() ? "" : " ") + tokens[i];
+                }
+            }
+            if (!argument.empty())
+                arguments.push_back(std::move(argument));
+
+            return arguments;
+        }
+
+        // "n - 2" is -2 from n, "n" is 0, anything else has no constant offset
+        std::optional<long long> Offset(const std::string &argument, Atom parameter) {
+            std::vector<std::string> tokens = TokenizeExpression(argument);
+            if (tokens.size() == 1 && tokens[0] == parameter.Text())
+                return 0;
+            if (tokens.size() != 3 || tokens[0] != parameter.Text() || (tokens[1] != "-" && tokens[1] != "+") ||
+                !std::all_of(tokens[2].begin(), tokens[2].end(), [](char c) { return std::isdigit(c); }))
+                return std::nullopt;
+
+            long long amount = std::stoll(tokens[2]);
+            return tokens[1] == "-" ? -amount : amount;
+        }
+
+    }
+
+    class MemoizeAnalysis::Collector : public AstVisitor<Collector> {
+    public:
+        explicit Collector(MemoizeAnalysis &analysis) : analysis(analysis) {}
+
+        void Visit(FunctionDeclaration &function) {
+            if (!function.name)
+                return;
+
+            consumed.insert(function.name.get());
+            if (function.type)
+                consumed.insert(function.type.get());
+
+            Atom name(function.name->statement);
+            analysis.by_name[name] = analysis.infos.size();
+            analysis.infos.push_back({&function, {}, {}, {}, {}, {}, {}, false});
+            for (const auto &[argument, type]: function.arguments)
+                analysis.infos.back().locals.insert(argument);
+
+            open.push_back(analysis.infos.size() - 1);
+            loop_indices.emplace_back();
+        }
+
+        void Leave(FunctionDeclaration &function) {
+            if (!function.name)
+                return;
+
+            open.pop_back();
+            loop_indices.pop_back();
+        }
+
+        void Visit(VariableDeclaration &declaration) {
+            if (!declaration.identifier)
+                return;
+
+            consumed.insert(declaration.identifier.get());
+            Atom name(declaration.identifier->statement);
+
+            if (open.empty()) {
+                if (!declaration.data_type.Text().starts_with("const"))
+                    analysis.globals.insert(name);
+                GlobalWrite(name);
+                return;
+            }
+
+            // an untyped declaration may assign an existing variable, which matters when it is global
+            if (declaration.data_type == AUTO_ATOM)
+                Current().writes.emplace_back(name, declaration.line);
+            else
+                Current().locals.insert(name);
+        }
+
+        void Visit(ForLoop &loop) {
+            EnterLoop(loop.identifier);
+        }
+
+        void Leave(ForLoop &loop) {
+            LeaveLoop(loop.identifier);
+        }
+
+        void Visit(RangedLoop &loop) {
+            EnterLoop(loop.identifier);
+        }
+
+        void Leave(RangedLoop &loop) {
+            LeaveLoop(loop.identifier);
+        }
+
+        void Visit(WhileLoop &) {
+            if (open.empty())
+                top_loops++;
+        }
+
+        void Leave(WhileLoop &) {
+            if (open.empty())
+                top_loops--;
+        }
+
+        void Visit(InputOutput &io) {
+            if (!open.empty()) {
+                Current().io = true;
+                return;
+            }
+
+            // the first name of each operand is read into, as in "in a [ i ]"
+            if (io.type != InOut::IN)
+                return;
+            for (const auto &operand: io.operands) {
+                if (!operand)
+                    continue;
+                for (const auto &token: TokenizeExpression(operand->statement)) {
+                    if (IsName(token)) {
+                        GlobalWrite(Atom(token));
+                        break;
+                    }
+                }
+            }
+        }
+
+        void Visit(GeneralStatement &statement) {
+            if (consumed.contains(&statement))
+                return;
+
+            std::vector<std::string> tokens = TokenizeExpression(statement.statement);
+            if (open.empty()) {
+                TopLevel(tokens);
+                return;
+            }
+
+            FunctionInfo &info = Current();
+            Atom self(info.function->name->statement);
+
+            for (size_t i = 0; i < tokens.size(); i++) {
+                if (!IsName(tokens[i]) || IsMember(tokens, i))
+                    continue;
+
+                if (IO_NAMES.contains(tokens[i]))
+                    info.io = true;
+
+                if (i + 1 < tokens.size() && tokens[i + 1] == "(") {
+                    if (Atom(tokens[i]) != self) {
+                        info.callees.emplace_back(tokens[i]);
+                        continue;
+                    }
+
+                    std::vector<std::string> arguments = Arguments(tokens, i + 1);
+                    std::string text = tokens[i] + " (";
+                    for (size_t j = 0; j < arguments.size(); j++)
+                        text += (j ? " , " : " ") + arguments[j];
+                    info.call_texts.push_back(text + " )");
+                    info.self_calls.push_back({std::move(arguments), loop_indices.back()});
+                    continue;
+                }
+
+                info.reads.emplace_back(tokens[i]);
+                if (Written(tokens, i))
+                    info.writes.emplace_back(tokens[i], statement.line);
+            }
+        }
+
+    private:
+        FunctionInfo &Current() {
+            return analysis.infos[open.back()];
+        }
+
+        // x = ..., x [ i ] + = ..., x < < = ..., x ++, ++ x and x . push_back ( ... )
+        static bool Written(const std::vector<std::string> &tokens, size_t i) {
+            size_t next = i + 1;
+            while (next < tokens.size() && tokens[next] == "[")
+                next = SkipGroup(tokens, next);
+
+            bool assigned = next < tokens.size() && IsAssignmentOperator(tokens[next]);
+            bool incremented = i > 0 && (tokens[i - 1] == "++" || tokens[i - 1] == "--");
+            bool mutated = next + 1 < tokens.size() && (tokens[next] == "." || tokens[next] == "->") &&
+                           MUTATORS.contains(tokens[next + 1]);
+            return assigned || incremented || mutated;
+        }
+
+        // top-level code runs in main, writes in the statement of the first call already follow it
+        void TopLevel(const std::vector<std::string> &tokens) {
+            for (size_t i = 0; i + 1 < tokens.size(); i++)
+                if (IsName(tokens[i]) && !IsMember(tokens, i) && tokens[i + 1] == "(" && !IsPureCall(tokens[i]))
+                    called = true;
+
+            for (size_t i = 0; i < tokens.size(); i++)
+                if (IsName(tokens[i]) && !IsMember(tokens, i) && Written(tokens, i))
+                    GlobalWrite(Atom(tokens[i]));
+        }
+
+        // a top-level write before the first call, outside loops, only initializes the global
+        void GlobalWrite(Atom name) {
+            if (open.empty() && (called || top_loops > 0))
+                analysis.rewritten.insert(name);
+        }
+
+        void EnterLoop(const std::shared_ptr<GeneralStatement> &identifier) {
+            if (open.empty())
+                top_loops++;
+            if (open.empty() || !identifier)
+                return;
+
+            consumed.insert(identifier.get());
+            Current().locals.insert(Atom(identifier->statement));
+            loop_indices.back().emplace_back(identifier->statement);
+        }
+
+        void LeaveLoop(const std::shared_ptr<GeneralStatement> &identifier) {
+            if (open.empty())
+                top_loops--;
+            else if (identifier)
+                loop_indices.back().pop_back();
+        }
+
+        MemoizeAnalysis &analysis;
+
+        std::vector<size_t> open;                     // functions being traversed, innermost last
+        std::vector<std::vector<Atom>> loop_indices;  // per open function
+        std::unordered_set<const Node *> consumed;    // names that are declared, not read or written
+        size_t top_loops = 0;                         // loops open in top-level code
+        bool called = false;                          // top-level code called a function
+    };
+
+    MemoizeAnalysis::MemoizeAnalysis(Diagnostics &diagnostics, MemoizeMode mode)
+            : diagnostics(diagnostics), mode(mode) {}
+
+    void MemoizeAnalysis::Run(Program &program) {
+        Collector(*this).Traverse(program);
+
+        for (const auto &info: infos)
+            for (const auto &[name, line]: info.writes)
+                if (globals.contains(name) && !info.locals.contains(name))
+                    rewritten.insert(name);
+
+        for (const auto &info: infos) {
+            if (info.self_calls.empty())
+                continue;
+
+            std::unordered_map<Atom, std::string> verdicts;
+            std::string reason = Impurity(info, verdicts);
+            bool overlapping = Overlapping(info);
+            reports.push_back({info.function, reason.empty(), overlapping, Decreasing(info), reason, info.call_texts});
+
+            FunctionDeclaration &function = *info.function;
+            std::string name = "`" + function.name->statement + "`";
+
+            if (function.is_memoize) {
+                if (!reason.empty())
+                    diagnostics.Warning("memoize", name + " is memoized but " + reason +
+                                                   ", so cached results can be wrong", function.line);
+                continue;
+            }
+            if (!overlapping)
+                continue;
+
+            // the first two distinct calls show the overlap
+            std::vector<std::string> shown;
+            for (const auto &text: info.call_texts)
+                if (shown.size() < 2 && std::find(shown.begin(), shown.end(), text) == shown.end())
+                    shown.push_back(text);
+            std::string through = shown[0] + (shown.size() > 1 ? " and " + shown[1] : "");
+
+            if (!reason.empty()) {
+                diagnostics.Warning("memoize", name + " recomputes overlapping subproblems through " + through +
+                                               " but cannot be memoized, " + reason, function.line);
+            } else if (mode == MemoizeMode::APPLY) {
+                function.is_memoize = true;
+                diagnostics.Note("memoize", name + " is memoized automatically, it is pure and recomputes "
+                                                   "overlapping subproblems through " + through, function.line);
+            } else {
+                diagnostics.Warning("memoize", name + " recomputes overlapping subproblems through " + through +
+                                               ", it is pure, add @memoize", function.line);
+            }
+        }
+    }
+
+    const std::vector<RecursionReport> &MemoizeAnalysis::Reports() const {
+        return reports;
+    }
+
+    std::string MemoizeAnalysis::SideEffect(const FunctionInfo &info, std::unordered_map<Atom, std::string> &verdicts) {
+        if (info.io)
+            return "it does input or output";
+
+        for (const auto &[name, line]: info.writes)
+            if (globals.contains(name) && !info.locals.contains(name))
+                return "it writes global `" + name.Text() + "`";
+
+        // a cached result would keep the value the global had at the first call
+        for (Atom name: info.reads)
+            if (rewritten.contains(name) && !info.locals.contains(name))
+                return "it reads global `" + name.Text() + "`, which changes after its initialization";
+
+        Atom self(info.function->name->statement);
+        for (Atom callee: info.callees) {
+            auto found = by_name.find(callee);
+            if (callee == self)
+                continue;
+            if (found == by_name.end()) {
+                if (IsPureCall(callee.Text()))
+                    continue;
+                return "it calls `" + callee.Text() + "`, which is not known to be pure";
+            }
+
+            auto verdict = verdicts.find(callee);
+            if (verdict == verdicts.end()) {
+                verdicts[callee] = ""; // optimistic for mutual recursion, a real side effect still shows up
+                std::string effect = SideEffect(infos[found->second], verdicts);
+                verdict = verdicts.insert_or_assign(callee, effect).first;
+            }
+            if (!verdict->second.empty())
+                return "it calls `" + callee.Text() + "`, where " + verdict->second;
+        }
+
+        return "";
+    }
+
+    std::string MemoizeAnalysis::Impurity(const FunctionInfo &info, std::unordered_map<Atom, std::string> &verdicts) {
+        const FunctionDeclaration &function = *info.function;
+        if (function.type && ParseType(function.type->statement).name == "void")
+            return "it returns nothing";
+
+        for (const auto &[argument, type]: function.arguments) {
+            const std::string &text = type.Text();
+            if (text.find('&') != std::string::npos || text.find('*') != std::string::npos)
+                return "argument `" + argument.Text() + "` is not passed by value";
+
+            TypeShape shape = ParseType(text);
+            if (ElementSize(shape) > 0 && shape.name != "string")
+                return "argument `" + argument.Text() + "` is a container";
+        }
+
+        return SideEffect(info, verdicts);
+    }
+
+    bool MemoizeAnalysis::Overlapping(const FunctionInfo &info) {
+        const auto &parameters = info.function->arguments;
+
+        // the same state reached from every iteration of a loop, as in coin change
+        for (const auto &call: info.self_calls) {
+            for (const auto &argument: call.arguments) {
+                std::vector<Atom> names = ExpressionNames(argument);
+                for (Atom index: call.loop_indices)
+                    if (std::find(names.begin(), names.end(), index) != names.end())
+                        return true;
+            }
+        }
+
+        if (info.self_calls.size() < 2)
+            return false;
+
+        // repeated arguments, or constant steps that reach the same state along different paths
+        std::map<std::vector<std::string>, size_t> repeated;
+        std::map<std::vector<long long>, size_t> steps;
+        for (const auto &call: info.self_calls) {
+            if (++repeated[call.arguments] > 1)
+                return true;
+            if (call.arguments.size() != parameters.size())
+                continue;
+
+            std::vector<long long> offsets;
+            for (size_t i = 0; i < parameters.size(); i++) {
+                std::optional<long long> offset = Offset(call.arguments[i], parameters[i].first);
+                if (!offset)
+                    break;
+                offsets.push_back(*offset);
+            }
+            if (offsets.size() == parameters.size() &&
+                std::any_of(offsets.begin(), offsets.end(), [](long long offset) { return offset != 0; }))
+                steps[offsets]++;
+        }
+
+        return steps.size() > 1;
+    }
+
+    bool MemoizeAnalysis::Decreasing(const FunctionInfo &info) {
+        const auto &parameters = info.function->arguments;
+
+        // an offset from a parameter the body reassigns says nothing about the value passed
+        for (const auto &[name, line]: info.writes)
+            for (const auto &parameter: parameters)
+                if (name == parameter.first)
+                    return false;
+
+        return std::all_of(info.self_calls.begin(), info.self_calls.end(), [&](const Call &call) {
+            if (call.arguments.size() != parameters.size())
+                return false;
+
+            bool lowered = false;
+            for (size_t i = 0; i < parameters.size(); i++) {
+                std::optional<long long> offset = Offset(call.arguments[i], parameters[i].first);
+                if (!offset || *offset > 0)
+                    return false;
+                lowered |= *offset < 0;
+            }
+            return lowered;
+        });
+    }
+
+    std::optional<std::vector<std::pair<long long, long long>>> DenseMemoRanges(const FunctionDeclaration &function,
+                                                                               const Constraints *constraints) {
+        if (!function.type || (!TypeRange(function.type->statement) &&
+                               !FLOATING_TYPES.contains(function.type->statement)))
+            return std::nullopt;
+
+        std::vector<std::pair<long long, long long>> ranges;
+        double cells = 1;
+        for (const auto &[name, argument_type]: function.arguments) {
+            auto range = TypeRange(argument_type);
+            if (!range)
+                return std::nullopt;
+            if (constraints) {
+                if (auto declared = constraints->find(name); declared != constraints->end()) {
+                    range->low = std::max(range->low, declared->second.low);
+                    range->high = std::min(range->high, declared->second.high);
+                }
+            }
+
+            double low = std::ceil(range->low), high = std::floor(range->high);
+            cells *= std::max(0.0, high - low + 1);
+            if (high < low || cells > static_cast<double>(MAX_DENSE_MEMO_CELLS))
+                return std::nullopt;
+            ranges.emplace_back(static_cast<long long>(low), static_cast<long long>(high - low + 1));
+        }
+        return ranges;
+    }
+
+}
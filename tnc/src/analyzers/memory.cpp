@@ -0,0 +1,718 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the memory footprint estimate
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <unordered_set>
+
+#include "analyzers/memoize.h"
+#include "analyzers/memory.h"
+#include "traversal/visitor.h"
+
+namespace tonic {
+
+    namespace {
+
+        // node overheads of libstdc++ containers on 64-bit targets
+        constexpr double TREE_NODE = 32;   // parent, left and right pointers and the color
+        constexpr double HASH_NODE = 24;   // next pointer, cached hash and the bucket pointer
+        constexpr double LIST_NODE = 16;   // previous and next pointers
+
+        // slots of runtime/memo.h hash tables, which start at 1024 and double once half full
+        constexpr double HASH_MEMO_SLOTS = 1024;
+        constexpr double HASH_MEMO_LOAD = 4; // slots per entry right after the table doubled
+
+        const std::unordered_map<std::string, double> SCALAR_SIZES = {
+                {"bool",               1},
+                {"char",               1},
+                {"signed char",        1},
+                {"unsigned char",      1},
+                {"int8_t",             1},
+                {"uint8_t",            1},
+                {"short",              2},
+                {"unsigned short",     2},
+                {"int16_t",            2},
+                {"uint16_t",           2},
+                {"int",                4},
+                {"unsigned",           4},
+                {"unsigned int",       4},
+                {"float",              4},
+                {"int32_t",            4},
+                {"uint32_t",           4},
+                {"long",               8},
+                {"long long",          8},
+                {"unsigned long",      8},
+                {"unsigned long long", 8},
+                {"double",             8},
+                {"size_t",             8},
+                {"int64_t",            8},
+                {"uint64_t",           8},
+                {"auto",               8}, // integers are inferred as long long
+                {"long double",        16},
+                {"__int128",           16},
+        };
+
+        const std::unordered_set<std::string> SEQUENCES = {"vector", "deque", "list", "string", "basic_string"};
+
+        // statements that add one element to the container they are called on
+        const std::unordered_set<std::string> INSERTIONS = {"push_back", "emplace_back", "push_front", "emplace_front",
+                                                            "push", "emplace", "insert", "append"};
+
+        const TypeShape LONG_LONG = {"long long", {}};
+        const TypeShape CHAR = {"char", {}};
+
+        std::string Normalize(std::string_view name) {
+            std::string normalized;
+            size_t position = 0;
+
+            while (position < name.size()) {
+                while (position < name.size() && std::isspace(static_cast<unsigned char>(name[position])))
+                    ++position;
+                size_t start = position;
+                while (position < name.size() && !std::isspace(static_cast<unsigned char>(name[position])))
+                    ++position;
+
+                std::string_view word = name.substr(start, position - start);
+                if (word.starts_with("std::"))
+                    word.remove_prefix(5);
+                if (word.empty() || word == "const" || word == "constexpr" || word == "static")
+                    continue;
+                normalized += (normalized.empty() ? "" : " ") + std::string(word);
+            }
+
+            return normalized;
+        }
+
+        TypeShape ParseShape(std::string_view text, size_t &position) {
+            size_t start = position;
+            while (position < text.size() && text[position] != '<' && text[position] != ',' && text[position] != '>')
+                ++position;
+
+            TypeShape shape{Normalize(text.substr(start, position - start)), {}};
+            if (position < text.size() && text[position] == '<') {
+                ++position;
+                while (position < text.size()) {
+                    shape.arguments.push_back(ParseShape(text, position));
+                    if (position >= text.size())
+                        break;
+                    if (text[position++] == '>')
+                        break;
+                }
+            }
+
+            return shape;
+        }
+
+        const TypeShape &Argument(const TypeShape &type, size_t index, const TypeShape &fallback = LONG_LONG) {
+            return index < type.arguments.size() ? type.arguments[index] : fallback;
+        }
+
+        bool IsOneOf(const std::string &name, std::initializer_list<std::string_view> names) {
+            return std::find(names.begin(), names.end(), name) != names.end();
+        }
+
+        double NumberIn(const TypeShape &type) {
+            char *end = nullptr;
+            double value = std::strtod(type.name.c_str(), &end);
+            return end != type.name.c_str() ? value : 0;
+        }
+
+        // 512 bytes, 3.5 KB, 76.3 MB
+        std::string FormatBytes(double bytes) {
+            const char *units[] = {"bytes", "KB", "MB", "GB", "TB"};
+            size_t unit = 0;
+            while (bytes >= 1024 && unit + 1 < std::size(units)) {
+                bytes /= 1024;
+                ++unit;
+            }
+
+            char buffer[48];
+            if (unit == 0)
+                std::snprintf(buffer, sizeof(buffer), "%.0f %s", bytes, units[unit]);
+            else
+                std::snprintf(buffer, sizeof(buffer), "%.1f %s", bytes, units[unit]);
+            return buffer;
+        }
+
+    }
+
+    TypeShape ParseType(std::string_view type) {
+        size_t position = 0;
+        return ParseShape(type, position);
+    }
+
+    double InlineSize(const TypeShape &type) {
+        const std::string &name = type.name;
+
+        if (auto found = SCALAR_SIZES.find(name); found != SCALAR_SIZES.end())
+            return found->second;
+        if (name.ends_with("*"))
+            return 8;
+        if (IsOneOf(name, {"string", "basic_string"}))
+            return 32;
+        if (IsOneOf(name, {"vector", "list", "priority_queue"}))
+            return 24;
+        if (IsOneOf(name, {"deque", "stack", "queue"}))
+            return 80;
+        if (IsOneOf(name, {"set", "multiset", "map", "multimap"}))
+            return 48;
+        if (IsOneOf(name, {"unordered_set", "unordered_multiset", "unordered_map", "unordered_multimap"}))
+            return 56;
+        if (name == "array")
+            return NumberIn(Argument(type, 1)) * InlineSize(Argument(type, 0));
+        if (name == "bitset")
+            return std::ceil(NumberIn(Argument(type, 0)) / 64) * 8;
+
+        if (IsOneOf(name, {"pair", "tuple"})) {
+            double size = 0, alignment = 1;
+            for (const auto &field: type.arguments) {
+                double field_size = InlineSize(field);
+                double field_alignment = std::clamp(field_size, 1.0, 8.0);
+                size = std::ceil(size / field_alignment) * field_alignment + field_size;
+                alignment = std::max(alignment, field_alignment);
+            }
+            return std::ceil(size / alignment) * alignment;
+        }
+
+        return 8;
+    }
+
+    double ElementSize(const TypeShape &type) {
+        const std::string &name = type.name;
+
+        if (IsOneOf(name, {"string", "basic_string"}))
+            return 1;
+        if (IsOneOf(name, {"vector", "deque", "stack", "queue", "priority_queue"}))
+            return InlineSize(Argument(type, 0));
+        if (name == "list")
+            return LIST_NODE + InlineSize(Argument(type, 0));
+        if (IsOneOf(name, {"set", "multiset"}))
+            return TREE_NODE + InlineSize(Argument(type, 0));
+        if (IsOneOf(name, {"map", "multimap"}))
+            return TREE_NODE + InlineSize({"pair", {Argument(type, 0), Argument(type, 1)}});
+        if (IsOneOf(name, {"unordered_set", "unordered_multiset"}))
+            return HASH_NODE + InlineSize(Argument(type, 0));
+        if (IsOneOf(name, {"unordered_map", "unordered_multimap"}))
+            return HASH_NODE + InlineSize({"pair", {Argument(type, 0), Argument(type, 1)}});
+
+        return 0;
+    }
+
+    class MemoryAnalysis::Collector : public AstVisitor<Collector> {
+    public:
+        explicit Collector(MemoryAnalysis &analysis) : analysis(analysis) {}
+
+        void Visit(FunctionDeclaration &function) {
+            std::string name = function.name ? function.name->statement : "";
+            if (function.name)
+                consumed.insert(function.name.get());
+            if (function.type)
+                consumed.insert(function.type.get());
+
+            if (function.is_memoize)
+                MemoTable(function, name);
+
+            analysis.callees[name];
+            functions.push_back(&function);
+            scopes.push_back(name);
+            saved.push_back(visible);
+            saved_loops.push_back(std::move(loops));
+            loops.clear();
+        }
+
+        void Leave(FunctionDeclaration &) {
+            functions.pop_back();
+            scopes.pop_back();
+            visible = std::move(saved.back());
+            saved.pop_back();
+            loops = std::move(saved_loops.back());
+            saved_loops.pop_back();
+        }
+
+        void Visit(VariableDeclaration &declaration) {
+            if (!declaration.identifier)
+                return;
+            consumed.insert(declaration.identifier.get());
+
+            TypeShape shape = ParseType(declaration.data_type.Text());
+            Cost bytes = Cost::Constant(InlineSize(shape));
+
+            if (declaration.initializer) {
+                DispatchNode(*declaration.initializer, [&](auto &initializer) {
+                    using Type = std::decay_t<decltype(initializer)>;
+
+                    if constexpr (std::is_same_v<Type, GeneralStatement>) {
+                        consumed.insert(&initializer);
+                        std::vector<std::string> tokens = TokenizeExpression(initializer.statement);
+                        bytes = Constructed(shape, tokens, 0, tokens.size());
+                    } else if constexpr (std::is_same_v<Type, ForLoop> || std::is_same_v<Type, RangedLoop>) {
+                        // a list comprehension, a vector of the declared element type
+                        if (ElementSize(shape) == 0)
+                            shape = {"vector", {shape.name == "auto" ? LONG_LONG : shape}};
+                        bytes = Cost::Constant(InlineSize(shape)) +
+                                Trips(initializer).Scaled(ElementSize(shape));
+                    }
+                });
+            }
+
+            if (ElementSize(shape) == 0 && InlineSize(shape) < LARGE_INLINE)
+                return; // scalars
+
+            Record(Atom(declaration.identifier->statement), declaration, scopes.back(), shape, bytes);
+        }
+
+        void Visit(ForLoop &loop) {
+            if (loop.identifier)
+                consumed.insert(loop.identifier.get());
+            Cost trips = Trips(loop);
+            loops.push_back(trips);
+            if (loop.identifier)
+                indices.emplace_back(Atom(loop.identifier->statement), trips);
+        }
+
+        void Leave(ForLoop &loop) {
+            loops.pop_back();
+            if (loop.identifier)
+                indices.pop_back();
+        }
+
+        void Visit(RangedLoop &loop) {
+            if (loop.identifier)
+                consumed.insert(loop.identifier.get());
+            loops.push_back(Trips(loop));
+        }
+
+        void Leave(RangedLoop &) {
+            loops.pop_back();
+        }
+
+        void Visit(WhileLoop &loop) {
+            loops.push_back(Trips(loop));
+        }
+
+        void Leave(WhileLoop &) {
+            loops.pop_back();
+        }
+
+        void Visit(GeneralStatement &statement) {
+            std::vector<std::string> tokens = TokenizeExpression(statement.statement);
+            Calls(tokens);
+
+            if (consumed.contains(&statement) || loops.empty())
+                return; // a single insertion outside loops is constant
+
+            if (tokens.size() < 3 || !IsName(tokens[0]))
+                return;
+
+            auto found = visible.find(Atom(tokens[0]));
+            if (found == visible.end())
+                return;
+
+            const TypeShape &shape = shapes[found->second];
+            bool inserts = (tokens[1] == "." || tokens[1] == "->") && INSERTIONS.contains(tokens[2]);
+            bool indexes = tokens[1] == "[" && IsOneOf(shape.name, {"map", "unordered_map"}) &&
+                           std::find(tokens.begin(), tokens.end(), "=") != tokens.end();
+            bool appends = tokens[1] == "+=" && IsOneOf(shape.name, {"string", "basic_string"});
+            if (!inserts && !indexes && !appends)
+                return;
+
+            Cost repeats = Cost::Constant(1);
+            for (const auto &trips: loops)
+                repeats = repeats * trips;
+
+            Allocation &allocation = analysis.allocations[found->second];
+            allocation.bytes = allocation.bytes + repeats.Scaled(ElementSize(shape));
+        }
+
+    private:
+        // inline objects at least this large, such as array<int, 100000>, are reported like containers
+        static constexpr double LARGE_INLINE = 1024;
+
+        void Record(Atom name, const Node &node, const std::string &scope, const TypeShape &shape, const Cost &bytes) {
+            visible[name] = analysis.allocations.size();
+            analysis.allocations.push_back({name, &node, scope, bytes, std::nullopt});
+            shapes.push_back(shape);
+        }
+
+        // the tables of runtime/memo.h, a dense cell per argument tuple in the declared ranges, or a
+        // slot per combination of the memoized arguments in an open addressing table
+        void MemoTable(const FunctionDeclaration &function, const std::string &name) {
+            TypeShape value = ParseType(function.type ? function.type->statement : "");
+
+            // a cell is the value and its 32-bit epoch, every cell is allocated up front
+            if (auto ranges = DenseMemoRanges(function, &analysis.constraints)) {
+                TypeShape cell{"tuple", {value, {"uint32_t", {}}}};
+                double cells = 1;
+                for (const auto &range: *ranges)
+                    cells *= static_cast<double>(range.second);
+                Record(Atom(name), function, "global", {"vector", {cell}},
+                       Cost::Constant(cells * InlineSize(cell)));
+                return;
+            }
+
+            Cost states = Cost::Constant(1);
+            std::vector<TypeShape> key;
+            for (const auto &[argument, type]: function.arguments) {
+                key.push_back(ParseType(type.Text()));
+                if (SCALAR_SIZES.contains(key.back().name))
+                    states = states * Cost::Symbol(argument);
+            }
+
+            // a slot is the key tuple, the value and a used flag
+            TypeShape slot{"tuple", {{"tuple", key}, value, {"bool", {}}}};
+            Record(Atom(name), function, "global", {"vector", {slot}},
+                   Cost::Constant(HASH_MEMO_SLOTS * InlineSize(slot)) +
+                   states.Scaled(HASH_MEMO_LOAD * InlineSize(slot)));
+        }
+
+        // callees of the current scope, a self call also adds the levels it recurses
+        void Calls(const std::vector<std::string> &tokens) {
+            for (size_t i = 0; i + 1 < tokens.size(); i++) {
+                if (!IsName(tokens[i]) || tokens[i + 1] != "(" || IsMember(tokens, i))
+                    continue;
+
+                analysis.callees[scopes.back()].push_back(tokens[i]);
+                if (functions.empty() || tokens[i] != scopes.back())
+                    continue;
+
+                auto depth = analysis.depths.try_emplace(scopes.back(), Cost::Constant(0)).first;
+                depth->second = depth->second + Depth(*functions.back(), tokens, i + 1);
+            }
+        }
+
+        // n levels for a self call passing n - 1, log n for n / 2 or n >> 1, unknown otherwise
+        static Cost Depth(const FunctionDeclaration &function, const std::vector<std::string> &tokens, size_t open) {
+            size_t close = SkipGroup(tokens, open);
+            for (size_t i = open + 1; i + 2 < close; i++) {
+                bool parameter = std::any_of(function.arguments.begin(), function.arguments.end(),
+                                             [&](const auto &argument) { return argument.first.Text() == tokens[i]; });
+                if (!parameter || IsMember(tokens, i))
+                    continue;
+                if (tokens[i + 1] == "-")
+                    return Cost::Symbol(Atom(tokens[i]));
+                if (tokens[i + 1] == "/" || tokens[i + 1] == ">>")
+                    return Cost::Log(Atom(tokens[i]));
+            }
+            return Cost::Symbol(UNKNOWN_SYMBOL);
+        }
+
+        Cost Resolve(Atom name) const {
+            for (auto index = indices.rbegin(); index != indices.rend(); ++index)
+                if (index->first == name)
+                    return index->second;
+            if (std::optional<int64_t> constant = analysis.bounds.ConstantOf(name))
+                return Cost::Constant(static_cast<double>(*constant));
+            return Cost::Symbol(name);
+        }
+
+        Cost Expression(const std::string &expression) const {
+            return ExpressionCost(expression, [this](Atom name) { return Resolve(name); });
+        }
+
+        Cost Trips(const ForLoop &loop) const {
+            if (loop.trip_count)
+                return Cost::Constant(static_cast<double>(*loop.trip_count));
+
+            const auto &bound = loop.step_sign < 0 ? loop.start : loop.end;
+            return bound ? Expression(bound->statement) : Cost::Symbol(UNKNOWN_SYMBOL);
+        }
+
+        Cost Trips(const RangedLoop &loop) const {
+            return loop.object ? Expression(loop.object->statement) : Cost::Symbol(UNKNOWN_SYMBOL);
+        }
+
+        // constrained names of the condition, as in "while q - -"
+        Cost Trips(const WhileLoop &loop) const {
+            if (!loop.condition)
+                return Cost::Symbol(UNKNOWN_SYMBOL);
+
+            Cost trips = Cost::Constant(0);
+            bool bounded = false;
+            for (Atom name: ExpressionNames(loop.condition->statement)) {
+                if (analysis.constraints.contains(name)) {
+                    trips = trips + Cost::Symbol(name);
+                    bounded = true;
+                }
+            }
+            return bounded ? trips : Cost::Symbol(UNKNOWN_SYMBOL);
+        }
+
+        /**
+         * Bytes of an object initialized by tokens[begin, end), such as "vector < int > ( n + 1 , 0 )",
+         * "{ 1 , 2 , 3 }" or the name of another container, a type in front replaces the declared one.
+         */
+        Cost Constructed(TypeShape &shape, const std::vector<std::string> &tokens, size_t begin, size_t end) {
+            size_t position = begin;
+
+            if (position + 1 < end && IsName(tokens[position]) &&
+                (tokens[position + 1] == "<" || tokens[position + 1] == "(" || tokens[position + 1] == "{")) {
+                std::string type = tokens[position++];
+                for (int depth = 0; position < end && (depth > 0 || tokens[position] == "<"); ++position) {
+                    if (tokens[position] == "<")
+                        depth++;
+                    else if (tokens[position] == ">")
+                        depth--;
+                    else if (tokens[position] == ">>")
+                        depth -= 2;
+                    type += tokens[position];
+                }
+
+                TypeShape named = ParseType(type);
+                if (ElementSize(named) == 0 && InlineSize(named) < LARGE_INLINE)
+                    return Cost::Constant(InlineSize(shape)); // a call or a scalar expression
+                shape = named;
+            } else if (position + 1 == end && IsName(tokens[position])) {
+                auto found = visible.find(Atom(tokens[position]));
+                if (found != visible.end()) {
+                    shape = shapes[found->second];
+                    return analysis.allocations[found->second].bytes; // a copy
+                }
+            }
+
+            Cost bytes = Cost::Constant(InlineSize(shape));
+            if (position >= end || (tokens[position] != "(" && tokens[position] != "{" && tokens[position] != "["))
+                return bytes;
+
+            // top-level arguments between the brackets
+            std::vector<std::pair<size_t, size_t>> arguments;
+            size_t start = position + 1;
+            int depth = 0;
+            for (size_t i = position; i < end; i++) {
+                const std::string &token = tokens[i];
+                if (token == "(" || token == "{" || token == "[") {
+                    depth++;
+                } else if (token == ")" || token == "}" || token == "]") {
+                    if (--depth == 0) {
+                        if (i > start)
+                            arguments.emplace_back(start, i);
+                        break;
+                    }
+                } else if (token == "," && depth == 1) {
+                    arguments.emplace_back(start, i);
+                    start = i + 1;
+                }
+            }
+
+            bool is_string = IsOneOf(shape.name, {"string", "basic_string"});
+            TypeShape element = is_string ? CHAR : Argument(shape, 0);
+            double overhead = ElementSize(shape) - InlineSize(element);
+
+            if (tokens[position] == "(" && SEQUENCES.contains(shape.name)) {
+                if (arguments.empty())
+                    return bytes;
+
+                auto [count_begin, count_end] = arguments[0];
+                std::string count;
+                for (size_t i = count_begin; i < count_end; i++)
+                    count += (i > count_begin ? " " : "") + tokens[i];
+
+                Cost each = Cost::Constant(InlineSize(element));
+                if (arguments.size() > 1 && !is_string)
+                    each = Constructed(element, tokens, arguments[1].first, arguments[1].second);
+                return bytes + Expression(count) * (each + Cost::Constant(overhead));
+            }
+
+            if (ElementSize(shape) == 0)
+                return bytes;
+
+            // a list literal, one element per argument
+            for (auto [argument_begin, argument_end]: arguments) {
+                TypeShape copy = element;
+                bytes = bytes + Constructed(copy, tokens, argument_begin, argument_end) + Cost::Constant(overhead);
+            }
+            return bytes;
+        }
+
+        MemoryAnalysis &analysis;
+
+        std::vector<std::string> scopes = {"global"};
+        std::vector<const FunctionDeclaration *> functions; // enclosing the current scope
+        std::unordered_map<Atom, size_t> visible; // name to allocation, shadowed by later declarations
+        std::vector<TypeShape> shapes;            // parallel to the allocations
+        std::vector<std::unordered_map<Atom, size_t>> saved;
+        std::vector<Cost> loops;                  // trip counts of the enclosing loops
+        std::vector<std::vector<Cost>> saved_loops;
+        std::vector<std::pair<Atom, Cost>> indices;
+        std::unordered_set<const Node *> consumed;
+    };
+
+    MemoryAnalysis::MemoryAnalysis(Diagnostics &diagnostics, Constraints constraints, double limit)
+            : diagnostics(diagnostics), constraints(std::move(constraints)), limit(limit) {}
+
+    void MemoryAnalysis::Run(Program &program) {
+        bounds.Run(program);
+        Collector(*this).Traverse(program);
+
+        for (auto &allocation: allocations)
+            allocation.estimate = allocation.bytes.Estimate(constraints);
+
+        for (const auto &allocation: allocations) {
+            auto scope = std::find_if(scopes.begin(), scopes.end(),
+                                      [&](const ScopeFootprint &footprint) { return footprint.name == allocation.scope; });
+            if (scope == scopes.end())
+                scope = scopes.insert(scopes.end(), ScopeFootprint{allocation.scope, Cost::Constant(0), std::nullopt});
+            scope->bytes = scope->bytes + allocation.bytes;
+        }
+
+        // global data and memo tables stay alive, the locals of one chain of calls on top of them
+        bool known = true;
+        bounded_peak = 0;
+        for (auto &scope: scopes) {
+            scope.estimate = scope.bytes.Estimate(constraints);
+
+            double bounded = 0;
+            for (const auto &allocation: allocations)
+                if (allocation.scope == scope.name && allocation.estimate)
+                    bounded += *allocation.estimate;
+
+            if (scope.name == "global") {
+                bounded_peak += scope.estimate.value_or(bounded);
+                known = known && scope.estimate;
+            } else {
+                locals[scope.name] = {scope.estimate.value_or(bounded), scope.estimate.has_value()};
+            }
+        }
+
+        double largest_chain = 0;
+        for (const auto &[function, called]: callees) {
+            if (function == "global")
+                continue;
+            std::unordered_set<std::string> open;
+            Chain chain = ChainOf(function, open);
+            largest_chain = std::max(largest_chain, chain.bounded);
+            known = known && chain.known;
+        }
+        bounded_peak += largest_chain;
+        peak = known ? std::optional(bounded_peak) : std::nullopt;
+
+        std::vector<const Allocation *> ranked;
+        for (const auto &allocation: allocations)
+            ranked.push_back(&allocation);
+        std::stable_sort(ranked.begin(), ranked.end(), [](const Allocation *first, const Allocation *second) {
+            return first->estimate.value_or(INFINITY) > second->estimate.value_or(INFINITY);
+        });
+
+        for (size_t i = 0; i < ranked.size() && i < TOP_CONSUMERS; i++) {
+            const Allocation &allocation = *ranked[i];
+            std::string subject = allocation.node->kind == NodeKind::FUNCTION_DECLARATION
+                                  ? "memo table of `" + allocation.name.Text() + "`"
+                                  : "`" + allocation.name.Text() + "`";
+            std::string shape = allocation.bytes.ToString();
+
+            if (allocation.estimate) {
+                std::string message = subject + " holds about " + FormatBytes(*allocation.estimate);
+                if (shape != "O(1)")
+                    message += ", " + shape + " bytes";
+                diagnostics.Note("memory", message, allocation.node->line);
+                continue;
+            }
+
+            std::vector<Atom> unbounded = allocation.bytes.Unbounded(constraints);
+            unbounded.erase(std::remove(unbounded.begin(), unbounded.end(), UNKNOWN_SYMBOL), unbounded.end());
+            std::string message = subject + " holds " + shape + " bytes";
+            if (unbounded.empty()) {
+                message += ", its size could not be bounded";
+            } else {
+                message += ", constrain ";
+                for (size_t j = 0; j < unbounded.size(); j++)
+                    message += (j ? ", `" : "`") + unbounded[j].Text() + "`";
+                message += " to estimate it";
+            }
+            diagnostics.Note("memory", message, allocation.node->line);
+        }
+
+        for (const auto &scope: scopes) {
+            if (!scope.estimate)
+                continue;
+            std::string subject = scope.name == "global" ? "global data" : "function `" + scope.name + "`";
+            diagnostics.Note("memory", subject + " holds about " + FormatBytes(*scope.estimate), 0);
+        }
+
+        if (!peak) {
+            if (bounded_peak > limit) {
+                auto largest = std::find_if(ranked.begin(), ranked.end(), [](const Allocation *allocation) {
+                    return allocation->estimate.has_value();
+                });
+                size_t line = largest == ranked.end() ? 0 : (*largest)->node->line;
+                diagnostics.Warning("memory", "the bounded allocations alone hold about " + FormatBytes(bounded_peak) +
+                                              ", over the limit of " + FormatBytes(limit) +
+                                              ", the rest could not be bounded", line);
+            } else if (bounded_peak > 0) {
+                diagnostics.Note("memory", "peak memory is at least " + FormatBytes(bounded_peak) + " of the " +
+                                           FormatBytes(limit) + " limit, the rest could not be bounded", 0);
+            }
+            return;
+        }
+
+        if (*peak > limit) {
+            size_t line = ranked.empty() ? 0 : ranked[0]->node->line;
+            diagnostics.Warning("memory", "peak memory of about " + FormatBytes(*peak) + " exceeds the limit of " +
+                                          FormatBytes(limit), line);
+        } else if (!allocations.empty()) {
+            diagnostics.Note("memory", "peak memory is about " + FormatBytes(*peak) + " of the " + FormatBytes(limit) +
+                                       " limit", 0);
+        }
+    }
+
+    MemoryAnalysis::Chain MemoryAnalysis::ChainOf(const std::string &function, std::unordered_set<std::string> &open) {
+        auto memoized = chains.find(function);
+        if (memoized != chains.end())
+            return memoized->second;
+
+        auto own = locals.find(function);
+        Chain chain = own == locals.end() ? Chain{} : own->second;
+
+        auto depth = depths.find(function);
+        if (depth != depths.end() && own != locals.end()) {
+            std::optional<double> levels = depth->second.Estimate(constraints);
+            chain.bounded *= std::max(levels.value_or(1), 1.0);
+            chain.known = chain.known && levels;
+        }
+
+        open.insert(function);
+        double deepest = 0;
+        for (const auto &callee: callees.at(function)) {
+            if (callee == function || !callees.contains(callee))
+                continue;
+
+            // mutual recursion repeats the locals of the cycle an unknown number of times
+            if (open.contains(callee)) {
+                chain.known = chain.known && !locals.contains(callee) && own == locals.end();
+                continue;
+            }
+
+            Chain below = ChainOf(callee, open);
+            deepest = std::max(deepest, below.bounded);
+            chain.known = chain.known && below.known;
+        }
+        open.erase(function);
+
+        chain.bounded += deepest;
+        return chains[function] = chain;
+    }
+
+    const std::vector<Allocation> &MemoryAnalysis::Allocations() const {
+        return allocations;
+    }
+
+    const std::vector<ScopeFootprint> &MemoryAnalysis::Scopes() const {
+        return scopes;
+    }
+
+    std::optional<double> MemoryAnalysis::Peak() const {
+        return peak;
+    }
+
+    double MemoryAnalysis::BoundedPeak() const {
+        return bounded_peak;
+    }
+
+}
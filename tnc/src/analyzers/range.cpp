@@ -0,0 +1,548 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the value range analysis
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <unordered_set>
+
+#include "analyzers/range.h"
+#include "core/children.h"
+#include "traversal/visitor.h"
+
+namespace tonic {
+
+    namespace {
+
+        constexpr int WIDEN_AFTER = 8; // rounds before a range that keeps growing is widened
+        constexpr int MAX_ROUNDS = 64;
+
+        constexpr double INF = std::numeric_limits<double>::infinity();
+
+        const Atom INT_ATOM = "int";
+        const Atom LONG_LONG_ATOM = "long long";
+
+        std::string Describe(const Interval &interval) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(0) << "[" << interval.low << ", " << interval.high << "]";
+            return out.str();
+        }
+
+        Interval Clamp(const Interval &interval, const Interval &bounds) {
+            Interval clamped = Interval::Of(std::max(interval.low, bounds.low), std::min(interval.high, bounds.high));
+            return clamped.IsEmpty() ? bounds : clamped;
+        }
+
+        // whether a statement under the node calls the function of that name
+        bool Calls(const Node &node, Atom name) {
+            if (node.kind == NodeKind::GENERAL_STATEMENT) {
+                std::vector<std::string> tokens = TokenizeExpression(NodeAs<GeneralStatement>(node).statement);
+                for (size_t i = 0; i + 1 < tokens.size(); i++) {
+                    if (!IsMember(tokens, i) && tokens[i] == name.Text() && tokens[i + 1] == "(")
+                        return true;
+                }
+                return false;
+            }
+
+            bool found = false;
+            ForEachChildSlot(node, [&](const auto &slot) {
+                found = found || (slot && Calls(*slot, name));
+            });
+            return found;
+        }
+
+    }
+
+    class RangeAnalysis::Collector : public AstVisitor<Collector> {
+    public:
+        explicit Collector(RangeAnalysis &analysis) : analysis(analysis) {}
+
+        void Visit(VariableDeclaration &declaration) {
+            if (!declaration.identifier || !IsName(declaration.identifier->statement))
+                return;
+
+            consumed.insert(declaration.identifier.get());
+            size_t index = analysis.VariableFor(Atom(declaration.identifier->statement));
+
+            if (declaration.data_type != AUTO_ATOM) {
+                Declare(index, declaration.data_type);
+                if (!declaration.initializer)
+                    Define(DefinitionKind::INPUT, index, '=', "", declaration.line);
+            }
+
+            if (!declaration.initializer)
+                return;
+
+            Variable &variable = analysis.variables[index];
+            if (declaration.data_type == AUTO_ATOM) {
+                variable.auto_declared = true;
+                if (!variable.declaration)
+                    variable.declaration = &declaration;
+            }
+
+            if (declaration.initializer->kind == NodeKind::GENERAL_STATEMENT) {
+                auto &initializer = NodeAs<GeneralStatement>(*declaration.initializer);
+                consumed.insert(&initializer);
+                Define(DefinitionKind::ASSIGN, index, '=', initializer.statement, declaration.line);
+                DefineWrites(initializer.statement, declaration.line);
+            } else {
+                variable.other = true;
+            }
+        }
+
+        void Visit(ForLoop &loop) {
+            if (!loop.identifier || !IsName(loop.identifier->statement))
+                return;
+
+            size_t index = analysis.VariableFor(loop);
+            if (loop.id_type != AUTO_ATOM)
+                Declare(index, loop.id_type);
+            else
+                analysis.variables[index].declaration = &loop;
+
+            for (const auto &slot: {loop.identifier, loop.start, loop.end, loop.step})
+                consumed.insert(slot.get());
+
+            analysis.definitions.push_back({DefinitionKind::LOOP, index, '=', "", &loop, loops, loop.line,
+                                            Repeats()});
+            loops.push_back(&loop);
+        }
+
+        void Leave(ForLoop &loop) {
+            if (!loops.empty() && loops.back() == &loop)
+                loops.pop_back();
+        }
+
+        void Visit(InputOutput &io) {
+            if (io.type != InOut::IN)
+                return;
+
+            for (const auto &operand: io.operands) {
+                if (!operand || !IsName(operand->statement))
+                    continue;
+
+                consumed.insert(operand.get());
+                Define(DefinitionKind::INPUT, Target(Atom(operand->statement)), '=', "", operand->line);
+            }
+        }
+
+        void Visit(GeneralStatement &statement) {
+            if (consumed.contains(&statement))
+                return;
+
+            std::optional<Assignment> assignment = SplitAssignment(statement.statement);
+            if (!assignment) {
+                analysis.uses.push_back({statement.statement, loops, statement.line});
+                DefineWrites(statement.statement, statement.line);
+                return;
+            }
+            DefineWrites(assignment->value, statement.line);
+
+            size_t index = Target(assignment->target);
+            if (assignment->operation == '=') {
+                Define(DefinitionKind::ASSIGN, index, '=', assignment->value, statement.line);
+            } else if (assignment->operation == '+' || assignment->operation == '-') {
+                Define(DefinitionKind::INCREMENT, index, assignment->operation, assignment->value, statement.line);
+            } else {
+                std::string value = assignment->target.Text() + " " + BinaryOperator(*assignment) + " ( " +
+                                    assignment->value + " )";
+                Define(DefinitionKind::ASSIGN, index, '=', value, statement.line);
+            }
+        }
+
+        // names bound by other constructs either carry a type or are of unknown type
+
+        void Visit(FunctionDeclaration &function) {
+            for (const auto &[name, type]: function.arguments)
+                Bind(name, type, function.line);
+
+            bool recursive = function.name && function.block && Calls(*function.block, Atom(function.name->statement));
+            factors.push_back(recursive ? INF : 1);
+        }
+
+        void Leave(FunctionDeclaration &) {
+            factors.pop_back();
+        }
+
+        void Visit(WhileLoop &) {
+            factors.push_back(INF);
+        }
+
+        void Leave(WhileLoop &) {
+            factors.pop_back();
+        }
+
+        void Visit(LambdaExpression &lambda) {
+            for (const auto &[name, type]: lambda.arguments)
+                Bind(name, type, lambda.line);
+        }
+
+        void Visit(TryCatchStatement &statement) {
+            for (const auto &[name, type]: statement.catch_arguments)
+                Bind(name, type, statement.line);
+        }
+
+        void Visit(RangedLoop &loop) {
+            if (loop.identifier && IsName(loop.identifier->statement)) {
+                consumed.insert(loop.identifier.get());
+                Bind(Atom(loop.identifier->statement), loop.id_type, loop.line);
+            }
+
+            // a constraint such as |s| <= 1e5 bounds the elements of s
+            double size = INF;
+            if (loop.object && IsName(loop.object->statement)) {
+                auto assumption = analysis.assumptions.find(Atom(loop.object->statement));
+                if (assumption != analysis.assumptions.end() && std::isfinite(assumption->second.high))
+                    size = std::max(assumption->second.high, 0.0);
+            }
+            factors.push_back(size);
+        }
+
+        void Leave(RangedLoop &) {
+            factors.pop_back();
+        }
+
+        void Visit(PairDestructuring &pair) {
+            Bind(pair.first_var, AUTO_ATOM, pair.line);
+            Bind(pair.second_var, AUTO_ATOM, pair.line);
+        }
+
+    private:
+        size_t Target(Atom name) {
+            std::optional<size_t> index = analysis.Resolve(name, loops);
+            return index ? *index : analysis.VariableFor(name);
+        }
+
+        void Declare(size_t index, Atom type) {
+            Variable &variable = analysis.variables[index];
+            std::optional<Interval> range = TypeRange(type);
+
+            if (!range)
+                variable.other = true;
+            else
+                variable.declared = variable.declared ? variable.declared->Hull(*range) : *range;
+        }
+
+        void Bind(Atom name, Atom type, size_t line) {
+            size_t index = analysis.VariableFor(name);
+            if (type == AUTO_ATOM || type.Empty()) {
+                analysis.variables[index].other = true;
+                return;
+            }
+
+            Declare(index, type);
+            Define(DefinitionKind::INPUT, index, '=', "", line);
+        }
+
+        void Define(DefinitionKind kind, size_t index, char operation, std::string value, size_t line) {
+            analysis.definitions.push_back({kind, index, operation, std::move(value), nullptr, loops, line,
+                                            Repeats()});
+        }
+
+        // "c ++" and "-- c" inside a larger expression, such as a [ c ++ ] = i, any other write, as in
+        // x <<= 1 inside a condition or swap ( x , y ), leaves the variable unbounded
+        void DefineWrites(const std::string &text, size_t line) {
+            std::vector<std::string> tokens = TokenizeExpression(text);
+            for (size_t i = 0; i < tokens.size(); i++) {
+                bool step = (i > 0 && (tokens[i - 1] == "++" || tokens[i - 1] == "--")) ||
+                            (i + 1 < tokens.size() && (tokens[i + 1] == "++" || tokens[i + 1] == "--"));
+                if (!step && IsWritten(tokens, i))
+                    Define(DefinitionKind::UNKNOWN, Target(Atom(tokens[i])), '=', "", line);
+            }
+
+            for (size_t i = 0; i < tokens.size(); i++) {
+                if (tokens[i] != "++" && tokens[i] != "--")
+                    continue;
+
+                if (i > 0 && IsName(tokens[i - 1]) && !IsMember(tokens, i - 1))
+                    Define(DefinitionKind::INCREMENT, Target(Atom(tokens[i - 1])), tokens[i][0], "1", line);
+                else if (i + 1 < tokens.size() && IsName(tokens[i + 1]))
+                    Define(DefinitionKind::INCREMENT, Target(Atom(tokens[i + 1])), tokens[i][0], "1", line);
+            }
+        }
+
+        double Repeats() const {
+            double repeats = 1;
+            for (double factor: factors)
+                repeats *= factor;
+            return repeats;
+        }
+
+        RangeAnalysis &analysis;
+        std::vector<const ForLoop *> loops;
+        std::vector<double> factors; // repeats of the enclosing constructs that are not for loops
+        std::unordered_set<const Node *> consumed; // statements handled by the construct that owns them
+    };
+
+    RangeAnalysis::RangeAnalysis(Diagnostics &diagnostics) : diagnostics(diagnostics) {}
+
+    void RangeAnalysis::Assume(Atom name, Interval range) {
+        assumptions[name] = range;
+    }
+
+    void RangeAnalysis::Run(Node &root) {
+        Collector(*this).Traverse(root);
+        Solve();
+
+        for (const auto &definition: definitions) {
+            if (definition.kind == DefinitionKind::LOOP) {
+                for (const auto &slot: {definition.loop->start, definition.loop->end, definition.loop->step}) {
+                    if (slot)
+                        CheckOverflow(slot->statement, definition.loops, definition.line);
+                }
+            } else if (definition.kind == DefinitionKind::INCREMENT && Pinned(variables[definition.variable])) {
+                // the solved range holds every sum unless an assumption or a declaration replaced it
+                std::string sum = variables[definition.variable].name.Text() + " " + definition.operation + " ( " +
+                                  definition.value + " )";
+                CheckOverflow(sum, definition.loops, definition.line);
+            } else if (definition.kind == DefinitionKind::ASSIGN || definition.kind == DefinitionKind::INCREMENT) {
+                CheckOverflow(definition.value, definition.loops, definition.line);
+            }
+        }
+        for (const auto &use: uses)
+            CheckOverflow(use.text, use.loops, use.line);
+
+        Decide();
+    }
+
+    const std::vector<RangeDecision> &RangeAnalysis::Decisions() const {
+        return decisions;
+    }
+
+    Interval RangeAnalysis::RangeOf(Atom name) const {
+        auto found = by_name.find(name);
+        if (found == by_name.end() || variables[found->second].other)
+            return Interval::Unbounded();
+
+        return variables[found->second].range;
+    }
+
+    size_t RangeAnalysis::VariableFor(Atom name) {
+        auto [found, inserted] = by_name.emplace(name, variables.size());
+        if (inserted) {
+            variables.push_back({});
+            variables.back().name = name;
+
+            auto assumption = assumptions.find(name);
+            if (assumption != assumptions.end())
+                variables.back().assumed = assumption->second;
+        }
+
+        return found->second;
+    }
+
+    size_t RangeAnalysis::VariableFor(const ForLoop &loop) {
+        auto [found, inserted] = by_loop.emplace(&loop, variables.size());
+        if (inserted) {
+            variables.push_back({});
+            variables.back().name = Atom(loop.identifier->statement);
+            variables.back().loop = &loop;
+        }
+
+        return found->second;
+    }
+
+    std::optional<size_t> RangeAnalysis::Resolve(Atom name, const std::vector<const ForLoop *> &loops) const {
+        for (auto loop = loops.rbegin(); loop != loops.rend(); ++loop) {
+            auto found = by_loop.find(*loop);
+            if (found != by_loop.end() && variables[found->second].name == name)
+                return found->second;
+        }
+
+        auto found = by_name.find(name);
+        if (found == by_name.end())
+            return std::nullopt;
+
+        return found->second;
+    }
+
+    Evaluation RangeAnalysis::Evaluate(const std::string &text, const std::vector<const ForLoop *> &loops) const {
+        return EvaluateInterval(text, [&](Atom name) -> std::optional<Interval> {
+            std::optional<size_t> index = Resolve(name, loops);
+            if (!index || variables[*index].other)
+                return std::nullopt;
+
+            return variables[*index].range;
+        });
+    }
+
+    void RangeAnalysis::Solve() {
+        size_t count = variables.size();
+
+        for (int round = 0; round < MAX_ROUNDS; round++) {
+            std::vector<Interval> base(count, Interval::Empty());
+            std::vector<bool> has_base(count, false);
+            std::vector<double> low_delta(count, 0);
+            std::vector<double> high_delta(count, 0);
+            std::vector<double> trips(count, 0);
+
+            for (const auto &definition: definitions) {
+                Variable &variable = variables[definition.variable];
+                Interval contribution = Interval::Unbounded();
+
+                if (definition.kind == DefinitionKind::ASSIGN) {
+                    Evaluation evaluation = Evaluate(definition.value, definition.loops);
+                    variable.other |= evaluation.kind == ValueKind::OTHER;
+                    variable.boolean |= evaluation.kind == ValueKind::BOOLEAN;
+                    contribution = evaluation.value;
+                } else if (definition.kind == DefinitionKind::INPUT) {
+                    if (variable.assumed)
+                        contribution = *variable.assumed;
+                    else if (variable.declared)
+                        contribution = *variable.declared;
+                } else if (definition.kind == DefinitionKind::UNKNOWN) {
+                    // the contribution stays unbounded
+                } else if (definition.kind == DefinitionKind::LOOP) {
+                    const ForLoop &loop = *definition.loop;
+                    if (!loop.start || !loop.end) {
+                        variable.other = true;
+                        trips[definition.variable] = INF;
+                    } else {
+                        Evaluation start = Evaluate(loop.start->statement, definition.loops);
+                        Evaluation end = Evaluate(loop.end->statement, definition.loops);
+                        Evaluation step = loop.step ? Evaluate(loop.step->statement, definition.loops) : Evaluation{
+                                Interval::Point(1), ValueKind::INTEGER, {}};
+
+                        variable.other |= start.kind != ValueKind::INTEGER || end.kind != ValueKind::INTEGER ||
+                                          step.kind != ValueKind::INTEGER;
+
+                        // the index leaves the loop at most one step minus one past the end
+                        const Interval &first = start.value, &last = end.value, &stride = step.value;
+                        double overshoot = std::max(std::max(std::abs(stride.low), std::abs(stride.high)) - 1, 0.0);
+                        double shortest = stride.low > 0 || stride.high < 0
+                                          ? std::min(std::abs(stride.low), std::abs(stride.high)) : 1;
+
+                        double width = 0;
+                        if (stride.low > 0) {
+                            contribution = Interval::Of(first.low, std::max(first.high, last.high + overshoot));
+                            width = last.high - first.low;
+                        } else if (stride.high < 0) {
+                            contribution = Interval::Of(std::min(first.low, last.low - overshoot), first.high);
+                            width = first.high - last.low;
+                        } else {
+                            Interval span = first.Hull(last);
+                            contribution = Interval::Of(span.low - overshoot, span.high + overshoot);
+                            width = std::max(last.high - first.low, first.high - last.low);
+                        }
+
+                        trips[definition.variable] = std::ceil(std::max(width, 0.0) / std::max(shortest, 1.0));
+                    }
+                } else {
+                    Evaluation evaluation = Evaluate(definition.value, definition.loops);
+                    variable.other |= evaluation.kind == ValueKind::OTHER;
+
+                    double repeats = definition.repeats;
+                    for (const ForLoop *loop: definition.loops)
+                        repeats *= variables[by_loop.at(loop)].trips;
+
+                    Interval step = evaluation.value;
+                    if (definition.operation == '-')
+                        step = Interval::Of(-step.high, -step.low);
+
+                    if (!step.IsEmpty()) {
+                        low_delta[definition.variable] += std::min(0.0, step.low == 0 ? 0 : step.low * repeats);
+                        high_delta[definition.variable] += std::max(0.0, step.high == 0 ? 0 : step.high * repeats);
+                    }
+                    continue;
+                }
+
+                base[definition.variable] = base[definition.variable].Hull(contribution);
+                has_base[definition.variable] = true;
+            }
+
+            bool changed = false;
+            for (size_t i = 0; i < count; i++) {
+                Variable &variable = variables[i];
+                if (variable.loop)
+                    variable.trips = trips[i];
+
+                Interval range = base[i];
+                if (!has_base[i] && (low_delta[i] != 0 || high_delta[i] != 0))
+                    range = Interval::Unbounded(); // incremented but never assigned here
+                if (!range.IsEmpty())
+                    range = Interval::Of(range.low + low_delta[i], range.high + high_delta[i]);
+
+                if (round >= WIDEN_AFTER && !variable.range.IsEmpty() && !range.IsEmpty()) {
+                    range = Interval::Of(range.low < variable.range.low ? -INF : range.low,
+                                         range.high > variable.range.high ? INF : range.high);
+                }
+
+                if (variable.assumed)
+                    range = *variable.assumed;
+                else if (variable.declared && !variable.auto_declared)
+                    range = range.IsEmpty() ? *variable.declared : Clamp(range, *variable.declared);
+
+                if (!(range == variable.range)) {
+                    variable.range = range;
+                    changed = true;
+                }
+            }
+
+            if (!changed)
+                break;
+        }
+
+        // nothing bounds a variable that was never given a value
+        for (auto &variable: variables) {
+            if (variable.range.IsEmpty())
+                variable.range = Interval::Unbounded();
+        }
+    }
+
+    bool RangeAnalysis::Pinned(const Variable &variable) {
+        return variable.assumed || (variable.declared && !variable.auto_declared);
+    }
+
+    void RangeAnalysis::CheckOverflow(const std::string &text, const std::vector<const ForLoop *> &loops,
+                                      size_t line) {
+        for (Atom name: Evaluate(text, loops).overflowing) {
+            std::optional<size_t> index = Resolve(name, loops);
+            if (index && variables[*index].overflow.empty()) {
+                variables[*index].overflow = text;
+                variables[*index].overflow_line = line;
+            }
+        }
+    }
+
+    void RangeAnalysis::Decide() {
+        for (auto &variable: variables) {
+            if (!variable.declaration || variable.other || variable.boolean)
+                continue;
+
+            bool narrow = variable.range.FitsInt32() && variable.overflow.empty();
+            Atom type = narrow ? INT_ATOM : LONG_LONG_ATOM;
+
+            if (variable.loop)
+                NodeAs<ForLoop>(*variable.declaration).id_type = type;
+            else
+                NodeAs<VariableDeclaration>(*variable.declaration).data_type = type;
+
+            decisions.push_back({variable.declaration, variable.name, type, variable.range});
+
+            std::string subject = (variable.loop ? "loop index `" : "`") + variable.name.Text() + "`";
+            std::string message;
+            if (narrow) {
+                message = subject + " is int, its values stay within " + Describe(variable.range);
+            } else if (!variable.overflow.empty()) {
+                message = subject + " is long long, `" + variable.overflow + "`";
+                if (variable.overflow_line)
+                    message += " on line " + std::to_string(variable.overflow_line);
+                message += " can exceed 32 bits";
+            } else if (!variable.range.IsBounded()) {
+                message = subject + " is long long, its range could not be bounded";
+            } else {
+                message = subject + " is long long, its values may reach " + Describe(variable.range);
+            }
+
+            diagnostics.Note("range", message, variable.declaration->line);
+        }
+    }
+
+}
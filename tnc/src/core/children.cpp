@@ -0,0 +1,63 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the uniform child slot access
+ */
+
+#include "core/children.h"
+#include "errors/errors.h"
+
+namespace tonic {
+
+    size_t ChildCount(const Node &node) {
+        size_t count = 0;
+        ForEachChildSlot(node, [&](const auto &) { ++count; });
+        return count;
+    }
+
+    std::shared_ptr<Node> GetChild(const Node &node, size_t index) {
+        std::shared_ptr<Node> result;
+        size_t i = 0;
+
+        ForEachChildSlot(node, [&](const auto &slot) {
+            if (i++ == index)
+                result = slot;
+        });
+
+        if (index >= i)
+            throw InternalError("Child index " + std::to_string(index) + " is out of range");
+
+        return result;
+    }
+
+    void SetChild(Node &node, size_t index, const std::shared_ptr<Node> &child) {
+        size_t i = 0;
+
+        ForEachChildSlot(node, [&](auto &slot) {
+            if (i++ != index)
+                return;
+
+            using SlotType = typename std::remove_reference_t<decltype(slot)>::element_type;
+            if constexpr (std::is_same_v<SlotType, Node>) {
+                slot = child;
+            } else {
+                if (child && child->kind != SlotType::KIND)
+                    throw InternalError("Child node type does not fit the slot at index " + std::to_string(index));
+
+                slot = std::static_pointer_cast<SlotType>(child);
+            }
+        });
+
+        if (index >= i)
+            throw InternalError("Child index " + std::to_string(index) + " is out of range");
+    }
+
+    std::shared_ptr<Node> ShallowCopy(const Node &node) {
+        return DispatchNode(node, [](const auto &concrete) -> std::shared_ptr<Node> {
+            return std::make_shared<std::remove_cvref_t<decltype(concrete)>>(concrete);
+        });
+    }
+
+}
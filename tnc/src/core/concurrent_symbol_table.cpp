@@ -0,0 +1,159 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the read-mostly concurrent symbol table
+ */
+
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
+
+#include "core/concurrent_symbol_table.h"
+#include "errors/errors.h"
+
+namespace tonic {
+
+    ConcurrentSymbolTable::ConcurrentSymbolTable() {
+        // every shard starts with an empty snapshot so lookups never see nullptr
+        for (auto &shard: shards)
+            shard.current.store(Build(nullptr, {}), std::memory_order_relaxed);
+    }
+
+    ConcurrentSymbolTable::~ConcurrentSymbolTable() {
+        Reclaim();
+        for (auto &shard: shards)
+            delete shard.current.load(std::memory_order_relaxed);
+    }
+
+    void ConcurrentSymbolTable::Insert(Atom name, Atom type) {
+        std::lock_guard lock(staging_mutex);
+        staged.emplace_back(name, type);
+    }
+
+    void ConcurrentSymbolTable::Publish() {
+        std::vector<SymbolInfo> batch;
+        {
+            std::lock_guard lock(staging_mutex);
+            batch.swap(staged);
+        }
+
+        std::array<std::vector<SymbolInfo>, size_t(1) << SHARD_BITS> by_shard;
+        for (const auto &symbol: batch)
+            by_shard[symbol.name.Id() & (shards.size() - 1)].push_back(symbol);
+
+        for (size_t i = 0; i < shards.size(); i++) {
+            if (by_shard[i].empty())
+                continue;
+
+            const Snapshot *previous = shards[i].current.load(std::memory_order_relaxed);
+            shards[i].current.store(Build(previous, by_shard[i]), std::memory_order_release);
+            retired.push_back(previous);
+        }
+    }
+
+    void ConcurrentSymbolTable::Reclaim() {
+        for (const Snapshot *snapshot: retired)
+            delete snapshot;
+        retired.clear();
+    }
+
+    const SymbolInfo *ConcurrentSymbolTable::Find(Atom name) const {
+        uint32_t id = name.Id();
+        return shards[id & (shards.size() - 1)].current.load(std::memory_order_acquire)->Find(id);
+    }
+
+    const SymbolInfo &ConcurrentSymbolTable::LookupSymbol(Atom name) const {
+        const SymbolInfo *symbol = Find(name);
+        if (!symbol)
+            throw InternalError("Symbol \"" + name.Text() + "\" is not declared");
+
+        return *symbol;
+    }
+
+    bool ConcurrentSymbolTable::SymbolExists(Atom name) const {
+        return Find(name) != nullptr;
+    }
+
+    std::vector<SymbolInfo> ConcurrentSymbolTable::Entries() const {
+        std::vector<SymbolInfo> entries;
+        for (const auto &shard: shards) {
+            const Snapshot *snapshot = shard.current.load(std::memory_order_acquire);
+            for (size_t i = 0; i < snapshot->keys.size(); i++) {
+                if (snapshot->keys[i] != NO_ATOM)
+                    entries.push_back(snapshot->symbols[i]);
+            }
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const SymbolInfo &first, const SymbolInfo &second) {
+            return first.name.Text() < second.name.Text();
+        });
+        return entries;
+    }
+
+    size_t ConcurrentSymbolTable::Size() const {
+        size_t size = 0;
+        for (const auto &shard: shards)
+            size += shard.current.load(std::memory_order_acquire)->size;
+        return size;
+    }
+
+    const SymbolInfo *ConcurrentSymbolTable::Snapshot::Find(uint32_t name) const {
+        size_t mask = keys.size() - 1;
+        size_t index = AtomSlot(name >> SHARD_BITS, shift);
+
+        while (keys[index] != name) {
+            if (keys[index] == NO_ATOM)
+                return nullptr;
+            index = (index + 1) & mask;
+        }
+
+        return &symbols[index];
+    }
+
+    const ConcurrentSymbolTable::Snapshot *ConcurrentSymbolTable::Build(const Snapshot *previous,
+                                                                        const std::vector<SymbolInfo> &staged) {
+        std::vector<SymbolInfo> entries;
+        std::unordered_map<uint32_t, size_t> positions;
+
+        auto add = [&](const SymbolInfo &symbol) {
+            auto [position, inserted] = positions.emplace(symbol.name.Id(), entries.size());
+            if (inserted)
+                entries.push_back(symbol);
+            else
+                entries[position->second] = symbol;
+        };
+
+        if (previous) {
+            for (size_t i = 0; i < previous->keys.size(); i++) {
+                if (previous->keys[i] != NO_ATOM)
+                    add(previous->symbols[i]);
+            }
+        }
+        for (const auto &symbol: staged)
+            add(symbol);
+
+        // load factor at or below one half
+        size_t capacity = std::max<size_t>(8, std::bit_ceil(entries.size() * 2));
+
+        auto *snapshot = new Snapshot{
+                std::vector<uint32_t>(capacity, NO_ATOM),
+                std::vector<SymbolInfo>(capacity, SymbolInfo(Atom(), Atom())),
+                static_cast<uint32_t>(32 - std::countr_zero(capacity)),
+                entries.size(),
+        };
+
+        for (const auto &symbol: entries) {
+            size_t index = AtomSlot(symbol.name.Id() >> SHARD_BITS, snapshot->shift);
+            while (snapshot->keys[index] != NO_ATOM)
+                index = (index + 1) & (capacity - 1);
+
+            snapshot->keys[index] = symbol.name.Id();
+            snapshot->symbols[index] = symbol;
+        }
+
+        return snapshot;
+    }
+
+}
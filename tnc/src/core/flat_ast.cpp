@@ -0,0 +1,67 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Flattening of pointer-based trees into the compact representation
+ */
+
+#include <algorithm>
+
+#include "core/flat_ast.h"
+#include "core/children.h"
+#include "errors/errors.h"
+
+namespace tonic {
+
+    FlatAst::FlatAst(const std::shared_ptr<Node> &root) {
+        if (!root)
+            return;
+
+        struct Pending {
+            std::shared_ptr<Node> node;
+            uint32_t parent;
+        };
+
+        // explicit stack, generated code can nest deeper than the call stack allows
+        std::vector<Pending> stack = {{root, FLAT_NONE}};
+        std::vector<uint32_t> last_child;
+
+        while (!stack.empty()) {
+            Pending pending = std::move(stack.back());
+            stack.pop_back();
+
+            if (nodes.size() >= FLAT_NONE)
+                throw InternalError("AST is too large for 32-bit flat indices");
+
+            auto index = static_cast<uint32_t>(nodes.size());
+            nodes.push_back({pending.node->kind, pending.parent, FLAT_NONE, FLAT_NONE, 1});
+            last_child.push_back(FLAT_NONE);
+
+            if (pending.parent != FLAT_NONE) {
+                uint32_t previous = last_child[pending.parent];
+                if (previous == FLAT_NONE)
+                    nodes[pending.parent].first_child = index;
+                else
+                    nodes[previous].next_sibling = index;
+
+                last_child[pending.parent] = index;
+            }
+
+            size_t first_pending = stack.size();
+            ForEachChildSlot(*pending.node, [&](const auto &slot) {
+                if (slot)
+                    stack.push_back({slot, index});
+            });
+            std::reverse(stack.begin() + static_cast<std::ptrdiff_t>(first_pending), stack.end());
+
+            sources.push_back(std::move(pending.node));
+        }
+
+        // children always come after their parent, so sizes can be summed backwards
+        for (size_t i = nodes.size(); i-- > 1;) {
+            nodes[nodes[i].parent].subtree_size += nodes[i].subtree_size;
+        }
+    }
+
+}
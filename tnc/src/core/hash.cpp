@@ -0,0 +1,113 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the Merkle subtree hashes
+ */
+
+#include "core/hash.h"
+#include "core/children.h"
+
+namespace tonic {
+
+    namespace {
+
+        const uint64_t EMPTY_SLOT_HASH = 0x6a09e667f3bcc909ULL;
+
+        uint64_t Mix(uint64_t value) {
+            value ^= value >> 30;
+            value *= 0xbf58476d1ce4e5b9ULL;
+            value ^= value >> 27;
+            value *= 0x94d049bb133111ebULL;
+            value ^= value >> 31;
+            return value;
+        }
+
+        uint64_t HashArguments(uint64_t seed, const std::vector<std::pair<Atom, Atom>> &arguments) {
+            seed = HashCombine(seed, arguments.size());
+            for (const auto &[identifier, type]: arguments) {
+                seed = HashCombine(seed, identifier.Hash());
+                seed = HashCombine(seed, type.Hash());
+            }
+            return seed;
+        }
+
+        // fields that are not child nodes but still change the generated code
+        uint64_t HashOwnFields(const Node &node, uint64_t seed) {
+            switch (node.kind) {
+                case NodeKind::GENERAL_STATEMENT:
+                    return HashCombine(seed, HashBytes(NodeAs<GeneralStatement>(node).statement));
+                case NodeKind::VARIABLE_DECLARATION: {
+                    const auto &variable = NodeAs<VariableDeclaration>(node);
+                    seed = HashCombine(seed, variable.data_type.Hash());
+                    return HashCombine(seed, static_cast<uint64_t>(variable.declaration_type));
+                }
+                case NodeKind::FUNCTION_DECLARATION: {
+                    const auto &function = NodeAs<FunctionDeclaration>(node);
+                    seed = HashCombine(seed, function.is_memoize);
+                    return HashArguments(seed, function.arguments);
+                }
+                case NodeKind::FOR_LOOP:
+                    return HashCombine(seed, NodeAs<ForLoop>(node).id_type.Hash());
+                case NodeKind::RANGED_LOOP:
+                    return HashCombine(seed, NodeAs<RangedLoop>(node).id_type.Hash());
+                case NodeKind::INPUT_OUTPUT:
+                    return HashCombine(seed, static_cast<uint64_t>(NodeAs<InputOutput>(node).type));
+                case NodeKind::TEMPLATE_DECLARATION:
+                    return HashArguments(seed, NodeAs<TemplateDeclaration>(node).arguments);
+                case NodeKind::LAMBDA_EXPRESSION:
+                    return HashArguments(seed, NodeAs<LambdaExpression>(node).arguments);
+                case NodeKind::TRY_CATCH_STATEMENT:
+                    return HashArguments(seed, NodeAs<TryCatchStatement>(node).catch_arguments);
+                case NodeKind::PAIR_DESTRUCTURING: {
+                    const auto &pair = NodeAs<PairDestructuring>(node);
+                    seed = HashCombine(seed, pair.first_var.Hash());
+                    return HashCombine(seed, pair.second_var.Hash());
+                }
+                default:
+                    return seed;
+            }
+        }
+
+    }
+
+    uint64_t HashBytes(std::string_view bytes) {
+        uint64_t hash = 0xcbf29ce484222325ULL; // FNV-1a
+        for (unsigned char c: bytes) {
+            hash ^= c;
+            hash *= 0x100000001b3ULL;
+        }
+        return Mix(hash);
+    }
+
+    uint64_t HashCombine(uint64_t seed, uint64_t value) {
+        return seed ^ (Mix(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    uint64_t RehashNode(Node &node) {
+        uint64_t hash = HashCombine(0, static_cast<uint64_t>(node.kind));
+        hash = HashOwnFields(node, hash);
+
+        ForEachChildSlot(node, [&](const auto &slot) {
+            hash = HashCombine(hash, slot ? slot->hash : EMPTY_SLOT_HASH);
+        });
+
+        node.hash = hash ? hash : 1; // 0 is reserved for unhashed nodes
+        return node.hash;
+    }
+
+    uint64_t HashTree(Node &node) {
+        ForEachChildSlot(node, [](const auto &slot) {
+            if (slot)
+                HashTree(*slot);
+        });
+
+        return RehashNode(node);
+    }
+
+    bool StructurallyEqual(const Node &first, const Node &second) {
+        return first.hash != 0 && first.hash == second.hash;
+    }
+
+}
@@ -0,0 +1,110 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the string interner
+ */
+
+#include <bit>
+#include <mutex>
+
+#include "core/interner.h"
+#include "core/hash.h"
+#include "errors/errors.h"
+
+namespace tonic {
+
+    namespace {
+
+        struct ChunkPosition {
+            uint32_t chunk;
+            uint64_t offset;
+        };
+
+        ChunkPosition Locate(uint32_t id, uint32_t first_chunk_bits) {
+            uint64_t shifted = uint64_t(id) + (uint64_t(1) << first_chunk_bits);
+            auto chunk = static_cast<uint32_t>(std::bit_width(shifted) - 1 - first_chunk_bits);
+            return {chunk, shifted - (uint64_t(1) << (first_chunk_bits + chunk))};
+        }
+
+    }
+
+    Interner::Interner() : size(0) {
+        for (auto &chunk: chunks)
+            chunk.store(nullptr, std::memory_order_relaxed);
+
+        Intern("");
+    }
+
+    Interner::~Interner() {
+        for (auto &chunk: chunks)
+            delete[] chunk.load(std::memory_order_relaxed);
+    }
+
+    Interner &Interner::Global() {
+        static Interner interner;
+        return interner;
+    }
+
+    uint32_t Interner::Intern(std::string_view text) {
+        {
+            std::shared_lock lock(mutex);
+            auto found = ids.find(text);
+            if (found != ids.end())
+                return found->second;
+        }
+
+        std::unique_lock lock(mutex);
+        auto found = ids.find(text);
+        if (found != ids.end())
+            return found->second;
+
+        uint32_t id = size.load(std::memory_order_relaxed);
+        if (id == NO_ATOM)
+            throw InternalError("Interner is full");
+
+        auto [chunk, offset] = Locate(id, FIRST_CHUNK_BITS);
+        Entry *entries = chunks[chunk].load(std::memory_order_relaxed);
+        if (!entries) {
+            entries = new Entry[size_t(1) << (FIRST_CHUNK_BITS + chunk)];
+            chunks[chunk].store(entries, std::memory_order_release);
+        }
+
+        Entry &entry = entries[offset];
+        entry.text = text;
+        entry.hash = HashBytes(text);
+        ids.emplace(entry.text, id);
+
+        // publishes the entry to lock-free readers
+        size.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    uint32_t Interner::Find(std::string_view text) const {
+        std::shared_lock lock(mutex);
+        auto found = ids.find(text);
+        return found == ids.end() ? NO_ATOM : found->second;
+    }
+
+    const std::string &Interner::Text(uint32_t id) const {
+        return At(id).text;
+    }
+
+    uint64_t Interner::Hash(uint32_t id) const {
+        return At(id).hash;
+    }
+
+    size_t Interner::Size() const {
+        return size.load(std::memory_order_acquire);
+    }
+
+    const Interner::Entry &Interner::At(uint32_t id) const {
+        if (id >= size.load(std::memory_order_acquire))
+            throw InternalError("Atom " + std::to_string(id) + " was never interned");
+
+        auto [chunk, offset] = Locate(id, FIRST_CHUNK_BITS);
+        return chunks[chunk].load(std::memory_order_acquire)[offset];
+    }
+
+}
@@ -0,0 +1,155 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of path-copying updates for the immutable AST
+ */
+
+#include "core/persistent.h"
+#include "core/children.h"
+#include "core/hash.h"
+#include "errors/errors.h"
+
+namespace tonic {
+
+    namespace {
+
+        // nodes from the root down to (but excluding) the node at the end of the path
+        std::vector<std::shared_ptr<Node>> CollectSpine(const std::shared_ptr<Node> &root, const AstPath &path) {
+            std::vector<std::shared_ptr<Node>> spine;
+            spine.reserve(path.size());
+
+            std::shared_ptr<Node> current = root;
+            for (size_t index: path) {
+                if (!current)
+                    throw InternalError("AST path goes through an empty slot");
+
+                spine.push_back(current);
+                current = GetChild(*current, index);
+            }
+
+            return spine;
+        }
+
+        // versions of a hashed tree stay hashed, new nodes are hashed once on insertion
+        void EnsureHashed(const std::shared_ptr<Node> &node) {
+            if (node && node->hash == 0)
+                HashTree(*node);
+        }
+
+        std::shared_ptr<Node> Rebuild(const std::vector<std::shared_ptr<Node>> &spine, const AstPath &path,
+                                      std::shared_ptr<Node> replacement, bool hashed) {
+            if (hashed)
+                EnsureHashed(replacement);
+
+            for (size_t i = spine.size(); i-- > 0;) {
+                auto copy = ShallowCopy(*spine[i]);
+                SetChild(*copy, path[i], replacement);
+                if (hashed)
+                    RehashNode(*copy);
+
+                replacement = std::move(copy);
+            }
+
+            return replacement;
+        }
+
+    }
+
+    std::shared_ptr<Node> PathCopy(const std::shared_ptr<Node> &root, const AstPath &path,
+                                   const std::shared_ptr<Node> &replacement) {
+        return Rebuild(CollectSpine(root, path), path, replacement, root && root->hash != 0);
+    }
+
+    std::shared_ptr<Node> PathModify(const std::shared_ptr<Node> &root, const AstPath &path,
+                                     const std::function<void(Node &)> &edit) {
+        auto spine = CollectSpine(root, path);
+        auto target = path.empty() ? root : GetChild(*spine.back(), path.back());
+        if (!target)
+            throw InternalError("Cannot modify an empty AST slot");
+
+        auto copy = ShallowCopy(*target);
+        edit(*copy);
+
+        bool hashed = root->hash != 0;
+        if (hashed) {
+            ForEachChildSlot(*copy, [](const auto &slot) { EnsureHashed(slot); });
+            RehashNode(*copy);
+        }
+
+        return Rebuild(spine, path, copy, hashed);
+    }
+
+    bool FindPath(const std::shared_ptr<Node> &root, const Node *target, AstPath &path) {
+        if (!root)
+            return false;
+        if (root.get() == target)
+            return true;
+
+        size_t index = 0;
+        bool found = false;
+        ForEachChildSlot(*root, [&](const auto &slot) {
+            if (found)
+                return;
+
+            path.push_back(index++);
+            found = FindPath(slot, target, path);
+            if (!found)
+                path.pop_back();
+        });
+
+        return found;
+    }
+
+    ///////////////////
+    // PersistentAst //
+    ///////////////////
+
+    PersistentAst::PersistentAst(std::shared_ptr<Program> root) {
+        if (!root)
+            throw InternalError("Persistent AST needs a program root");
+
+        versions.push_back(std::move(root));
+    }
+
+    std::shared_ptr<const Program> PersistentAst::Root() const {
+        return versions.back();
+    }
+
+    std::shared_ptr<const Program> PersistentAst::Root(size_t version) const {
+        if (version >= versions.size())
+            throw InternalError("AST version " + std::to_string(version) + " does not exist");
+
+        return versions[version];
+    }
+
+    size_t PersistentAst::Version() const {
+        return versions.size() - 1;
+    }
+
+    size_t PersistentAst::Replace(const AstPath &path, const std::shared_ptr<Node> &replacement) {
+        return Commit(PathCopy(versions.back(), path, replacement));
+    }
+
+    size_t PersistentAst::Modify(const AstPath &path, const std::function<void(Node &)> &edit) {
+        return Commit(PathModify(versions.back(), path, edit));
+    }
+
+    void PersistentAst::Rollback(size_t version) {
+        if (version >= versions.size())
+            throw InternalError("AST version " + std::to_string(version) + " does not exist");
+
+        versions.resize(version + 1);
+    }
+
+    size_t PersistentAst::Commit(const std::shared_ptr<Node> &root) {
+        auto program = std::dynamic_pointer_cast<Program>(root);
+        if (!program)
+            throw InternalError("The root of a persistent AST must stay a program");
+
+        versions.push_back(std::move(program));
+        return Version();
+    }
+
+}
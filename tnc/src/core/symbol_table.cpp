@@ -0,0 +1,133 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the scoped symbol table
+ */
+
+#include <utility>
+
+#include "core/symbol_table.h"
+#include "errors/errors.h"
+
+namespace tonic {
+
+    namespace {
+
+        constexpr uint32_t INITIAL_SLOT_BITS = 6;
+
+    }
+
+    SymbolTable::SymbolTable()
+            : slots(size_t(1) << INITIAL_SLOT_BITS, Slot{NO_ATOM, NO_BINDING}),
+              used_slots(0),
+              shift(32 - INITIAL_SLOT_BITS) {}
+
+    void SymbolTable::PushScope() {
+        scopes.push_back({undo_log.size(), bindings.size()});
+    }
+
+    void SymbolTable::PopScope() {
+        if (scopes.empty())
+            throw InternalError("PopScope called on the global scope");
+
+        ScopeMark mark = scopes.back();
+        scopes.pop_back();
+
+        while (undo_log.size() > mark.undo_size) {
+            UndoEntry entry = undo_log.back();
+            undo_log.pop_back();
+            slots[Probe(entry.name)].binding = entry.binding;
+        }
+
+        bindings.resize(mark.binding_count, Binding{SymbolInfo(Atom(), Atom()), NO_BINDING});
+    }
+
+    size_t SymbolTable::Depth() const {
+        return scopes.size();
+    }
+
+    SymbolInfo &SymbolTable::Insert(Atom name, Atom type) {
+        Slot &slot = SlotFor(name.Id());
+
+        // the global scope is never popped, so it needs no undo entries
+        if (!scopes.empty())
+            undo_log.push_back({name.Id(), slot.binding});
+
+        bindings.push_back({SymbolInfo(name, type, static_cast<uint32_t>(scopes.size())), slot.binding});
+        slot.binding = static_cast<uint32_t>(bindings.size() - 1);
+        return bindings.back().info;
+    }
+
+    SymbolInfo *SymbolTable::Find(Atom name) {
+        return const_cast<SymbolInfo *>(std::as_const(*this).Find(name));
+    }
+
+    const SymbolInfo *SymbolTable::Find(Atom name) const {
+        uint32_t binding = slots[Probe(name.Id())].binding; // empty slots hold NO_BINDING as well
+        return binding == NO_BINDING ? nullptr : &bindings[binding].info;
+    }
+
+    SymbolInfo &SymbolTable::LookupSymbol(Atom name) {
+        SymbolInfo *info = Find(name);
+        if (!info)
+            throw InternalError("Symbol \"" + name.Text() + "\" is not declared");
+
+        return *info;
+    }
+
+    bool SymbolTable::SymbolExists(Atom name) const {
+        return Find(name) != nullptr;
+    }
+
+    void SymbolTable::RemoveSymbol(Atom name) {
+        Slot &slot = slots[Probe(name.Id())];
+        if (slot.binding == NO_BINDING)
+            return;
+
+        if (!scopes.empty())
+            undo_log.push_back({name.Id(), slot.binding});
+
+        slot.binding = bindings[slot.binding].shadowed;
+    }
+
+    size_t SymbolTable::Probe(uint32_t name) const {
+        size_t mask = slots.size() - 1;
+        size_t index = AtomSlot(name, shift);
+
+        while (slots[index].name != name && slots[index].name != NO_ATOM)
+            index = (index + 1) & mask;
+
+        return index;
+    }
+
+    SymbolTable::Slot &SymbolTable::SlotFor(uint32_t name) {
+        size_t index = Probe(name);
+        if (slots[index].name == name)
+            return slots[index];
+
+        // keeps the load factor at or below one half
+        if ((used_slots + 1) * 2 > slots.size()) {
+            Grow();
+            index = Probe(name);
+        }
+
+        slots[index].name = name;
+        ++used_slots;
+        return slots[index];
+    }
+
+    void SymbolTable::Grow() {
+        std::vector<Slot> old_slots(slots.size() * 2, Slot{NO_ATOM, NO_BINDING});
+        old_slots.swap(slots);
+        --shift;
+
+        // names without a binding are kept, undo entries may still refer to them
+        for (const Slot &slot: old_slots) {
+            if (slot.name != NO_ATOM)
+                slots[Probe(slot.name)] = slot;
+        }
+    }
+
+}
@@ -0,0 +1,149 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the work-stealing thread pool
+ */
+
+#include <algorithm>
+
+#include "core/thread_pool.h"
+
+namespace tonic {
+
+    namespace {
+
+        // lets Submit and Wait find the deque of the worker they are called from
+        thread_local const ThreadPool *current_pool = nullptr;
+        thread_local size_t current_index = 0;
+
+    }
+
+    ThreadPool::ThreadPool(size_t threads) : queued(0), pending(0), steals(0), stopping(false) {
+        if (threads == 0)
+            threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+        for (size_t i = 0; i <= threads; i++)
+            queues.push_back(std::make_unique<Queue>());
+
+        for (size_t i = 0; i < threads; i++)
+            workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+
+        for (auto &worker: workers)
+            worker.join();
+    }
+
+    void ThreadPool::Submit(Task task) {
+        size_t index = current_pool == this ? current_index : queues.size() - 1;
+
+        ++pending;
+        {
+            std::lock_guard lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        ++queued;
+
+        // taking the lock orders the increment before a sleeper's predicate check
+        {
+            std::lock_guard lock(sleep_mutex);
+        }
+        wake.notify_one();
+        idle.notify_all();
+    }
+
+    void ThreadPool::Wait() {
+        size_t self = current_pool == this ? current_index : queues.size() - 1;
+
+        while (pending > 0) {
+            if (TryRun(self))
+                continue;
+
+            std::unique_lock lock(sleep_mutex);
+            idle.wait(lock, [this] { return pending == 0 || queued > 0; });
+        }
+
+        std::exception_ptr failure;
+        {
+            std::lock_guard lock(error_mutex);
+            std::swap(failure, error);
+        }
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+
+    size_t ThreadPool::Size() const {
+        return workers.size();
+    }
+
+    size_t ThreadPool::Steals() const {
+        return steals;
+    }
+
+    bool ThreadPool::TryRun(size_t self) {
+        Task task;
+
+        {
+            std::lock_guard lock(queues[self]->mutex);
+            if (!queues[self]->tasks.empty()) {
+                task = std::move(queues[self]->tasks.back());
+                queues[self]->tasks.pop_back();
+            }
+        }
+
+        for (size_t offset = 1; !task && offset < queues.size(); offset++) {
+            Queue &victim = *queues[(self + offset) % queues.size()];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                ++steals;
+            }
+        }
+
+        if (!task)
+            return false;
+
+        --queued;
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+
+        if (--pending == 0) {
+            {
+                std::lock_guard lock(sleep_mutex);
+            }
+            idle.notify_all();
+        }
+
+        return true;
+    }
+
+    void ThreadPool::WorkerLoop(size_t index) {
+        current_pool = this;
+        current_index = index;
+
+        while (true) {
+            if (TryRun(index))
+                continue;
+
+            std::unique_lock lock(sleep_mutex);
+            wake.wait(lock, [this] { return stopping || queued > 0; });
+            if (stopping && queued == 0)
+                return;
+        }
+    }
+
+}
@@ -36,6 +36,7 @@ namespace tonic {
                 case '\n':
                     AddToken(TokenType::NEWLINE, "\n");
                     ++first_pass_current;
+                    ++first_pass_line;
                     HandleIndentation();
                     break;
                 case ' ':
@@ -195,15 +196,15 @@ namespace tonic {
                     new_tokens.push_back(first_pass_tokens[i]);
                 } else if (i >= first_pass_tokens.size() - 1 || first_pass_tokens[i + 1] != TokenType::IDENTIFIER) {
                     throw SyntaxError("Please use const or constexpr before a type", first_pass_tokens[i].line,
-                                      first_pass_tokens[i].lexeme, file_name);
+                                      std::string(first_pass_tokens[i].Lexeme()), file_name);
                 } else {
-                    new_tokens.emplace_back(TokenType::TYPE,
-                                            first_pass_tokens[i].lexeme + " " + first_pass_tokens[i + 1].lexeme,
-                                            first_pass_tokens[i].line);
+                    std::string type = std::string(first_pass_tokens[i].Lexeme()) + " ";
+                    type += first_pass_tokens[i + 1].Lexeme();
+                    new_tokens.emplace_back(TokenType::TYPE, type, first_pass_tokens[i].line);
                     ++i;
                 }
             } else if (CheckType(i)) {
-                new_tokens.emplace_back(TokenType::TYPE, first_pass_tokens[i].lexeme, first_pass_tokens[i].line);
+                new_tokens.emplace_back(TokenType::TYPE, first_pass_tokens[i].Lexeme(), first_pass_tokens[i].line);
             } else if (CheckIdentifier(i)) {
                 new_tokens.push_back(first_pass_tokens[i]);
             } else if (CheckForRange(i)) {
@@ -276,7 +277,7 @@ namespace tonic {
         return first_pass_tokens[i] == TokenType::AT &&
                i < first_pass_tokens.size() - 1 &&
                first_pass_tokens[i + 1] == TokenType::IDENTIFIER &&
-               first_pass_tokens[i + 1].lexeme == "memoize";
+               first_pass_tokens[i + 1].Lexeme() == "memoize";
     }
 
     bool Lexer::CheckLambda(size_t i) {
@@ -320,27 +321,22 @@ namespace tonic {
     void Lexer::HandlePreprocessor() {
         first_pass_current++;
 
-        std::string directive = "#";
+        size_t directive_start = first_pass_current - 1;
 
-        while (first_pass_current < source.size()) {
-            if (std::isalpha(source[first_pass_current])) {
-                directive.push_back(source[first_pass_current]);
-                first_pass_current++;
-            } else {
-                first_pass_current++;
-                break;
-            }
-        }
+        while (first_pass_current < source.size() && std::isalpha(source[first_pass_current]))
+            first_pass_current++;
+        std::string_view directive = std::string_view(source).substr(directive_start,
+                                                                     first_pass_current - directive_start);
+        if (first_pass_current < source.size())
+            first_pass_current++;
         if (directive == CPP_TAG) {
             size_t j = first_pass_current + 1;
             bool ended = false;
-            std::string chunk;
             while (j < source.size()) {
-                if (j < source.size() - 3 && source.substr(j, 4) == END_TAG) {
+                if (j < source.size() - 3 && source.compare(j, 4, END_TAG) == 0) {
                     ended = true;
                     break;
                 }
-                chunk += source[j];
                 j++;
             }
             if (!ended) {
@@ -348,7 +344,8 @@ namespace tonic {
                                   get_last_first_token(), file_name);
             }
 
-            AddToken(TokenType::CPP_CHUNK, chunk);
+            AddToken(TokenType::CPP_CHUNK, std::string_view(source).substr(first_pass_current + 1,
+                                                                            j - first_pass_current - 1));
             first_pass_current = j + 4;
         } else {
             AddToken(TokenType::CPP_DIRECTIVE, directive);
@@ -374,22 +371,24 @@ namespace tonic {
                                   get_last_first_token(), file_name);
             }
         } else {
+            // the newline itself is left to FirstPass, which counts the line
             while (first_pass_current < source.size() && source[first_pass_current] != '\n') {
                 ++first_pass_current;
             }
-            if (first_pass_current < source.size() && source[first_pass_current] == '\n') {
-                ++first_pass_line;
-            }
         }
 
         AddToken(TokenType::COMMENT,
-                 source.substr(start_comment, first_pass_current - start_comment));
+                 std::string_view(source).substr(start_comment, first_pass_current - start_comment));
     }
 
-    void Lexer::AddToken(TokenType type, const std::string &text) {
+    void Lexer::AddToken(TokenType type, std::string_view text) {
         first_pass_tokens.emplace_back(type, text, first_pass_line);
     }
 
+    std::string_view Lexer::CurrentLexeme() const {
+        return std::string_view(source).substr(first_pass_start, first_pass_current - first_pass_start);
+    }
+
     void Lexer::SkipWhitespace() {
         while (first_pass_current < source.size() &&
                (source[first_pass_current] == ' ' || source[first_pass_current] == '\t')) {
@@ -429,8 +428,8 @@ namespace tonic {
     }
 
     void Lexer::HandleKeywords() {
-        std::string identifier = source.substr(first_pass_start, first_pass_current - first_pass_start);
-        static const std::unordered_map<std::string, TokenType> keywords = {
+        std::string_view identifier = CurrentLexeme();
+        static const std::unordered_map<std::string_view, TokenType> keywords = {
                 {"if",        TokenType::IF},
                 {"else if",   TokenType::ELSE_IF},
                 {"else",      TokenType::ELSE},
@@ -531,7 +530,7 @@ namespace tonic {
             ++first_pass_current;
         }
 
-        AddToken(TokenType::LITERAL, source.substr(first_pass_start, first_pass_current - first_pass_start));
+        AddToken(TokenType::LITERAL, CurrentLexeme());
     }
 
     void Lexer::HandleNumbers() {
@@ -547,7 +546,7 @@ namespace tonic {
             }
         }
 
-        AddToken(TokenType::LITERAL, source.substr(first_pass_start, first_pass_current - first_pass_start));
+        AddToken(TokenType::LITERAL, CurrentLexeme());
     }
 
     void Lexer::HandleString() {
@@ -568,7 +567,7 @@ namespace tonic {
         }
 
         ++first_pass_current;
-        AddToken(TokenType::LITERAL, source.substr(first_pass_start, first_pass_current - first_pass_start));
+        AddToken(TokenType::LITERAL, CurrentLexeme());
     }
 
     void Lexer::HandleCharacter() {
@@ -615,13 +614,13 @@ namespace tonic {
         }
 
         ++first_pass_current;
-        AddToken(TokenType::LITERAL, source.substr(first_pass_start, first_pass_current - first_pass_start));
+        AddToken(TokenType::LITERAL, CurrentLexeme());
     }
 
     std::string Lexer::get_last_first_token() {
         if (first_pass_tokens.empty())
             return "";
-        return first_pass_tokens[first_pass_tokens.size() - 1].lexeme;
+        return std::string(first_pass_tokens[first_pass_tokens.size() - 1].Lexeme());
     }
 
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
  */
 
 #include "parser.h"
+#include "core/hash.h"
 #include "errors/errors.h"
 
 namespace tonic {
@@ -25,7 +26,11 @@ namespace tonic {
 
         while (!CheckEnd()) {
             try {
-                program->body.push_back(ParseStatement());
+                auto statement = ParseStatement();
+                if (statement)
+                    HashTree(*statement); // statements are hashed bottom-up as soon as they are complete
+
+                program->body.push_back(statement);
             } catch (const SyntaxError &e) {
                 error.AddError(e.what());
                 SynchronizeError();
@@ -35,6 +40,7 @@ namespace tonic {
         if (error.HasErrors())
             error.Throw();
 
+        RehashNode(*program);
         return program;
     }
 
@@ -72,12 +78,13 @@ namespace tonic {
 
     std::shared_ptr<VariableDeclaration> Parser::ParseVariableDeclaration() {
         auto variable_declaration = std::make_shared<VariableDeclaration>();
+        variable_declaration->line = CurrentLine();
 
         variable_declaration->identifier = ParseGeneralStatement(1);
 
         if (Match(TokenType::COLON)) {
             Advance();
-            variable_declaration->data_type = Advance().lexeme;
+            variable_declaration->data_type = Advance().atom;
         }
 
         if (Match(TokenType::EQ)) {
@@ -91,7 +98,9 @@ namespace tonic {
             }
         }
 
-        Advance();
+        // the initializer already consumed the newline, the token after it may be the end of a block
+        if (Match(TokenType::NEWLINE))
+            Advance();
 
         return variable_declaration;
     }
@@ -135,14 +144,14 @@ namespace tonic {
 
         std::shared_ptr<GeneralStatement> identifier = ParseGeneralStatement(1);
 
-        std::string id_type = AUTO;
+        Atom id_type = AUTO_ATOM;
         if (Match(TokenType::COLON)) {
             Advance();
 
             if (!Match(TokenType::TYPE))
                 Throw("Invalid type of for loop identifier");
 
-            id_type = Advance().lexeme;
+            id_type = Advance().atom;
         }
 
         if (!Match(TokenType::IN))
@@ -154,6 +163,7 @@ namespace tonic {
 
         if (is_manual) {
             auto for_loop = std::make_shared<ForLoop>();
+            for_loop->line = identifier->line;
             for_loop->identifier = identifier;
             for_loop->id_type = id_type;
 
@@ -172,6 +182,7 @@ namespace tonic {
 
         } else {
             auto ranged_loop = std::make_shared<RangedLoop>();
+            ranged_loop->line = identifier->line;
             ranged_loop->identifier = identifier;
             ranged_loop->id_type = id_type;
 
@@ -182,7 +193,74 @@ namespace tonic {
     }
 
     std::shared_ptr<FunctionDeclaration> Parser::ParseFunctionDeclaration() {
-        return {};
+        auto function_declaration = std::make_shared<FunctionDeclaration>();
+        function_declaration->line = CurrentLine();
+
+        if (!Match(TokenType::TYPE))
+            Throw("Function declaration must begin with a return type");
+
+        function_declaration->type = ParseGeneralStatement(1);
+
+        if (!Match(TokenType::IDENTIFIER))
+            Throw("Missing function name");
+
+        function_declaration->name = ParseGeneralStatement(1);
+
+        if (!Match(TokenType::LPAREN))
+            Throw("Missing \"(\" after the function name");
+
+        Advance();
+
+        // "a, b: int" gives both arguments the type after them, arguments without a type are auto
+        std::vector<Atom> untyped;
+        while (!Match(TokenType::RPAREN)) {
+            if (CheckEnd())
+                Throw("Closing parenthesis missing");
+
+            if (Match({TokenType::COMMA, TokenType::NEWLINE, TokenType::INDENT, TokenType::DEDENT})) {
+                Advance();
+                continue;
+            }
+
+            if (!Match(TokenType::IDENTIFIER))
+                Throw("Invalid function argument");
+
+            untyped.push_back(Advance().atom);
+
+            if (Match(TokenType::COLON)) {
+                Advance();
+
+                if (!Match(TokenType::TYPE))
+                    Throw("Invalid type of function argument");
+
+                Atom type = Advance().atom;
+                for (Atom argument: untyped)
+                    function_declaration->arguments.emplace_back(argument, type);
+                untyped.clear();
+            }
+        }
+
+        Advance();
+
+        for (Atom argument: untyped)
+            function_declaration->arguments.emplace_back(argument, AUTO_ATOM);
+
+        // qualifiers such as const before the colon
+        while (!Match(TokenType::COLON)) {
+            if (CheckEnd() || Match(TokenType::NEWLINE))
+                Throw("Missing \":\" after the function declaration");
+
+            Advance();
+        }
+
+        Advance();
+
+        if (Match(TokenType::NEWLINE))
+            Advance();
+
+        function_declaration->block = ParseBlock();
+
+        return function_declaration;
     }
 
     std::shared_ptr<Node> Parser::ParseForLoop() {
@@ -190,7 +268,27 @@ namespace tonic {
     }
 
     std::shared_ptr<WhileLoop> Parser::ParseWhileLoop() {
-        return {};
+        auto while_loop = std::make_shared<WhileLoop>();
+        while_loop->line = CurrentLine();
+
+        if (!Match(TokenType::WHILE))
+            Throw("While loop must begin with a \"while\" token");
+
+        Advance();
+
+        while_loop->condition = ParseGeneralStatement(TokenType::COLON);
+
+        if (!Match(TokenType::COLON))
+            Throw("Missing \":\" after the while condition");
+
+        Advance();
+
+        if (Match(TokenType::NEWLINE))
+            Advance();
+
+        while_loop->block = ParseBlock();
+
+        return while_loop;
     }
 
     std::shared_ptr<InputOutput> Parser::ParseInputOutput() {
@@ -230,7 +328,28 @@ namespace tonic {
     }
 
     std::shared_ptr<Block> Parser::ParseBlock() {
-        return {};
+        auto block = std::make_shared<Block>();
+        block->line = CurrentLine();
+
+        if (!Match(TokenType::INDENT))
+            Throw("Expected an indented block");
+
+        Advance();
+
+        // the lexer emits no dedent at the end of the file, so the last block ends there
+        while (!CheckEnd() && !Match(TokenType::DEDENT)) {
+            if (Match({TokenType::NEWLINE, TokenType::COMMENT})) {
+                Advance();
+                continue;
+            }
+
+            block->body.push_back(ParseStatement());
+        }
+
+        if (Match(TokenType::DEDENT))
+            Advance();
+
+        return block;
     }
 
     std::shared_ptr<LambdaExpression> Parser::ParseLambdaExpression() {
@@ -245,9 +364,10 @@ namespace tonic {
 
     std::shared_ptr<GeneralStatement> Parser::ParseGeneralStatement() {
         auto general_statement = std::make_shared<GeneralStatement>();
+        general_statement->line = CurrentLine();
 
         while (!Match(TokenType::NEWLINE) && !CheckEnd()) {
-            general_statement->statement += Advance().lexeme;
+            general_statement->statement += Advance().Lexeme();
             general_statement->statement += ' ';
         }
 
@@ -259,9 +379,10 @@ namespace tonic {
 
     std::shared_ptr<GeneralStatement> Parser::ParseGeneralStatement(size_t length) {
         auto general_statement = std::make_shared<GeneralStatement>();
+        general_statement->line = CurrentLine();
 
         for (size_t i = 0; !Match(TokenType::NEWLINE) && !CheckEnd() && i < length; i++) {
-            general_statement->statement += Advance().lexeme;
+            general_statement->statement += Advance().Lexeme();
             general_statement->statement += ' ';
         }
 
@@ -275,9 +396,10 @@ namespace tonic {
 
     std::shared_ptr<GeneralStatement> Parser::ParseGeneralStatement(TokenType type) {
         auto general_statement = std::make_shared<GeneralStatement>();
+        general_statement->line = CurrentLine();
 
         while (!Match({TokenType::NEWLINE, type}) && !CheckEnd()) {
-            general_statement->statement += Advance().lexeme;
+            general_statement->statement += Advance().Lexeme();
             general_statement->statement += ' ';
         }
 
@@ -291,9 +413,10 @@ namespace tonic {
 
     std::shared_ptr<GeneralStatement> Parser::ParseGeneralStatement(const std::vector<TokenType> &types) {
         auto general_statement = std::make_shared<GeneralStatement>();
+        general_statement->line = CurrentLine();
 
         while (!Match(types) && !CheckEnd()) {
-            general_statement->statement += Advance().lexeme;
+            general_statement->statement += Advance().Lexeme();
             general_statement->statement += ' ';
         }
 
@@ -368,7 +491,7 @@ namespace tonic {
     void Parser::Throw(const std::string &message) {
         throw SyntaxError(message,
                           CurrentLine(),
-                          Peek().lexeme,
+                          std::string(Peek().Lexeme()),
                           file_name);
     }
 
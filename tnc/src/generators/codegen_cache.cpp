@@ -0,0 +1,58 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the per-declaration codegen cache
+ */
+
+#include "generators/codegen_cache.h"
+
+namespace tonic {
+
+    const CachedDeclaration *CodegenCache::Find(uint64_t key) {
+        std::lock_guard lock(mutex);
+        auto entry = entries.find(key);
+        if (entry == entries.end()) {
+            ++misses;
+            return nullptr;
+        }
+
+        ++hits;
+        entry->second.last_build = build;
+        return &entry->second.declaration;
+    }
+
+    void CodegenCache::Store(uint64_t key, CachedDeclaration declaration) {
+        std::lock_guard lock(mutex);
+        entries.try_emplace(key, Entry{std::move(declaration), build}); // a worker may still read an equal entry
+    }
+
+    void CodegenCache::BeginBuild() {
+        std::lock_guard lock(mutex);
+        ++build;
+    }
+
+    void CodegenCache::Prune() {
+        std::lock_guard lock(mutex);
+        std::erase_if(entries, [&](const auto &entry) {
+            return entry.second.last_build != build;
+        });
+    }
+
+    size_t CodegenCache::Hits() const {
+        std::lock_guard lock(mutex);
+        return hits;
+    }
+
+    size_t CodegenCache::Misses() const {
+        std::lock_guard lock(mutex);
+        return misses;
+    }
+
+    size_t CodegenCache::Size() const {
+        std::lock_guard lock(mutex);
+        return entries.size();
+    }
+
+}
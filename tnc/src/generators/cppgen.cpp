@@ -0,0 +1,1129 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the C++ generator
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "analyzers/memory.h"
+#include "core/children.h"
+#include "core/hash.h"
+#include "errors/errors.h"
+#include "generators/cppgen.h"
+#include "generators/runtime.h"
+
+namespace tonic {
+
+    namespace {
+
+        // standard library names and the header declaring them
+        const std::unordered_map<std::string_view, std::string_view> HEADERS = {
+                {"cin",               "iostream"},
+                {"cout",              "iostream"},
+                {"cerr",              "iostream"},
+                {"endl",              "iostream"},
+                {"ios",               "iostream"},
+                {"vector",            "vector"},
+                {"string",            "string"},
+                {"to_string",         "string"},
+                {"stoi",              "string"},
+                {"stoll",             "string"},
+                {"getline",           "string"},
+                {"map",               "map"},
+                {"multimap",          "map"},
+                {"set",               "set"},
+                {"multiset",          "set"},
+                {"unordered_map",     "unordered_map"},
+                {"unordered_set",     "unordered_set"},
+                {"queue",             "queue"},
+                {"priority_queue",    "queue"},
+                {"deque",             "deque"},
+                {"stack",             "stack"},
+                {"bitset",            "bitset"},
+                {"array",             "array"},
+                {"tuple",             "tuple"},
+                {"make_tuple",        "tuple"},
+                {"tie",               "tuple"},
+                {"pair",              "utility"},
+                {"make_pair",         "utility"},
+                {"swap",              "utility"},
+                {"sort",              "algorithm"},
+                {"stable_sort",       "algorithm"},
+                {"reverse",           "algorithm"},
+                {"max",               "algorithm"},
+                {"min",               "algorithm"},
+                {"max_element",       "algorithm"},
+                {"min_element",       "algorithm"},
+                {"lower_bound",       "algorithm"},
+                {"upper_bound",       "algorithm"},
+                {"binary_search",     "algorithm"},
+                {"unique",            "algorithm"},
+                {"fill",              "algorithm"},
+                {"next_permutation",  "algorithm"},
+                {"accumulate",        "numeric"},
+                {"iota",              "numeric"},
+                {"partial_sum",       "numeric"},
+                {"gcd",               "numeric"},
+                {"lcm",               "numeric"},
+                {"abs",               "cmath"},
+                {"sqrt",              "cmath"},
+                {"pow",               "cmath"},
+                {"floor",             "cmath"},
+                {"ceil",              "cmath"},
+                {"log",               "cmath"},
+                {"log2",              "cmath"},
+                {"exp",               "cmath"},
+                {"hypot",             "cmath"},
+                {"function",          "functional"},
+                {"greater",           "functional"},
+                {"less",              "functional"},
+                {"memset",            "cstring"},
+                {"memcpy",            "cstring"},
+                {"strlen",            "cstring"},
+                {"printf",            "cstdio"},
+                {"scanf",             "cstdio"},
+                {"puts",              "cstdio"},
+                {"INT_MAX",           "climits"},
+                {"INT_MIN",           "climits"},
+                {"LLONG_MAX",         "climits"},
+                {"LLONG_MIN",         "climits"},
+                {"setprecision",      "iomanip"},
+                {"setw",              "iomanip"},
+        };
+
+        // ways a program reads stdin itself, ahead of which the reader would have buffered the input
+        const std::unordered_set<std::string_view> STDIN_NAMES = {
+                "cin", "scanf", "getchar", "getc", "fgetc", "fgets", "fread", "stdin",
+        };
+
+        // ways a program prints itself, its output would come before what the writer holds until exit
+        const std::unordered_set<std::string_view> STDOUT_NAMES = {
+                "cout", "cerr", "clog", "printf", "puts", "putchar", "fputs", "fwrite", "fprintf", "stdout", "stderr",
+        };
+
+        bool IsNameChar(char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        // an integer expression without names, as "1 << 20", scanned in place since it runs for every loop
+        bool IsLiteral(std::string_view expression) {
+            bool digits = false;
+            for (char c: expression) {
+                if (std::isdigit(static_cast<unsigned char>(c)))
+                    digits = true;
+                else if (c != ' ' && std::string_view("+-*/%()<>&|^~").find(c) == std::string_view::npos)
+                    return false;
+            }
+            return digits;
+        }
+
+        // a const or reference variable is initialized where it is declared, it cannot be assigned later
+        bool BindsOnce(std::string_view type) {
+            if (type.find('&') != std::string_view::npos)
+                return true;
+
+            for (size_t i = 0; i < type.size();) {
+                if (!IsNameChar(type[i])) {
+                    i++;
+                    continue;
+                }
+                size_t end = i;
+                while (end < type.size() && IsNameChar(type[end]))
+                    end++;
+                std::string_view word = type.substr(i, end - i);
+                if (word == "const" || word == "constexpr")
+                    return true;
+                i = end;
+            }
+            return false;
+        }
+
+        // argument types the HashOf overloads of runtime/memo.h cover
+        const std::unordered_set<std::string_view> HASHABLE_SCALARS = {
+                "bool", "char", "short", "int", "unsigned", "unsigned int", "long", "long long", "unsigned long",
+                "unsigned long long", "size_t", "int32_t", "uint32_t", "int64_t", "uint64_t", "float", "double",
+                "long double", "string",
+        };
+
+        bool IsHashable(const TypeShape &type) {
+            if (type.name == "pair" || type.name == "tuple" || type.name == "vector")
+                return !type.arguments.empty() && std::all_of(type.arguments.begin(), type.arguments.end(), IsHashable);
+            if (type.name == "array")
+                return type.arguments.size() == 2 && IsHashable(type.arguments[0]);
+            return HASHABLE_SCALARS.contains(type.name);
+        }
+
+        bool IsMain(const FunctionDeclaration &function) {
+            return function.name && function.name->statement == "main";
+        }
+
+        // two operator characters the lexer splits, as in "+ =" or "< <"
+        bool Joins(char first, char second) {
+            switch (second) {
+                case '=':
+                    return std::string_view("+-*/%^|&=!<>").find(first) != std::string_view::npos;
+                case '+':
+                case '-':
+                case '&':
+                case '|':
+                case '<':
+                case ':':
+                    return first == second;
+                case '>':
+                    return first == '>' || first == '-';
+                default:
+                    return false;
+            }
+        }
+
+        // calls on_name for the names outside quotes that are not members, as cin but not tie in "cin . tie",
+        // and on_split for the spaces between operator characters the lexer split
+        template<typename OnName, typename OnSplit>
+        void ScanCode(std::string_view text, OnName &&on_name, OnSplit &&on_split) {
+            char quote = 0;
+            for (size_t i = 0; i < text.size(); i++) {
+                char c = text[i];
+                if (quote) {
+                    if (c == '\\')
+                        i++;
+                    else if (c == quote)
+                        quote = 0;
+                } else if (c == '"' || c == '\'') {
+                    quote = c;
+                } else if (IsNameChar(c)) {
+                    bool number = std::isdigit(static_cast<unsigned char>(c));
+                    size_t end = i;
+                    while (end < text.size() && (IsNameChar(text[end]) || (number && text[end] == '.')))
+                        end++;
+                    size_t before = i;
+                    while (before > 0 && text[before - 1] == ' ')
+                        before--;
+                    bool member = before > 0 && (text[before - 1] == '.' ||
+                                                 (before > 1 && text[before - 1] == '>' && text[before - 2] == '-'));
+                    if (!number && !member)
+                        on_name(text.substr(i, end - i));
+                    i = end - 1;
+                } else if (c == ' ' && i > 0 && i + 1 < text.size() && Joins(text[i - 1], text[i + 1]) &&
+                           (i + 2 == text.size() || text[i + 2] == ' ')) {
+                    on_split(i);
+                }
+            }
+        }
+
+        // whether a statement of the tree, C++ chunks included, names one of the names
+        bool MentionsAny(const Node &node, const std::unordered_set<std::string_view> &names) {
+            bool found = false;
+            if (node.kind == NodeKind::GENERAL_STATEMENT) {
+                ScanCode(static_cast<const GeneralStatement &>(node).statement, [&](std::string_view name) {
+                    found |= names.contains(name);
+                }, [](size_t) {});
+                return found;
+            }
+
+            ForEachChildSlot(node, [&](const auto &slot) {
+                if (!found && slot)
+                    found = MentionsAny(*slot, names);
+            });
+            return found;
+        }
+
+        bool IsLoop(const Node &node) {
+            return node.kind == NodeKind::FOR_LOOP || node.kind == NodeKind::RANGED_LOOP;
+        }
+
+        bool IsFileScope(const Node &node) {
+            switch (node.kind) {
+                case NodeKind::FUNCTION_DECLARATION:
+                case NodeKind::CLASS_DECLARATION:
+                case NodeKind::STRUCT_DECLARATION:
+                case NodeKind::NAMESPACE_DECLARATION:
+                case NodeKind::TEMPLATE_DECLARATION:
+                case NodeKind::CPP_NODE:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // a top-level variable is a global when its type can be written at file scope, it is declared there
+        // and a non-constant initializer runs in main, where the variable appears, unless the variable is
+        // const or a reference and has to stay a local of main
+        enum class Placement {
+            GLOBAL,
+            DEFERRED,
+            LOCAL,
+        };
+
+        Placement PlacementOf(const VariableDeclaration &declaration) {
+            const Node *initializer = declaration.initializer.get();
+            if (!initializer)
+                return Placement::GLOBAL;
+            if (initializer->kind == NodeKind::GENERAL_STATEMENT &&
+                IsLiteral(static_cast<const GeneralStatement &>(*initializer).statement))
+                return Placement::GLOBAL;
+            if (BindsOnce(declaration.data_type.Text()))
+                return Placement::LOCAL;
+            if (declaration.data_type != AUTO_ATOM || IsLoop(*initializer))
+                return Placement::DEFERRED;
+            return Placement::LOCAL;
+        }
+
+
+        // the loop bounds and recursion reports of the subtree, which its hash leaves out
+        void HashAnalysis(const Node &node, const GeneratorOptions &options, uint64_t &key) {
+            if (node.kind == NodeKind::FOR_LOOP) {
+                const auto &loop = static_cast<const ForLoop &>(node);
+                key = HashCombine(key, loop.trip_count.has_value());
+                key = HashCombine(key, loop.trip_count.value_or(0));
+                key = HashCombine(key, static_cast<uint64_t>(loop.step_sign) << 1 | loop.bounds_invariant);
+            } else if (node.kind == NodeKind::FUNCTION_DECLARATION && options.recursion) {
+                for (const auto &report: *options.recursion)
+                    if (report.function == &node)
+                        key = HashCombine(key, report.pure | report.overlapping << 1 | report.decreasing << 2);
+            }
+
+            ForEachChildSlot(node, [&](const auto &slot) {
+                if (slot)
+                    HashAnalysis(*slot, options, key);
+            });
+        }
+
+        // everything the code of a top-level declaration depends on, nullopt when the declaration is not hashed
+        std::optional<uint64_t> CacheKey(const Node &node, Placement placement, const GeneratorOptions &options) {
+            if (node.hash == 0)
+                return std::nullopt;
+
+            uint64_t key = HashCombine(node.hash, static_cast<uint64_t>(placement));
+            key = HashCombine(key, options.fast_input | options.fast_output << 1 | options.interactive << 2 |
+                                   static_cast<uint64_t>(options.judge) << 3);
+            if (options.constraints) {
+                uint64_t ranges = 1; // the map is unordered, so the hashes of the entries are summed
+                for (const auto &[name, range]: *options.constraints)
+                    ranges += HashCombine(HashCombine(HashBytes(name.Text()), std::bit_cast<uint64_t>(range.low)),
+                                          std::bit_cast<uint64_t>(range.high));
+                key = HashCombine(key, ranges);
+            }
+            HashAnalysis(node, options, key);
+            return key;
+        }
+
+    }
+
+    namespace cppgen {
+
+        std::string Generate(const VariableDeclaration &var) {
+            OutputSink out;
+            CppGenerator(out).Emit(var);
+            return out.ToString();
+        }
+
+        std::string GenerateLoopHeader(const ForLoop &loop) {
+            OutputSink out;
+            CppGenerator(out).EmitLoopHeader(loop);
+            return out.ToString();
+        }
+
+    }
+
+    CppGenerator::CppGenerator(OutputSink &out, GeneratorOptions options)
+            : out(&out), options(options), reads_input(false), writes_output(false), uses_memo(false),
+              in_type(false) {}
+
+    void CppGenerator::Generate(const Program &program, ThreadPool *pool) {
+        if (options.fast_input && MentionsAny(program, STDIN_NAMES))
+            options.fast_input = false;
+        if (options.fast_output && MentionsAny(program, STDOUT_NAMES))
+            options.fast_output = false;
+
+        if (options.cache)
+            options.cache->BeginBuild();
+
+        bool has_main = false;
+        for (const auto &node: program.body)
+            if (node && node->kind == NodeKind::FUNCTION_DECLARATION)
+                has_main |= IsMain(static_cast<const FunctionDeclaration &>(*node));
+
+        // the blank line before each item is decided here, so a chunk does not depend on the ones before it
+        struct Item {
+            const Node *node;
+            Placement placement; // of a top-level variable
+            bool blank;
+        };
+
+        std::vector<Item> declarations;
+        std::vector<const Node *> statements;
+        std::unordered_set<const Node *> deferred;
+        bool after_declaration = false;
+
+        for (const auto &node: program.body) {
+            if (!node)
+                continue;
+
+            // main is the user's, so the other top-level code has to be declarations that can stand at file scope
+            if (has_main && !IsFileScope(*node)) {
+                if (node->kind != NodeKind::VARIABLE_DECLARATION)
+                    throw SyntaxError("Statements outside functions cannot run when the program defines main",
+                                      node->line, "", options.file_name);
+                const auto &declaration = static_cast<const VariableDeclaration &>(*node);
+                if (declaration.initializer && IsLoop(*declaration.initializer))
+                    throw SyntaxError("A list comprehension cannot initialize `" + declaration.identifier->statement +
+                                      "` outside functions when the program defines main", node->line, "",
+                                      options.file_name);
+
+                declarations.push_back({node.get(), Placement::GLOBAL, after_declaration});
+                after_declaration = false;
+                continue;
+            }
+
+            if (node->kind == NodeKind::VARIABLE_DECLARATION) {
+                Placement placement = PlacementOf(static_cast<const VariableDeclaration &>(*node));
+                if (placement == Placement::LOCAL) {
+                    statements.push_back(node.get());
+                    continue;
+                }
+
+                declarations.push_back({node.get(), placement, after_declaration});
+                after_declaration = false;
+                if (placement == Placement::DEFERRED) {
+                    statements.push_back(node.get());
+                    deferred.insert(node.get());
+                }
+            } else if (IsFileScope(*node)) {
+                declarations.push_back({node.get(), Placement::LOCAL, !declarations.empty()});
+                after_declaration = true;
+            } else {
+                statements.push_back(node.get());
+            }
+        }
+
+        // the types and globals declared before the first function come before the prototypes, which can use them
+        size_t first_function = declarations.size();
+        for (size_t i = 0; i < declarations.size() && first_function == declarations.size(); i++)
+            if (declarations[i].node->kind == NodeKind::FUNCTION_DECLARATION)
+                first_function = i;
+
+        struct Chunk {
+            OutputSink leading; // declarations before first_function
+            OutputSink prototypes;
+            OutputSink body;
+            std::set<std::string, std::less<>> includes;
+            bool reads_input = false;
+            bool writes_output = false;
+            bool uses_memo = false;
+        };
+
+        // contiguous runs of declarations, a few per worker so stealing evens out their sizes, and main last
+        size_t runs = pool ? std::min(declarations.size(), pool->Size() * 4) : std::min<size_t>(declarations.size(), 1);
+        std::vector<Chunk> chunks(runs + 1);
+
+        auto run_declarations = [&](size_t run) {
+            Chunk &chunk = chunks[run];
+            CppGenerator generator(chunk.body, options);
+
+            for (size_t i = run * declarations.size() / runs; i < (run + 1) * declarations.size() / runs; i++) {
+                const Item &item = declarations[i];
+                bool deferred = item.placement == Placement::DEFERRED;
+                OutputSink &body = i < first_function ? chunk.leading : chunk.body;
+                generator.out = &body;
+                if (item.blank)
+                    body.Put('\n');
+
+                std::optional<uint64_t> key;
+                if (options.cache)
+                    key = CacheKey(*item.node, item.placement, options);
+                if (!key) {
+                    generator.Declaration(*item.node, deferred, chunk.prototypes);
+                    continue;
+                }
+
+                const CachedDeclaration *cached = options.cache->Find(*key);
+                CachedDeclaration generated;
+                if (!cached) {
+                    OutputSink code;
+                    OutputSink prototype;
+                    CppGenerator single(code, options);
+                    single.Declaration(*item.node, deferred, prototype);
+                    generated = {code.ToString(), prototype.ToString(), std::move(single.includes),
+                                 single.reads_input, single.writes_output, single.uses_memo};
+                    options.cache->Store(*key, generated);
+                    cached = &generated;
+                }
+
+                body.Write(cached->code);
+                chunk.prototypes.Write(cached->prototype);
+                generator.includes.insert(cached->includes.begin(), cached->includes.end());
+                generator.reads_input |= cached->reads_input;
+                generator.writes_output |= cached->writes_output;
+                generator.uses_memo |= cached->uses_memo;
+            }
+
+            chunk.includes = std::move(generator.includes);
+            chunk.reads_input = generator.reads_input;
+            chunk.writes_output = generator.writes_output;
+            chunk.uses_memo = generator.uses_memo;
+        };
+
+        auto run_main = [&] {
+            Chunk &chunk = chunks.back();
+            if (has_main)
+                return;
+
+            CppGenerator generator(chunk.body, options);
+            OutputSink &out = chunk.body;
+            if (!declarations.empty())
+                out.Put('\n');
+            out.Write("int main() {\n");
+            out.Indent();
+            generator.Code("ios::sync_with_stdio(false);\ncin.tie(nullptr);\n");
+
+            for (const Node *statement: statements) {
+                if (!deferred.contains(statement)) {
+                    generator.Emit(*statement);
+                    continue;
+                }
+
+                const auto &declaration = static_cast<const VariableDeclaration &>(*statement);
+                if (IsLoop(*declaration.initializer)) {
+                    generator.Comprehension(declaration.identifier->statement, *declaration.initializer);
+                } else {
+                    generator.Code(declaration.identifier->statement);
+                    out.Write(" = ");
+                    generator.Initializer(*declaration.initializer);
+                    out.Write(";\n");
+                }
+            }
+
+            out.Write("return 0;\n");
+            out.Dedent();
+            out.Write("}\n");
+            chunk.includes = std::move(generator.includes);
+            chunk.reads_input = generator.reads_input;
+            chunk.writes_output = generator.writes_output;
+            chunk.uses_memo = generator.uses_memo;
+        };
+
+        if (pool) {
+            for (size_t run = 0; run < runs; run++)
+                pool->Submit([&run_declarations, run] { run_declarations(run); });
+            pool->Submit(run_main);
+            pool->Wait();
+        } else {
+            for (size_t run = 0; run < runs; run++)
+                run_declarations(run);
+            run_main();
+        }
+
+        // merged in source order, so the text is the same for any pool and thread count
+        bool has_prototypes = false;
+        for (auto &chunk: chunks) {
+            includes.merge(chunk.includes);
+            reads_input |= chunk.reads_input;
+            writes_output |= chunk.writes_output;
+            uses_memo |= chunk.uses_memo;
+            has_prototypes |= chunk.prototypes.Size() > 0;
+        }
+
+        for (const auto &header: includes) {
+            out->Write("#include <");
+            out->Write(header);
+            out->Write(">\n");
+        }
+        if (reads_input) {
+            out->Put('\n');
+            if (options.judge != JudgeProfile::PORTABLE) {
+                out->Write("#define TNC_RUNTIME_SIMD ");
+                out->Put(options.judge == JudgeProfile::AVX2 ? '2' : '1');
+                out->Put('\n');
+            }
+            out->Write(runtime::FastInput());
+            out->Write("\nstatic _tnc_runtime::Reader ");
+            out->Write(cppgen::GENERATED_PREFIX);
+            out->Write("in;\n");
+        }
+        if (writes_output) {
+            out->Put('\n');
+            out->Write(runtime::FastOutput());
+            out->Write("\nstatic _tnc_runtime::Writer ");
+            out->Write(cppgen::GENERATED_PREFIX);
+            out->Write(options.interactive ? "out(true);\n" : "out;\n");
+        }
+        if (uses_memo) {
+            out->Put('\n');
+            out->Write(runtime::Memo());
+        }
+        out->Write("\nusing namespace std;\n\n");
+        for (auto &chunk: chunks)
+            out->Splice(std::move(chunk.leading));
+        if (has_prototypes) {
+            // the first function has a blank line before it when declarations came before the prototypes
+            if (first_function > 0)
+                out->Put('\n');
+            for (auto &chunk: chunks)
+                out->Splice(std::move(chunk.prototypes));
+            if (first_function == 0)
+                out->Put('\n');
+        }
+        for (auto &chunk: chunks)
+            out->Splice(std::move(chunk.body));
+    }
+
+    void CppGenerator::Declaration(const Node &node, bool deferred, OutputSink &prototypes) {
+        if (deferred) {
+            const auto &declaration = static_cast<const VariableDeclaration &>(node);
+            Type(declaration.data_type, "vector<long long>");
+            out->Put(' ');
+            Code(declaration.identifier->statement);
+            out->Write(";\n");
+            return;
+        }
+
+        if (node.kind == NodeKind::FUNCTION_DECLARATION) {
+            OutputSink *body = out;
+            out = &prototypes;
+            Prototype(static_cast<const FunctionDeclaration &>(node));
+            out = body;
+        }
+        Emit(node);
+    }
+
+    void CppGenerator::Emit(const Node &node) {
+        DispatchNode(node, [&](const auto &concrete) {
+            using Type = std::decay_t<decltype(concrete)>;
+
+            if constexpr (std::is_same_v<Type, Program> || std::is_same_v<Type, Block>) {
+                for (const auto &child: concrete.body)
+                    if (child)
+                        Emit(*child);
+            } else if constexpr (std::is_same_v<Type, GeneralStatement>) {
+                Statement(concrete.statement);
+            } else if constexpr (std::is_same_v<Type, CppNode>) {
+                const std::string &code = concrete.cpp_code->statement;
+                out->Write(code);
+                if (code.empty() || code.back() != '\n')
+                    out->Put('\n');
+            } else if constexpr (std::is_same_v<Type, VariableDeclaration>) {
+                if (concrete.initializer && IsLoop(*concrete.initializer)) {
+                    this->Type(concrete.data_type, "vector<long long>");
+                    out->Put(' ');
+                    Code(concrete.identifier->statement);
+                    out->Write(";\n");
+                    Comprehension(concrete.identifier->statement, *concrete.initializer);
+                    return;
+                }
+
+                this->Type(concrete.data_type, concrete.initializer ? "auto" : "long long");
+                out->Put(' ');
+                Code(concrete.identifier->statement);
+                if (concrete.initializer) {
+                    out->Write(" = ");
+                    Initializer(*concrete.initializer);
+                }
+                out->Write(";\n");
+            } else if constexpr (std::is_same_v<Type, FunctionDeclaration>) {
+                if (IsMemoized(concrete))
+                    return Memoized(concrete);
+                Signature(concrete, "");
+                out->Write(" {\n");
+                Body(concrete.block.get());
+                out->Write("}\n");
+            } else if constexpr (std::is_same_v<Type, ForLoop>) {
+                EmitLoopHeader(concrete);
+                out->Write(" {\n");
+                Body(concrete.block.get());
+                out->Write("}\n");
+            } else if constexpr (std::is_same_v<Type, RangedLoop>) {
+                out->Write("for (");
+                if (concrete.id_type == AUTO_ATOM) {
+                    out->Write("auto &&");
+                } else {
+                    Code(concrete.id_type.Text());
+                    out->Put(' ');
+                }
+                Code(concrete.identifier->statement);
+                out->Write(" : ");
+                Code(concrete.object->statement);
+                out->Write(") {\n");
+                Body(concrete.block.get());
+                out->Write("}\n");
+            } else if constexpr (std::is_same_v<Type, WhileLoop>) {
+                out->Write("while (");
+                Code(concrete.condition->statement);
+                out->Write(") {\n");
+                Body(concrete.block.get());
+                out->Write("}\n");
+            } else if constexpr (std::is_same_v<Type, InputOutput>) {
+                bool input = concrete.type == InOut::IN;
+                if (input ? options.fast_input : options.fast_output) {
+                    // overloads of the runtime pick the parser or the format from the operand types, the
+                    // writer flushes at exit, or after every line in interactive mode
+                    (input ? reads_input : writes_output) = true;
+                    out->Write(cppgen::GENERATED_PREFIX);
+                    out->Write(input ? "in.Read(" : "out.Line(");
+                    for (size_t i = 0; i < concrete.operands.size(); i++) {
+                        if (i)
+                            out->Write(", ");
+                        Code(concrete.operands[i]->statement);
+                    }
+                    out->Write(");\n");
+                    return;
+                }
+
+                Code(input ? "cin" : "cout");
+                for (size_t i = 0; i < concrete.operands.size(); i++) {
+                    out->Write(input ? " >> " : (i ? " << ' ' << " : " << "));
+                    Operand(concrete.operands[i]->statement);
+                }
+                if (input)
+                    out->Write(";\n");
+                else
+                    out->Write(options.interactive ? " << endl;\n" : " << '\\n';\n");
+            } else if constexpr (std::is_same_v<Type, ClassDeclaration> || std::is_same_v<Type, StructDeclaration>) {
+                out->Write(std::is_same_v<Type, ClassDeclaration> ? "class " : "struct ");
+                Code(concrete.declaration->statement);
+                out->Write(" {\n");
+                bool outer = std::exchange(in_type, true);
+                Body(concrete.block.get());
+                in_type = outer;
+                out->Write("};\n");
+            } else if constexpr (std::is_same_v<Type, NamespaceDeclaration>) {
+                out->Write("namespace ");
+                Code(concrete.namespace_name->statement);
+                out->Write(" {\n");
+                Body(concrete.block.get());
+                out->Write("}\n");
+            } else if constexpr (std::is_same_v<Type, TemplateDeclaration>) {
+                out->Write("template <");
+                if (concrete.template_statement) {
+                    Code(concrete.template_statement->statement);
+                } else {
+                    for (size_t i = 0; i < concrete.arguments.size(); i++) {
+                        const auto &[name, type] = concrete.arguments[i];
+                        if (i)
+                            out->Write(", ");
+                        this->Type(type, "typename");
+                        out->Put(' ');
+                        out->Write(name.Text());
+                    }
+                }
+                out->Write(">\n");
+                bool outer = std::exchange(in_type, true);
+                if (concrete.content)
+                    Emit(*concrete.content);
+                in_type = outer;
+            } else if constexpr (std::is_same_v<Type, LambdaExpression>) {
+                Lambda(concrete);
+                out->Write(";\n");
+            } else if constexpr (std::is_same_v<Type, ElseIfStatement>) {
+                out->Write("else if (");
+                Code(concrete.condition->statement);
+                out->Write(") {\n");
+                Body(concrete.block.get());
+                out->Write("}\n");
+            } else if constexpr (std::is_same_v<Type, IfStatement>) {
+                out->Write("if (");
+                Code(concrete.condition->statement);
+                out->Write(") {\n");
+                Body(concrete.true_block.get());
+                out->Put('}');
+                for (const auto &branch: concrete.else_if_statements) {
+                    out->Write(" else if (");
+                    Code(branch->condition->statement);
+                    out->Write(") {\n");
+                    Body(branch->block.get());
+                    out->Put('}');
+                }
+                if (concrete.else_block) {
+                    out->Write(" else {\n");
+                    Body(concrete.else_block.get());
+                    out->Put('}');
+                }
+                out->Put('\n');
+            } else if constexpr (std::is_same_v<Type, TryCatchStatement>) {
+                out->Write("try {\n");
+                Body(concrete.try_block.get());
+                out->Write("} catch (");
+                if (concrete.catch_arguments.empty())
+                    out->Write("...");
+                else
+                    Arguments(concrete.catch_arguments);
+                out->Write(") {\n");
+                Body(concrete.catch_block.get());
+                out->Write("}\n");
+            } else if constexpr (std::is_same_v<Type, SwitchCaseStatement>) {
+                // cases do not fall through into each other
+                out->Write("switch (");
+                Code(concrete.condition->statement);
+                out->Write(") {\n");
+                out->Indent();
+                for (const auto &[value, block]: concrete.cases) {
+                    out->Write("case ");
+                    Code(value->statement);
+                    out->Write(": {\n");
+                    Body(block.get());
+                    out->Indent();
+                    out->Write("break;\n");
+                    out->Dedent();
+                    out->Write("}\n");
+                }
+                if (concrete.default_case) {
+                    out->Write("default: {\n");
+                    Body(concrete.default_case.get());
+                    out->Write("}\n");
+                }
+                out->Dedent();
+                out->Write("}\n");
+            } else if constexpr (std::is_same_v<Type, PairDestructuring>) {
+                out->Write("auto [");
+                out->Write(concrete.first_var.Text());
+                out->Write(", ");
+                out->Write(concrete.second_var.Text());
+                out->Write("] = ");
+                Code(concrete.initializer->statement);
+                out->Write(";\n");
+            }
+        });
+    }
+
+    void CppGenerator::EmitLoopHeader(const ForLoop &loop) {
+        std::string_view index = loop.identifier->statement;
+        bool hoist_end = loop.bounds_invariant && !IsLiteral(loop.end->statement);
+        bool hoist_step = loop.bounds_invariant && loop.step && !IsLiteral(loop.step->statement);
+        std::string_view step = loop.step ? std::string_view(loop.step->statement) : "1";
+
+        auto end_bound = [&] {
+            if (!hoist_end)
+                return Operand(loop.end->statement);
+            out->Write(cppgen::GENERATED_PREFIX);
+            out->Write("end_");
+            out->Write(index);
+        };
+        auto step_value = [&] {
+            if (!hoist_step)
+                return Operand(step);
+            out->Write(cppgen::GENERATED_PREFIX);
+            out->Write("step_");
+            out->Write(index);
+        };
+
+        out->Write("for (");
+        Type(loop.id_type, "long long");
+        out->Put(' ');
+        out->Write(index);
+        out->Write(" = ");
+        Code(loop.start ? std::string_view(loop.start->statement) : "0");
+
+        if (hoist_end) {
+            out->Write(", ");
+            end_bound();
+            out->Write(" = ");
+            Code(loop.end->statement);
+        }
+        if (hoist_step) {
+            out->Write(", ");
+            step_value();
+            out->Write(" = ");
+            Code(step);
+        }
+
+        out->Write("; ");
+        if (loop.step_sign != 0) {
+            out->Write(index);
+            out->Write(loop.step_sign > 0 ? " < " : " > ");
+            end_bound();
+        } else {
+            out->Put('(');
+            step_value();
+            out->Write(" > 0 ? ");
+            out->Write(index);
+            out->Write(" < ");
+            end_bound();
+            out->Write(" : ");
+            out->Write(index);
+            out->Write(" > ");
+            end_bound();
+            out->Put(')');
+        }
+
+        out->Write("; ");
+        if (!hoist_step && (step == "1" || step == "-1")) {
+            out->Write(step == "1" ? "++" : "--");
+            out->Write(index);
+        } else {
+            out->Write(index);
+            out->Write(" += ");
+            step_value();
+        }
+        out->Put(')');
+    }
+
+    const std::set<std::string, std::less<>> &CppGenerator::Includes() const {
+        return includes;
+    }
+
+    void CppGenerator::Code(std::string_view text) {
+        size_t run = 0; // start of the text not written yet
+        ScanCode(text, [&](std::string_view name) {
+            NeedsFor(name);
+        }, [&](size_t split) {
+            out->Write(text.substr(run, split - run));
+            run = split + 1;
+        });
+
+        out->Write(text.substr(run));
+    }
+
+    void CppGenerator::Type(Atom type, std::string_view fallback) {
+        if (type.Empty() || type == AUTO_ATOM)
+            out->Write(fallback);
+        else
+            Code(type.Text());
+    }
+
+    void CppGenerator::Operand(std::string_view expression) {
+        if (expression.find(' ') == std::string_view::npos)
+            return Code(expression);
+        out->Put('(');
+        Code(expression);
+        out->Put(')');
+    }
+
+    void CppGenerator::Statement(std::string_view text) {
+        Code(text);
+        if (text.empty() || (text.back() != ';' && text.back() != '{' && text.back() != '}'))
+            out->Put(';');
+        out->Put('\n');
+    }
+
+    void CppGenerator::Body(const Block *block) {
+        out->Indent();
+        if (block)
+            Emit(*block);
+        out->Dedent();
+    }
+
+    void CppGenerator::Arguments(const std::vector<std::pair<Atom, Atom>> &arguments) {
+        for (size_t i = 0; i < arguments.size(); i++) {
+            const auto &[name, type] = arguments[i];
+            if (i)
+                out->Write(", ");
+            Type(type, "auto");
+            out->Put(' ');
+            out->Write(name.Text());
+        }
+    }
+
+    void CppGenerator::Signature(const FunctionDeclaration &function, std::string_view prefix) {
+        if (function.type)
+            Code(function.type->statement);
+        else
+            out->Write("auto");
+        out->Put(' ');
+        if (!prefix.empty()) {
+            out->Write(cppgen::GENERATED_PREFIX);
+            out->Write(prefix);
+        }
+        if (function.name)
+            Code(function.name->statement);
+        out->Put('(');
+        Arguments(function.arguments);
+        out->Put(')');
+    }
+
+    void CppGenerator::Prototype(const FunctionDeclaration &function) {
+        // a function with a deduced return type cannot be called before its definition anyway
+        if (!function.type || function.type->statement == AUTO || !function.name || IsMain(function))
+            return;
+
+        if (IsMemoized(function))
+            out->Write("inline ");
+        Signature(function, "");
+        out->Write(";\n");
+    }
+
+    bool CppGenerator::IsMemoized(const FunctionDeclaration &function) const {
+        if (!function.is_memoize || in_type || !function.type || function.type->statement == AUTO ||
+            !function.name || IsMain(function))
+            return false;
+
+        // the table is declared before the function, so every type has to be written out, and hashed
+        return std::none_of(function.arguments.begin(), function.arguments.end(), [](const auto &argument) {
+            return argument.second.Empty() || argument.second == AUTO_ATOM ||
+                   !IsHashable(ParseType(argument.second.Text()));
+        });
+    }
+
+    bool CppGenerator::BottomUp(const FunctionDeclaration &function) const {
+        if (!options.recursion)
+            return false;
+
+        return std::any_of(options.recursion->begin(), options.recursion->end(), [&](const RecursionReport &report) {
+            return report.function == &function && report.pure && report.decreasing;
+        });
+    }
+
+    void CppGenerator::Memoized(const FunctionDeclaration &function) {
+        std::string_view name = function.name->statement;
+        auto table = [&] {
+            out->Write(cppgen::GENERATED_PREFIX);
+            out->Write("memo_");
+            out->Write(name);
+        };
+        auto compute = [&] {
+            out->Write(cppgen::GENERATED_PREFIX);
+            out->Write("compute_");
+            out->Write(name);
+        };
+        auto arguments = [&] {
+            for (size_t i = 0; i < function.arguments.size(); i++) {
+                if (i)
+                    out->Write(", ");
+                out->Write(function.arguments[i].first.Text());
+            }
+        };
+
+        uses_memo = true;
+        auto ranges = DenseMemoRanges(function, options.constraints);
+        bool bottom_up = ranges && BottomUp(function);
+        out->Write("static _tnc_runtime::");
+        if (ranges) {
+            out->Write("DenseMemo<");
+            Code(function.type->statement);
+            *out << ", " << static_cast<long long>(ranges->size()) << "> ";
+            table();
+            out->Write("({");
+            for (size_t i = 0; i < ranges->size(); i++)
+                *out << (i ? ", " : "") << (*ranges)[i].first;
+            out->Write("}, {");
+            for (size_t i = 0; i < ranges->size(); i++)
+                *out << (i ? ", " : "") << (*ranges)[i].second;
+            out->Write("});\n");
+        } else {
+            out->Write("HashMemo<");
+            Code(function.type->statement);
+            for (const auto &argument: function.arguments) {
+                out->Write(", ");
+                Code(argument.second.Text());
+            }
+            out->Write("> ");
+            table();
+            out->Write(";\n");
+        }
+        Signature(function, "compute_");
+        out->Write(";\n\n");
+
+        out->Write("inline ");
+        Signature(function, "");
+        out->Write(" {\n");
+        out->Indent();
+        out->Write("if (const ");
+        Code(function.type->statement);
+        out->Write(" *cached = ");
+        table();
+        if (bottom_up) {
+            // no recursion, the table is filled up to the arguments; outside it the body runs as written
+            out->Write(".Fill(");
+            compute();
+            out->Write(", ");
+        } else {
+            out->Write(".Find(");
+        }
+        arguments();
+        out->Write("))\n");
+        out->Indent();
+        out->Write("return *cached;\n");
+        out->Dedent();
+        out->Write("return ");
+        if (bottom_up) {
+            compute();
+            out->Put('(');
+            arguments();
+            out->Put(')');
+        } else {
+            table();
+            out->Write(".Store(");
+            compute();
+            out->Put('(');
+            arguments();
+            out->Put(')');
+            if (!function.arguments.empty())
+                out->Write(", ");
+            arguments();
+            out->Put(')');
+        }
+        out->Write(";\n");
+        out->Dedent();
+        out->Write("}\n\n");
+
+        Signature(function, "compute_");
+        out->Write(" {\n");
+        Body(function.block.get());
+        out->Write("}\n");
+    }
+
+    void CppGenerator::Initializer(const Node &initializer) {
+        if (initializer.kind == NodeKind::LAMBDA_EXPRESSION)
+            Lambda(static_cast<const LambdaExpression &>(initializer));
+        else if (initializer.kind == NodeKind::GENERAL_STATEMENT)
+            Code(static_cast<const GeneralStatement &>(initializer).statement);
+    }
+
+    void CppGenerator::Lambda(const LambdaExpression &lambda) {
+        out->Put('[');
+        if (lambda.capture_clause)
+            Code(lambda.capture_clause->statement);
+        out->Write("](");
+        Arguments(lambda.arguments);
+        out->Write(") ");
+
+        if (lambda.body && lambda.body->kind == NodeKind::BLOCK) {
+            out->Write("{\n");
+            Body(static_cast<const Block *>(lambda.body.get()));
+            out->Put('}');
+        } else if (lambda.body) {
+            out->Write("{ return ");
+            Initializer(*lambda.body);
+            out->Write("; }");
+        } else {
+            out->Write("{}");
+        }
+    }
+
+    void CppGenerator::Comprehension(std::string_view name, const Node &loop) {
+        const GeneralStatement *operation;
+        if (loop.kind == NodeKind::FOR_LOOP) {
+            const auto &manual = static_cast<const ForLoop &>(loop);
+            EmitLoopHeader(manual);
+            operation = manual.operation ? manual.operation.get() : manual.identifier.get();
+        } else {
+            const auto &ranged = static_cast<const RangedLoop &>(loop);
+            out->Write("for (auto &&");
+            Code(ranged.identifier->statement);
+            out->Write(" : ");
+            Code(ranged.object->statement);
+            out->Put(')');
+            operation = ranged.operation ? ranged.operation.get() : ranged.identifier.get();
+        }
+
+        out->Put(' ');
+        Code(name);
+        out->Write(".push_back(");
+        Code(operation->statement);
+        out->Write(");\n");
+    }
+
+    void CppGenerator::NeedsFor(std::string_view name) {
+        auto header = HEADERS.find(name);
+        if (header != HEADERS.end() && !includes.contains(header->second))
+            includes.emplace(header->second);
+    }
+
+}
@@ -0,0 +1,202 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the chunked output sink
+ */
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <unistd.h>
+
+#include "errors/errors.h"
+#include "generators/output_sink.h"
+
+namespace tonic {
+
+    namespace {
+
+        const std::string SPACES(256, ' ');
+
+    }
+
+    OutputSink::OutputSink() : OutputSink(-1) {}
+
+    OutputSink::OutputSink(int fd) : allocated(0), flushed(0), fd(fd), indent(0), line_start(true) {}
+
+    OutputSink::OutputSink(OutputSink &&other) noexcept
+            : pages(std::move(other.pages)), allocated(other.allocated), flushed(other.flushed), fd(other.fd),
+              indent(other.indent), line_start(other.line_start) {
+        other.pages.clear();
+        other.fd = -1;
+    }
+
+    OutputSink &OutputSink::operator=(OutputSink &&other) noexcept {
+        if (this != &other) {
+            pages = std::move(other.pages);
+            allocated = other.allocated;
+            flushed = other.flushed;
+            fd = other.fd;
+            indent = other.indent;
+            line_start = other.line_start;
+            other.pages.clear();
+            other.fd = -1;
+        }
+        return *this;
+    }
+
+    OutputSink::~OutputSink() {
+        if (fd < 0)
+            return;
+
+        try {
+            Flush();
+        } catch (const InternalError &) {
+            // nothing can be reported from a destructor, call Flush to see the error
+        }
+    }
+
+    void OutputSink::Write(std::string_view text) {
+        while (!text.empty()) {
+            if (line_start && indent > 0 && text.front() != '\n') {
+                size_t width = indent * INDENT_WIDTH;
+                for (; width > SPACES.size(); width -= SPACES.size())
+                    Append(SPACES.data(), SPACES.size());
+                Append(SPACES.data(), width);
+            }
+
+            const void *newline = std::memchr(text.data(), '\n', text.size());
+            size_t line = newline ? static_cast<const char *>(newline) - text.data() + 1 : text.size();
+            Append(text.data(), line);
+            line_start = newline != nullptr;
+            text.remove_prefix(line);
+        }
+    }
+
+    void OutputSink::Put(char c) {
+        if (line_start && c != '\n') {
+            Write(std::string_view(&c, 1));
+            return;
+        }
+
+        Page &page = Writable();
+        page.data[page.size++] = c;
+        line_start = c == '\n';
+    }
+
+    OutputSink &OutputSink::operator<<(std::string_view text) {
+        Write(text);
+        return *this;
+    }
+
+    OutputSink &OutputSink::operator<<(char c) {
+        Put(c);
+        return *this;
+    }
+
+    OutputSink &OutputSink::operator<<(long long value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        Write(std::string_view(digits, result.ptr - digits));
+        return *this;
+    }
+
+    void OutputSink::Indent() {
+        ++indent;
+    }
+
+    void OutputSink::Dedent() {
+        if (indent > 0)
+            --indent;
+    }
+
+    void OutputSink::Flush() {
+        if (fd < 0 || pages.empty())
+            return;
+
+        WritePage(pages.back());
+        pages.back().size = 0;
+    }
+
+    void OutputSink::Splice(OutputSink &&other) {
+        if (other.fd >= 0)
+            throw InternalError("Only an in-memory output sink can be spliced");
+        if (other.pages.empty())
+            return;
+
+        if (fd >= 0) {
+            Flush();
+            for (const auto &page: other.pages)
+                WritePage(page);
+        } else {
+            for (auto &page: other.pages)
+                pages.push_back(std::move(page));
+            allocated += other.allocated;
+        }
+
+        line_start = other.line_start;
+        other.pages.clear();
+        other.allocated = 0;
+    }
+
+    size_t OutputSink::Size() const {
+        size_t size = flushed;
+        for (const auto &page: pages)
+            size += page.size;
+        return size;
+    }
+
+    size_t OutputSink::Pages() const {
+        return allocated;
+    }
+
+    std::string OutputSink::ToString() const {
+        std::string text;
+        text.reserve(Size() - flushed);
+        for (const auto &page: pages)
+            text.append(page.data.get(), page.size);
+        return text;
+    }
+
+    void OutputSink::Append(const char *data, size_t size) {
+        while (size > 0) {
+            Page &page = Writable();
+            size_t chunk = std::min(size, PAGE_SIZE - page.size);
+            std::memcpy(page.data.get() + page.size, data, chunk);
+            page.size += chunk;
+            data += chunk;
+            size -= chunk;
+        }
+    }
+
+    OutputSink::Page &OutputSink::Writable() {
+        if (!pages.empty() && pages.back().size < PAGE_SIZE)
+            return pages.back();
+
+        // a descriptor sink reuses its only page
+        if (fd >= 0 && !pages.empty()) {
+            Flush();
+            return pages.back();
+        }
+
+        pages.push_back({std::make_unique_for_overwrite<char[]>(PAGE_SIZE), 0});
+        ++allocated;
+        return pages.back();
+    }
+
+    void OutputSink::WritePage(const Page &page) {
+        size_t written = 0;
+        while (written < page.size) {
+            ssize_t result = ::write(fd, page.data.get() + written, page.size - written);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result < 0)
+                throw InternalError("Cannot write generated code: " + std::string(std::strerror(errno)));
+            written += static_cast<size_t>(result);
+        }
+        flushed += page.size;
+    }
+
+}
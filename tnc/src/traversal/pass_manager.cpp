@@ -0,0 +1,187 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Implementation of the fused pass manager
+ */
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iomanip>
+#include <unordered_map>
+
+#include "traversal/pass_manager.h"
+#include "traversal/walker.h"
+#include "errors/errors.h"
+
+namespace tonic {
+
+    namespace {
+
+        using Clock = std::chrono::steady_clock;
+
+        template<typename F>
+        void Timed(PassTiming &timing, F &&f) {
+            auto start = Clock::now();
+            f();
+            timing.time += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+            ++timing.calls;
+        }
+
+    }
+
+    PassManager::PassManager(bool time_nodes) : time_nodes(time_nodes) {}
+
+    void PassManager::Add(std::unique_ptr<Pass> pass) {
+        passes.push_back(std::move(pass));
+    }
+
+    std::vector<std::vector<size_t>> PassManager::Levels() const {
+        std::unordered_map<std::string, size_t> indices;
+        for (size_t i = 0; i < passes.size(); i++) {
+            if (!indices.emplace(passes[i]->Name(), i).second)
+                throw InternalError("Pass \"" + passes[i]->Name() + "\" is registered twice");
+        }
+
+        // level of a pass is one more than the deepest level it depends on
+        const size_t unvisited = SIZE_MAX, visiting = SIZE_MAX - 1;
+        std::vector<size_t> level(passes.size(), unvisited);
+
+        std::function<size_t(size_t)> resolve = [&](size_t i) -> size_t {
+            if (level[i] == visiting)
+                throw InternalError("Pass \"" + passes[i]->Name() + "\" has a cyclic dependency");
+            if (level[i] != unvisited)
+                return level[i];
+
+            level[i] = visiting;
+            size_t result = 0;
+            for (const auto &dependency: passes[i]->Dependencies()) {
+                auto found = indices.find(dependency);
+                if (found == indices.end())
+                    throw InternalError("Pass \"" + passes[i]->Name() + "\" depends on unknown pass \"" +
+                                        dependency + "\"");
+
+                result = std::max(result, resolve(found->second) + 1);
+            }
+
+            return level[i] = result;
+        };
+
+        std::vector<std::vector<size_t>> levels;
+        for (size_t i = 0; i < passes.size(); i++) {
+            size_t pass_level = resolve(i);
+            if (levels.size() <= pass_level)
+                levels.resize(pass_level + 1);
+
+            levels[pass_level].push_back(i);
+        }
+
+        return levels;
+    }
+
+    std::vector<std::vector<std::string>> PassManager::Schedule() const {
+        std::vector<std::vector<std::string>> schedule;
+        for (const auto &level: Levels()) {
+            schedule.emplace_back();
+            for (size_t i: level)
+                schedule.back().push_back(passes[i]->Name());
+        }
+        return schedule;
+    }
+
+    void PassManager::Run(const std::shared_ptr<Program> &program) {
+        auto levels = Levels();
+
+        timings.clear();
+        for (const auto &pass: passes)
+            timings.push_back({pass->Name(), 0, 0, std::chrono::nanoseconds(0)});
+        level_times.clear();
+
+        for (size_t level = 0; level < levels.size(); level++) {
+            auto level_start = Clock::now();
+
+            // passes interested in each node kind, in registration order
+            std::array<std::vector<size_t>, NODE_KIND_COUNT> routes;
+            for (size_t i: levels[level]) {
+                timings[i].level = level;
+                Timed(timings[i], [&] { passes[i]->Begin(*program); });
+
+                for (NodeKind kind: passes[i]->Kinds())
+                    routes[static_cast<size_t>(kind)].push_back(i);
+            }
+
+            Walker walker;
+            bool needs_walk = false;
+            for (size_t kind = 0; kind < NODE_KIND_COUNT; kind++) {
+                if (routes[kind].empty())
+                    continue;
+
+                needs_walk = true;
+                const auto &route = routes[kind];
+                if (time_nodes) {
+                    walker.Register(static_cast<NodeKind>(kind), [this, &route](const Walker::NodePtr &node) {
+                        for (size_t i: route)
+                            Timed(timings[i], [&] { passes[i]->Enter(*node); });
+                    });
+                    walker.RegisterPost(static_cast<NodeKind>(kind), [this, &route](const Walker::NodePtr &node) {
+                        for (size_t i: route)
+                            Timed(timings[i], [&] { passes[i]->Leave(*node); });
+                    });
+                    continue;
+                }
+
+                walker.Register(static_cast<NodeKind>(kind), [this, &route](const Walker::NodePtr &node) {
+                    for (size_t i: route) {
+                        passes[i]->Enter(*node);
+                        ++timings[i].calls;
+                    }
+                });
+                walker.RegisterPost(static_cast<NodeKind>(kind), [this, &route](const Walker::NodePtr &node) {
+                    for (size_t i: route) {
+                        passes[i]->Leave(*node);
+                        ++timings[i].calls;
+                    }
+                });
+            }
+
+            if (needs_walk)
+                walker.Walk(program);
+
+            for (size_t i: levels[level])
+                Timed(timings[i], [&] { passes[i]->End(*program); });
+
+            level_times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - level_start));
+        }
+    }
+
+    const std::vector<PassTiming> &PassManager::Timings() const {
+        return timings;
+    }
+
+    size_t PassManager::Traversals() const {
+        return level_times.size();
+    }
+
+    void PassManager::Report(std::ostream &os) const {
+        auto milliseconds = [](std::chrono::nanoseconds time) {
+            return std::chrono::duration<double, std::milli>(time).count();
+        };
+
+        os << std::fixed << std::setprecision(3);
+        for (size_t level = 0; level < level_times.size(); level++) {
+            os << "level " << level << ": " << milliseconds(level_times[level]) << " ms\n";
+
+            for (const auto &timing: timings) {
+                if (timing.level != level)
+                    continue;
+
+                os << "  " << std::left << std::setw(32) << timing.name << std::right
+                   << std::setw(12) << milliseconds(timing.time) << " ms"
+                   << std::setw(12) << timing.calls << " calls\n";
+            }
+        }
+    }
+
+}
@@ -7,142 +7,120 @@
  * heavily in semantic analysis
  */
 
+#include <algorithm>
+
 #include "traversal/walker.h"
+#include "core/children.h"
 
 namespace tonic {
 
     Walker::Walker() = default;
 
-    void Walker::Walk(const NodePtr &node) {
+    bool Walker::Walk(const NodePtr &node) {
         if (!node)
-            return;
-
-        // executing lambda if registered
-        auto handler = handlers.find(typeid(*node).name());
-        if (handler != handlers.end()) {
-            handler->second(node);
-        }
-
-        visited_nodes.push(node);
-
-        // walking through sub-nodes
-        auto program_node = std::dynamic_pointer_cast<Program>(node);
-        if (program_node) {
-            WalkVector(program_node->body);
-        }
-
-        auto block_node = std::dynamic_pointer_cast<Block>(node);
-        if (block_node) {
-            WalkVector(block_node->body);
-        }
-
-        auto cpp_node = std::dynamic_pointer_cast<CppNode>(node);
-        if (cpp_node) {
-            Walk(cpp_node->cpp_code);
-        }
-
-        auto variable_declaration_node = std::dynamic_pointer_cast<VariableDeclaration>(node);
-        if (variable_declaration_node) {
-            Walk(variable_declaration_node->identifier);
-            Walk(variable_declaration_node->initializer);
-        }
-
-        auto function_declaration_node = std::dynamic_pointer_cast<FunctionDeclaration>(node);
-        if (function_declaration_node) {
-            Walk(function_declaration_node->type);
-            Walk(function_declaration_node->name);
-            Walk(function_declaration_node->block);
-        }
-
-        auto for_loop_node = std::dynamic_pointer_cast<ForLoop>(node);
-        if (for_loop_node) {
-            Walk(for_loop_node->identifier);
-            Walk(for_loop_node->start);
-            Walk(for_loop_node->end);
-            Walk(for_loop_node->step);
-            Walk(for_loop_node->operation);
-            Walk(for_loop_node->block);
-        }
-
-        auto ranged_loop_node = std::dynamic_pointer_cast<RangedLoop>(node);
-        if (ranged_loop_node) {
-            Walk(ranged_loop_node->identifier);
-            Walk(ranged_loop_node->object);
-            Walk(ranged_loop_node->operation);
-            Walk(ranged_loop_node->block);
-        }
+            return true;
+
+        // walks may be started from inside a handler, so only frames above the base belong to this one
+        size_t base = stack.size();
+        size_t ancestors_base = ancestors.size();
+        stack.push_back({node.get(), &node, &Own<Node>, false});
+
+        while (stack.size() > base) {
+            Frame frame = stack.back();
+            WalkControl control;
+
+            if (frame.entered) {
+                stack.pop_back();
+                ancestors.pop_back();
+                control = Leave(frame);
+            } else {
+                stack.back().entered = true;
+                control = Enter(frame);
+                ancestors.push_back(frame.node);
+
+                if (control == WalkControl::CONTINUE) {
+                    // children are pushed in reverse so they are popped in walking order
+                    size_t first_child = stack.size();
+                    ForEachChildSlot(*frame.node, [this](const auto &slot) {
+                        using SlotType = typename std::remove_reference_t<decltype(slot)>::element_type;
+                        if (slot)
+                            stack.push_back({slot.get(), &slot, &Own<SlotType>, false});
+                    });
+                    std::reverse(stack.begin() + static_cast<std::ptrdiff_t>(first_child), stack.end());
+                }
+            }
 
-        auto while_loop_node = std::dynamic_pointer_cast<WhileLoop>(node);
-        if (while_loop_node) {
-            Walk(while_loop_node->condition);
-            Walk(while_loop_node->block);
+            if (control == WalkControl::STOP) {
+                stack.resize(base);
+                ancestors.resize(ancestors_base);
+                return false;
+            }
         }
 
-        auto in_out_node = std::dynamic_pointer_cast<InputOutput>(node);
-        if (in_out_node) {
-            WalkVector(in_out_node->operands);
-        }
+        return true;
+    }
 
-        auto class_declaration_node = std::dynamic_pointer_cast<ClassDeclaration>(node);
-        if (class_declaration_node) {
-            Walk(class_declaration_node->declaration);
-            Walk(class_declaration_node->block);
-        }
+    bool Walker::Walk(const FlatAst &ast) {
+        size_t base = open_flat_nodes.size();
+        size_t ancestors_base = ancestors.size();
+
+        auto close = [&]() {
+            uint32_t index = open_flat_nodes.back();
+            open_flat_nodes.pop_back();
+            ancestors.pop_back();
+            return Leave({ast.Source(index).get(), &ast.Source(index), &Own<Node>, true});
+        };
+
+        auto stop = [&]() {
+            open_flat_nodes.resize(base);
+            ancestors.resize(ancestors_base);
+            return false;
+        };
+
+        for (uint32_t i = 0; i < ast.Size(); i++) {
+            while (open_flat_nodes.size() > base && open_flat_nodes.back() != ast[i].parent) {
+                if (close() == WalkControl::STOP)
+                    return stop();
+            }
 
-        auto struct_declaration_node = std::dynamic_pointer_cast<StructDeclaration>(node);
-        if (struct_declaration_node) {
-            Walk(struct_declaration_node->declaration);
-            Walk(struct_declaration_node->block);
-        }
+            const NodePtr &node = ast.Source(i);
+            WalkControl control = Enter({node.get(), &node, &Own<Node>, false});
+            if (control == WalkControl::STOP)
+                return stop();
 
-        auto namespace_declaration_node = std::dynamic_pointer_cast<NamespaceDeclaration>(node);
-        if (namespace_declaration_node) {
-            Walk(namespace_declaration_node->namespace_name);
-            Walk(namespace_declaration_node->block);
-        }
+            open_flat_nodes.push_back(i);
+            ancestors.push_back(node.get());
 
-        auto template_node = std::dynamic_pointer_cast<TemplateDeclaration>(node);
-        if (template_node) {
-            Walk(template_node->template_statement);
-            Walk(template_node->content);
+            // the node stays open, so its post handler still runs
+            if (control == WalkControl::SKIP_CHILDREN)
+                i = ast.SkipSubtree(i) - 1;
         }
 
-        auto lambda_expression_node = std::dynamic_pointer_cast<LambdaExpression>(node);
-        if (lambda_expression_node) {
-            Walk(lambda_expression_node->capture_clause);
-            Walk(lambda_expression_node->body);
+        while (open_flat_nodes.size() > base) {
+            if (close() == WalkControl::STOP)
+                return stop();
         }
 
-        auto if_statement_node = std::dynamic_pointer_cast<IfStatement>(node);
-        if (if_statement_node) {
-            Walk(if_statement_node->condition);
-            Walk(if_statement_node->true_block);
-            WalkVector(if_statement_node->else_if_statements);
-            Walk(if_statement_node->else_block);
-        }
-
-        auto try_catch_statement_node = std::dynamic_pointer_cast<TryCatchStatement>(node);
-        if (try_catch_statement_node) {
-            Walk(try_catch_statement_node->try_block);
-            Walk(try_catch_statement_node->catch_block);
-        }
+        return true;
+    }
 
-        auto switch_case_statement_node = std::dynamic_pointer_cast<SwitchCaseStatement>(node);
-        if (switch_case_statement_node) {
-            Walk(switch_case_statement_node->condition);
-            for (const auto& case_pair : switch_case_statement_node->cases) {
-                Walk(case_pair.first);
-                Walk(case_pair.second);
-            }
-            Walk(switch_case_statement_node->default_case);
+    WalkControl Walker::Enter(const Frame &frame) {
+        // executing lambda if registered
+        const Action &handler = handlers[static_cast<size_t>(frame.node->kind)];
+        if (handler) {
+            return handler(frame.own(frame.slot));
         }
+        return WalkControl::CONTINUE;
+    }
 
-        auto pair_destructuring_node = std::dynamic_pointer_cast<PairDestructuring>(node);
-        if (pair_destructuring_node) {
-            Walk(pair_destructuring_node->initializer);
+    WalkControl Walker::Leave(const Frame &frame) {
+        const Action &handler = post_handlers[static_cast<size_t>(frame.node->kind)];
+        if (handler) {
+            // skipping children is meaningless once they have been walked
+            WalkControl control = handler(frame.own(frame.slot));
+            return control == WalkControl::STOP ? WalkControl::STOP : WalkControl::CONTINUE;
         }
-
-        visited_nodes.pop();
+        return WalkControl::CONTINUE;
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,168 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the access pattern analysis and loop interchange
+ */
+
+#include "gtest/gtest.h"
+
+#include "analyzers/access.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    const ForLoop &LoopAt(const Program &program, size_t index) {
+        return static_cast<const ForLoop &>(*program.body[index]);
+    }
+
+}
+
+TEST(AccessTests, FindsSubscripts) {
+    std::vector<ArrayAccess> accesses = FindAccesses("a [ j ] [ i + 1 ] + = b [ p [ i ] ]");
+
+    ASSERT_EQ(3u, accesses.size());
+    EXPECT_EQ(Atom("a"), accesses[0].array);
+    EXPECT_EQ((std::vector<std::string>{"j", "i + 1"}), accesses[0].subscripts);
+    EXPECT_TRUE(accesses[0].write);
+    EXPECT_EQ((std::vector<std::string>{"p [ i ]"}), accesses[1].subscripts);
+    EXPECT_FALSE(accesses[1].write);
+
+    EXPECT_TRUE(IsStrided(accesses[0], "j"));
+    EXPECT_FALSE(IsStrided(accesses[0], "i"));
+    EXPECT_FALSE(IsStrided(accesses[1], "i"));
+}
+
+TEST(AccessTests, InterchangesColumnMajorReductions) {
+    auto body = Statement("s + = a [ j ] [ i ]");
+    auto nest = Loop("i", "0", "n", {Loop("j", "0", "m", {body})});
+    auto program = MakeProgram({nest});
+
+    Diagnostics diagnostics;
+    AccessAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    ASSERT_EQ(1u, analysis.Nests().size());
+    EXPECT_TRUE(analysis.Nests()[0].interchanged);
+    EXPECT_EQ(std::vector<Atom>{"a"}, analysis.Nests()[0].arrays);
+
+    const ForLoop &outer = LoopAt(*program, 0);
+    EXPECT_EQ("j", outer.identifier->statement);
+    EXPECT_EQ("m", outer.end->statement);
+    const auto &inner = static_cast<const ForLoop &>(*outer.block->body[0]);
+    EXPECT_EQ("i", inner.identifier->statement);
+    EXPECT_EQ(body, inner.block->body[0]);
+
+    // the original nest is left as it was
+    EXPECT_EQ("i", nest->identifier->statement);
+    EXPECT_EQ(1u, diagnostics.Count(Severity::NOTE));
+}
+
+TEST(AccessTests, RowMajorNestsStay) {
+    auto program = MakeProgram({Loop("i", "0", "n", {Loop("j", "0", "m",
+                                                          {Statement("b [ i ] [ j ] = a [ i ] [ j ] * 2")})})});
+
+    Diagnostics diagnostics;
+    AccessAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    ASSERT_EQ(1u, analysis.Nests().size());
+    EXPECT_FALSE(analysis.Nests()[0].interchanged);
+    EXPECT_EQ("i", LoopAt(*program, 0).identifier->statement);
+    EXPECT_TRUE(diagnostics.Empty());
+}
+
+TEST(AccessTests, DependencesBlockTheSwap) {
+    auto shifted = Loop("i", "0", "n", {Loop("j", "0", "m", {Statement("a [ j ] [ i ] = a [ j - 1 ] [ i + 1 ] + 1")})});
+    auto triangular = Loop("i", "0", "n", {Loop("j", "0", "i", {Statement("s + = a [ j ] [ i ]")})});
+    auto last_value = Loop("i", "0", "n", {Loop("j", "0", "m", {Statement("x = a [ j ] [ i ]")})});
+    auto printed = Loop("i", "0", "n", {Loop("j", "0", "m", {Statement("print ( a [ j ] [ i ] )")})});
+    auto program = MakeProgram({shifted, triangular, last_value, printed});
+
+    Diagnostics diagnostics;
+    AccessAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    const auto &nests = analysis.Nests();
+    ASSERT_EQ(4u, nests.size());
+    EXPECT_EQ("`a` is written at a [ j ] [ i ] and accessed at a [ j - 1 ] [ i + 1 ]", nests[0].reason);
+    EXPECT_EQ("the bounds of `j` depend on `i`", nests[1].reason);
+    EXPECT_EQ("`x` is assigned in the body", nests[2].reason);
+    EXPECT_EQ("the body calls `print`", nests[3].reason);
+
+    EXPECT_EQ(shifted, program->body[0]);
+    EXPECT_EQ(4u, diagnostics.Count(Severity::WARNING));
+    EXPECT_NE(std::string::npos, diagnostics.All()[0].message.find("making `j` the outer loop"));
+}
+
+TEST(AccessTests, EveryScalarWriteIsChecked) {
+    // each nest also sums a column, which makes it worth interchanging
+    auto nest = [](const std::string &statement) {
+        return Loop("i", "0", "n", {Loop("j", "0", "m", {Statement(statement), Statement("t + = a [ j ] [ i ]")})});
+    };
+    auto shifted = nest("s < < = 1"), joined = nest("s >>= 1"), masked = nest("s | = b [ j ] [ i ]");
+    auto nested = nest("if ( ( s < < = 1 ) > m ) u = 1");
+    auto embedded = nest("u + = c ++");
+    auto program = MakeProgram({shifted, joined, masked, nested, embedded});
+
+    Diagnostics diagnostics;
+    AccessAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    const auto &nests = analysis.Nests();
+    ASSERT_EQ(5u, nests.size());
+    EXPECT_EQ("`s` is assigned in the body", nests[0].reason);
+    EXPECT_EQ("`s` is assigned in the body", nests[1].reason);
+    EXPECT_TRUE(nests[2].interchanged);
+    EXPECT_EQ("`s` is written in `if ( ( s < < = 1 ) > m ) u = 1`", nests[3].reason);
+    EXPECT_EQ("`c` is written in `u + = c ++`", nests[4].reason);
+}
+
+TEST(AccessTests, OrderDependentWritesBlockTheSwap) {
+    auto same_cell = Loop("i", "0", "n", {Loop("j", "0", "m",
+                                               {Statement("t [ 0 ] [ 0 ] = t [ 0 ] [ 0 ] * 2 + a [ j ] [ i ]")})});
+    auto diagonal = Loop("i", "0", "n", {Loop("j", "0", "m",
+                                              {Statement("c [ i + j ] = c [ i + j ] * 2 + a [ j ] [ i ]")})});
+    auto reduction = Loop("i", "0", "n", {Loop("j", "0", "m", {Statement("c [ i + j ] + = a [ j ] [ i ]")})});
+    auto program = MakeProgram({same_cell, diagonal, reduction});
+
+    Diagnostics diagnostics;
+    AccessAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    const auto &nests = analysis.Nests();
+    ASSERT_EQ(3u, nests.size());
+    EXPECT_EQ("`t` is written at t [ 0 ] [ 0 ], the same element in different iterations", nests[0].reason);
+    EXPECT_EQ("`c` is written at c [ i + j ], the same element in different iterations", nests[1].reason);
+    EXPECT_TRUE(nests[2].interchanged);
+
+    EXPECT_EQ(same_cell, program->body[0]);
+    EXPECT_EQ(diagonal, program->body[1]);
+}
+
+TEST(AccessTests, InterchangeCopiesThePathToTheNest) {
+    auto nest = Loop("i", "0", "n", {Loop("j", "0", "m", {Statement("s + = a [ j ] [ i ]")})});
+    auto function = std::make_shared<FunctionDeclaration>();
+    function->name = Statement("sum");
+    function->block = std::make_shared<Block>();
+    function->block->body = {nest};
+    auto block = function->block;
+    auto program = MakeProgram({function});
+
+    Diagnostics diagnostics;
+    AccessAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    // the function and its block are copies, the shared originals still hold the nest
+    ASSERT_TRUE(analysis.Nests()[0].interchanged);
+    const auto &copy = static_cast<const FunctionDeclaration &>(*program->body[0]);
+    EXPECT_NE(function, program->body[0]);
+    EXPECT_NE(block, copy.block);
+    EXPECT_EQ("j", static_cast<const ForLoop &>(*copy.block->body[0]).identifier->statement);
+    EXPECT_EQ(nest, block->body[0]);
+    EXPECT_EQ("i", nest->identifier->statement);
+}
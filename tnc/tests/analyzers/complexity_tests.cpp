@@ -0,0 +1,148 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the time complexity estimate
+ */
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "analyzers/complexity.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    std::shared_ptr<FunctionDeclaration> Function(const std::string &name, std::vector<std::string> arguments,
+                                                  std::vector<std::shared_ptr<Node>> body) {
+        auto function = std::make_shared<FunctionDeclaration>();
+        function->name = Statement(name);
+        for (const auto &argument: arguments)
+            function->arguments.emplace_back(Atom(argument), Atom("int"));
+        function->block = MakeBlock(std::move(body));
+        return function;
+    }
+
+    Constraints Parse(const std::string &text) {
+        Constraints constraints;
+        ParseConstraints(text, constraints);
+        return constraints;
+    }
+
+}
+
+TEST(ComplexityTests, CostAlgebra) {
+    Cost n = Cost::Symbol("n"), m = Cost::Symbol("m");
+
+    EXPECT_EQ("O(1)", Cost::Constant(5).ToString());
+    EXPECT_EQ("O(m·n + n·log n)", (n * m + n * Cost::Log("n") + n + Cost::Constant(3)).ToString());
+    EXPECT_EQ("O(n^2)", (n * n + n).ToString());
+    EXPECT_EQ("O(sqrt n)", n.Power(0.5).ToString());
+    EXPECT_EQ("O(2^n·n)", (Cost::Exponential(2, "n") * n + n * n).ToString());
+    EXPECT_EQ(2, (n * n * m).PowerOf("n"));
+}
+
+TEST(ComplexityTests, EstimatesUnderConstraints) {
+    Constraints constraints = Parse("n <= 1000, m <= 8");
+    Cost cost = Cost::Symbol("n") * Cost::Symbol("n") + Cost::Exponential(2, "m");
+
+    EXPECT_DOUBLE_EQ(1000256, *cost.Estimate(constraints));
+    EXPECT_FALSE((cost * Cost::Symbol("k")).Estimate(constraints).has_value());
+    EXPECT_EQ(std::vector<Atom>{"k"}, (cost * Cost::Symbol("k")).Unbounded(constraints));
+}
+
+TEST(ComplexityTests, NestedLoopsOverBudget) {
+    auto inner = Loop("j", "0", "m", {Statement("s + = a [ i ] [ j ]")});
+    auto outer = Loop("i", "0", "n", {inner}, 4);
+    auto program = MakeProgram({outer});
+
+    Diagnostics diagnostics;
+    ComplexityAnalysis analysis(diagnostics, Parse("1 <= n, m <= 1e5"));
+    analysis.Run(*program);
+
+    ASSERT_EQ(1u, analysis.LoopNests().size());
+    EXPECT_EQ("O(m·n)", analysis.LoopNests()[0].cost.ToString());
+    EXPECT_GT(*analysis.LoopNests()[0].operations, 1e10);
+    ASSERT_EQ(1u, diagnostics.Count(Severity::WARNING)); // top-level code does not repeat the warning
+
+    auto warning = std::find_if(diagnostics.All().begin(), diagnostics.All().end(),
+                                [](const Diagnostic &diagnostic) { return diagnostic.severity == Severity::WARNING; });
+    EXPECT_EQ(4u, warning->line);
+    EXPECT_NE(std::string::npos, warning->message.find("over the budget of 3.0e8"));
+}
+
+TEST(ComplexityTests, DependentAndConstantBounds) {
+    auto triangle = Loop("i", "0", "n", {Loop("j", "0", "i", {Statement("c + = 1")})});
+    auto constant = Loop("k", "0", "100", {Statement("c + = 1")});
+    auto strided = Loop("t", "0", "sqrt ( n )", {});
+
+    Diagnostics diagnostics;
+    ComplexityAnalysis analysis(diagnostics, Parse("n <= 2000"));
+    analysis.Run(*MakeProgram({triangle, constant, strided}));
+
+    ASSERT_EQ(3u, analysis.LoopNests().size());
+    EXPECT_EQ("O(n^2)", analysis.LoopNests()[0].cost.ToString());
+    EXPECT_EQ("O(1)", analysis.LoopNests()[1].cost.ToString());
+    EXPECT_EQ("O(sqrt n)", analysis.LoopNests()[2].cost.ToString());
+    EXPECT_EQ(0u, diagnostics.Count(Severity::WARNING));
+}
+
+TEST(ComplexityTests, RangedAndHalvingLoops) {
+    auto ranged = std::make_shared<RangedLoop>();
+    ranged->identifier = Statement("x");
+    ranged->object = Statement("v");
+    ranged->block = MakeBlock({Statement("s + = x")});
+
+    auto halving = std::make_shared<WhileLoop>();
+    halving->condition = Statement("n > 0");
+    halving->block = MakeBlock({Statement("n / = 2")});
+
+    Diagnostics diagnostics;
+    ComplexityAnalysis analysis(diagnostics, Parse("|v| <= 1e5, n <= 1e18"));
+    analysis.Run(*MakeProgram({ranged, halving}));
+
+    ASSERT_EQ(2u, analysis.LoopNests().size());
+    EXPECT_EQ("O(v)", analysis.LoopNests()[0].cost.ToString());
+    EXPECT_EQ("O(log n)", analysis.LoopNests()[1].cost.ToString());
+}
+
+TEST(ComplexityTests, SolvesRecursion) {
+    auto fib = Function("fib", {"n"}, {Statement("return fib ( n - 1 ) + fib ( n - 2 )")});
+    auto sort = Function("sort", {"n"}, {Statement("sort ( n / 2 )"), Statement("sort ( n / 2 )"),
+                                         Loop("i", "0", "n", {Statement("merge ( i )")})});
+    auto search = Function("search", {"n"}, {Statement("return search ( n / 2 )")});
+    auto memo = Function("ways", {"n", "k"}, {Statement("return ways ( n - 1 , k ) + ways ( n , k - 1 )")});
+    memo->is_memoize = true;
+
+    Diagnostics diagnostics;
+    ComplexityAnalysis analysis(diagnostics, Parse("n <= 50, k <= 50"));
+    analysis.Run(*MakeProgram({fib, sort, search, memo}));
+
+    const auto &functions = analysis.Functions();
+    ASSERT_EQ(4u, functions.size());
+    EXPECT_EQ("O(2^n)", functions[0].cost.ToString());
+    EXPECT_EQ("O(n·log n)", functions[1].cost.ToString());
+    EXPECT_EQ("O(log n)", functions[2].cost.ToString());
+    EXPECT_EQ("O(k·n)", functions[3].cost.ToString());
+    EXPECT_EQ(1u, diagnostics.Count(Severity::WARNING)); // 2^50
+}
+
+TEST(ComplexityTests, CalleesAreChargedAtTheirCalls) {
+    auto scan = Function("scan", {"n"}, {Loop("i", "0", "n", {Statement("s + = i")})});
+    auto loop = Loop("q", "0", "queries", {Statement("scan ( n )")});
+
+    Diagnostics diagnostics;
+    ComplexityAnalysis analysis(diagnostics, Parse("n <= 1e5"));
+    analysis.Run(*MakeProgram({scan, loop}));
+
+    ASSERT_EQ(2u, analysis.Functions().size());
+    EXPECT_EQ("main", analysis.Functions()[1].name);
+    EXPECT_EQ("O(n·queries)", analysis.Functions()[1].cost.ToString());
+    EXPECT_FALSE(analysis.Functions()[1].operations.has_value());
+    EXPECT_NE(std::string::npos, diagnostics.All().back().message.find("constrain `queries`"));
+}
@@ -0,0 +1,57 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the constraint parser
+ */
+
+#include "gtest/gtest.h"
+
+#include "analyzers/constraints.h"
+
+using namespace tonic;
+
+TEST(ConstraintsTests, ParsesChains) {
+    Constraints constraints;
+    ParseConstraints("1 <= n <= 2e5, 0<=a_i<10^9; k < 2*10^5", constraints);
+
+    EXPECT_EQ(Interval::Of(1, 200000), constraints.at("n"));
+    EXPECT_EQ(Interval::Of(0, 999999999), constraints.at("a_i"));
+    EXPECT_EQ(199999, UpperBound(constraints, "k"));
+}
+
+TEST(ConstraintsTests, NamesShareTheFollowingChain) {
+    Constraints constraints;
+    ParseConstraints("n, m <= 1'000'000 and |s| <= 1e5", constraints);
+
+    EXPECT_EQ(1000000, UpperBound(constraints, "n"));
+    EXPECT_EQ(1000000, UpperBound(constraints, "m"));
+    EXPECT_EQ(100000, UpperBound(constraints, "s"));
+
+    Constraints lower_first;
+    ParseConstraints("1 <= n, m <= 1e5", lower_first);
+    EXPECT_EQ(Interval::Of(1, 100000), lower_first.at("n"));
+    EXPECT_EQ(100000, UpperBound(lower_first, "m"));
+}
+
+TEST(ConstraintsTests, LowerBoundsAloneAreNotUpperBounds) {
+    Constraints constraints;
+    ParseConstraints("n >= 1, q = 5", constraints);
+
+    EXPECT_FALSE(UpperBound(constraints, "n").has_value());
+    EXPECT_EQ(Interval::Point(5), constraints.at("q"));
+    EXPECT_FALSE(UpperBound(constraints, "x").has_value());
+}
+
+TEST(ConstraintsTests, ReadsConstraintComments) {
+    std::vector<Token> tokens = {
+            Token(TokenType::COMMENT, "// Constraints: 1 <= n <= 100", 1),
+            Token(TokenType::COMMENT, "// m <= 5", 2),
+            Token(TokenType::COMMENT, "/* constraints: m <= 7 */", 3),
+    };
+    Constraints constraints = ConstraintsFromComments(tokens);
+
+    EXPECT_EQ(100, UpperBound(constraints, "n"));
+    EXPECT_EQ(7, UpperBound(constraints, "m"));
+}
@@ -0,0 +1,146 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the interval evaluator
+ */
+
+#include "gtest/gtest.h"
+
+#include "analyzers/interval.h"
+
+using namespace tonic;
+
+namespace {
+
+    std::optional<Interval> Variables(Atom name) {
+        if (name == "n")
+            return Interval::Of(1, 200000);
+        if (name == "i")
+            return Interval::Of(0, 199999);
+        return std::nullopt;
+    }
+
+    Evaluation Evaluate(std::string_view expression) {
+        return EvaluateInterval(expression, Variables);
+    }
+
+}
+
+TEST(IntervalTests, Literals) {
+    EXPECT_EQ(Interval::Point(200000), Evaluate("2e5").value);
+    EXPECT_EQ(Interval::Point(1000000007), Evaluate("1e9 + 7").value);
+    EXPECT_EQ(Interval::Point(1000000), Evaluate("1'000'000").value);
+    EXPECT_EQ(Interval::Point(255), Evaluate("0xFF").value);
+    EXPECT_EQ(Interval::Point(1LL << 20), Evaluate("1 << 20").value);
+    EXPECT_EQ(ValueKind::INTEGER, Evaluate("10LL").kind);
+    EXPECT_EQ(ValueKind::OTHER, Evaluate("0.5").kind);
+    EXPECT_EQ(ValueKind::OTHER, Evaluate("\"text\"").kind);
+}
+
+TEST(IntervalTests, Arithmetic) {
+    EXPECT_EQ(Interval::Of(2, 400000), Evaluate("n * 2").value);
+    EXPECT_EQ(Interval::Of(-199998, 200000), Evaluate("n - i").value);
+    EXPECT_EQ(Interval::Of(0, 100000), Evaluate("n / 2").value);
+    EXPECT_EQ(Interval::Of(0, 6), Evaluate("( i + n ) % 7").value);
+    EXPECT_EQ(Interval::Of(-200000, -1), Evaluate("-n").value);
+    EXPECT_EQ(Interval::Of(0, 12499), Evaluate("i >> 4").value);
+    EXPECT_EQ(Interval::Of(1, 400000), Evaluate("n > 5 ? n * 2 : 1").value);
+}
+
+TEST(IntervalTests, ComparisonsAreBoolean) {
+    Evaluation evaluation = Evaluate("i < n && n != 3");
+
+    EXPECT_EQ(ValueKind::BOOLEAN, evaluation.kind);
+    EXPECT_EQ(Interval::Of(0, 1), evaluation.value);
+}
+
+TEST(IntervalTests, UnknownOperandsAreOther) {
+    EXPECT_EQ(ValueKind::OTHER, Evaluate("m + 1").kind);
+    EXPECT_EQ(ValueKind::OTHER, Evaluate("a [ i ] + 1").kind);
+    EXPECT_EQ(ValueKind::OTHER, Evaluate("v . size ( )").kind);
+    EXPECT_EQ(ValueKind::OTHER, Evaluate("std :: max ( n , i )").kind);
+    EXPECT_FALSE(Evaluate("n +").value.IsBounded());
+}
+
+TEST(IntervalTests, ReportsOverflowingOperands) {
+    EXPECT_TRUE(Evaluate("n * 1000").overflowing.empty());
+
+    std::vector<Atom> overflowing = Evaluate("n * i").overflowing;
+    ASSERT_EQ(2, overflowing.size());
+    EXPECT_EQ("n", overflowing[0]);
+    EXPECT_EQ("i", overflowing[1]);
+
+    // arguments of calls are still checked
+    EXPECT_FALSE(Evaluate("f ( n * n )").overflowing.empty());
+    EXPECT_TRUE(Evaluate("a [ i ] * n").overflowing.empty());
+}
+
+TEST(IntervalTests, TypeRanges) {
+    EXPECT_EQ(Int32Range(), TypeRange("int"));
+    EXPECT_EQ(Int32Range(), TypeRange("const int"));
+    EXPECT_EQ(Int64Range(), TypeRange("long long"));
+    EXPECT_EQ(Interval::Of(0, 1), TypeRange("bool"));
+    EXPECT_FALSE(TypeRange("string").has_value());
+    EXPECT_FALSE(TypeRange("auto").has_value());
+}
+
+TEST(IntervalTests, JoinsShiftAssignments) {
+    EXPECT_EQ((std::vector<std::string>{"a", "<<=", "b"}), TokenizeExpression("a < < = b"));
+    EXPECT_EQ((std::vector<std::string>{"a", ">>=", "b"}), TokenizeExpression("a >>= b"));
+    EXPECT_EQ((std::vector<std::string>{"a", "<<", "b", "==", "c"}), TokenizeExpression("a < < b == c"));
+    EXPECT_EQ((std::vector<std::string>{"a", "<<", "==", "c"}), TokenizeExpression("a << == c"));
+}
+
+TEST(IntervalTests, FindsWrites) {
+    auto written = [](std::string_view statement) {
+        std::vector<std::string> tokens = TokenizeExpression(statement);
+        std::vector<std::string> names;
+        for (size_t i = 0; i < tokens.size(); i++)
+            if (IsWritten(tokens, i))
+                names.push_back(tokens[i]);
+        return names;
+    };
+
+    EXPECT_EQ((std::vector<std::string>{"a", "c"}), written("a [ c ++ ] = i"));
+    EXPECT_EQ((std::vector<std::string>{"s", "t"}), written("if ( s < < = 1 ) t = s"));
+    EXPECT_EQ((std::vector<std::string>{"x", "y"}), written("swap ( x , y )"));
+    EXPECT_EQ((std::vector<std::string>{"n"}), written("scanf ( \"%d\" , & n )"));
+    EXPECT_EQ((std::vector<std::string>{"x"}), written("x = max ( y , z ) + v . size ( ) + f ( y + 1 )"));
+}
+
+TEST(IntervalTests, SplitsAssignments) {
+    std::optional<Assignment> plain = SplitAssignment("x = n * 2");
+    ASSERT_TRUE(plain.has_value());
+    EXPECT_EQ("x", plain->target);
+    EXPECT_EQ('=', plain->operation);
+    EXPECT_EQ("n * 2", plain->value);
+
+    std::optional<Assignment> compound = SplitAssignment("total + = a [ i ]");
+    ASSERT_TRUE(compound.has_value());
+    EXPECT_EQ('+', compound->operation);
+    EXPECT_EQ("a [ i ]", compound->value);
+
+    for (std::string_view increment: {"cnt ++", "cnt + +", "++ cnt"}) {
+        std::optional<Assignment> step = SplitAssignment(increment);
+        ASSERT_TRUE(step.has_value()) << increment;
+        EXPECT_EQ("cnt", step->target);
+        EXPECT_EQ('+', step->operation);
+        EXPECT_EQ("1", step->value);
+    }
+
+    for (std::string_view shift: {"mask <<= k + 1", "mask < < = k + 1", "mask << = k + 1"}) {
+        std::optional<Assignment> shifted = SplitAssignment(shift);
+        ASSERT_TRUE(shifted.has_value()) << shift;
+        EXPECT_EQ('<', shifted->operation);
+        EXPECT_EQ("<<", BinaryOperator(*shifted));
+        EXPECT_EQ("k + 1", shifted->value);
+    }
+    for (std::string_view bitwise: {"mask |= 1", "mask | = 1", "mask ^ = 1", "mask & = 1", "mask > > = 1"})
+        EXPECT_TRUE(SplitAssignment(bitwise).has_value()) << bitwise;
+
+    EXPECT_FALSE(SplitAssignment("a [ i ] = 3").has_value());
+    EXPECT_FALSE(SplitAssignment("x == 3").has_value());
+    EXPECT_FALSE(SplitAssignment("f ( x )").has_value());
+}
@@ -0,0 +1,162 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the loop bounds analysis
+ */
+
+#include "gtest/gtest.h"
+
+#include "analyzers/loop_bounds.h"
+#include "core/hash.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    std::shared_ptr<VariableDeclaration> Declare(const std::string &name, const std::string &initializer) {
+        auto declaration = std::make_shared<VariableDeclaration>();
+        declaration->identifier = Statement(name);
+        declaration->initializer = Statement(initializer);
+        return declaration;
+    }
+
+}
+
+TEST(LoopBoundsTests, FoldsConstantBounds) {
+    auto loop = WithStep(Loop("i", "0", "1 << 20"), "2");
+    LoopBoundsAnalysis().Run(*MakeProgram({loop}));
+
+    EXPECT_EQ("1048576", loop->end->statement);
+    EXPECT_EQ(1, loop->step_sign);
+    EXPECT_EQ(524288u, loop->trip_count);
+    EXPECT_TRUE(loop->bounds_invariant);
+}
+
+TEST(LoopBoundsTests, PropagatesSingleAssignmentConstants) {
+    auto loop = Loop("i", "0", "N + 1");
+    auto program = MakeProgram({Declare("MAX", "2e5"), Declare("N", "MAX * 2"), loop});
+
+    LoopBoundsAnalysis analysis;
+    analysis.Run(*program);
+
+    EXPECT_EQ(400000, analysis.ConstantOf("N"));
+    EXPECT_EQ("400001", loop->end->statement);
+    EXPECT_EQ(400001u, loop->trip_count);
+}
+
+TEST(LoopBoundsTests, ReassignedVariablesAreNotConstant) {
+    auto loop = Loop("i", "0", "n");
+    auto program = MakeProgram({Declare("n", "10"), Declare("n", "20"), loop});
+
+    LoopBoundsAnalysis analysis;
+    analysis.Run(*program);
+
+    EXPECT_FALSE(analysis.ConstantOf("n").has_value());
+    EXPECT_EQ("n", loop->end->statement);
+    EXPECT_FALSE(loop->trip_count.has_value());
+    EXPECT_EQ(1, loop->step_sign);
+}
+
+TEST(LoopBoundsTests, EveryWriteRedefinesAVariable) {
+    auto shifted = Loop("i", "0", "c"), masked = Loop("i", "0", "n"), swapped = Loop("i", "0", "m");
+    auto program = MakeProgram({Declare("c", "8"), Declare("n", "5"), Declare("m", "7"), Statement("c < < = 2"),
+                                Statement("n | = 1"), Statement("swap ( m , k )"), shifted, masked, swapped});
+
+    LoopBoundsAnalysis analysis;
+    analysis.Run(*program);
+
+    EXPECT_FALSE(analysis.ConstantOf("c").has_value());
+    EXPECT_FALSE(analysis.ConstantOf("n").has_value());
+    EXPECT_FALSE(analysis.ConstantOf("m").has_value());
+    EXPECT_EQ("c", shifted->end->statement);
+    EXPECT_EQ("n", masked->end->statement);
+    EXPECT_EQ("m", swapped->end->statement);
+
+    auto body = Loop("i", "0", "c", {Statement("c < < = 1")});
+    LoopBoundsAnalysis().Run(*MakeProgram({body}));
+    EXPECT_FALSE(body->bounds_invariant);
+}
+
+TEST(LoopBoundsTests, FoldsOnlyExactValues) {
+    auto large = Loop("i", "0", "1000000000000000001");
+    auto rounded = Loop("i", "0", "( 1 << 53 ) + 1");
+    auto exact = Loop("i", "0", "( 1 << 52 ) + 1");
+    LoopBoundsAnalysis().Run(*MakeProgram({large, rounded, exact}));
+
+    EXPECT_EQ("1000000000000000001", large->end->statement);
+    EXPECT_FALSE(large->trip_count.has_value());
+    EXPECT_EQ("( 1 << 53 ) + 1", rounded->end->statement);
+    EXPECT_EQ("4503599627370497", exact->end->statement);
+    EXPECT_EQ(4503599627370497u, exact->trip_count);
+}
+
+TEST(LoopBoundsTests, DescendingLoops) {
+    auto loop = WithStep(Loop("i", "10", "0"), "-3");
+    LoopBoundsAnalysis().Run(*MakeProgram({loop}));
+
+    EXPECT_EQ(-1, loop->step_sign);
+    EXPECT_EQ(4u, loop->trip_count); // 10, 7, 4, 1
+
+    auto empty = WithStep(Loop("i", "0", "10"), "-1");
+    LoopBoundsAnalysis().Run(*MakeProgram({empty}));
+    EXPECT_EQ(0u, empty->trip_count);
+}
+
+TEST(LoopBoundsTests, UnknownStepHasNoDirection) {
+    auto loop = WithStep(Loop("i", "0", "n"), "k");
+    LoopBoundsAnalysis().Run(*MakeProgram({loop}));
+
+    EXPECT_EQ(0, loop->step_sign);
+    EXPECT_TRUE(loop->bounds_invariant);
+}
+
+TEST(LoopBoundsTests, BoundsAssignedInTheBodyAreNotInvariant) {
+    auto assigned = Loop("i", "0", "n", {Statement("n - = 1")});
+    auto nested = Loop("i", "0", "n", {Loop("i", "0", "3", {Declare("n", "5")})});
+    auto index = Loop("i", "1", "i * 2");
+    auto unrelated = Loop("i", "0", "n", {Statement("m + = n")});
+    LoopBoundsAnalysis().Run(*MakeProgram({assigned, nested, index, unrelated}));
+
+    EXPECT_FALSE(assigned->bounds_invariant);
+    EXPECT_FALSE(nested->bounds_invariant);
+    EXPECT_FALSE(index->bounds_invariant);
+    EXPECT_TRUE(unrelated->bounds_invariant);
+}
+
+TEST(LoopBoundsTests, CallsInBoundsNeedUntouchedVariables) {
+    auto untouched = Loop("i", "0", "v . size ( )", {Statement("total + = w [ i ]")});
+    auto touched = Loop("i", "0", "v . size ( )", {Statement("v . push_back ( i )")});
+    LoopBoundsAnalysis().Run(*MakeProgram({untouched, touched}));
+
+    EXPECT_TRUE(untouched->bounds_invariant);
+    EXPECT_FALSE(touched->bounds_invariant);
+}
+
+TEST(LoopBoundsTests, CallsInTheBodyMayChangeBounds) {
+    auto unknown = Loop("i", "0", "n", {Statement("shrink ( )")});
+    auto library = Loop("i", "0", "n", {Statement("best = max ( best , a [ i ] )")});
+    auto member = Loop("i", "0", "n", {Statement("n . update ( i )")});
+    LoopBoundsAnalysis().Run(*MakeProgram({unknown, library, member}));
+
+    EXPECT_FALSE(unknown->bounds_invariant);
+    EXPECT_TRUE(library->bounds_invariant);
+    EXPECT_FALSE(member->bounds_invariant);
+}
+
+TEST(LoopBoundsTests, FoldingRehashesTheTree) {
+    auto loop = Loop("i", "0", "10 * 10");
+    auto program = MakeProgram({loop});
+    HashTree(*program);
+    uint64_t before = program->hash;
+
+    LoopBoundsAnalysis().Run(*program);
+    uint64_t after = program->hash;
+
+    EXPECT_EQ("100", loop->end->statement);
+    EXPECT_NE(before, after);
+    EXPECT_EQ(after, HashTree(*program));
+}
@@ -0,0 +1,211 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the memoization analysis
+ */
+
+#include "gtest/gtest.h"
+
+#include "analyzers/memoize.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    std::shared_ptr<FunctionDeclaration> Function(const std::string &name, std::vector<std::pair<Atom, Atom>> arguments,
+                                                  std::vector<std::shared_ptr<Node>> body,
+                                                  const std::string &type = "long long") {
+        auto function = std::make_shared<FunctionDeclaration>();
+        function->type = Statement(type);
+        function->name = Statement(name);
+        function->arguments = std::move(arguments);
+        function->block = std::make_shared<Block>();
+        function->block->body = std::move(body);
+        return function;
+    }
+
+}
+
+TEST(MemoizeTests, SuggestsForPureOverlappingRecursion) {
+    auto fib = Function("fib", {{"n", "int"}}, {Statement("if n < 2 : return n"),
+                                                 Statement("return fib ( n - 1 ) + fib ( n - 2 )")});
+    auto ways = Function("ways", {{"r", "int"}, {"c", "int"}},
+                         {Statement("return ways ( r - 1 , c ) + ways ( r , c - 1 )")});
+
+    Diagnostics diagnostics;
+    MemoizeAnalysis analysis(diagnostics);
+    analysis.Run(*MakeProgram({fib, ways}));
+
+    ASSERT_EQ(2u, analysis.Reports().size());
+    EXPECT_TRUE(analysis.Reports()[0].pure);
+    EXPECT_TRUE(analysis.Reports()[0].overlapping);
+    EXPECT_TRUE(analysis.Reports()[1].overlapping);
+    EXPECT_FALSE(fib->is_memoize);
+    ASSERT_EQ(2u, diagnostics.Count(Severity::WARNING));
+    EXPECT_EQ("`fib` recomputes overlapping subproblems through fib ( n - 1 ) and fib ( n - 2 ), it is pure, "
+              "add @memoize", diagnostics.All()[0].message);
+}
+
+TEST(MemoizeTests, AppliesUnderTheFlag) {
+    auto fib = Function("fib", {{"n", "int"}}, {Statement("return fib ( n - 1 ) + fib ( n - 2 )")});
+
+    Diagnostics diagnostics;
+    MemoizeAnalysis(diagnostics, MemoizeMode::APPLY).Run(*MakeProgram({fib}));
+
+    EXPECT_TRUE(fib->is_memoize);
+    EXPECT_EQ(0u, diagnostics.Count(Severity::WARNING));
+    EXPECT_EQ(1u, diagnostics.Count(Severity::NOTE));
+}
+
+TEST(MemoizeTests, NonOverlappingRecursionIsLeftAlone) {
+    auto factorial = Function("fact", {{"n", "int"}}, {Statement("return n * fact ( n - 1 )")});
+    auto sort = Function("sort", {{"l", "int"}, {"r", "int"}},
+                         {Statement("sort ( l , ( l + r ) / 2 )"), Statement("sort ( ( l + r ) / 2 + 1 , r )")});
+
+    Diagnostics diagnostics;
+    MemoizeAnalysis analysis(diagnostics);
+    analysis.Run(*MakeProgram({factorial, sort}));
+
+    ASSERT_EQ(2u, analysis.Reports().size());
+    EXPECT_FALSE(analysis.Reports()[0].overlapping);
+    EXPECT_FALSE(analysis.Reports()[1].overlapping);
+    EXPECT_TRUE(diagnostics.Empty());
+}
+
+TEST(MemoizeTests, DecreasingRecursion) {
+    auto ways = Function("ways", {{"r", "int"}, {"c", "int"}},
+                         {Statement("return ways ( r - 1 , c ) + ways ( r , c - 2 )")});
+    auto climb = Function("climb", {{"n", "int"}}, {Statement("return climb ( n + 1 ) + climb ( n - 1 )")});
+    auto same = Function("same", {{"a", "int"}, {"b", "int"}}, {Statement("return same ( a , b ) + same ( a - 1 , b )")});
+    auto reassigned = Function("down", {{"n", "int"}}, {Statement("n = n * 2"),
+                                                        Statement("return down ( n - 1 ) + down ( n - 2 )")});
+    auto halving = Function("half", {{"n", "int"}}, {Statement("return half ( n / 2 ) + half ( n - 1 )")});
+
+    Diagnostics diagnostics;
+    MemoizeAnalysis analysis(diagnostics);
+    analysis.Run(*MakeProgram({ways, climb, same, reassigned, halving}));
+
+    ASSERT_EQ(5u, analysis.Reports().size());
+    EXPECT_TRUE(analysis.Reports()[0].decreasing);
+    EXPECT_FALSE(analysis.Reports()[1].decreasing);
+    EXPECT_FALSE(analysis.Reports()[2].decreasing);
+    EXPECT_FALSE(analysis.Reports()[3].decreasing);
+    EXPECT_FALSE(analysis.Reports()[4].decreasing);
+}
+
+TEST(MemoizeTests, LoopDependentCallsOverlap) {
+    auto loop = std::make_shared<ForLoop>();
+    loop->identifier = Statement("c");
+    loop->start = Statement("1");
+    loop->end = Statement("n + 1");
+    loop->block = std::make_shared<Block>();
+    loop->block->body = {Statement("best = max ( best , price [ c ] + cut ( n - c ) )")};
+    auto cut = Function("cut", {{"n", "int"}}, {loop});
+
+    Diagnostics diagnostics;
+    MemoizeAnalysis analysis(diagnostics);
+    analysis.Run(*MakeProgram({cut}));
+
+    ASSERT_EQ(1u, analysis.Reports().size());
+    EXPECT_TRUE(analysis.Reports()[0].overlapping);
+}
+
+TEST(MemoizeTests, ImpureFunctionsAreNotMemoized) {
+    auto counter = std::make_shared<VariableDeclaration>();
+    counter->identifier = Statement("calls");
+    counter->data_type = "int";
+
+    auto writes = Function("f", {{"n", "int"}}, {Statement("calls + = 1"), Statement("return f ( n - 1 ) + f ( n - 2 )")});
+    auto log = Function("trace", {{"n", "int"}}, {Statement("cout << n")}, "void");
+    auto calls = Function("g", {{"n", "int"}}, {Statement("trace ( n )"), Statement("return g ( n - 1 ) + g ( n - 2 )")});
+    auto reference = Function("h", {{"v", "vector<int>&"}, {"n", "int"}},
+                              {Statement("return h ( v , n - 1 ) + h ( v , n - 2 )")});
+    auto shadowed = Function("s", {{"n", "int"}}, {Statement("return s ( n - 1 ) + s ( n - 2 )")});
+    auto local = std::make_shared<VariableDeclaration>();
+    local->identifier = Statement("calls");
+    local->data_type = "int";
+    shadowed->block->body.insert(shadowed->block->body.begin(), local);
+    shadowed->block->body.insert(shadowed->block->body.begin() + 1, Statement("calls + = 1"));
+
+    Diagnostics diagnostics;
+    MemoizeAnalysis analysis(diagnostics, MemoizeMode::APPLY);
+    analysis.Run(*MakeProgram({counter, writes, log, calls, reference, shadowed}));
+
+    const auto &reports = analysis.Reports();
+    ASSERT_EQ(4u, reports.size());
+    EXPECT_EQ("it writes global `calls`", reports[0].reason);
+    EXPECT_EQ("it calls `trace`, where it does input or output", reports[1].reason);
+    EXPECT_EQ("argument `v` is not passed by value", reports[2].reason);
+    EXPECT_TRUE(reports[3].pure);
+
+    EXPECT_FALSE(writes->is_memoize);
+    EXPECT_TRUE(shadowed->is_memoize);
+    EXPECT_EQ(3u, diagnostics.Count(Severity::WARNING));
+}
+
+TEST(MemoizeTests, WarnsWhenMemoizedFunctionIsImpure) {
+    auto f = Function("f", {{"n", "int"}}, {Statement("cout << n"), Statement("return f ( n - 1 )")});
+    f->is_memoize = true;
+
+    Diagnostics diagnostics;
+    MemoizeAnalysis(diagnostics).Run(*MakeProgram({f}));
+
+    ASSERT_EQ(1u, diagnostics.Count(Severity::WARNING));
+    EXPECT_NE(std::string::npos, diagnostics.All()[0].message.find("cached results can be wrong"));
+}
+
+TEST(MemoizeTests, GlobalsChangedAfterInitializationAreImpure) {
+    auto declare = [](const std::string &name, const std::string &initializer) {
+        auto declaration = std::make_shared<VariableDeclaration>();
+        declaration->identifier = Statement(name);
+        declaration->initializer = Statement(initializer);
+        return declaration;
+    };
+    auto reads_constant = Function("f", {{"n", "int"}}, {Statement("return ( f ( n - 1 ) + f ( n - 2 ) ) % mod")});
+    auto reads_changed = Function("g", {{"n", "int"}}, {Statement("return g ( n - 1 ) + g ( n - 2 ) + k")});
+    auto random = Function("r", {{"n", "int"}}, {Statement("return r ( n - 1 ) + r ( n - 2 ) + rand ( )")});
+
+    Diagnostics diagnostics;
+    MemoizeAnalysis analysis(diagnostics, MemoizeMode::APPLY);
+    analysis.Run(*MakeProgram({declare("mod", "7"), declare("k", "1"), reads_constant, reads_changed, random,
+                               Statement("answer = g ( 10 )"), Statement("k = 2")}));
+
+    const auto &reports = analysis.Reports();
+    ASSERT_EQ(3u, reports.size());
+    EXPECT_TRUE(reports[0].pure);
+    EXPECT_EQ("it reads global `k`, which changes after its initialization", reports[1].reason);
+    EXPECT_EQ("it calls `rand`, which is not known to be pure", reports[2].reason);
+
+    EXPECT_TRUE(reads_constant->is_memoize);
+    EXPECT_FALSE(reads_changed->is_memoize);
+    EXPECT_FALSE(random->is_memoize);
+}
+
+TEST(MemoizeTests, SplitCompoundAssignmentsAreWrites) {
+    auto global = [](const std::string &name) {
+        auto declaration = std::make_shared<VariableDeclaration>();
+        declaration->identifier = Statement(name);
+        declaration->data_type = "int";
+        return declaration;
+    };
+    auto shifts = Function("f", {{"n", "int"}},
+                           {Statement("seen < < = 1"), Statement("return f ( n - 1 ) + f ( n - 2 )")});
+    auto masks = Function("g", {{"n", "int"}},
+                          {Statement("mask | = n"), Statement("return g ( n - 1 ) + g ( n - 2 )")});
+    auto reads = Function("h", {{"n", "int"}}, {Statement("return h ( n - 1 ) + h ( n - 2 ) + k")});
+
+    Diagnostics diagnostics;
+    MemoizeAnalysis analysis(diagnostics, MemoizeMode::APPLY);
+    analysis.Run(*MakeProgram({global("seen"), global("mask"), global("k"), shifts, masks, reads,
+                               Statement("answer = h ( 10 )"), Statement("k > > = 1")}));
+
+    const auto &reports = analysis.Reports();
+    ASSERT_EQ(3u, reports.size());
+    EXPECT_EQ("it writes global `seen`", reports[0].reason);
+    EXPECT_EQ("it writes global `mask`", reports[1].reason);
+    EXPECT_EQ("it reads global `k`, which changes after its initialization", reports[2].reason);
+}
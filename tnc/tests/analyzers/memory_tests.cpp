@@ -0,0 +1,199 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the memory footprint estimate
+ */
+
+#include "gtest/gtest.h"
+
+#include "analyzers/memory.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    std::shared_ptr<VariableDeclaration> Declare(const std::string &name, const std::string &type,
+                                                 std::shared_ptr<Node> initializer, size_t line = 0) {
+        auto declaration = std::make_shared<VariableDeclaration>();
+        declaration->identifier = Statement(name);
+        declaration->data_type = type;
+        declaration->initializer = std::move(initializer);
+        declaration->line = line;
+        return declaration;
+    }
+
+    std::shared_ptr<FunctionDeclaration> Function(const std::string &name, std::vector<std::shared_ptr<Node>> body) {
+        auto function = std::make_shared<FunctionDeclaration>();
+        function->type = Statement("void");
+        function->name = Statement(name);
+        function->arguments = {{"n", "int"}};
+        function->block = MakeBlock(std::move(body));
+        return function;
+    }
+
+    Constraints Parse(const std::string &text) {
+        Constraints constraints;
+        ParseConstraints(text, constraints);
+        return constraints;
+    }
+
+}
+
+TEST(MemoryTests, TypeSizes) {
+    EXPECT_EQ(4, InlineSize(ParseType("int")));
+    EXPECT_EQ(8, InlineSize(ParseType("const long long")));
+    EXPECT_EQ(16, InlineSize(ParseType("pair<int, long long>")));
+    EXPECT_EQ(24, InlineSize(ParseType("std::vector<std::vector<int>>")));
+    EXPECT_EQ(400, InlineSize(ParseType("array<int, 100>")));
+
+    EXPECT_EQ(4, ElementSize(ParseType("vector<int>")));
+    EXPECT_EQ(24, ElementSize(ParseType("vector < vector < int > >")));
+    EXPECT_EQ(48, ElementSize(ParseType("map<int, long long>")));
+    EXPECT_EQ(0, ElementSize(ParseType("double")));
+}
+
+TEST(MemoryTests, ConstructorSizes) {
+    auto grid = Declare("dp", "vector<vector<long long>>", Statement("vector < vector < long long > > ( n + 1 , "
+                                                                     "vector < long long > ( m ) )"), 3);
+    auto inferred = Declare("seen", "auto", Statement("vector < bool > ( 1 << 20 )"));
+    auto literal = Declare("small", "vector<int>", Statement("{ 1 , 2 , 3 }"));
+    auto scalar = Declare("x", "int", Statement("n * 2"));
+
+    Diagnostics diagnostics;
+    MemoryAnalysis analysis(diagnostics, Parse("n, m <= 5000"));
+    analysis.Run(*MakeProgram({grid, inferred, literal, scalar}));
+
+    const auto &allocations = analysis.Allocations();
+    ASSERT_EQ(3u, allocations.size());
+    EXPECT_EQ(Atom("dp"), allocations[0].name);
+    EXPECT_EQ("O(m·n)", allocations[0].bytes.ToString());
+    EXPECT_DOUBLE_EQ(24 + 5001 * (24 + 5000 * 8), *allocations[0].estimate);
+    EXPECT_DOUBLE_EQ(24 + (1 << 20), *allocations[1].estimate);
+    EXPECT_DOUBLE_EQ(24 + 3 * 4, *allocations[2].estimate);
+    EXPECT_EQ(0u, diagnostics.Count(Severity::WARNING));
+}
+
+TEST(MemoryTests, LoopInsertionsAndComprehensions) {
+    auto edges = Declare("adj", "vector<pair<int, int>>", nullptr);
+    auto insert = Loop("i", "0", "m", {Statement("adj . push_back ( { u , v } )")});
+    auto comprehension = Declare("squares", "vector<int>", Loop("i", "0", "n"));
+
+    Diagnostics diagnostics;
+    MemoryAnalysis analysis(diagnostics, Parse("n <= 1000"));
+    analysis.Run(*MakeProgram({edges, insert, comprehension}));
+
+    const auto &allocations = analysis.Allocations();
+    ASSERT_EQ(2u, allocations.size());
+    EXPECT_EQ("O(m)", allocations[0].bytes.ToString());
+    EXPECT_FALSE(allocations[0].estimate.has_value());
+    EXPECT_DOUBLE_EQ(24 + 1000 * 4, *allocations[1].estimate);
+    EXPECT_FALSE(analysis.Peak().has_value());
+    EXPECT_NE(std::string::npos, diagnostics.All().front().message.find("constrain `m`"));
+}
+
+TEST(MemoryTests, MemoTablesAndTheLimit) {
+    auto function = std::make_shared<FunctionDeclaration>();
+    function->is_memoize = true;
+    function->type = Statement("long long");
+    function->name = Statement("ways");
+    function->arguments = {{"i", "int"}, {"j", "int"}};
+    function->block = MakeBlock({Declare("local", "vector<int>", Statement("vector < int > ( j )"))});
+    function->line = 7;
+
+    Diagnostics diagnostics;
+    MemoryAnalysis analysis(diagnostics, Parse("i, j <= 3000"));
+    analysis.Run(*MakeProgram({function}));
+
+    const auto &allocations = analysis.Allocations();
+    ASSERT_EQ(2u, allocations.size());
+    EXPECT_EQ("O(i·j)", allocations[0].bytes.ToString());
+    EXPECT_DOUBLE_EQ(1024 * 24 + 3000.0 * 3000 * 4 * 24, *allocations[0].estimate); // hashed, i and j may be negative
+
+    ASSERT_EQ(2u, analysis.Scopes().size());
+    EXPECT_EQ("ways", analysis.Scopes()[1].name);
+    EXPECT_DOUBLE_EQ(*allocations[0].estimate + *allocations[1].estimate, *analysis.Peak());
+
+    ASSERT_EQ(1u, diagnostics.Count(Severity::WARNING)); // 864 MB
+    EXPECT_EQ(7u, diagnostics.All().back().line);
+}
+
+TEST(MemoryTests, DenseMemoTables) {
+    auto function = std::make_shared<FunctionDeclaration>();
+    function->is_memoize = true;
+    function->type = Statement("long long");
+    function->name = Statement("ways");
+    function->arguments = {{"i", "int"}, {"j", "int"}};
+    function->block = MakeBlock({});
+
+    Diagnostics diagnostics;
+    MemoryAnalysis analysis(diagnostics, {{"i", Interval(0, 2999)}, {"j", Interval(1, 1000)}});
+    analysis.Run(*MakeProgram({function}));
+
+    // a long long value and a 32-bit epoch per cell, as in runtime/memo.h
+    ASSERT_EQ(1u, analysis.Allocations().size());
+    EXPECT_DOUBLE_EQ(3000.0 * 1000 * 16, *analysis.Allocations()[0].estimate);
+    EXPECT_EQ(0u, diagnostics.Count(Severity::WARNING));
+}
+
+TEST(MemoryTests, BoundedPartAgainstTheLimit) {
+    auto edges = Declare("adj", "vector<pair<int, int>>", nullptr);
+    auto insert = Loop("i", "0", "m", {Statement("adj . push_back ( { u , v } )")});
+    auto large = Declare("a", "vector<long long>", Statement("vector < long long > ( n )"), 4);
+
+    Diagnostics diagnostics;
+    MemoryAnalysis analysis(diagnostics, Parse("n <= 5e7"));
+    analysis.Run(*MakeProgram({edges, insert, large}));
+
+    EXPECT_FALSE(analysis.Peak().has_value());
+    EXPECT_DOUBLE_EQ(24 + 5e7 * 8, analysis.BoundedPeak()); // `adj` is left out
+    ASSERT_EQ(1u, diagnostics.Count(Severity::WARNING));
+    EXPECT_EQ(4u, diagnostics.All().back().line);
+    EXPECT_NE(std::string::npos, diagnostics.All().back().message.find("the rest could not be bounded"));
+}
+
+TEST(MemoryTests, LocalsAlongTheDeepestCallChain) {
+    auto inner = Function("inner", {Declare("b", "vector<int>", Statement("vector < int > ( n )"))});
+    auto outer = Function("outer", {Declare("a", "vector<int>", Statement("vector < int > ( n )")),
+                                    Statement("inner ( n )")});
+    auto shallow = Function("shallow", {Declare("c", "vector<int>", Statement("vector < int > ( 10 )"))});
+
+    Diagnostics diagnostics;
+    MemoryAnalysis analysis(diagnostics, Parse("n <= 1000"));
+    analysis.Run(*MakeProgram({inner, outer, shallow, Statement("outer ( n )")}));
+
+    EXPECT_DOUBLE_EQ(2 * (24 + 1000 * 4), *analysis.Peak());
+}
+
+TEST(MemoryTests, LocalsPerLevelOfRecursion) {
+    auto linear = Function("solve", {Declare("a", "vector<int>", Statement("vector < int > ( 100 )")),
+                                     Statement("solve ( n - 1 )")});
+    auto halving = Function("split", {Declare("b", "vector<int>", Statement("vector < int > ( 100 )")),
+                                      Statement("split ( n / 2 )")});
+
+    Diagnostics diagnostics;
+    MemoryAnalysis analysis(diagnostics, Parse("n <= 1000"));
+    analysis.Run(*MakeProgram({linear}));
+    EXPECT_DOUBLE_EQ(1000 * (24 + 100 * 4), *analysis.Peak());
+
+    MemoryAnalysis logarithmic(diagnostics, Parse("n <= 1024"));
+    logarithmic.Run(*MakeProgram({halving}));
+    ASSERT_TRUE(logarithmic.Peak().has_value());
+    EXPECT_LT(*logarithmic.Peak(), 20 * (24 + 100 * 4));
+    EXPECT_GE(*logarithmic.Peak(), 10 * (24 + 100 * 4));
+}
+
+TEST(MemoryTests, MutualRecursionHasNoKnownDepth) {
+    auto even = Function("even", {Declare("a", "vector<int>", Statement("vector < int > ( 100 )")),
+                                  Statement("odd ( n - 1 )")});
+    auto odd = Function("odd", {Statement("even ( n - 1 )")});
+
+    Diagnostics diagnostics;
+    MemoryAnalysis analysis(diagnostics, Parse("n <= 1000"));
+    analysis.Run(*MakeProgram({even, odd}));
+
+    EXPECT_FALSE(analysis.Peak().has_value());
+}
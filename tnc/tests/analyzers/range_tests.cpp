@@ -0,0 +1,290 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the value range analysis
+ */
+
+#include "gtest/gtest.h"
+
+#include "analyzers/range.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    std::shared_ptr<VariableDeclaration> Declare(const std::string &name, const std::string &initializer,
+                                                 size_t line = 0, Atom type = AUTO_ATOM) {
+        auto declaration = std::make_shared<VariableDeclaration>();
+        declaration->identifier = Statement(name, line);
+        declaration->data_type = type;
+        if (!initializer.empty())
+            declaration->initializer = Statement(initializer, line);
+        declaration->line = line;
+        return declaration;
+    }
+
+    std::shared_ptr<InputOutput> Read(const std::string &name) {
+        auto io = std::make_shared<InputOutput>();
+        io->type = InOut::IN;
+        io->operands.push_back(Statement(name));
+        return io;
+    }
+
+}
+
+TEST(RangeTests, LoopIndexAndCounterBoundedByIntInput) {
+    auto cnt = Declare("cnt", "0", 3);
+    auto loop = Loop("i", "0", "n", {Statement("cnt + = 1")}, 4);
+    auto program = MakeProgram({Declare("n", "", 1, "int"), Read("n"), cnt, loop});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    EXPECT_EQ("int", loop->id_type);
+    EXPECT_EQ("int", cnt->data_type);
+    EXPECT_EQ(Interval::Of(0, 2147483647), analysis.RangeOf("cnt"));
+    EXPECT_EQ(2, analysis.Decisions().size());
+    EXPECT_EQ(2, diagnostics.Count(Severity::NOTE));
+}
+
+TEST(RangeTests, UnboundedInputKeepsLongLong) {
+    auto n = Declare("n", "0");
+    auto loop = Loop("i", "0", "n", {});
+    auto program = MakeProgram({n, Read("n"), loop});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    EXPECT_EQ("long long", n->data_type);
+    EXPECT_EQ("long long", loop->id_type);
+    EXPECT_NE(std::string::npos, diagnostics.All()[0].message.find("could not be bounded"));
+}
+
+TEST(RangeTests, AssumptionsNarrowInputs) {
+    auto n = Declare("n", "0");
+    auto loop = Loop("i", "0", "n", {});
+    auto program = MakeProgram({n, Read("n"), loop});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Assume("n", Interval::Of(1, 2e5));
+    analysis.Run(*program);
+
+    EXPECT_EQ("int", n->data_type);
+    EXPECT_EQ("int", loop->id_type);
+    EXPECT_EQ(Interval::Of(1, 200000), analysis.RangeOf("n"));
+}
+
+TEST(RangeTests, NestedCounterNeedsLongLong) {
+    auto pairs = Declare("pairs", "0");
+    auto inner = Loop("j", "0", "n", {Statement("pairs ++")});
+    auto outer = Loop("i", "0", "n", {inner});
+    auto program = MakeProgram({Declare("n", "", 0, "int"), Read("n"), pairs, outer});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Assume("n", Interval::Of(1, 2e5));
+    analysis.Run(*program);
+
+    EXPECT_EQ("int", outer->id_type);
+    EXPECT_EQ("int", inner->id_type);
+    EXPECT_EQ("long long", pairs->data_type);
+    EXPECT_EQ(Interval::Of(0, 4e10), analysis.RangeOf("pairs"));
+}
+
+TEST(RangeTests, OperandsOfOverflowingArithmeticStayWide) {
+    auto a = Declare("a", "100000", 1);
+    auto b = Declare("b", "a * a", 2);
+    auto program = MakeProgram({a, b});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    EXPECT_EQ("long long", a->data_type);
+    EXPECT_EQ("long long", b->data_type);
+
+    const Diagnostic &note = diagnostics.All()[0];
+    EXPECT_EQ(1, note.line);
+    EXPECT_EQ("range", note.pass);
+    EXPECT_EQ("`a` is long long, `a * a` on line 2 can exceed 32 bits", note.message);
+}
+
+TEST(RangeTests, GrowingAssignmentsAreWidened) {
+    auto x = Declare("x", "1");
+    auto loop = std::make_shared<WhileLoop>();
+    loop->condition = Statement("x < limit");
+    loop->block = std::make_shared<Block>();
+    loop->block->body.push_back(Statement("x = x * 2"));
+    auto program = MakeProgram({x, loop});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    EXPECT_EQ("long long", x->data_type);
+    EXPECT_FALSE(analysis.RangeOf("x").IsBounded());
+}
+
+TEST(RangeTests, FlagsAreNarrowed) {
+    auto found = Declare("found", "0");
+    auto loop = Loop("i", "0", "10", {Statement("found = 1")});
+    auto program = MakeProgram({found, loop});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    EXPECT_EQ("int", found->data_type);
+    EXPECT_EQ(Interval::Of(0, 1), analysis.RangeOf("found"));
+}
+
+TEST(RangeTests, LeavesOtherDeclarationsAlone) {
+    auto text = Declare("text", "\"abc\"");
+    auto flag = Declare("ok", "false");
+    auto size = Declare("size", "v . size ( )");
+    auto wide = Declare("wide", "5", 0, "long long");
+    auto program = MakeProgram({text, flag, size, wide});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    EXPECT_EQ(AUTO_ATOM, text->data_type);
+    EXPECT_EQ(AUTO_ATOM, flag->data_type);
+    EXPECT_EQ(AUTO_ATOM, size->data_type);
+    EXPECT_EQ("long long", wide->data_type);
+    EXPECT_TRUE(analysis.Decisions().empty());
+    EXPECT_TRUE(diagnostics.Empty());
+}
+
+TEST(RangeTests, RangedLoopVariablesAreUnknown) {
+    auto x = Declare("x", "3");
+    auto total = Declare("total", "0");
+    auto loop = std::make_shared<RangedLoop>();
+    loop->identifier = Statement("x");
+    loop->object = Statement("values");
+    loop->block = std::make_shared<Block>();
+    loop->block->body.push_back(Statement("total + = x * x"));
+    auto program = MakeProgram({x, total, loop});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    // x may hold any element of values, so nothing is known about it or the sum
+    EXPECT_EQ(AUTO_ATOM, x->data_type);
+    EXPECT_EQ(AUTO_ATOM, total->data_type);
+}
+
+TEST(RangeTests, IncrementsWithoutATripCountAreUnbounded) {
+    auto forever = std::make_shared<WhileLoop>();
+    forever->condition = Statement("true");
+    forever->block = std::make_shared<Block>();
+    forever->block->body.push_back(Statement("total + = 1000000"));
+
+    auto ranged = std::make_shared<RangedLoop>();
+    ranged->identifier = Statement("x");
+    ranged->object = Statement("values");
+    ranged->block = std::make_shared<Block>();
+    ranged->block->body.push_back(Statement("seen + = 1000000"));
+
+    auto recursive = std::make_shared<FunctionDeclaration>();
+    recursive->type = Statement("void");
+    recursive->name = Statement("visit");
+    recursive->arguments = {{"v", "int"}};
+    recursive->block = std::make_shared<Block>();
+    recursive->block->body = {Statement("calls + = 1000000"), Statement("visit ( v + 1 )")};
+
+    auto total = Declare("total", "0"), seen = Declare("seen", "0"), calls = Declare("calls", "0");
+    auto program = MakeProgram({total, seen, calls, forever, ranged, recursive});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    EXPECT_EQ("long long", total->data_type);
+    EXPECT_EQ("long long", seen->data_type);
+    EXPECT_EQ("long long", calls->data_type);
+}
+
+TEST(RangeTests, RangedLoopOverBoundedObject) {
+    auto seen = Declare("seen", "0");
+    auto ranged = std::make_shared<RangedLoop>();
+    ranged->identifier = Statement("x");
+    ranged->object = Statement("values");
+    ranged->block = std::make_shared<Block>();
+    ranged->block->body.push_back(Statement("seen + = 1000"));
+    auto program = MakeProgram({seen, ranged});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Assume("values", Interval::Of(0, 1e5));
+    analysis.Run(*program);
+
+    EXPECT_EQ("int", seen->data_type);
+    EXPECT_EQ(Interval::Of(0, 1e8), analysis.RangeOf("seen"));
+}
+
+TEST(RangeTests, EmbeddedStepsAreIncrements) {
+    auto c = Declare("c", "0"), d = Declare("d", "5");
+    auto loop = Loop("i", "0", "3e9", {Statement("a [ c ++ ] = i"), Statement("x = -- d + 1")});
+    auto program = MakeProgram({c, d, loop});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    EXPECT_EQ("long long", c->data_type);
+    EXPECT_EQ(Interval::Of(0, 3e9), analysis.RangeOf("c"));
+    EXPECT_EQ("long long", d->data_type);
+}
+
+TEST(RangeTests, EveryWriteIsADefinition) {
+    auto shifted = Declare("shifted", "1"), masked = Declare("masked", "3");
+    auto swapped = Declare("swapped", "0"), scanned = Declare("scanned", "0");
+    auto program = MakeProgram({shifted, masked, swapped, scanned, Statement("shifted < < = 40"),
+                                Statement("masked | = 4"), Statement("swap ( swapped , other )"),
+                                Statement("scanf ( \"%d\" , & scanned )")});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    EXPECT_EQ("long long", shifted->data_type);
+    EXPECT_FALSE(analysis.RangeOf("shifted").IsBounded());
+    EXPECT_EQ("int", masked->data_type);
+    EXPECT_FALSE(analysis.RangeOf("swapped").IsBounded());
+    EXPECT_EQ("long long", swapped->data_type);
+    EXPECT_FALSE(analysis.RangeOf("scanned").IsBounded());
+}
+
+TEST(RangeTests, SumsEscapingAnAssumedRange) {
+    auto x = Declare("x", "0");
+    auto program = MakeProgram({x, Statement("x + = 1000000000")});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Assume("x", Interval::Of(0, 2e9));
+    analysis.Run(*program);
+
+    EXPECT_EQ("long long", x->data_type);
+}
+
+TEST(RangeTests, PrintsDiagnostics) {
+    auto program = MakeProgram({Loop("i", "0", "1 << 20", {}, 7)});
+
+    Diagnostics diagnostics;
+    RangeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+
+    std::ostringstream out;
+    diagnostics.Print(out);
+    EXPECT_EQ("line 7: note [range]: loop index `i` is int, its values stay within [0, 1048576]\n", out.str());
+}
@@ -0,0 +1,82 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the read-mostly concurrent symbol table
+ */
+
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "core/concurrent_symbol_table.h"
+#include "errors/errors.h"
+
+using namespace tonic;
+
+TEST(ConcurrentSymbolTableTests, InsertsBecomeVisibleOnPublish) {
+    ConcurrentSymbolTable table;
+    table.Insert("solve", "void");
+    table.Insert("MOD", "const int");
+
+    EXPECT_FALSE(table.SymbolExists("solve"));
+    EXPECT_THROW(table.LookupSymbol("solve"), InternalError);
+
+    table.Publish();
+    EXPECT_EQ("void", table.LookupSymbol("solve").type);
+    EXPECT_EQ(2, table.Size());
+
+    table.Insert("MOD", "const long long");
+    table.Publish();
+    table.Reclaim();
+    EXPECT_EQ("const long long", table.LookupSymbol("MOD").type);
+    EXPECT_EQ(2, table.Size());
+}
+
+TEST(ConcurrentSymbolTableTests, EntriesAreOrderedByName) {
+    ConcurrentSymbolTable table;
+    for (const char *name: {"zeta", "alpha", "mid", "beta"})
+        table.Insert(name, "int");
+    table.Publish();
+
+    std::vector<std::string> names;
+    for (const auto &symbol: table.Entries())
+        names.push_back(symbol.name.Text());
+
+    EXPECT_EQ((std::vector<std::string>{"alpha", "beta", "mid", "zeta"}), names);
+}
+
+TEST(ConcurrentSymbolTableTests, ReadersRunDuringPublish) {
+    ConcurrentSymbolTable table;
+    table.Insert("n", "int");
+    table.Publish();
+
+    std::atomic<bool> done = false;
+    std::atomic<size_t> bad_reads = 0;
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < 4; i++) {
+        readers.emplace_back([&] {
+            while (!done) {
+                const SymbolInfo *symbol = table.Find("n");
+                if (!symbol || (symbol->type != "int" && symbol->type != "long long"))
+                    ++bad_reads;
+            }
+        });
+    }
+
+    for (size_t round = 0; round < 200; round++) {
+        table.Insert("n", round % 2 ? "int" : "long long");
+        table.Insert("g" + std::to_string(round), "int");
+        table.Publish();
+    }
+
+    done = true;
+    for (auto &reader: readers)
+        reader.join();
+    table.Reclaim();
+
+    EXPECT_EQ(0, bad_reads);
+    EXPECT_EQ(201, table.Size());
+}
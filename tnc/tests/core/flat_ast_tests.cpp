@@ -0,0 +1,114 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the flat AST representation
+ */
+
+#include "gtest/gtest.h"
+
+#include "core/flat_ast.h"
+#include "tests/test_helpers.h"
+#include "traversal/walker.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    // program: [ for i in 0..n: [ a, b ], c ]
+    std::shared_ptr<Program> SampleProgram() {
+        auto for_loop = std::make_shared<ForLoop>();
+        for_loop->identifier = Statement("i");
+        for_loop->start = Statement("0");
+        for_loop->end = Statement("n");
+        for_loop->block = std::make_shared<Block>();
+        for_loop->block->body.push_back(Statement("a"));
+        for_loop->block->body.push_back(Statement("b"));
+
+        auto program = std::make_shared<Program>();
+        program->body.push_back(for_loop);
+        program->body.push_back(Statement("c"));
+        return program;
+    }
+
+}
+
+TEST(FlatAstTests, PreOrderLayout) {
+    FlatAst flat(SampleProgram());
+
+    std::vector<NodeKind> expected = {
+            NodeKind::PROGRAM,
+            NodeKind::FOR_LOOP,
+            NodeKind::GENERAL_STATEMENT, // i
+            NodeKind::GENERAL_STATEMENT, // 0
+            NodeKind::GENERAL_STATEMENT, // n
+            NodeKind::BLOCK,
+            NodeKind::GENERAL_STATEMENT, // a
+            NodeKind::GENERAL_STATEMENT, // b
+            NodeKind::GENERAL_STATEMENT, // c
+    };
+
+    ASSERT_EQ(expected.size(), flat.Size());
+    for (uint32_t i = 0; i < flat.Size(); i++) {
+        EXPECT_EQ(expected[i], flat[i].kind) << "at index " << i;
+    }
+
+    EXPECT_EQ("c", std::dynamic_pointer_cast<GeneralStatement>(flat.Source(8))->statement);
+}
+
+TEST(FlatAstTests, LinksAndSubtreeSizes) {
+    FlatAst flat(SampleProgram());
+
+    EXPECT_EQ(FLAT_NONE, flat[0].parent);
+    EXPECT_EQ(9, flat[0].subtree_size);
+    EXPECT_EQ(1, flat[0].first_child);
+
+    EXPECT_EQ(7, flat[1].subtree_size);
+    EXPECT_EQ(8, flat[1].next_sibling);
+    EXPECT_EQ(0, flat[1].parent);
+
+    // empty step and operation slots are skipped
+    EXPECT_EQ(3, flat[2].next_sibling);
+    EXPECT_EQ(5, flat[4].next_sibling);
+    EXPECT_EQ(FLAT_NONE, flat[5].next_sibling);
+    EXPECT_EQ(1, flat[5].parent);
+
+    EXPECT_EQ(FLAT_NONE, flat[8].first_child);
+    EXPECT_EQ(FLAT_NONE, flat[8].next_sibling);
+}
+
+TEST(FlatAstTests, SkipSubtree) {
+    FlatAst flat(SampleProgram());
+
+    EXPECT_EQ(8, flat.SkipSubtree(1));
+    EXPECT_EQ(8, flat.SkipSubtree(5));
+    EXPECT_EQ(9, flat.SkipSubtree(0));
+}
+
+TEST(FlatAstTests, EmptyRoot) {
+    FlatAst flat(nullptr);
+    EXPECT_EQ(0, flat.Size());
+}
+
+TEST(FlatAstTests, WalkerVisitsInTreeOrder) {
+    auto program = SampleProgram();
+    std::vector<std::string> tree_order;
+    std::vector<std::string> flat_order;
+
+    Walker tree_walker;
+    tree_walker.Register<GeneralStatement>([&](std::shared_ptr<GeneralStatement> node) {
+        tree_order.push_back(node->statement);
+    });
+    tree_walker.Walk(program);
+
+    Walker flat_walker;
+    flat_walker.Register<GeneralStatement>([&](std::shared_ptr<GeneralStatement> node) {
+        flat_order.push_back(node->statement);
+    });
+    flat_walker.Walk(FlatAst(program));
+
+    EXPECT_EQ((std::vector<std::string>{"i", "0", "n", "a", "b", "c"}), flat_order);
+    EXPECT_EQ(tree_order, flat_order);
+}
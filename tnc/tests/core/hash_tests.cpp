@@ -0,0 +1,95 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the Merkle subtree hashes
+ */
+
+#include "gtest/gtest.h"
+
+#include "parser.h"
+#include "core/hash.h"
+#include "core/persistent.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    std::shared_ptr<Program> ParseSource(const std::string &source) {
+        Lexer lexer(source, "test.tn");
+        std::vector<Token> tokens = lexer.Tokenize();
+        Parser parser(tokens, "test.tn");
+        return parser.Parse();
+    }
+
+}
+
+TEST(HashTests, ParserHashesEveryNode) {
+    auto program = ParseSource("x = 5\n\ny = 6\n");
+
+    ASSERT_EQ(2, program->body.size());
+    EXPECT_NE(0, program->hash);
+    for (const auto &node: program->body) {
+        auto variable = std::dynamic_pointer_cast<VariableDeclaration>(node);
+        ASSERT_NE(nullptr, variable);
+        EXPECT_NE(0, variable->hash);
+        EXPECT_NE(0, variable->identifier->hash);
+    }
+}
+
+TEST(HashTests, EqualSourcesHaveEqualHashes) {
+    auto first = ParseSource("x = 5\n\ny = 6\n");
+    auto second = ParseSource("x = 5\n\ny = 7\n");
+
+    EXPECT_TRUE(StructurallyEqual(*first->body[0], *second->body[0]));
+    EXPECT_FALSE(StructurallyEqual(*first->body[1], *second->body[1]));
+    EXPECT_NE(first->hash, second->hash);
+}
+
+TEST(HashTests, HashCoversKindFieldsAndEmptySlots) {
+    auto block = std::make_shared<Block>();
+    auto program = std::make_shared<Program>();
+    EXPECT_NE(HashTree(*block), HashTree(*program));
+
+    auto memoized = std::make_shared<FunctionDeclaration>();
+    memoized->is_memoize = true;
+    EXPECT_NE(HashTree(*memoized), HashTree(*std::make_shared<FunctionDeclaration>()));
+
+    auto with_step = std::make_shared<ForLoop>();
+    with_step->end = Statement("n");
+    auto with_end = std::make_shared<ForLoop>();
+    with_end->step = Statement("n");
+    EXPECT_NE(HashTree(*with_step), HashTree(*with_end));
+}
+
+TEST(HashTests, UnhashedNodesAreNeverEqual) {
+    auto first = Statement("a");
+    auto second = Statement("a");
+    EXPECT_FALSE(StructurallyEqual(*first, *second));
+
+    HashTree(*first);
+    HashTree(*second);
+    EXPECT_TRUE(StructurallyEqual(*first, *second));
+}
+
+TEST(HashTests, PathCopyKeepsHashesUpToDate) {
+    auto program = ParseSource("x = 5\n\ny = 6\n");
+    auto expected = ParseSource("x = 5\n\ny = 7\n");
+
+    auto variable = std::make_shared<VariableDeclaration>(
+            *std::dynamic_pointer_cast<VariableDeclaration>(program->body[1]));
+    variable->initializer = Statement("7");
+    variable->hash = 0;
+
+    auto copy = PathCopy(program, {1}, variable);
+    EXPECT_EQ(expected->hash, copy->hash);
+    EXPECT_NE(program->hash, copy->hash);
+
+    auto modified = PathModify(copy, {1, 1}, [](Node &node) {
+        dynamic_cast<GeneralStatement &>(node).statement = "6";
+    });
+    EXPECT_EQ(program->hash, modified->hash);
+}
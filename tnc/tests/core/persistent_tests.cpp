@@ -0,0 +1,124 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the persistent AST and child slot access
+ */
+
+#include "gtest/gtest.h"
+
+#include "core/children.h"
+#include "core/persistent.h"
+#include "errors/errors.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    // program: [ for i in 0..n: [ a ], b ]
+    std::shared_ptr<Program> SampleProgram() {
+        auto for_loop = std::make_shared<ForLoop>();
+        for_loop->identifier = Statement("i");
+        for_loop->start = Statement("0");
+        for_loop->end = Statement("n");
+        for_loop->block = std::make_shared<Block>();
+        for_loop->block->body.push_back(Statement("a"));
+
+        auto program = std::make_shared<Program>();
+        program->body.push_back(for_loop);
+        program->body.push_back(Statement("b"));
+        return program;
+    }
+
+}
+
+TEST(PersistentTests, ChildSlotsIncludeEmptySlots) {
+    auto program = SampleProgram();
+    auto for_loop = program->body[0];
+
+    ASSERT_EQ(2, ChildCount(*program));
+    ASSERT_EQ(6, ChildCount(*for_loop));
+    EXPECT_EQ(nullptr, GetChild(*for_loop, 3)); // step
+    EXPECT_EQ("n", std::dynamic_pointer_cast<GeneralStatement>(GetChild(*for_loop, 2))->statement);
+    EXPECT_THROW(GetChild(*for_loop, 6), InternalError);
+}
+
+TEST(PersistentTests, SetChildChecksSlotType) {
+    auto for_loop = std::make_shared<ForLoop>();
+
+    EXPECT_THROW(SetChild(*for_loop, 5, Statement("not a block")), InternalError);
+    EXPECT_NO_THROW(SetChild(*for_loop, 5, std::make_shared<Block>()));
+    EXPECT_NE(nullptr, for_loop->block);
+}
+
+TEST(PersistentTests, ReplaceCopiesOnlyTheSpine) {
+    auto program = SampleProgram();
+    PersistentAst ast(program);
+
+    // program -> for loop -> block -> first statement
+    size_t version = ast.Replace({0, 5, 0}, Statement("c"));
+    ASSERT_EQ(1, version);
+
+    auto old_loop = std::dynamic_pointer_cast<ForLoop>(ast.Root(0)->body[0]);
+    auto new_loop = std::dynamic_pointer_cast<ForLoop>(ast.Root()->body[0]);
+
+    EXPECT_NE(ast.Root(0), ast.Root());
+    EXPECT_NE(old_loop, new_loop);
+    EXPECT_NE(old_loop->block, new_loop->block);
+
+    // untouched subtrees are shared
+    EXPECT_EQ(old_loop->identifier, new_loop->identifier);
+    EXPECT_EQ(old_loop->end, new_loop->end);
+    EXPECT_EQ(ast.Root(0)->body[1], ast.Root()->body[1]);
+
+    // the old version is unchanged
+    EXPECT_EQ("a", std::dynamic_pointer_cast<GeneralStatement>(old_loop->block->body[0])->statement);
+    EXPECT_EQ("c", std::dynamic_pointer_cast<GeneralStatement>(new_loop->block->body[0])->statement);
+}
+
+TEST(PersistentTests, ModifyEditsAPrivateCopy) {
+    auto function = std::make_shared<FunctionDeclaration>();
+    auto program = std::make_shared<Program>();
+    program->body.push_back(function);
+
+    PersistentAst ast(program);
+    ast.Modify({0}, [](Node &node) {
+        dynamic_cast<FunctionDeclaration &>(node).is_memoize = true;
+    });
+
+    EXPECT_FALSE(function->is_memoize);
+    EXPECT_TRUE(std::dynamic_pointer_cast<FunctionDeclaration>(ast.Root()->body[0])->is_memoize);
+}
+
+TEST(PersistentTests, Rollback) {
+    PersistentAst ast(SampleProgram());
+    auto original = ast.Root();
+
+    ast.Replace({1}, Statement("x"));
+    ast.Replace({1}, Statement("y"));
+    ASSERT_EQ(2, ast.Version());
+
+    ast.Rollback(0);
+    EXPECT_EQ(0, ast.Version());
+    EXPECT_EQ(original, ast.Root());
+    EXPECT_THROW(ast.Rollback(1), InternalError);
+}
+
+TEST(PersistentTests, FindPath) {
+    auto program = SampleProgram();
+    auto for_loop = std::dynamic_pointer_cast<ForLoop>(program->body[0]);
+    auto target = for_loop->block->body[0];
+
+    AstPath path;
+    ASSERT_TRUE(FindPath(program, target.get(), path));
+    EXPECT_EQ((AstPath{0, 5, 0}), path);
+
+    auto copy = PathCopy(program, path, Statement("z"));
+    EXPECT_EQ(program->body[1], std::dynamic_pointer_cast<Program>(copy)->body[1]);
+
+    AstPath missing;
+    EXPECT_FALSE(FindPath(program, Statement("other").get(), missing));
+}
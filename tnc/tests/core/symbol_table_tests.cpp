@@ -0,0 +1,127 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the interner and the scoped symbol table
+ */
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "core/hash.h"
+#include "core/symbol_table.h"
+#include "errors/errors.h"
+
+using namespace tonic;
+
+TEST(InternerTests, EqualStringsShareAnId) {
+    Interner interner;
+    uint32_t first = interner.Intern("n");
+    uint32_t type = interner.Intern("vector<long long>");
+
+    EXPECT_EQ(first, interner.Intern(std::string("n")));
+    EXPECT_NE(first, type);
+    EXPECT_EQ("vector<long long>", interner.Text(type));
+    EXPECT_EQ(type, interner.Find("vector<long long>"));
+    EXPECT_EQ(NO_ATOM, interner.Find("m"));
+    EXPECT_EQ(0, interner.Find(""));
+    EXPECT_EQ(3, interner.Size());
+    EXPECT_THROW(interner.Text(5), InternalError);
+}
+
+TEST(InternerTests, ConcurrentInterningAgreesOnIds) {
+    Interner interner;
+    std::vector<std::vector<uint32_t>> ids(4);
+
+    // thousands of names force several chunks to be allocated while other threads read
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < ids.size(); t++) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < 5000; i++) {
+                uint32_t id = interner.Intern("name" + std::to_string(i));
+                EXPECT_EQ("name" + std::to_string(i), interner.Text(id));
+                ids[t].push_back(id);
+            }
+        });
+    }
+    for (auto &thread: threads)
+        thread.join();
+
+    for (size_t t = 1; t < ids.size(); t++)
+        EXPECT_EQ(ids[0], ids[t]);
+    EXPECT_EQ(5001, interner.Size());
+}
+
+TEST(InternerTests, AtomsCompareByIdAndAgainstStrings) {
+    Atom first("vector<long long>");
+    Atom second(std::string("vector<long long>"));
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first.Id(), second.Id());
+    EXPECT_EQ(first, "vector<long long>");
+    EXPECT_NE(first, Atom("int"));
+    EXPECT_TRUE(Atom().Empty());
+    EXPECT_EQ(HashBytes("vector<long long>"), first.Hash());
+}
+
+TEST(SymbolTableTests, InnerScopesShadowAndRestore) {
+    SymbolTable table;
+
+    table.Insert("x", "int");
+    table.PushScope();
+    table.Insert("x", "string");
+    table.Insert("y", "bool");
+
+    EXPECT_EQ("string", table.LookupSymbol("x").type);
+    EXPECT_EQ(1, table.LookupSymbol("x").depth);
+    EXPECT_TRUE(table.SymbolExists("y"));
+
+    table.PopScope();
+
+    EXPECT_EQ("int", table.LookupSymbol("x").type);
+    EXPECT_EQ(0, table.LookupSymbol("x").depth);
+    EXPECT_FALSE(table.SymbolExists("y"));
+    EXPECT_EQ(0, table.Depth());
+    EXPECT_THROW(table.PopScope(), InternalError);
+}
+
+TEST(SymbolTableTests, RemovalUnshadowsAndIsUndoneByPopScope) {
+    SymbolTable table;
+
+    table.Insert("i", "int");
+    table.PushScope();
+    table.Insert("i", "long long");
+    table.PushScope();
+
+    table.RemoveSymbol("i");
+    EXPECT_EQ("int", table.LookupSymbol("i").type);
+    table.RemoveSymbol("i");
+    EXPECT_FALSE(table.SymbolExists("i"));
+    EXPECT_THROW(table.LookupSymbol("i"), InternalError);
+
+    table.PopScope();
+    EXPECT_EQ("long long", table.LookupSymbol("i").type);
+
+    table.RemoveSymbol("undeclared");
+    EXPECT_EQ(nullptr, table.Find(Atom("undeclared")));
+}
+
+TEST(SymbolTableTests, ManyNamesAcrossDeepScopes) {
+    SymbolTable table;
+
+    // forces the slot array to grow while undo entries are pending
+    for (size_t depth = 0; depth < 50; depth++) {
+        table.PushScope();
+        for (size_t name = 0; name < 100; name++)
+            table.Insert("v" + std::to_string(name), "depth" + std::to_string(depth));
+    }
+
+    for (size_t depth = 50; depth-- > 0;) {
+        EXPECT_EQ("depth" + std::to_string(depth), table.LookupSymbol("v7").type);
+        table.PopScope();
+    }
+
+    EXPECT_FALSE(table.SymbolExists("v7"));
+}
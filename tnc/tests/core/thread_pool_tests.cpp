@@ -0,0 +1,63 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the work-stealing thread pool
+ */
+
+#include <atomic>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "core/thread_pool.h"
+
+using namespace tonic;
+
+TEST(ThreadPoolTests, RunsEverySubmittedTask) {
+    ThreadPool pool(4);
+    std::atomic<size_t> sum = 0;
+
+    for (size_t i = 1; i <= 1000; i++)
+        pool.Submit([&sum, i] { sum += i; });
+    pool.Wait();
+
+    EXPECT_EQ(500500, sum);
+    EXPECT_EQ(4, pool.Size());
+}
+
+TEST(ThreadPoolTests, WaitsForTasksSubmittedByTasks) {
+    ThreadPool pool(3);
+    std::atomic<size_t> leaves = 0;
+
+    // binary fan-out of depth 10 from inside the pool
+    std::function<void(size_t)> split = [&](size_t depth) {
+        if (depth == 0) {
+            ++leaves;
+            return;
+        }
+        pool.Submit([&split, depth] { split(depth - 1); });
+        pool.Submit([&split, depth] { split(depth - 1); });
+    };
+
+    pool.Submit([&split] { split(10); });
+    pool.Wait();
+
+    EXPECT_EQ(1024, leaves);
+}
+
+TEST(ThreadPoolTests, WaitRethrowsTaskExceptionAndPoolStaysUsable) {
+    ThreadPool pool(2);
+    std::atomic<size_t> finished = 0;
+
+    pool.Submit([] { throw std::runtime_error("task failed"); });
+    for (size_t i = 0; i < 10; i++)
+        pool.Submit([&finished] { ++finished; });
+    EXPECT_THROW(pool.Wait(), std::runtime_error);
+    EXPECT_EQ(10, finished);
+
+    pool.Submit([&finished] { ++finished; });
+    EXPECT_NO_THROW(pool.Wait());
+    EXPECT_EQ(11, finished);
+}
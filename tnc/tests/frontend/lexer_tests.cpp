@@ -47,7 +47,7 @@ TEST(LexerTests, Function) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -87,7 +87,7 @@ TEST(LexerTests, MemberFunctionImpl) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -149,7 +149,7 @@ TEST(LexerTests, ClassDefinition) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -209,7 +209,7 @@ TEST(LexerTests, IfStatement) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -248,7 +248,7 @@ TEST(LexerTests, CppChunk) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -293,7 +293,7 @@ TEST(LexerTests, SwitchCase) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -317,7 +317,7 @@ TEST(LexerTests, SliceRange) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -362,7 +362,7 @@ TEST(LexerTests, ForRange) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -430,7 +430,7 @@ TEST(LexerTests, ShiftsAndI0) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -451,7 +451,7 @@ TEST(LexerTests, HexLiteral) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -486,7 +486,7 @@ TEST(LexerTests, ConstReturn) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -522,7 +522,7 @@ TEST(LexerTests, ConstFunction) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -563,7 +563,7 @@ TEST(LexerTests, MultilineParenthesis) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -595,7 +595,7 @@ TEST(LexerTests, MultilineSquare) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -641,7 +641,7 @@ TEST(LexerTests, MultilineCurly) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -691,7 +691,7 @@ TEST(LexerTests, Enums) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
 }
 
@@ -741,6 +741,24 @@ TEST(LexerTests, NestedLoops) {
 
     for (int i = 0; i < tokens.size(); i++) {
         ASSERT_EQ(expected[i], tokens[i].type) << "Expected and result token is different at " << i << " and lexeme: "
-                                               << tokens[i].lexeme;
+                                               << tokens[i].Lexeme();
     }
-}
\ No newline at end of file
+}
+TEST(LexerTests, NamedTokensKeepOnlyTheirAtom) {
+    std::string code = "count: int = 12 // total\n";
+
+    tonic::Lexer lexer(code, "test.tn");
+    std::vector<tonic::Token> tokens = lexer.Tokenize();
+
+    ASSERT_LE(6, tokens.size());
+    EXPECT_EQ(tonic::Atom("count"), tokens[0].atom);
+    EXPECT_TRUE(tokens[0].text.empty());
+    EXPECT_EQ(tonic::TokenType::TYPE, tokens[2].type);
+    EXPECT_EQ("int", tokens[2].Lexeme());
+
+    EXPECT_EQ(tonic::TokenType::LITERAL, tokens[4].type);
+    EXPECT_EQ("12", tokens[4].Lexeme());
+    EXPECT_EQ(tonic::Atom(), tokens[4].atom);
+    EXPECT_EQ(tonic::TokenType::COMMENT, tokens[5].type);
+    EXPECT_EQ("// total", tokens[5].Lexeme());
+}
@@ -7,6 +7,7 @@
  */
 
 #include "parser.h"
+#include "errors/errors.h"
 #include "gtest/gtest.h"
 
 using namespace tonic;
@@ -87,5 +88,96 @@ TEST(ParserTests, ManualRangedStatementWithType) {
     ASSERT_EQ(ranged_node->id_type, "int&");
 }
 
+TEST(ParserTests, FunctionDeclarationHeader) {
+    std::string code = "// sums\n"
+                       "\n"
+                       "int sum(a, b: int, c) const:\n"
+                       "  return a + b + c\n";
+
+    Lexer l(code, file);
+    std::vector<Token> tokens = l.Tokenize();
+
+    // the parser starts at the declaration, the lines above keep its line number
+    auto start = std::find_if(tokens.begin(), tokens.end(), [](const Token &token) { return token == TokenType::TYPE; });
+    std::vector<Token> declaration(start, tokens.end());
+    Parser p(declaration, file);
+    std::shared_ptr<FunctionDeclaration> function = p.ParseFunctionDeclaration();
+
+    ASSERT_NE(function, nullptr);
+    ASSERT_EQ(function->line, 3);
+    ASSERT_EQ(function->type->statement, "int");
+    ASSERT_EQ(function->name->statement, "sum");
+    ASSERT_EQ(function->arguments.size(), 3);
+    ASSERT_EQ(function->arguments[0].second, "int");
+    ASSERT_EQ(function->arguments[1].first, "b");
+    ASSERT_EQ(function->arguments[2].second, "auto");
+}
+
+TEST(ParserTests, WhileLoopHeader) {
+    std::string code = "x = 1\n"
+                       "while x < n:\n"
+                       "  x = x * 2\n";
+
+    Lexer l(code, file);
+    std::vector<Token> tokens = l.Tokenize();
+
+    auto start = std::find_if(tokens.begin(), tokens.end(), [](const Token &token) { return token == TokenType::WHILE; });
+    std::vector<Token> declaration(start, tokens.end());
+    Parser p(declaration, file);
+    std::shared_ptr<WhileLoop> loop = p.ParseWhileLoop();
+
+    ASSERT_NE(loop, nullptr);
+    ASSERT_EQ(loop->line, 2);
+    ASSERT_EQ(loop->condition->statement, "x < n");
+}
+
+TEST(ParserTests, FunctionAndWhileBodies) {
+    std::string code = "int twice(a: int):\n"
+                       "  b = a * 2\n"
+                       "  return b\n"
+                       "while x < n:\n"
+                       "  x = x * 2\n"
+                       "y = 3\n";
+
+    Lexer l(code, file);
+    std::vector<Token> tokens = l.Tokenize();
+
+    Parser p(tokens, file);
+    std::shared_ptr<Program> program = p.Parse();
+    ASSERT_EQ(program->body.size(), 3);
+
+    auto function = std::dynamic_pointer_cast<FunctionDeclaration>(program->body[0]);
+    ASSERT_NE(function, nullptr);
+    ASSERT_NE(function->block, nullptr);
+    ASSERT_EQ(function->block->body.size(), 2);
+    auto local = std::dynamic_pointer_cast<VariableDeclaration>(function->block->body[0]);
+    ASSERT_NE(local, nullptr);
+    ASSERT_EQ(std::static_pointer_cast<GeneralStatement>(local->initializer)->statement, "a * 2");
+    auto result = std::dynamic_pointer_cast<GeneralStatement>(function->block->body[1]);
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->statement, "return b");
+    ASSERT_EQ(result->line, 3);
+
+    auto loop = std::dynamic_pointer_cast<WhileLoop>(program->body[1]);
+    ASSERT_NE(loop, nullptr);
+    ASSERT_EQ(loop->block->body.size(), 1);
+    ASSERT_EQ(loop->block->body[0]->line, 5);
+
+    auto after = std::dynamic_pointer_cast<VariableDeclaration>(program->body[2]);
+    ASSERT_NE(after, nullptr);
+    ASSERT_EQ(after->identifier->statement, "y");
+}
+
+TEST(ParserTests, BlockMustBeIndented) {
+    std::string code = "while x < n:\n"
+                       "x = x * 2\n";
+
+    Lexer l(code, file);
+    std::vector<Token> tokens = l.Tokenize();
+
+    Parser p(tokens, file);
+    ASSERT_THROW(p.ParseWhileLoop(), SyntaxError);
+}
+
 // list compr, const, constexpr variables or const functions too
 // destructor, constructor
\ No newline at end of file
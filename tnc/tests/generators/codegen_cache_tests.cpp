@@ -0,0 +1,99 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the per-declaration codegen cache
+ */
+
+#include "gtest/gtest.h"
+
+#include "analyzers/loop_bounds.h"
+#include "core/hash.h"
+#include "generators/cppgen.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    std::shared_ptr<FunctionDeclaration> Function(const std::string &name, std::vector<std::shared_ptr<Node>> body) {
+        auto function = std::make_shared<FunctionDeclaration>();
+        function->type = Statement("void");
+        function->name = Statement(name);
+        function->arguments = {{"n", "int"}};
+        function->block = MakeBlock(std::move(body));
+        return function;
+    }
+
+    // a hashed program of two functions, one printing a loop over n
+    std::shared_ptr<Program> Printing() {
+        auto output = std::make_shared<InputOutput>();
+        output->type = InOut::OUT;
+        output->operands = {Statement("i")};
+
+        auto loop = Loop("i", "0", "n", {output});
+        loop->id_type = "int";
+        auto program = MakeProgram({Function("show", {loop}), Function("idle", {Statement("n = 0")})});
+        LoopBoundsAnalysis().Run(*program);
+        HashTree(*program);
+        return program;
+    }
+
+    std::string Generate(const Program &program, GeneratorOptions options = {}) {
+        OutputSink out;
+        CppGenerator(out, options).Generate(program);
+        return out.ToString();
+    }
+
+}
+
+TEST(CodegenCacheTests, UnchangedDeclarationsAreSpliced) {
+    auto program = Printing();
+    std::string expected = Generate(*program);
+
+    CodegenCache cache;
+    EXPECT_EQ(expected, Generate(*program, {.cache = &cache}));
+    EXPECT_EQ(0u, cache.Hits());
+    EXPECT_EQ(2u, cache.Misses());
+
+    // the includes and the writer runtime come back with the cached code
+    EXPECT_EQ(expected, Generate(*Printing(), {.cache = &cache}));
+    EXPECT_EQ(2u, cache.Hits());
+    EXPECT_EQ(2u, cache.Size());
+}
+
+TEST(CodegenCacheTests, KeyCoversOptionsAndAnalysis) {
+    CodegenCache cache;
+    auto program = Printing();
+    Generate(*program, {.cache = &cache});
+
+    GeneratorOptions plain = {.fast_output = false};
+    EXPECT_EQ(Generate(*program, plain), Generate(*program, {.fast_output = false, .cache = &cache}));
+    EXPECT_EQ(0u, cache.Hits());
+
+    // analysis results are not part of the hash, but they change the loop header
+    auto &show = static_cast<FunctionDeclaration &>(*program->body[0]);
+    static_cast<ForLoop &>(*show.block->body[0]).bounds_invariant = false;
+    EXPECT_EQ(Generate(*program, plain), Generate(*program, {.fast_output = false, .cache = &cache}));
+    EXPECT_EQ(1u, cache.Hits()); // `idle`
+}
+
+TEST(CodegenCacheTests, PruneDropsUnusedEntries) {
+    CodegenCache cache;
+    Generate(*Printing(), {.cache = &cache});
+
+    auto changed = Printing();
+    static_cast<FunctionDeclaration &>(*changed->body[1]).block->body[0] = Statement("n = 1");
+    HashTree(*changed);
+    Generate(*changed, {.cache = &cache});
+    EXPECT_EQ(3u, cache.Size());
+
+    cache.Prune();
+    EXPECT_EQ(2u, cache.Size());
+
+    // unhashed declarations are generated every time
+    Generate(*MakeProgram({Function("idle", {})}), {.cache = &cache});
+    EXPECT_EQ(2u, cache.Size());
+}
@@ -0,0 +1,405 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the C++ generator
+ */
+
+#include "gtest/gtest.h"
+
+#include "analyzers/loop_bounds.h"
+#include "analyzers/memoize.h"
+#include "core/thread_pool.h"
+#include "errors/errors.h"
+#include "generators/cppgen.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    // an int loop over i with its bounds analysed, as the generator sees it
+    std::shared_ptr<ForLoop> Bounded(std::shared_ptr<ForLoop> loop) {
+        loop->id_type = "int";
+        LoopBoundsAnalysis().Run(*MakeProgram({loop}));
+        return loop;
+    }
+
+}
+
+TEST(CppgenTests, LoopWithConstantBounds) {
+    EXPECT_EQ("for (int i = 0; i < 1048576; i += 2)",
+              cppgen::GenerateLoopHeader(*Bounded(WithStep(Loop("i", "0", "1 << 20"), "2"))));
+    EXPECT_EQ("for (int i = 10; i > 0; --i)",
+              cppgen::GenerateLoopHeader(*Bounded(WithStep(Loop("i", "10", "0"), "-1"))));
+}
+
+TEST(CppgenTests, InvariantBoundsAreHoisted) {
+    EXPECT_EQ("for (int i = 0, _tnc_end_i = v . size ( ); i < _tnc_end_i; ++i)",
+              cppgen::GenerateLoopHeader(*Bounded(Loop("i", "0", "v . size ( )"))));
+    EXPECT_EQ("for (int i = 0, _tnc_end_i = n, _tnc_step_i = k; (_tnc_step_i > 0 ? i < _tnc_end_i : i > _tnc_end_i); "
+              "i += _tnc_step_i)", cppgen::GenerateLoopHeader(*Bounded(WithStep(Loop("i", "0", "n"), "k"))));
+}
+
+TEST(CppgenTests, ChangingBoundsAreReevaluated) {
+    auto loop = Bounded(Loop("i", "0", "n - 1", {Statement("n - = 1")}));
+    EXPECT_EQ("for (int i = 0; i < (n - 1); ++i)", cppgen::GenerateLoopHeader(*loop));
+}
+
+TEST(CppgenTests, ProgramLayout) {
+    auto function = std::make_shared<FunctionDeclaration>();
+    function->type = Statement("long long");
+    function->name = Statement("square");
+    function->arguments = {{"x", "long long"}};
+    function->block = std::make_shared<Block>();
+    function->block->body.push_back(Statement("return x * x"));
+
+    auto n = std::make_shared<VariableDeclaration>();
+    n->data_type = "int";
+    n->identifier = Statement("n");
+
+    auto a = std::make_shared<VariableDeclaration>();
+    a->data_type = "vector<long long>";
+    a->identifier = Statement("a");
+    a->initializer = Statement("vector<long long> ( n )");
+
+    auto input = std::make_shared<InputOutput>();
+    input->operands.push_back(Statement("n"));
+
+    auto output = std::make_shared<InputOutput>();
+    output->type = InOut::OUT;
+    output->operands = {Statement("square ( n )"), Statement("n")};
+
+    auto program = std::make_shared<Program>();
+    program->body = {n, function, input, a, Bounded(Loop("i", "0", "n", {Statement("a [ i ] + = i")})), output};
+
+    OutputSink out;
+    CppGenerator(out, {.fast_input = false, .fast_output = false}).Generate(*program);
+    EXPECT_EQ("#include <iostream>\n"
+              "#include <vector>\n"
+              "\n"
+              "using namespace std;\n"
+              "\n"
+              "int n;\n"
+              "\n"
+              "long long square(long long x);\n"
+              "\n"
+              "long long square(long long x) {\n"
+              "    return x * x;\n"
+              "}\n"
+              "\n"
+              "vector<long long> a;\n"
+              "\n"
+              "int main() {\n"
+              "    ios::sync_with_stdio(false);\n"
+              "    cin.tie(nullptr);\n"
+              "    cin >> n;\n"
+              "    a = vector<long long> ( n );\n"
+              "    for (int i = 0, _tnc_end_i = n; i < _tnc_end_i; ++i) {\n"
+              "        a [ i ] += i;\n"
+              "    }\n"
+              "    cout << (square ( n )) << ' ' << n << '\\n';\n"
+              "    return 0;\n"
+              "}\n", out.ToString());
+}
+
+TEST(CppgenTests, ConstAndReferenceVariablesStayInMain) {
+    auto declare = [](const std::string &type, const std::string &name, const std::string &initializer) {
+        auto declaration = std::make_shared<VariableDeclaration>();
+        declaration->data_type = type;
+        declaration->identifier = Statement(name);
+        if (!initializer.empty())
+            declaration->initializer = Statement(initializer);
+        return declaration;
+    };
+
+    auto input = std::make_shared<InputOutput>();
+    input->operands = {Statement("n")};
+    auto output = std::make_shared<InputOutput>();
+    output->type = InOut::OUT;
+    output->operands = {Statement("first"), Statement("m")};
+
+    auto program = MakeProgram({declare("int", "n", ""), input, declare("const int", "limit", "1 << 10"),
+                                declare("const int", "m", "n * 2"), declare("vector<long long>", "a",
+                                                                           "vector<long long> ( m + 1 )"),
+                                declare("long long&", "first", "a [ 0 ]"), Statement("first = limit"), output});
+
+    OutputSink out;
+    CppGenerator(out).Generate(*program);
+    std::string text = out.ToString();
+
+    EXPECT_NE(std::string::npos, text.find("\nconst int limit = 1 << 10;\n"));
+    EXPECT_NE(std::string::npos, text.find("\nvector<long long> a;\n"));
+    EXPECT_NE(std::string::npos, text.find("    const int m = n * 2;\n"));
+    EXPECT_NE(std::string::npos, text.find("    a = vector<long long> ( m + 1 );\n"));
+    EXPECT_NE(std::string::npos, text.find("    long long& first = a [ 0 ];\n"));
+    EXPECT_TRUE(Compiles(text));
+}
+
+TEST(CppgenTests, UserMainKeepsGlobalsAtFileScope) {
+    auto declare = [](const std::string &type, const std::string &name, std::shared_ptr<Node> initializer) {
+        auto declaration = std::make_shared<VariableDeclaration>();
+        declaration->data_type = type;
+        declaration->identifier = Statement(name);
+        declaration->initializer = std::move(initializer);
+        declaration->line = 3;
+        return declaration;
+    };
+
+    auto main = std::make_shared<FunctionDeclaration>();
+    main->type = Statement("int");
+    main->name = Statement("main");
+    main->block = MakeBlock({Statement("a [ 0 ] = limit"), Statement("return 0")});
+
+    auto program = MakeProgram({declare("int", "n", Statement("10")), declare("const int", "limit", Statement("n * 2")),
+                                declare("vector<long long>", "a", Statement("vector<long long> ( limit + 1 )")),
+                                main});
+
+    OutputSink out;
+    CppGenerator(out).Generate(*program);
+    std::string text = out.ToString();
+
+    EXPECT_NE(std::string::npos, text.find("\nint n = 10;\nconst int limit = n * 2;\n"
+                                           "vector<long long> a = vector<long long> ( limit + 1 );\n"));
+    EXPECT_EQ(std::string::npos, text.find("sync_with_stdio")); // no generated main
+    EXPECT_NE(std::string::npos, text.find("int main() {\n    a [ 0 ] = limit;\n"));
+    EXPECT_TRUE(Compiles(text));
+
+    auto input = std::make_shared<InputOutput>();
+    input->operands = {Statement("n")};
+    OutputSink rejected;
+    EXPECT_THROW(CppGenerator(rejected).Generate(*MakeProgram({input, main})), SyntaxError);
+    EXPECT_THROW(CppGenerator(rejected).Generate(*MakeProgram({declare("vector<int>", "squares", Loop("i", "0", "n")),
+                                                               main})), SyntaxError);
+}
+
+TEST(CppgenTests, SplitOperatorsAreJoined) {
+    auto declaration = std::make_shared<VariableDeclaration>();
+    declaration->identifier = Statement("shifted");
+    declaration->initializer = Statement("x < < 2 > = y & & s = = \"a < = b\"");
+    EXPECT_EQ("auto shifted = x << 2 >= y && s == \"a < = b\";\n", cppgen::Generate(*declaration));
+}
+
+TEST(CppgenTests, InputGoesThroughTheReader) {
+    auto input = std::make_shared<InputOutput>();
+    input->operands = {Statement("n"), Statement("a [ i ]")};
+    auto program = std::make_shared<Program>();
+    program->body.push_back(input);
+
+    OutputSink out;
+    CppGenerator(out).Generate(*program);
+    std::string text = out.ToString();
+
+    EXPECT_NE(std::string::npos, text.find("class Reader"));
+    EXPECT_NE(std::string::npos, text.find("static _tnc_runtime::Reader _tnc_in;\n\nusing namespace std;"));
+    EXPECT_NE(std::string::npos, text.find("    _tnc_in.Read(n, a [ i ]);\n"));
+    EXPECT_EQ(std::string::npos, text.find("cin >>"));
+}
+
+TEST(CppgenTests, ProgramsReadingStdinThemselvesKeepCin) {
+    auto input = [] {
+        auto node = std::make_shared<InputOutput>();
+        node->operands = {Statement("n")};
+        return node;
+    };
+    auto scanf_chunk = std::make_shared<CppNode>();
+    scanf_chunk->cpp_code = Statement("scanf(\"%d\", &k);");
+
+    OutputSink getline_stream, scanf_stream, reader;
+    CppGenerator(getline_stream).Generate(*MakeProgram({input(), Statement("getline ( cin , s )")}));
+    CppGenerator(scanf_stream).Generate(*MakeProgram({input(), scanf_chunk}));
+    CppGenerator(reader).Generate(*MakeProgram({input(), Statement("s = \"cin\""), Statement("x . cin = 1")}));
+
+    EXPECT_NE(std::string::npos, getline_stream.ToString().find("    cin >> n;\n"));
+    EXPECT_EQ(std::string::npos, getline_stream.ToString().find("class Reader"));
+    EXPECT_NE(std::string::npos, scanf_stream.ToString().find("    cin >> n;\n"));
+    EXPECT_NE(std::string::npos, reader.ToString().find("    _tnc_in.Read(n);\n"));
+}
+
+TEST(CppgenTests, OutputGoesThroughTheWriter) {
+    auto output = std::make_shared<InputOutput>();
+    output->type = InOut::OUT;
+    output->operands = {Statement("a"), Statement("x + 1")};
+    auto program = std::make_shared<Program>();
+    program->body.push_back(output);
+
+    OutputSink batched, interactive, streams;
+    CppGenerator(batched).Generate(*program);
+    CppGenerator(interactive, {.interactive = true}).Generate(*program);
+    CppGenerator(streams, {.fast_output = false, .interactive = true}).Generate(*program);
+
+    EXPECT_NE(std::string::npos, batched.ToString().find("static _tnc_runtime::Writer _tnc_out;\n"));
+    EXPECT_NE(std::string::npos, batched.ToString().find("    _tnc_out.Line(a, x + 1);\n"));
+    EXPECT_NE(std::string::npos, interactive.ToString().find("static _tnc_runtime::Writer _tnc_out(true);\n"));
+    EXPECT_NE(std::string::npos, streams.ToString().find("    cout << a << ' ' << (x + 1) << endl;\n"));
+}
+
+TEST(CppgenTests, ProgramsPrintingThemselvesKeepCout) {
+    auto output = std::make_shared<InputOutput>();
+    output->type = InOut::OUT;
+    output->operands = {Statement("n")};
+    auto printf_chunk = std::make_shared<CppNode>();
+    printf_chunk->cpp_code = Statement("printf(\"%d\\n\", k);");
+
+    OutputSink cout_stream, printf_stream, writer;
+    CppGenerator(cout_stream).Generate(*MakeProgram({Statement("cout < < 1 < < endl"), output}));
+    CppGenerator(printf_stream).Generate(*MakeProgram({printf_chunk, output}));
+    CppGenerator(writer).Generate(*MakeProgram({Statement("s = \"cout\""), output}));
+
+    EXPECT_NE(std::string::npos, cout_stream.ToString().find("    cout << n << '\\n';\n"));
+    EXPECT_EQ(std::string::npos, cout_stream.ToString().find("class Writer"));
+    EXPECT_NE(std::string::npos, printf_stream.ToString().find("    cout << n << '\\n';\n"));
+    EXPECT_NE(std::string::npos, writer.ToString().find("    _tnc_out.Line(n);\n"));
+}
+
+TEST(CppgenTests, JudgeProfileSelectsTheDigitKernel) {
+    auto input = std::make_shared<InputOutput>();
+    input->operands = {Statement("a")};
+    auto program = std::make_shared<Program>();
+    program->body.push_back(input);
+
+    OutputSink portable, avx2;
+    CppGenerator(portable).Generate(*program);
+    CppGenerator(avx2, {.judge = JudgeProfile::AVX2}).Generate(*program);
+
+    std::string text = avx2.ToString();
+    EXPECT_EQ(std::string::npos, portable.ToString().find("#define TNC_RUNTIME_SIMD 2"));
+    EXPECT_LT(text.find("#define TNC_RUNTIME_SIMD 2\n"), text.find("#ifndef TONIC_RUNTIME_FAST_INPUT_H"));
+}
+
+TEST(CppgenTests, ParallelOutputMatchesSequential) {
+    auto program = std::make_shared<Program>();
+    for (int i = 0; i < 40; i++) {
+        auto function = std::make_shared<FunctionDeclaration>();
+        function->type = Statement(i % 3 ? "int" : "auto");
+        function->name = Statement("f" + std::to_string(i));
+        function->block = std::make_shared<Block>();
+        function->block->body.push_back(Statement(i % 2 ? "return max ( 1 , 2 )" : "return sqrt ( 4 )"));
+        program->body.push_back(function);
+
+        auto global = std::make_shared<VariableDeclaration>();
+        global->data_type = "int";
+        global->identifier = Statement("g" + std::to_string(i));
+        global->initializer = Statement("f" + std::to_string(i) + " ( )");
+        program->body.push_back(global);
+        program->body.push_back(Statement("g" + std::to_string(i) + " + = 1"));
+    }
+
+    OutputSink sequential;
+    CppGenerator(sequential).Generate(*program);
+
+    for (size_t threads: {1, 3, 8}) {
+        ThreadPool pool(threads);
+        OutputSink parallel;
+        CppGenerator generator(parallel);
+        generator.Generate(*program, &pool);
+        EXPECT_EQ(sequential.ToString(), parallel.ToString());
+        EXPECT_TRUE(generator.Includes().contains("cmath"));
+    }
+}
+
+TEST(CppgenTests, MemoTableFollowsTheArgumentRanges) {
+    auto memoized = [](const std::string &name, const std::string &second_type) {
+        auto function = std::make_shared<FunctionDeclaration>();
+        function->is_memoize = true;
+        function->type = Statement("long long");
+        function->name = Statement(name);
+        function->arguments = {{"i", "int"}, {"j", second_type}};
+        function->block = std::make_shared<Block>();
+        function->block->body.push_back(Statement("return i + j"));
+        return function;
+    };
+    auto program = std::make_shared<Program>();
+    program->body.push_back(memoized("paths", "int"));
+    program->body.push_back(memoized("count", "string"));
+
+    Constraints constraints = {{"i", Interval(0, 1000)}, {"j", Interval(1, 5000)}};
+    OutputSink bounded, unbounded;
+    CppGenerator(bounded, {.constraints = &constraints}).Generate(*program);
+    CppGenerator(unbounded).Generate(*program);
+
+    std::string text = bounded.ToString();
+    EXPECT_NE(std::string::npos, text.find("class DenseMemo"));
+    EXPECT_NE(std::string::npos, text.find("inline long long paths(int i, int j);\n"));
+    EXPECT_NE(std::string::npos,
+              text.find("static _tnc_runtime::DenseMemo<long long, 2> _tnc_memo_paths({0, 1}, {1001, 5000});\n"
+                        "long long _tnc_compute_paths(int i, int j);\n\n"
+                        "inline long long paths(int i, int j) {\n"
+                        "    if (const long long *cached = _tnc_memo_paths.Find(i, j))\n"
+                        "        return *cached;\n"
+                        "    return _tnc_memo_paths.Store(_tnc_compute_paths(i, j), i, j);\n"
+                        "}\n\n"
+                        "long long _tnc_compute_paths(int i, int j) {\n"
+                        "    return i + j;\n"
+                        "}\n"));
+    EXPECT_NE(std::string::npos, text.find("static _tnc_runtime::HashMemo<long long, int, string> _tnc_memo_count;\n"));
+    EXPECT_NE(std::string::npos,
+              unbounded.ToString().find("static _tnc_runtime::HashMemo<long long, int, int> _tnc_memo_paths;\n"));
+}
+
+TEST(CppgenTests, MemoKeysOfContainersCompile) {
+    auto memoized = [](const std::string &name, std::vector<std::pair<Atom, Atom>> arguments,
+                       const std::string &body) {
+        auto function = std::make_shared<FunctionDeclaration>();
+        function->is_memoize = true;
+        function->type = Statement("long long");
+        function->name = Statement(name);
+        function->arguments = std::move(arguments);
+        function->block = MakeBlock({Statement(body)});
+        return function;
+    };
+    auto point = std::make_shared<CppNode>();
+    point->cpp_code = Statement("struct Point { int x; };");
+
+    auto program = MakeProgram({point,
+                                memoized("walk", {{"v", "vector<int>"}, {"i", "int"}},
+                                         "return i < 0 ? 0 : v [ i ] + walk ( v , i - 1 )"),
+                                memoized("pick", {{"t", "tuple<int, string>"}},
+                                         "return get<0> ( t ) + pick ( t )"),
+                                memoized("count", {{"m", "map<int, int>"}}, "return m . size ( )"),
+                                memoized("far", {{"p", "Point"}}, "return p . x")});
+
+    OutputSink out;
+    CppGenerator(out).Generate(*program);
+    std::string text = out.ToString();
+
+    EXPECT_NE(std::string::npos, text.find("_tnc_runtime::HashMemo<long long, vector<int>, int> _tnc_memo_walk;"));
+    EXPECT_NE(std::string::npos, text.find("_tnc_runtime::HashMemo<long long, tuple<int, string>> _tnc_memo_pick;"));
+    EXPECT_EQ(std::string::npos, text.find("_tnc_memo_count"));
+    EXPECT_LT(text.find("struct Point"), text.find("long long far(Point p);"));
+    EXPECT_TRUE(Compiles(text));
+}
+
+TEST(CppgenTests, DecreasingRecursionFillsBottomUp) {
+    auto function = std::make_shared<FunctionDeclaration>();
+    function->is_memoize = true;
+    function->type = Statement("int");
+    function->name = Statement("ways");
+    function->arguments = {{"r", "int"}, {"c", "int"}};
+    function->block = std::make_shared<Block>();
+    function->block->body = {Statement("if ( r == 0 || c == 0 ) return 1"),
+                             Statement("return ways ( r - 1 , c ) + ways ( r , c - 1 )")};
+    auto program = std::make_shared<Program>();
+    program->body.push_back(function);
+
+    Diagnostics diagnostics;
+    MemoizeAnalysis analysis(diagnostics);
+    analysis.Run(*program);
+    Constraints constraints = {{"r", Interval::Of(0, 100)}, {"c", Interval::Of(0, 100)}};
+
+    OutputSink bottom_up, top_down, unbounded;
+    CppGenerator(bottom_up, {.constraints = &constraints, .recursion = &analysis.Reports()}).Generate(*program);
+    CppGenerator(top_down, {.constraints = &constraints}).Generate(*program);
+    CppGenerator(unbounded, {.recursion = &analysis.Reports()}).Generate(*program);
+
+    EXPECT_NE(std::string::npos,
+              bottom_up.ToString().find("inline int ways(int r, int c) {\n"
+                                        "    if (const int *cached = _tnc_memo_ways.Fill(_tnc_compute_ways, r, c))\n"
+                                        "        return *cached;\n"
+                                        "    return _tnc_compute_ways(r, c);\n"
+                                        "}\n"));
+    EXPECT_NE(std::string::npos, top_down.ToString().find("_tnc_memo_ways.Find(r, c)"));
+    EXPECT_NE(std::string::npos, unbounded.ToString().find("_tnc_memo_ways.Find(r, c)"));
+}
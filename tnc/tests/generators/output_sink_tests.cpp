@@ -0,0 +1,76 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the chunked output sink
+ */
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "errors/errors.h"
+#include "generators/output_sink.h"
+
+using namespace tonic;
+
+TEST(OutputSinkTests, IndentsEachLine) {
+    OutputSink out;
+    out << "if (x) {\n";
+    out.Indent();
+    out << "y = 1;\n\nz = " << 2LL << ';' << '\n';
+    out.Dedent();
+    out << "}\n";
+
+    EXPECT_EQ("if (x) {\n    y = 1;\n\n    z = 2;\n}\n", out.ToString());
+}
+
+TEST(OutputSinkTests, AllocatesPerPage) {
+    OutputSink out;
+    std::string line(100, 'x');
+    line.back() = '\n';
+    for (size_t i = 0; i < 10000; i++)
+        out << line;
+
+    EXPECT_EQ(1000000u, out.Size());
+    EXPECT_EQ((1000000 + OutputSink::PAGE_SIZE - 1) / OutputSink::PAGE_SIZE, out.Pages());
+    EXPECT_EQ(1000000u, out.ToString().size());
+}
+
+TEST(OutputSinkTests, SpliceMovesPages) {
+    OutputSink first, second;
+    first << "int a;\n";
+    second << "int b;\n";
+    size_t pages = first.Pages() + second.Pages();
+
+    first.Splice(std::move(second));
+    EXPECT_EQ("int a;\nint b;\n", first.ToString());
+    EXPECT_EQ(pages, first.Pages());
+    EXPECT_EQ(0u, second.Size());
+}
+
+TEST(OutputSinkTests, StreamsToDescriptor) {
+    int pipe_fds[2];
+    ASSERT_EQ(0, pipe(pipe_fds));
+
+    {
+        OutputSink out(pipe_fds[1]);
+        out.Indent();
+        out << "x;\n";
+        OutputSink rest;
+        rest << "y;\n";
+        out.Splice(std::move(rest));
+        EXPECT_EQ(1u, out.Pages());
+    }
+    close(pipe_fds[1]);
+
+    char buffer[64];
+    ssize_t size = read(pipe_fds[0], buffer, sizeof(buffer));
+    close(pipe_fds[0]);
+    EXPECT_EQ("    x;\ny;\n", std::string(buffer, size));
+
+    OutputSink closed(pipe_fds[1]);
+    closed << "lost";
+    EXPECT_THROW(closed.Flush(), InternalError);
+}
@@ -0,0 +1,198 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the input reader runtime
+ */
+
+#include <climits>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "runtime/fast_input.h"
+
+namespace {
+
+    // a temporary file holding the text, closed when the test ends
+    // kernels the machine can run, 0 is the scalar parser
+    std::vector<int> SimdLevels() {
+        std::vector<int> levels = {0};
+#if TNC_RUNTIME_X86
+        if (__builtin_cpu_supports("sse4.1"))
+            levels.push_back(1);
+        if (__builtin_cpu_supports("avx2"))
+            levels.push_back(2);
+#endif
+        return levels;
+    }
+
+    struct InputFile {
+        explicit InputFile(const std::string &text) : file(std::tmpfile()) {
+            std::fwrite(text.data(), 1, text.size(), file);
+            std::fflush(file);
+            std::rewind(file);
+        }
+
+        ~InputFile() {
+            std::fclose(file);
+        }
+
+        int Descriptor() const {
+            return fileno(file);
+        }
+
+        FILE *file;
+    };
+
+}
+
+TEST(FastInputTests, ReadsValuesOfEachType) {
+    InputFile input("  42\n-7 +3 -9223372036854775808 18446744073709551615\nword x 2.5 1\n");
+
+    for (bool map: {true, false}) {
+        lseek(input.Descriptor(), 0, SEEK_SET);
+        _tnc_runtime::Reader reader(input.Descriptor(), map);
+
+        int a, b, c;
+        long long smallest;
+        unsigned long long largest;
+        std::string word;
+        char letter;
+        double real;
+        bool flag;
+        ASSERT_TRUE(reader.Read(a, b, c, smallest, largest, word, letter, real, flag));
+
+        EXPECT_EQ(42, a);
+        EXPECT_EQ(-7, b);
+        EXPECT_EQ(3, c);
+        EXPECT_EQ(LLONG_MIN, smallest);
+        EXPECT_EQ(ULLONG_MAX, largest);
+        EXPECT_EQ("word", word);
+        EXPECT_EQ('x', letter);
+        EXPECT_DOUBLE_EQ(2.5, real);
+        EXPECT_TRUE(flag);
+
+        int missing = -1;
+        EXPECT_FALSE(reader.Read(missing));
+        EXPECT_EQ(-1, missing);
+    }
+}
+
+TEST(FastInputTests, FillsPreallocatedContainers) {
+    InputFile input("3\n1 2 3\n4 5 6\n7 8\n");
+    _tnc_runtime::Reader reader(input.Descriptor());
+
+    int n;
+    ASSERT_TRUE(reader.Read(n));
+    std::vector<std::vector<int>> grid(2, std::vector<int>(n));
+    std::pair<int, int> last;
+    ASSERT_TRUE(reader.Read(grid, last));
+
+    EXPECT_EQ((std::vector<std::vector<int>>{{1, 2, 3}, {4, 5, 6}}), grid);
+    EXPECT_EQ(std::make_pair(7, 8), last);
+}
+
+TEST(FastInputTests, TokensCrossBufferBoundaries) {
+    std::string text, word(100000, 'w');
+    for (int i = 0; i < 30000; i++)
+        text += std::to_string(i * 7919LL - 100000) + (i % 10 ? " " : "\n");
+    text += word;
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    InputFile file(text);
+
+    for (int fd: {file.Descriptor(), fds[0]}) {
+        std::thread writer;
+        if (fd == fds[0]) {
+            writer = std::thread([&] {
+                for (size_t written = 0; written < text.size();)
+                    written += write(fds[1], text.data() + written, std::min<size_t>(4093, text.size() - written));
+                close(fds[1]);
+            });
+        }
+
+        _tnc_runtime::Reader reader(fd, false);
+        bool matches = true;
+        for (int i = 0; i < 30000; i++) {
+            long long value;
+            matches &= reader.Read(value) && value == i * 7919LL - 100000;
+        }
+        std::string last;
+        EXPECT_TRUE(matches);
+        EXPECT_TRUE(reader.Read(last));
+        EXPECT_EQ(word, last);
+
+        if (writer.joinable())
+            writer.join();
+    }
+    close(fds[0]);
+}
+
+TEST(FastInputTests, BulkIntegersMatchStrtoll) {
+    const std::vector<std::string> boundaries = {
+            "0", "-0", "+0", "1", "-1", "2147483647", "-2147483648", "9223372036854775807", "-9223372036854775808",
+            "99999999", "100000000", "999999999999999", "1000000000000000", "9999999999999999", "10000000000000000",
+            "0000000000000000000000000042", "-000000000000000000007", "+00012", "1234567890123456789"};
+    const std::vector<std::string> separators = {" ", "\n", "  ", "\t", " \r\n"};
+
+    std::mt19937_64 random(2024);
+    std::string text;
+    std::vector<long long> expected;
+    for (int i = 0; i < 200000; i++) {
+        std::string token;
+        if (random() % 8 == 0) {
+            token = boundaries[random() % boundaries.size()];
+        } else {
+            long long value = static_cast<long long>(random() >> (random() % 64));
+            std::string digits = std::to_string(value < 0 ? -(value + 1) : value);
+            token = (random() % 2 ? "-" : random() % 4 ? "" : "+") + std::string(random() % 4 ? 0 : random() % 12, '0') +
+                    digits;
+        }
+        expected.push_back(std::strtoll(token.c_str(), nullptr, 10));
+        text += token + separators[random() % separators.size()];
+    }
+    InputFile input(text);
+
+    for (int level: SimdLevels()) {
+        for (bool map: {true, false}) {
+            lseek(input.Descriptor(), 0, SEEK_SET);
+            _tnc_runtime::Reader reader(input.Descriptor(), map, level);
+            std::vector<long long> values(expected.size());
+            ASSERT_TRUE(reader.Read(values));
+
+            size_t mismatches = 0;
+            for (size_t i = 0; i < values.size(); i++)
+                mismatches += values[i] != expected[i];
+            EXPECT_EQ(0u, mismatches) << "kernel " << level << (map ? ", mapped" : ", buffered");
+        }
+    }
+}
+
+TEST(FastInputTests, BulkIntsMatchStrtol) {
+    std::mt19937 random(7);
+    std::string text;
+    std::vector<int> expected;
+    for (int i = 0; i < 100000; i++) {
+        int value = static_cast<int>(random());
+        std::string token = std::to_string(value);
+        if (i % 5 == 0)
+            token = (value < 0 ? "-00" + token.substr(1) : "+0" + token);
+        expected.push_back(static_cast<int>(std::strtol(token.c_str(), nullptr, 10)));
+        text += token + (i % 10 == 9 ? "\n" : " ");
+    }
+    InputFile input(text);
+
+    for (int level: SimdLevels()) {
+        lseek(input.Descriptor(), 0, SEEK_SET);
+        _tnc_runtime::Reader reader(input.Descriptor(), true, level);
+        std::vector<int> values(expected.size());
+        ASSERT_TRUE(reader.Read(values));
+        EXPECT_EQ(expected, values) << "kernel " << level;
+    }
+}
@@ -0,0 +1,113 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the output writer runtime
+ */
+
+#include <climits>
+#include <cstdio>
+#include <fcntl.h>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "runtime/fast_output.h"
+
+namespace {
+
+    // what a pipe received so far, without blocking
+    std::string Drain(int fd) {
+        std::string text;
+        char buffer[4096];
+        for (ssize_t size; (size = read(fd, buffer, sizeof(buffer))) > 0;)
+            text.append(buffer, size);
+        return text;
+    }
+
+    struct Pipe {
+        Pipe() {
+            EXPECT_EQ(0, pipe(fds));
+            fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        }
+
+        ~Pipe() {
+            close(fds[0]);
+            close(fds[1]);
+        }
+
+        int fds[2];
+    };
+
+}
+
+TEST(FastOutputTests, FormatsLikeCout) {
+    FILE *file = std::tmpfile();
+    std::mt19937_64 random(3);
+    std::ostringstream expected;
+
+    {
+        _tnc_runtime::Writer writer(false, fileno(file));
+        for (long long value: {0LL, 7LL, -7LL, 10LL, 99LL, 100LL, LLONG_MAX, LLONG_MIN}) {
+            writer.Line(value);
+            expected << value << '\n';
+        }
+        for (int i = 0; i < 2000; i++) {
+            auto value = static_cast<long long>(random()) >> (random() % 64);
+            auto small = static_cast<int>(random());
+            unsigned long long large = random();
+            writer.Line(value, small, large);
+            expected << value << ' ' << small << ' ' << large << '\n';
+        }
+
+        std::string word = "word";
+        writer.Line('c', word, "text", true, 2.5, 1.0 / 3, 1e20);
+        expected << 'c' << ' ' << word << ' ' << "text" << ' ' << true << ' ' << 2.5 << ' ' << 1.0 / 3 << ' ' << 1e20
+                 << '\n';
+    }
+
+    std::string text(expected.str().size() + 1, '\0');
+    std::rewind(file);
+    text.resize(std::fread(text.data(), 1, text.size(), file));
+    std::fclose(file);
+    EXPECT_EQ(expected.str(), text);
+}
+
+TEST(FastOutputTests, JoinsContainers) {
+    Pipe pipe;
+    {
+        _tnc_runtime::Writer writer(false, pipe.fds[1]);
+        std::vector<int> row = {1, 2, 3};
+        std::vector<std::vector<int>> grid = {{1, 2}, {3, 4}};
+        std::pair<int, std::string> pair = {5, "five"};
+        int array[] = {6, 7};
+        writer.Line(row);
+        writer.Line(grid);
+        writer.Line(pair, array);
+        writer.Line();
+    }
+
+    EXPECT_EQ("1 2 3\n1 2\n3 4\n5 five 6 7\n\n", Drain(pipe.fds[0]));
+}
+
+TEST(FastOutputTests, FlushesAtExitOrPerLineWhenInteractive) {
+    Pipe pipe;
+    {
+        _tnc_runtime::Writer writer(false, pipe.fds[1]);
+        writer.Line(1, 2);
+        EXPECT_EQ("", Drain(pipe.fds[0]));
+        writer.Flush();
+        EXPECT_EQ("1 2\n", Drain(pipe.fds[0]));
+        writer.Line(3);
+    }
+    EXPECT_EQ("3\n", Drain(pipe.fds[0]));
+
+    _tnc_runtime::Writer interactive(true, pipe.fds[1]);
+    interactive.Write(4);
+    EXPECT_EQ("", Drain(pipe.fds[0]));
+    interactive.Line(5, 6);
+    EXPECT_EQ("45 6\n", Drain(pipe.fds[0]));
+}
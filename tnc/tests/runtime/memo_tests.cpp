@@ -0,0 +1,145 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the memo table runtime
+ */
+
+#include <array>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "runtime/memo.h"
+
+TEST(MemoTests, DenseCachesOnlyInsideTheRanges) {
+    _tnc_runtime::DenseMemo<long long, 2> memo({-2, 0}, {5, 3});
+
+    EXPECT_EQ(nullptr, memo.Find(0, 0));
+    EXPECT_EQ(7, memo.Store(7, -2, 2));
+    EXPECT_EQ(9, memo.Store(9, 2, 0));
+    EXPECT_EQ(11, memo.Store(11, 3, 0));
+    EXPECT_EQ(13, memo.Store(13, 0, -1));
+
+    ASSERT_NE(nullptr, memo.Find(-2, 2));
+    EXPECT_EQ(7, *memo.Find(-2, 2));
+    ASSERT_NE(nullptr, memo.Find(2, 0));
+    EXPECT_EQ(9, *memo.Find(2, 0));
+    EXPECT_EQ(nullptr, memo.Find(3, 0));
+    EXPECT_EQ(nullptr, memo.Find(0, -1));
+    EXPECT_EQ(nullptr, memo.Find(-3, 2));
+}
+
+TEST(MemoTests, ResetForgetsEveryValue) {
+    _tnc_runtime::DenseMemo<double, 1> memo({0}, {100});
+    for (int i = 0; i < 100; i++)
+        memo.Store(i * 0.5, i);
+    memo.Reset();
+
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(nullptr, memo.Find(i));
+    memo.Store(1.5, 42);
+    ASSERT_NE(nullptr, memo.Find(42));
+    EXPECT_DOUBLE_EQ(1.5, *memo.Find(42));
+}
+
+TEST(MemoTests, FillMatchesTopDown) {
+    _tnc_runtime::DenseMemo<long long, 2> top_down({-1, 0}, {40, 30}), bottom_up({-1, 0}, {40, 30});
+    std::function<long long(long long, long long)> recursive, filled;
+    auto compute = [](long long i, long long j, auto &f) -> long long {
+        if (i < 0 || j == 0)
+            return 1;
+        return (f(i - 1, j) * 3 + f(i, j - 1) + (i > 2 ? f(i - 3, j - 1) : 0) + i * j) % 1000003;
+    };
+    recursive = [&](long long i, long long j) {
+        if (const long long *cached = top_down.Find(i, j))
+            return *cached;
+        return top_down.Store(compute(i, j, recursive), i, j);
+    };
+    long long calls = 0;
+    auto body = [&](long long i, long long j) {
+        calls++;
+        return compute(i, j, filled);
+    };
+    filled = [&](long long i, long long j) {
+        if (const long long *cached = bottom_up.Fill(body, i, j))
+            return *cached;
+        return body(i, j);
+    };
+
+    // growing, shrinking and unrelated corners, each cell is computed once
+    for (auto [i, j]: std::vector<std::pair<int, int>>{{5, 7}, {20, 3}, {2, 2}, {38, 29}, {10, 10}, {38, 29}})
+        EXPECT_EQ(recursive(i, j), filled(i, j)) << i << ", " << j;
+    EXPECT_EQ(40 * 30, calls);
+    EXPECT_EQ(nullptr, bottom_up.Fill(body, 39, 0));
+}
+
+TEST(MemoTests, FillDoesNotRecurse) {
+    const long long n = 10000000;
+    _tnc_runtime::DenseMemo<long long, 1> memo({0}, {n + 1});
+    std::function<long long(long long)> fib;
+    fib = [&](long long i) -> long long {
+        auto body = [&](long long k) { return k < 2 ? k : (fib(k - 1) + fib(k - 2)) % 1000000007; };
+        if (const long long *cached = memo.Fill(body, i))
+            return *cached;
+        return body(i);
+    };
+    EXPECT_EQ(0, fib(0));
+    EXPECT_EQ(1, fib(2));
+    EXPECT_EQ(490189494, fib(n));
+}
+
+TEST(MemoTests, HashMatchesMapAcrossGrowth) {
+    _tnc_runtime::HashMemo<long long, int, long long> memo;
+    std::map<std::pair<int, long long>, long long> expected;
+    std::mt19937_64 random(49);
+
+    for (int i = 0; i < 50000; i++) {
+        int a = static_cast<int>(random() % 1000) - 500;
+        long long b = static_cast<long long>(random() % 100) << 40;
+        long long value = static_cast<long long>(random());
+        if (const long long *cached = memo.Find(a, b)) {
+            EXPECT_EQ(expected.at({a, b}), *cached);
+        } else {
+            EXPECT_EQ(0u, expected.count({a, b}));
+            memo.Store(value, a, b);
+            expected[{a, b}] = value;
+        }
+    }
+    EXPECT_EQ(expected.size(), memo.Size());
+}
+
+TEST(MemoTests, HashKeysOfAnyType) {
+    _tnc_runtime::HashMemo<std::string, const std::string &, std::pair<int, int>> memo;
+    memo.Store("first", "key", {1, 2});
+    memo.Store("second", "key", {2, 1});
+    memo.Store("third", "key", {1, 2});
+
+    ASSERT_NE(nullptr, memo.Find("key", {1, 2}));
+    EXPECT_EQ("third", *memo.Find("key", {1, 2}));
+    EXPECT_EQ("second", *memo.Find("key", {2, 1}));
+    EXPECT_EQ(nullptr, memo.Find("other", {1, 2}));
+    EXPECT_EQ(2u, memo.Size());
+}
+
+TEST(MemoTests, HashKeysOfContainers) {
+    _tnc_runtime::HashMemo<int, std::tuple<int, std::string>, std::vector<std::pair<int, int>>,
+                           std::array<long long, 2>, std::vector<bool>> memo;
+    memo.Store(1, {1, "a"}, {{1, 2}}, {3, 4}, {true});
+    memo.Store(2, {1, "a"}, {{2, 1}}, {3, 4}, {true});
+    memo.Store(3, {1, "a"}, {{1, 2}}, {3, 4}, {false});
+
+    ASSERT_NE(nullptr, memo.Find({1, "a"}, {{1, 2}}, {3, 4}, {true}));
+    EXPECT_EQ(1, *memo.Find({1, "a"}, {{1, 2}}, {3, 4}, {true}));
+    EXPECT_EQ(2, *memo.Find({1, "a"}, {{2, 1}}, {3, 4}, {true}));
+    EXPECT_EQ(3, *memo.Find({1, "a"}, {{1, 2}}, {3, 4}, {false}));
+    EXPECT_EQ(nullptr, memo.Find({1, "b"}, {{1, 2}}, {3, 4}, {true}));
+    EXPECT_EQ(nullptr, memo.Find({1, "a"}, {}, {3, 4}, {true}));
+    EXPECT_EQ(3u, memo.Size());
+}
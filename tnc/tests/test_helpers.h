@@ -0,0 +1,73 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Builders of small ASTs shared by the tests, statements keep the
+ * token spacing of the parser, as in "a [ i ] + = 1"
+ */
+
+#ifndef TONIC_TEST_HELPERS_H
+#define TONIC_TEST_HELPERS_H
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "core/ast.h"
+
+namespace tonic::test {
+
+    inline std::shared_ptr<GeneralStatement> Statement(const std::string &text, size_t line = 0) {
+        auto statement = std::make_shared<GeneralStatement>();
+        statement->statement = text;
+        statement->line = line;
+        return statement;
+    }
+
+    inline std::shared_ptr<Block> MakeBlock(std::vector<std::shared_ptr<Node>> body) {
+        auto block = std::make_shared<Block>();
+        block->body = std::move(body);
+        return block;
+    }
+
+    // for index in start..end, with no step
+    inline std::shared_ptr<ForLoop> Loop(const std::string &index, const std::string &start, const std::string &end,
+                                         std::vector<std::shared_ptr<Node>> body = {}, size_t line = 0) {
+        auto loop = std::make_shared<ForLoop>();
+        loop->identifier = Statement(index, line);
+        loop->start = Statement(start, line);
+        loop->end = Statement(end, line);
+        loop->block = MakeBlock(std::move(body));
+        loop->line = line;
+        return loop;
+    }
+
+    inline std::shared_ptr<ForLoop> WithStep(std::shared_ptr<ForLoop> loop, const std::string &step) {
+        loop->step = Statement(step, loop->line);
+        return loop;
+    }
+
+    inline std::shared_ptr<Program> MakeProgram(std::vector<std::shared_ptr<Node>> body) {
+        auto program = std::make_shared<Program>();
+        program->body = std::move(body);
+        return program;
+    }
+
+    // checks a generated program with the compiler of the build, its errors go to the test log
+    inline bool Compiles(const std::string &source) {
+        std::string path = ::testing::TempDir() + ::testing::UnitTest::GetInstance()->current_test_info()->name() +
+                           ".cpp";
+        std::ofstream(path) << source;
+        std::string command = std::string(TNC_TEST_CXX) + " -std=c++17 -fsyntax-only " + path;
+        return std::system(command.c_str()) == 0;
+    }
+
+}
+
+#endif //TONIC_TEST_HELPERS_H
@@ -0,0 +1,108 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the parallel walker
+ */
+
+#include <atomic>
+
+#include "gtest/gtest.h"
+
+#include "tests/test_helpers.h"
+#include "traversal/parallel_walker.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    struct Names {
+        std::vector<std::string> names;
+
+        void Merge(Names &&other) {
+            names.insert(names.end(), other.names.begin(), other.names.end());
+        }
+    };
+
+    std::shared_ptr<FunctionDeclaration> Function(const std::string &name,
+                                                  std::vector<std::shared_ptr<Node>> body) {
+        auto function = std::make_shared<FunctionDeclaration>();
+        function->block = std::make_shared<Block>();
+        function->block->body.push_back(Statement(name));
+        for (auto &node: body)
+            function->block->body.push_back(std::move(node));
+        return function;
+    }
+
+    // top, f: [ f, g: [ g ], f2 ], h: [ h ], bottom
+    std::shared_ptr<Program> SampleProgram() {
+        auto program = std::make_shared<Program>();
+        program->body.push_back(Statement("top"));
+        program->body.push_back(Function("f", {Function("g", {}), Statement("f2")}));
+        program->body.push_back(Function("h", {}));
+        program->body.push_back(Statement("bottom"));
+        return program;
+    }
+
+    ParallelWalker<Names> NameCollector(HandlerSafety safety) {
+        ParallelWalker<Names> walker;
+        walker.Register<GeneralStatement>([](GeneralStatement &statement, Names &state) {
+            state.names.push_back(statement.statement);
+        }, safety);
+        return walker;
+    }
+
+}
+
+TEST(ParallelWalkerTests, StatesAreMergedInPreOrderOfTaskRoots) {
+    auto walker = NameCollector(HandlerSafety::SUBTREE_LOCAL);
+    ThreadPool pool(4);
+
+    std::vector<std::string> expected = {"top", "bottom", "f", "f2", "g", "h"};
+    for (size_t run = 0; run < 20; run++) {
+        EXPECT_EQ(expected, walker.Walk(SampleProgram(), &pool).names);
+        EXPECT_TRUE(walker.Parallel());
+        EXPECT_EQ(4, walker.Tasks());
+    }
+
+    // the serial walk splits the tree the same way and gives the same result
+    EXPECT_EQ(expected, walker.Walk(SampleProgram()).names);
+    EXPECT_FALSE(walker.Parallel());
+}
+
+TEST(ParallelWalkerTests, SerialHandlerForcesSerialWalk) {
+    auto walker = NameCollector(HandlerSafety::SUBTREE_LOCAL);
+
+    size_t functions = 0;
+    walker.Register<FunctionDeclaration>([&functions](FunctionDeclaration &, Names &) {
+        ++functions;
+    }, HandlerSafety::SERIAL);
+
+    ThreadPool pool(4);
+    auto names = walker.Walk(SampleProgram(), &pool).names;
+
+    EXPECT_FALSE(walker.Parallel());
+    EXPECT_EQ(3, functions);
+    EXPECT_EQ((std::vector<std::string>{"top", "bottom", "f", "f2", "g", "h"}), names);
+}
+
+TEST(ParallelWalkerTests, ThreadSafeHandlersSeeEveryNodeOnce) {
+    auto program = std::make_shared<Program>();
+    for (size_t i = 0; i < 200; i++)
+        program->body.push_back(Function("f" + std::to_string(i), {Function("g", {})}));
+
+    std::atomic<size_t> statements = 0;
+    ParallelWalker<Names> walker;
+    walker.Register<GeneralStatement>([&statements](GeneralStatement &, Names &) {
+        ++statements;
+    }, HandlerSafety::THREAD_SAFE);
+
+    ThreadPool pool(4);
+    walker.Walk(program, &pool);
+
+    EXPECT_TRUE(walker.Parallel());
+    EXPECT_EQ(401, walker.Tasks());
+    EXPECT_EQ(400, statements);
+}
@@ -0,0 +1,173 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the fused pass manager
+ */
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "traversal/pass_manager.h"
+#include "errors/errors.h"
+#include "tests/test_helpers.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    // records its events into a log shared between passes
+    class RecordingPass : public Pass {
+    public:
+        RecordingPass(std::string name, std::vector<NodeKind> kinds, std::vector<std::string> dependencies,
+                      std::vector<std::string> &log)
+                : name(std::move(name)), kinds(std::move(kinds)), dependencies(std::move(dependencies)), log(log) {}
+
+        std::string Name() const override { return name; }
+
+        std::vector<NodeKind> Kinds() const override { return kinds; }
+
+        std::vector<std::string> Dependencies() const override { return dependencies; }
+
+        void Begin(Program &) override { log.push_back(name + " begin"); }
+
+        void Enter(Node &node) override {
+            if (node.kind == NodeKind::GENERAL_STATEMENT)
+                log.push_back(name + " " + static_cast<GeneralStatement &>(node).statement);
+            else
+                log.push_back(name + " enter");
+        }
+
+        void Leave(Node &node) override {
+            if (node.kind != NodeKind::GENERAL_STATEMENT)
+                log.push_back(name + " leave");
+        }
+
+        void End(Program &) override { log.push_back(name + " end"); }
+
+    private:
+        std::string name;
+        std::vector<NodeKind> kinds;
+        std::vector<std::string> dependencies;
+        std::vector<std::string> &log;
+    };
+
+    std::unique_ptr<Pass> MakePass(const std::string &name, std::vector<NodeKind> kinds,
+                                   std::vector<std::string> dependencies, std::vector<std::string> &log) {
+        return std::make_unique<RecordingPass>(name, std::move(kinds), std::move(dependencies), log);
+    }
+
+    // function: [ a, b ]
+    std::shared_ptr<Program> SampleProgram() {
+        auto function = std::make_shared<FunctionDeclaration>();
+        function->block = std::make_shared<Block>();
+        function->block->body.push_back(Statement("a"));
+        function->block->body.push_back(Statement("b"));
+
+        auto program = std::make_shared<Program>();
+        program->body.push_back(function);
+        return program;
+    }
+
+}
+
+TEST(PassManagerTests, IndependentPassesShareOneTraversal) {
+    std::vector<std::string> log;
+    PassManager manager;
+    manager.Add(MakePass("statements", {NodeKind::GENERAL_STATEMENT}, {}, log));
+    manager.Add(MakePass("functions", {NodeKind::FUNCTION_DECLARATION}, {}, log));
+
+    manager.Run(SampleProgram());
+
+    std::vector<std::string> expected = {
+            "statements begin", "functions begin",
+            "functions enter",
+            "statements a", "statements b",
+            "functions leave",
+            "statements end", "functions end",
+    };
+    EXPECT_EQ(expected, log);
+    EXPECT_EQ(1, manager.Traversals());
+}
+
+TEST(PassManagerTests, DependentPassesRunInLaterTraversals) {
+    std::vector<std::string> log;
+    PassManager manager;
+    manager.Add(MakePass("uses", {NodeKind::GENERAL_STATEMENT}, {"types"}, log));
+    manager.Add(MakePass("types", {NodeKind::GENERAL_STATEMENT}, {}, log));
+    manager.Add(MakePass("names", {NodeKind::GENERAL_STATEMENT}, {}, log));
+
+    std::vector<std::vector<std::string>> schedule = {{"types", "names"}, {"uses"}};
+    EXPECT_EQ(schedule, manager.Schedule());
+
+    manager.Run(SampleProgram());
+
+    std::vector<std::string> expected = {
+            "types begin", "names begin",
+            "types a", "names a", "types b", "names b",
+            "types end", "names end",
+            "uses begin", "uses a", "uses b", "uses end",
+    };
+    EXPECT_EQ(expected, log);
+    EXPECT_EQ(2, manager.Traversals());
+}
+
+TEST(PassManagerTests, InvalidDependenciesThrow) {
+    std::vector<std::string> log;
+
+    PassManager unknown;
+    unknown.Add(MakePass("uses", {}, {"types"}, log));
+    EXPECT_THROW(unknown.Schedule(), InternalError);
+
+    PassManager cyclic;
+    cyclic.Add(MakePass("a", {}, {"b"}, log));
+    cyclic.Add(MakePass("b", {}, {"a"}, log));
+    EXPECT_THROW(cyclic.Run(SampleProgram()), InternalError);
+
+    PassManager duplicate;
+    duplicate.Add(MakePass("a", {}, {}, log));
+    duplicate.Add(MakePass("a", {}, {}, log));
+    EXPECT_THROW(duplicate.Schedule(), InternalError);
+}
+
+TEST(PassManagerTests, TimingsCountEveryCall) {
+    std::vector<std::string> log;
+    PassManager manager;
+    manager.Add(MakePass("statements", {NodeKind::GENERAL_STATEMENT}, {}, log));
+    manager.Add(MakePass("summary", {}, {"statements"}, log));
+
+    manager.Run(SampleProgram());
+
+    const auto &timings = manager.Timings();
+    ASSERT_EQ(2, timings.size());
+
+    // begin, end and an enter and leave for both statements
+    EXPECT_EQ("statements", timings[0].name);
+    EXPECT_EQ(0, timings[0].level);
+    EXPECT_EQ(6, timings[0].calls);
+
+    EXPECT_EQ("summary", timings[1].name);
+    EXPECT_EQ(1, timings[1].level);
+    EXPECT_EQ(2, timings[1].calls);
+
+    std::ostringstream report;
+    manager.Report(report);
+    EXPECT_NE(std::string::npos, report.str().find("statements"));
+    EXPECT_NE(std::string::npos, report.str().find("level 1"));
+}
+
+TEST(PassManagerTests, NodesAreTimedOnRequest) {
+    std::vector<std::string> untimed_log, timed_log;
+    PassManager untimed, timed(true);
+    untimed.Add(MakePass("statements", {NodeKind::GENERAL_STATEMENT}, {}, untimed_log));
+    timed.Add(MakePass("statements", {NodeKind::GENERAL_STATEMENT}, {}, timed_log));
+
+    untimed.Run(SampleProgram());
+    timed.Run(SampleProgram());
+
+    EXPECT_EQ(untimed_log, timed_log);
+    EXPECT_EQ(untimed.Timings()[0].calls, timed.Timings()[0].calls);
+}
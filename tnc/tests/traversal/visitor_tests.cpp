@@ -0,0 +1,105 @@
+/**
+ * Licensed under the Apache License, Version 2.0;
+ * Please find the license in the repository .LICENSE file here:
+ * https://github.com/tonic-lang/tonic/blob/main/LICENSE
+ *
+ * @brief Tests for the compile-time AST visitor
+ */
+
+#include "gtest/gtest.h"
+
+#include "tests/test_helpers.h"
+#include "traversal/visitor.h"
+
+using namespace tonic;
+using namespace tonic::test;
+
+namespace {
+
+    struct OrderRecorder : AstVisitor<OrderRecorder> {
+        std::vector<std::string> events;
+
+        void Visit(FunctionDeclaration &) { events.emplace_back("enter function"); }
+
+        void Leave(FunctionDeclaration &) { events.emplace_back("leave function"); }
+
+        void Visit(ForLoop &) { events.emplace_back("enter for"); }
+
+        void Leave(ForLoop &) { events.emplace_back("leave for"); }
+
+        void Visit(GeneralStatement &statement) { events.push_back(statement.statement); }
+    };
+
+    struct NodeCounter : AstVisitor<NodeCounter> {
+        size_t count = 0;
+
+        void Visit(Node &) { ++count; }
+    };
+
+    // function: [ for i in 0..n: [ a ], b ]
+    std::shared_ptr<Program> SampleProgram() {
+        auto for_loop = std::make_shared<ForLoop>();
+        for_loop->identifier = Statement("i");
+        for_loop->start = Statement("0");
+        for_loop->end = Statement("n");
+        for_loop->block = std::make_shared<Block>();
+        for_loop->block->body.push_back(Statement("a"));
+
+        auto function = std::make_shared<FunctionDeclaration>();
+        function->block = std::make_shared<Block>();
+        function->block->body.push_back(for_loop);
+        function->block->body.push_back(Statement("b"));
+
+        auto program = std::make_shared<Program>();
+        program->body.push_back(function);
+        return program;
+    }
+
+}
+
+TEST(VisitorTests, TypedVisitAndLeaveOrder) {
+    OrderRecorder recorder;
+    recorder.Traverse(SampleProgram());
+
+    std::vector<std::string> expected = {
+            "enter function",
+            "enter for",
+            "i", "0", "n", "a",
+            "leave for",
+            "b",
+            "leave function",
+    };
+    EXPECT_EQ(expected, recorder.events);
+}
+
+TEST(VisitorTests, CatchAllOverloadSeesEveryNode) {
+    NodeCounter counter;
+    counter.Traverse(*SampleProgram());
+
+    // program, function, block, for, 4 statements, block, statement
+    EXPECT_EQ(10, counter.count);
+}
+
+TEST(VisitorTests, EmptySlotsAreSkipped) {
+    NodeCounter counter;
+    counter.Traverse(std::shared_ptr<Node>());
+    counter.Traverse(std::make_shared<IfStatement>());
+
+    EXPECT_EQ(1, counter.count);
+}
+
+TEST(VisitorTests, ElseIfChildrenAreVisited) {
+    auto else_if = std::make_shared<ElseIfStatement>();
+    else_if->condition = Statement("x > 0");
+    else_if->block = std::make_shared<Block>();
+    else_if->block->body.push_back(Statement("y"));
+
+    auto if_statement = std::make_shared<IfStatement>();
+    if_statement->condition = Statement("x < 0");
+    if_statement->else_if_statements.push_back(else_if);
+
+    OrderRecorder recorder;
+    recorder.Traverse(if_statement);
+
+    EXPECT_EQ((std::vector<std::string>{"x < 0", "x > 0", "y"}), recorder.events);
+}
@@ -290,4 +290,208 @@ TEST(WalkerTests, CorrectOrderOfExecution) {
     EXPECT_EQ("VariableDeclaration", visit_order[0]);
     EXPECT_EQ("FunctionDeclaration", visit_order[1]);
     EXPECT_EQ("ForLoop", visit_order[2]);
-}
\ No newline at end of file
+}
+
+TEST(WalkerTests, PostHandlersRunAfterChildren) {
+    Walker walker;
+    std::vector<std::string> events;
+
+    walker.Register<Block>([&](std::shared_ptr<Block>) {
+        events.emplace_back("enter Block");
+    });
+
+    walker.RegisterPost<Block>([&](std::shared_ptr<Block>) {
+        events.emplace_back("leave Block");
+    });
+
+    walker.Register<FunctionDeclaration>([&](std::shared_ptr<FunctionDeclaration>) {
+        events.emplace_back("FunctionDeclaration");
+    });
+
+    auto outer_block = std::make_shared<Block>();
+    auto inner_block = std::make_shared<Block>();
+    inner_block->body.push_back(std::make_shared<FunctionDeclaration>());
+    outer_block->body.push_back(inner_block);
+    walker.Walk(outer_block);
+
+    std::vector<std::string> expected = {
+            "enter Block",
+            "enter Block",
+            "FunctionDeclaration",
+            "leave Block",
+            "leave Block",
+    };
+    EXPECT_EQ(expected, events);
+}
+
+TEST(WalkerTests, AncestorsAreAvailableToHandlers) {
+    Walker walker;
+    std::vector<Node *> seen_ancestors;
+    Node *seen_parent = nullptr;
+
+    walker.Register<VariableDeclaration>([&](std::shared_ptr<VariableDeclaration>) {
+        seen_ancestors = walker.Ancestors();
+        seen_parent = walker.Parent();
+    });
+
+    auto variable = std::make_shared<VariableDeclaration>();
+    auto function = std::make_shared<FunctionDeclaration>();
+    function->block = std::make_shared<Block>();
+    function->block->body.push_back(variable);
+    auto program = std::make_shared<Program>();
+    program->body.push_back(function);
+
+    walker.Walk(program);
+
+    std::vector<Node *> expected = {program.get(), function.get(), function->block.get()};
+    EXPECT_EQ(expected, seen_ancestors);
+    EXPECT_EQ(function->block.get(), seen_parent);
+    EXPECT_TRUE(walker.Ancestors().empty());
+}
+
+TEST(WalkerTests, DeeplyNestedTreeDoesNotOverflowTheStack) {
+    Walker walker;
+    size_t blocks = 0;
+    size_t max_depth = 0;
+
+    walker.Register<Block>([&](std::shared_ptr<Block>) {
+        ++blocks;
+        max_depth = std::max(max_depth, walker.Ancestors().size());
+    });
+
+    const size_t depth = 200000;
+    std::vector<std::shared_ptr<Block>> chain = {std::make_shared<Block>()};
+    for (size_t i = 1; i < depth; i++) {
+        chain.push_back(std::make_shared<Block>());
+        chain[i - 1]->body.push_back(chain[i]);
+    }
+
+    walker.Walk(chain[0]);
+
+    EXPECT_EQ(depth, blocks);
+    EXPECT_EQ(depth - 1, max_depth);
+
+    // unlinking first keeps the destructor from recursing through the chain
+    for (auto &block: chain)
+        block->body.clear();
+}
+
+TEST(WalkerTests, FlatWalkRunsPostHandlersAndTracksAncestors) {
+    Walker walker;
+    std::vector<std::string> events;
+
+    walker.Register<Block>([&](std::shared_ptr<Block>) {
+        events.push_back("enter Block at depth " + std::to_string(walker.Ancestors().size()));
+    });
+
+    walker.RegisterPost<Block>([&](std::shared_ptr<Block>) {
+        events.emplace_back("leave Block");
+    });
+
+    walker.Register<FunctionDeclaration>([&](std::shared_ptr<FunctionDeclaration>) {
+        events.emplace_back("FunctionDeclaration");
+    });
+
+    auto inner_block = std::make_shared<Block>();
+    inner_block->body.push_back(std::make_shared<FunctionDeclaration>());
+    auto outer_block = std::make_shared<Block>();
+    outer_block->body.push_back(inner_block);
+    outer_block->body.push_back(std::make_shared<FunctionDeclaration>());
+
+    walker.Walk(FlatAst(outer_block));
+
+    std::vector<std::string> expected = {
+            "enter Block at depth 0",
+            "enter Block at depth 1",
+            "FunctionDeclaration",
+            "leave Block",
+            "FunctionDeclaration",
+            "leave Block",
+    };
+    EXPECT_EQ(expected, events);
+    EXPECT_TRUE(walker.Ancestors().empty());
+}
+
+TEST(WalkerTests, SkipChildrenPrunesSubtreeButRunsPostHandler) {
+    Walker walker;
+    std::vector<std::string> events;
+
+    walker.Register<FunctionDeclaration>([&](std::shared_ptr<FunctionDeclaration>) {
+        events.emplace_back("enter FunctionDeclaration");
+        return WalkControl::SKIP_CHILDREN;
+    });
+
+    walker.RegisterPost<FunctionDeclaration>([&](std::shared_ptr<FunctionDeclaration>) {
+        events.emplace_back("leave FunctionDeclaration");
+    });
+
+    walker.Register<VariableDeclaration>([&](std::shared_ptr<VariableDeclaration>) {
+        events.emplace_back("VariableDeclaration");
+    });
+
+    auto function = std::make_shared<FunctionDeclaration>();
+    function->block = std::make_shared<Block>();
+    function->block->body.push_back(std::make_shared<VariableDeclaration>());
+    auto program = std::make_shared<Program>();
+    program->body.push_back(function);
+    program->body.push_back(std::make_shared<VariableDeclaration>());
+
+    std::vector<std::string> expected = {
+            "enter FunctionDeclaration",
+            "leave FunctionDeclaration",
+            "VariableDeclaration",
+    };
+
+    EXPECT_TRUE(walker.Walk(program));
+    EXPECT_EQ(expected, events);
+
+    events.clear();
+    EXPECT_TRUE(walker.Walk(FlatAst(program)));
+    EXPECT_EQ(expected, events);
+}
+
+TEST(WalkerTests, StopEndsTheWalk) {
+    Walker walker;
+    size_t visited = 0;
+
+    walker.Register<VariableDeclaration>([&](std::shared_ptr<VariableDeclaration>) {
+        return ++visited == 2 ? WalkControl::STOP : WalkControl::CONTINUE;
+    });
+
+    auto block = std::make_shared<Block>();
+    for (size_t i = 0; i < 5; i++)
+        block->body.push_back(std::make_shared<VariableDeclaration>());
+    auto program = std::make_shared<Program>();
+    program->body.push_back(block);
+
+    EXPECT_FALSE(walker.Walk(program));
+    EXPECT_EQ(2, visited);
+    EXPECT_TRUE(walker.Ancestors().empty());
+
+    visited = 0;
+    EXPECT_FALSE(walker.Walk(FlatAst(program)));
+    EXPECT_EQ(2, visited);
+    EXPECT_TRUE(walker.Ancestors().empty());
+}
+
+TEST(WalkerTests, FindFirstAndAnyStopAtTheFirstMatch) {
+    auto first = std::make_shared<InputOutput>();
+    first->type = InOut::IN;
+    auto second = std::make_shared<InputOutput>();
+    second->type = InOut::OUT;
+
+    auto block = std::make_shared<Block>();
+    block->body.push_back(first);
+    block->body.push_back(second);
+    auto program = std::make_shared<Program>();
+    program->body.push_back(block);
+
+    EXPECT_EQ(first, FindFirst<InputOutput>(program));
+    EXPECT_EQ(second, FindFirst<InputOutput>(program, [](const InputOutput &node) {
+        return node.type == InOut::OUT;
+    }));
+
+    EXPECT_TRUE(Any<InputOutput>(program));
+    EXPECT_FALSE(Any<ForLoop>(program));
+    EXPECT_FALSE(Any<Block>(program, [](const Block &node) { return node.body.empty(); }));
+}